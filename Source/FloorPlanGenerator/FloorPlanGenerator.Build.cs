@@ -45,10 +45,25 @@ public class FloorPlanGenerator : ModuleRules
                 "AssetTools",
                 "ProceduralMeshComponent",
                 "MeshDescription",
-                "StaticMeshDescription"
+                "StaticMeshDescription",
+                "ImageWrapper",
+                "Sockets",
+                "Networking"
             }
         );
 
+        // Row-by-row PNG/TIFF decoding for streaming analysis
+        AddEngineThirdPartyPrivateStaticDependencies(Target, "UElibPNG", "zlib");
+
+        bool bWithLibTiff = Target.Platform == UnrealTargetPlatform.Win64 ||
+                            Target.Platform == UnrealTargetPlatform.Mac ||
+                            Target.Platform == UnrealTargetPlatform.Linux;
+        if (bWithLibTiff)
+        {
+            AddEngineThirdPartyPrivateStaticDependencies(Target, "LibTiff");
+        }
+        PrivateDefinitions.Add("WITH_FLOORPLAN_LIBTIFF=" + (bWithLibTiff ? "1" : "0"));
+
         DynamicallyLoadedModuleNames.AddRange(
             new string[]
             {
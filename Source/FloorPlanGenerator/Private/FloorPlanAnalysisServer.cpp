@@ -0,0 +1,414 @@
+#include "FloorPlanAnalysisServer.h"
+#include "FloorPlanLog.h"
+#include "FloorPlanAnalyzer.h"
+#include "Async/Async.h"
+#include "Common/TcpListener.h"
+#include "Common/TcpSocketBuilder.h"
+#include "Interfaces/IPv4/IPv4Endpoint.h"
+#include "Sockets.h"
+#include "SocketSubsystem.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeExit.h"
+#include "Misc/SecureHash.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+namespace FloorPlanAnalysisServerPrivate
+{
+    // Every message is a header of three native-endian uint32 (magic, version, payload size) and the
+    // payload; client and server always run on the same machine
+    constexpr uint32 Magic = 0x53415046; // "FPAS"
+    constexpr uint32 Version = 1;
+    constexpr uint32 MaxPayloadBytes = 1u << 30;
+
+    // A client that connects has its request ready, so a slow one is dropped rather than waited for
+    constexpr double RequestTimeoutSeconds = 30.0;
+
+    // Granularity at which blocked reads notice a timeout or a stopping server
+    constexpr double WaitSliceSeconds = 0.1;
+
+    void DestroySocket(FSocket* Socket)
+    {
+        Socket->Close();
+        ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(Socket);
+    }
+
+    bool SendAll(FSocket* Socket, const uint8* Data, int64 Size)
+    {
+        while (Size > 0)
+        {
+            int32 BytesSent = 0;
+            if (!Socket->Send(Data, static_cast<int32>(FMath::Min<int64>(Size, MAX_int32)), BytesSent) || BytesSent <= 0)
+            {
+                return false;
+            }
+            Data += BytesSent;
+            Size -= BytesSent;
+        }
+        return true;
+    }
+
+    bool RecvAll(FSocket* Socket, uint8* Data, int64 Size, double TimeoutSeconds, const std::atomic<bool>* bCancel)
+    {
+        const double EndSeconds = FPlatformTime::Seconds() + TimeoutSeconds;
+        while (Size > 0)
+        {
+            if ((bCancel && *bCancel) || FPlatformTime::Seconds() > EndSeconds)
+            {
+                return false;
+            }
+            if (!Socket->Wait(ESocketWaitConditions::WaitForRead, FTimespan::FromSeconds(WaitSliceSeconds)))
+            {
+                continue;
+            }
+
+            // Readable with nothing to read means the other side closed the connection
+            int32 BytesRead = 0;
+            if (!Socket->Recv(Data, static_cast<int32>(FMath::Min<int64>(Size, MAX_int32)), BytesRead) || BytesRead <= 0)
+            {
+                return false;
+            }
+            Data += BytesRead;
+            Size -= BytesRead;
+        }
+        return true;
+    }
+
+    bool SendMessage(FSocket* Socket, const TArray<uint8>& Payload)
+    {
+        const uint32 Header[3] = { Magic, Version, static_cast<uint32>(Payload.Num()) };
+        return SendAll(Socket, reinterpret_cast<const uint8*>(Header), sizeof(Header)) && SendAll(Socket, Payload.GetData(), Payload.Num());
+    }
+
+    bool RecvMessage(FSocket* Socket, TArray<uint8>& OutPayload, double TimeoutSeconds, const std::atomic<bool>* bCancel = nullptr)
+    {
+        uint32 Header[3] = { 0, 0, 0 };
+        if (!RecvAll(Socket, reinterpret_cast<uint8*>(Header), sizeof(Header), TimeoutSeconds, bCancel))
+        {
+            return false;
+        }
+        if (Header[0] != Magic || Header[1] != Version || Header[2] > MaxPayloadBytes)
+        {
+            UE_LOG(LogFloorPlan, Warning, TEXT("FloorPlanAnalysisServer: Rejected message with magic %08x, version %u, %u bytes"), Header[0], Header[1], Header[2]);
+            return false;
+        }
+
+        OutPayload.SetNumUninitialized(Header[2]);
+        return RecvAll(Socket, OutPayload.GetData(), OutPayload.Num(), TimeoutSeconds, bCancel);
+    }
+}
+
+bool FFloorPlanAnalysisClient::Submit(const FString& Address, const FString& FilePath, float ScaleFactor, const TArray<uint8>& Settings,
+                                      float TimeoutSeconds, TArray<uint8>& OutResults, bool& bOutCacheHit)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(FFloorPlanAnalysisClient::Submit);
+    using namespace FloorPlanAnalysisServerPrivate;
+
+    bOutCacheHit = false;
+    FIPv4Endpoint Endpoint;
+    if (!FIPv4Endpoint::Parse(Address, Endpoint))
+    {
+        UE_LOG(LogFloorPlan, Warning, TEXT("FloorPlanAnalysisClient: Invalid server address %s, expected ip:port"), *Address);
+        return false;
+    }
+
+    FSocket* Socket = FTcpSocketBuilder(TEXT("FloorPlanAnalysisClient")).AsBlocking().Build();
+    if (!Socket)
+    {
+        return false;
+    }
+    ON_SCOPE_EXIT
+    {
+        DestroySocket(Socket);
+    };
+
+    if (!Socket->Connect(*Endpoint.ToInternetAddr()))
+    {
+        UE_LOG(LogFloorPlan, Verbose, TEXT("FloorPlanAnalysisClient: No server at %s"), *Address);
+        return false;
+    }
+
+    // The server stats and reads the file itself, so it gets the absolute path
+    TArray<uint8> Request;
+    FMemoryWriter Writer(Request);
+    FString FullPath = FPaths::ConvertRelativePathToFull(FilePath);
+    TArray<uint8> SettingsCopy = Settings;
+    Writer << FullPath << ScaleFactor << SettingsCopy;
+
+    TArray<uint8> Response;
+    if (!SendMessage(Socket, Request) || !RecvMessage(Socket, Response, TimeoutSeconds))
+    {
+        UE_LOG(LogFloorPlan, Warning, TEXT("FloorPlanAnalysisClient: No reply from %s for %s"), *Address, *FullPath);
+        return false;
+    }
+
+    FMemoryReader Reader(Response);
+    bool bSucceeded = false;
+    Reader << bSucceeded << bOutCacheHit << OutResults;
+    return bSucceeded && !Reader.IsError();
+}
+
+FFloorPlanAnalysisServer::~FFloorPlanAnalysisServer()
+{
+    Stop();
+}
+
+bool FFloorPlanAnalysisServer::Start(const FString& Address, int64 InMaxCacheBytes)
+{
+    FIPv4Endpoint Endpoint;
+    if (!FIPv4Endpoint::Parse(Address, Endpoint))
+    {
+        UE_LOG(LogFloorPlan, Error, TEXT("FloorPlanAnalysisServer: Invalid address %s, expected ip:port"), *Address);
+        return false;
+    }
+
+    MaxCacheBytes = FMath::Max<int64>(0, InMaxCacheBytes);
+    bStopping = false;
+
+    Listener = MakeUnique<FTcpListener>(Endpoint, FTimespan::FromMilliseconds(100));
+    Listener->OnConnectionAccepted().BindRaw(this, &FFloorPlanAnalysisServer::HandleConnectionAccepted);
+    if (!Listener->IsActive())
+    {
+        UE_LOG(LogFloorPlan, Error, TEXT("FloorPlanAnalysisServer: Could not listen on %s"), *Address);
+        Listener.Reset();
+        return false;
+    }
+
+    // One analyzer for every job, so its allocations and lazily created helpers stay warm
+    Analyzer = NewObject<UFloorPlanAnalyzer>();
+    Analyzer->AddToRoot();
+
+    UE_LOG(LogFloorPlan, Display, TEXT("FloorPlanAnalysisServer: Listening on %s with a %.0f MB result cache"),
+           *Endpoint.ToString(), MaxCacheBytes / (1024.0 * 1024.0));
+    return true;
+}
+
+void FFloorPlanAnalysisServer::Stop()
+{
+    bStopping = true;
+    Listener.Reset();
+
+    // Jobs are queued under the lock, so nothing is added after this drain
+    {
+        FScopeLock Lock(&JobsLock);
+        TSharedPtr<FJob> Job;
+        while (PendingJobs.Dequeue(Job))
+        {
+            Job->bSucceeded = false;
+            Job->Promise.SetValue();
+        }
+        Jobs.Empty();
+        CachedBytes = 0;
+    }
+
+    while (NumActiveConnections > 0)
+    {
+        FPlatformProcess::Sleep(0.01f);
+    }
+
+    if (Analyzer)
+    {
+        Analyzer->RemoveFromRoot();
+        Analyzer = nullptr;
+    }
+}
+
+int32 FFloorPlanAnalysisServer::Tick()
+{
+    check(IsInGameThread());
+
+    int32 NumRun = 0;
+    TSharedPtr<FJob> Job;
+    while (!bStopping && Analyzer && PendingJobs.Dequeue(Job))
+    {
+        TRACE_CPUPROFILER_EVENT_SCOPE(FFloorPlanAnalysisServer::RunJob);
+        const double StartSeconds = FPlatformTime::Seconds();
+
+        // The settings never carry a server address, so the analysis always runs here
+        FMemoryReader SettingsReader(Job->Settings);
+        Analyzer->SerializeSettings(SettingsReader);
+        bool bSucceeded = !SettingsReader.IsError() && Analyzer->AnalyzeFloorPlanFile(Job->FilePath, Job->ScaleFactor);
+        if (bSucceeded)
+        {
+            FMemoryWriter ResultsWriter(Job->Results);
+            Analyzer->SerializeResults(ResultsWriter);
+            bSucceeded = !ResultsWriter.IsError();
+        }
+        Job->bSucceeded = bSucceeded;
+        Job->Promise.SetValue();
+
+        {
+            // Failed jobs are forgotten so the next request retries them
+            FScopeLock Lock(&JobsLock);
+            Job->LastUsedSeconds = FPlatformTime::Seconds();
+            if (bSucceeded)
+            {
+                CachedBytes += Job->Results.Num();
+            }
+            else if (Jobs.FindRef(Job->Key) == Job)
+            {
+                Jobs.Remove(Job->Key);
+            }
+        }
+
+        UE_LOG(LogFloorPlan, Display, TEXT("FloorPlanAnalysisServer: %s %s in %.1f ms (%d KB of results)"),
+               bSucceeded ? TEXT("Analyzed") : TEXT("Failed"), *FPaths::GetCleanFilename(Job->FilePath),
+               (FPlatformTime::Seconds() - StartSeconds) * 1000.0, Job->Results.Num() / 1024);
+        ++NumRun;
+    }
+
+    if (NumRun > 0)
+    {
+        EvictToBudget();
+    }
+    return NumRun;
+}
+
+int32 FFloorPlanAnalysisServer::GetNumCached() const
+{
+    FScopeLock Lock(&JobsLock);
+    return Jobs.Num();
+}
+
+int64 FFloorPlanAnalysisServer::GetNumHits() const
+{
+    FScopeLock Lock(&JobsLock);
+    return NumHits;
+}
+
+int64 FFloorPlanAnalysisServer::GetNumMisses() const
+{
+    FScopeLock Lock(&JobsLock);
+    return NumMisses;
+}
+
+bool FFloorPlanAnalysisServer::HandleConnectionAccepted(FSocket* Socket, const FIPv4Endpoint& Endpoint)
+{
+    if (bStopping)
+    {
+        return false;
+    }
+
+    // The listener thread only hands the socket over, requests are read and answered on the pool
+    ++NumActiveConnections;
+    Socket->SetNonBlocking(false);
+    Async(EAsyncExecution::ThreadPool, [this, Socket]()
+    {
+        ServeConnection(Socket);
+        FloorPlanAnalysisServerPrivate::DestroySocket(Socket);
+        --NumActiveConnections;
+    });
+    return true;
+}
+
+void FFloorPlanAnalysisServer::ServeConnection(FSocket* Socket)
+{
+    using namespace FloorPlanAnalysisServerPrivate;
+
+    TArray<uint8> Request;
+    if (!RecvMessage(Socket, Request, RequestTimeoutSeconds, &bStopping))
+    {
+        return;
+    }
+
+    FMemoryReader Reader(Request);
+    FString FilePath;
+    float ScaleFactor = 1.0f;
+    TArray<uint8> Settings;
+    Reader << FilePath << ScaleFactor << Settings;
+    if (Reader.IsError())
+    {
+        return;
+    }
+
+    // Cached, in flight for another client, or queued for the next Tick
+    bool bCacheHit = false;
+    const TSharedPtr<FJob> Job = FindOrQueueJob(FilePath, ScaleFactor, MoveTemp(Settings), bCacheHit);
+    if (Job)
+    {
+        Job->Done.Wait();
+    }
+
+    // Results are written once before Done is set, so every waiter can read them without the lock
+    bool bSucceeded = Job && Job->bSucceeded;
+    TArray<uint8> Response;
+    FMemoryWriter Writer(Response);
+    Writer << bSucceeded << bCacheHit;
+    int32 NumResultBytes = bSucceeded ? Job->Results.Num() : 0;
+    Writer << NumResultBytes;
+    if (NumResultBytes > 0)
+    {
+        Writer.Serialize(const_cast<uint8*>(Job->Results.GetData()), NumResultBytes);
+    }
+    SendMessage(Socket, Response);
+}
+
+TSharedPtr<FFloorPlanAnalysisServer::FJob> FFloorPlanAnalysisServer::FindOrQueueJob(const FString& FilePath, float ScaleFactor, TArray<uint8>&& Settings, bool& bOutCacheHit)
+{
+    bOutCacheHit = false;
+
+    // A file that changes on disk gets a new key, its stale entry ages out of the cache
+    const int64 FileSize = IFileManager::Get().FileSize(*FilePath);
+    if (FileSize < 0)
+    {
+        UE_LOG(LogFloorPlan, Warning, TEXT("FloorPlanAnalysisServer: %s not found"), *FilePath);
+        return nullptr;
+    }
+    const FDateTime TimeStamp = IFileManager::Get().GetTimeStamp(*FilePath);
+    const FString Key = FString::Printf(TEXT("%s|%lld|%lld|%g|%s"), *FilePath, FileSize, TimeStamp.GetTicks(), ScaleFactor,
+                                        *FMD5::HashBytes(Settings.GetData(), Settings.Num()));
+
+    FScopeLock Lock(&JobsLock);
+    if (bStopping)
+    {
+        return nullptr;
+    }
+
+    if (const TSharedPtr<FJob>* Found = Jobs.Find(Key))
+    {
+        (*Found)->LastUsedSeconds = FPlatformTime::Seconds();
+        ++NumHits;
+        bOutCacheHit = true;
+        return *Found;
+    }
+
+    TSharedPtr<FJob> Job = MakeShared<FJob>();
+    Job->Key = Key;
+    Job->FilePath = FilePath;
+    Job->ScaleFactor = ScaleFactor;
+    Job->Settings = MoveTemp(Settings);
+    Job->LastUsedSeconds = FPlatformTime::Seconds();
+    Job->Done = Job->Promise.GetFuture().Share();
+    Jobs.Add(Key, Job);
+    PendingJobs.Enqueue(Job);
+    ++NumMisses;
+    return Job;
+}
+
+void FFloorPlanAnalysisServer::EvictToBudget()
+{
+    FScopeLock Lock(&JobsLock);
+
+    // Least recently used finished results go first; cache sizes are small enough for a linear scan
+    while (CachedBytes > MaxCacheBytes)
+    {
+        FString OldestKey;
+        double OldestSeconds = TNumericLimits<double>::Max();
+        for (const TPair<FString, TSharedPtr<FJob>>& Pair : Jobs)
+        {
+            if (Pair.Value->Done.IsReady() && Pair.Value->LastUsedSeconds < OldestSeconds)
+            {
+                OldestKey = Pair.Key;
+                OldestSeconds = Pair.Value->LastUsedSeconds;
+            }
+        }
+        if (OldestKey.IsEmpty())
+        {
+            break;
+        }
+
+        CachedBytes -= Jobs.FindChecked(OldestKey)->Results.Num();
+        Jobs.Remove(OldestKey);
+    }
+}
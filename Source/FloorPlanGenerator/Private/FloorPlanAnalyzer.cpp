@@ -1,7 +1,124 @@
 #include "FloorPlanAnalyzer.h"
+#include "FloorPlanLog.h"
+#include "FloorPlanProfile.h"
+#include "FloorPlanStripReader.h"
+#include "FloorPlanStreamingAnalyzer.h"
+#include "FloorPlanPyramidAnalyzer.h"
+#include "FloorPlanMask.h"
+#include "FloorPlanPreprocessor.h"
+#include "FloorPlanDistanceTransform.h"
+#include "FloorPlanOpeningDetector.h"
+#include "FloorPlanTextRecognizer.h"
+#include "FloorPlanDXFReader.h"
+#include "FloorPlanSVGReader.h"
+#include "FloorPlanPDFReader.h"
+#include "FloorPlanVectorScene.h"
+#include "FloorPlanVectorAnalyzer.h"
+#include "FloorPlanSpatialIndex.h"
+#include "FloorPlanAnalysisServer.h"
+#include "Internationalization/Regex.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
 #include "Engine/Texture2D.h"
 #include "Engine/Engine.h"
 
+namespace FloorPlanAnalyzerPrivate
+{
+    // Streaming state besides the strip: three class rows, two run rows, label stats and wall cells
+    constexpr int64 StreamingRowStateBytesPerPixel = 32;
+
+    // Strips lower than this lose too much context for run merging to pay off
+    constexpr int32 MinStreamingStripRows = 16;
+
+    // USTRUCT arrays through their reflected layout, so new fields travel without touching this code
+    template <typename StructType>
+    void SerializeStructArray(FArchive& Ar, TArray<StructType>& Array)
+    {
+        int32 Num = Array.Num();
+        Ar << Num;
+        if (Ar.IsLoading())
+        {
+            if (Num < 0 || Ar.IsError())
+            {
+                Ar.SetError();
+                return;
+            }
+            Array.SetNum(Num);
+        }
+        for (StructType& Element : Array)
+        {
+            StructType::StaticStruct()->SerializeBin(Ar, &Element);
+        }
+    }
+
+    template <typename ElementType>
+    bool CopyAt(const TArray<ElementType>& Array, int32 Index, ElementType& OutElement)
+    {
+        if (!Array.IsValidIndex(Index))
+        {
+            OutElement = ElementType();
+            return false;
+        }
+        OutElement = Array[Index];
+        return true;
+    }
+
+    template <typename ElementType>
+    TArray<ElementType> CopyRange(const TArray<ElementType>& Array, int32 First, int32 Count)
+    {
+        const int32 Begin = FMath::Clamp(First, 0, Array.Num());
+        const int32 Num = FMath::Min(FMath::Max(Count, 0), Array.Num() - Begin);
+        return TArray<ElementType>(Array.GetData() + Begin, Num);
+    }
+
+    // Index of the first element at or after Cursor that passes the filter, INDEX_NONE when there is none
+    template <typename ElementType, typename PredicateType>
+    int32 FindNext(const TArray<ElementType>& Array, int32 Cursor, PredicateType Predicate)
+    {
+        for (int32 Index = FMath::Max(Cursor, 0); Index < Array.Num(); ++Index)
+        {
+            if (Predicate(Array[Index]))
+            {
+                return Index;
+            }
+        }
+        return INDEX_NONE;
+    }
+}
+
+FFloorPlanAnalysisResult::FFloorPlanAnalysisResult() = default;
+
+FFloorPlanAnalysisResult::~FFloorPlanAnalysisResult() = default;
+
+const FFloorPlanSpatialIndex& FFloorPlanAnalysisResult::GetSpatialIndex() const
+{
+    FScopeLock Lock(&SpatialIndexLock);
+    if (!SpatialIndex.IsValid())
+    {
+        TUniquePtr<FFloorPlanSpatialIndex> Index = MakeUnique<FFloorPlanSpatialIndex>();
+        Index->Build(Rooms, WallSegments, Openings);
+        SpatialIndex = MoveTemp(Index);
+    }
+    return *SpatialIndex;
+}
+
+void FFloorPlanAnalysisResult::Serialize(FArchive& Ar)
+{
+    using namespace FloorPlanAnalyzerPrivate;
+
+    SerializeStructArray(Ar, Rooms);
+    SerializeStructArray(Ar, Openings);
+    SerializeStructArray(Ar, WallSegments);
+    Ar << WallPoints << ImageDimensions << CalibratedScaleFactor;
+}
+
+FFloorPlanAnalysisResultRef FFloorPlanAnalysisResult::GetEmpty()
+{
+    static const FFloorPlanAnalysisResultRef Empty = MakeShared<FFloorPlanAnalysisResult, ESPMode::ThreadSafe>();
+    return Empty;
+}
+
 UFloorPlanAnalyzer::UFloorPlanAnalyzer()
 {
     ImageDimensions = FVector2D::ZeroVector;
@@ -11,32 +128,732 @@ bool UFloorPlanAnalyzer::AnalyzeFloorPlan(UTexture2D* FloorPlanImage, float Scal
 {
     if (!FloorPlanImage)
     {
-        UE_LOG(LogTemp, Error, TEXT("FloorPlanAnalyzer: No image provided"));
+        UE_LOG(LogFloorPlan, Error, TEXT("FloorPlanAnalyzer: No image provided"));
         return false;
     }
 
-    // Clear previous data
-    RoomData.Empty();
-    OpeningData.Empty();
-    WallPoints.Empty();
+    ResetResults();
+    FFloorPlanStageTimer TotalTimer(&Profile.TotalMs);
 
     int32 Width = FloorPlanImage->GetSizeX();
     int32 Height = FloorPlanImage->GetSizeY();
     ImageDimensions = FVector2D(Width, Height);
 
-    UE_LOG(LogTemp, Log, TEXT("FloorPlanAnalyzer: Analyzing image %dx%d with scale factor %.2f"), Width, Height, ScaleFactor);
+    UE_LOG(LogFloorPlan, Log, TEXT("FloorPlanAnalyzer: Analyzing image %dx%d with scale factor %.2f"), Width, Height, ScaleFactor);
+
+    if (AnalysisMode != EFloorPlanAnalysisMode::Sample)
+    {
+        TUniquePtr<FFloorPlanStripReader> Reader = FFloorPlanStripReader::CreateForTexture(FloorPlanImage);
+        return Reader && AnalyzeRaster(*Reader, ScaleFactor);
+    }
 
     // Create sample room data based on your floor plan
     CreateSampleRoomsFromFloorPlan(ScaleFactor);
     CreateSampleWallPoints(ScaleFactor);
     CreateSampleOpenings(ScaleFactor);
+    PublishResults();
+
+    UE_LOG(LogFloorPlan, Log, TEXT("FloorPlanAnalyzer: Found %d rooms, %d openings, %d wall points"), 
+           Result->Rooms.Num(), Result->Openings.Num(), Result->WallPoints.Num());
+
+    return true;
+}
+
+bool UFloorPlanAnalyzer::AnalyzeFloorPlanFile(const FString& FilePath, float ScaleFactor)
+{
+    if (!AnalysisServerAddress.IsEmpty() && AnalyzeOnServer(FilePath, ScaleFactor))
+    {
+        return true;
+    }
+
+    const FString Extension = FPaths::GetExtension(FilePath);
+    if (Extension.Equals(TEXT("dxf"), ESearchCase::IgnoreCase) || Extension.Equals(TEXT("svg"), ESearchCase::IgnoreCase) ||
+        Extension.Equals(TEXT("pdf"), ESearchCase::IgnoreCase))
+    {
+        return AnalyzeFloorPlanVectorFile(FilePath, ScaleFactor);
+    }
+
+    TUniquePtr<FFloorPlanStripReader> Reader = FFloorPlanStripReader::CreateForFile(FilePath);
+    if (!Reader)
+    {
+        UE_LOG(LogFloorPlan, Error, TEXT("FloorPlanAnalyzer: Could not open %s"), *FilePath);
+        return false;
+    }
+
+    UE_LOG(LogFloorPlan, Log, TEXT("FloorPlanAnalyzer: Reading %s"), *FilePath);
+    return AnalyzeFloorPlanReader(*Reader, ScaleFactor);
+}
+
+void UFloorPlanAnalyzer::SetAnalysisServer(const FString& Address, float TimeoutSeconds)
+{
+    AnalysisServerAddress = Address;
+    AnalysisServerTimeoutSeconds = FMath::Max(1.0f, TimeoutSeconds);
+}
+
+bool UFloorPlanAnalyzer::AnalyzeOnServer(const FString& FilePath, float ScaleFactor)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(UFloorPlanAnalyzer::AnalyzeOnServer);
+    const double StartSeconds = FPlatformTime::Seconds();
+
+    TArray<uint8> Settings;
+    FMemoryWriter SettingsWriter(Settings);
+    SerializeSettings(SettingsWriter);
+
+    TArray<uint8> Results;
+    bool bCacheHit = false;
+    if (!FFloorPlanAnalysisClient::Submit(AnalysisServerAddress, FilePath, ScaleFactor, Settings, AnalysisServerTimeoutSeconds, Results, bCacheHit))
+    {
+        UE_LOG(LogFloorPlan, Warning, TEXT("FloorPlanAnalyzer: Analysis server %s unavailable for %s, analyzing in-process"),
+               *AnalysisServerAddress, *FilePath);
+        return false;
+    }
+
+    ResetResults();
+    FMemoryReader ResultsReader(Results);
+    SerializeResults(ResultsReader);
+    if (ResultsReader.IsError())
+    {
+        UE_LOG(LogFloorPlan, Warning, TEXT("FloorPlanAnalyzer: Malformed results from %s, analyzing in-process"), *AnalysisServerAddress);
+        ResetResults();
+        return false;
+    }
+
+    // The profile is the server's own run; only the round trip is timed here
+    Profile.Strategy += bCacheHit ? TEXT(" (server cache)") : TEXT(" (server)");
+    UE_LOG(LogFloorPlan, Log, TEXT("FloorPlanAnalyzer: %s %s by %s in %.1f ms: %d rooms, %d openings, %d wall segments"),
+           bCacheHit ? TEXT("Served") : TEXT("Analyzed"), *FPaths::GetCleanFilename(FilePath), *AnalysisServerAddress,
+           (FPlatformTime::Seconds() - StartSeconds) * 1000.0, Result->Rooms.Num(), Result->Openings.Num(), Result->WallSegments.Num());
+    return true;
+}
+
+void UFloorPlanAnalyzer::SerializeSettings(FArchive& Ar)
+{
+    uint8 Mode = static_cast<uint8>(AnalysisMode);
+    uint8 ThresholdMethod = static_cast<uint8>(PreprocessSettings.Method);
+    Ar << Mode << StreamingStripRows << MemoryBudgetBytes << PyramidCoarseLevel << bMeasureWallThickness << bRecognizeText;
+    Ar << ThresholdMethod << PreprocessSettings.BlackThreshold << PreprocessSettings.WhiteThreshold << PreprocessSettings.WindowSize;
+    Ar << PreprocessSettings.BradleyFraction << PreprocessSettings.SauvolaK << PreprocessSettings.SauvolaRange;
+    Ar << PreprocessSettings.OpenRadius << PreprocessSettings.CloseRadius;
+    Ar << PreprocessSettings.bDeskew << PreprocessSettings.MaxSkewDegrees << PreprocessSettings.MinSkewDegrees;
+    Ar << VectorIncludeLayers << VectorExcludeLayers;
+    AnalysisMode = static_cast<EFloorPlanAnalysisMode>(Mode);
+    PreprocessSettings.Method = static_cast<EFloorPlanThresholdMethod>(ThresholdMethod);
+}
+
+void UFloorPlanAnalyzer::SerializeResults(FArchive& Ar)
+{
+    if (Ar.IsLoading())
+    {
+        // Loaded results become a new snapshot, readers of the previous one are unaffected
+        TSharedRef<FFloorPlanAnalysisResult, ESPMode::ThreadSafe> Loaded = MakeShared<FFloorPlanAnalysisResult, ESPMode::ThreadSafe>();
+        Loaded->Serialize(Ar);
+        FFloorPlanProfile::StaticStruct()->SerializeBin(Ar, &Profile);
+        Result = Loaded;
+    }
+    else
+    {
+        // Saving only reads the snapshot, the archive API just has no const overloads
+        const_cast<FFloorPlanAnalysisResult&>(*Result).Serialize(Ar);
+        FFloorPlanProfile::StaticStruct()->SerializeBin(Ar, &Profile);
+    }
+}
+
+bool UFloorPlanAnalyzer::AnalyzeFloorPlanReader(FFloorPlanStripReader& Reader, float ScaleFactor)
+{
+    ResetResults();
+    FFloorPlanStageTimer TotalTimer(&Profile.TotalMs);
+    ImageDimensions = FVector2D(Reader.GetWidth(), Reader.GetHeight());
+
+    UE_LOG(LogFloorPlan, Log, TEXT("FloorPlanAnalyzer: Analyzing %dx%d image with scale factor %.2f"),
+           Reader.GetWidth(), Reader.GetHeight(), ScaleFactor);
+
+    return AnalyzeRaster(Reader, ScaleFactor);
+}
 
-    UE_LOG(LogTemp, Log, TEXT("FloorPlanAnalyzer: Found %d rooms, %d openings, %d wall points"), 
-           RoomData.Num(), OpeningData.Num(), WallPoints.Num());
+bool UFloorPlanAnalyzer::AnalyzeFloorPlanDXF(const FString& FilePath, float ScaleFactor)
+{
+    ResetResults();
+    FFloorPlanStageTimer TotalTimer(&Profile.TotalMs);
+    ImageDimensions = FVector2D::ZeroVector;
+
+    FFloorPlanDXFSettings Settings;
+    Settings.IncludeLayers = VectorIncludeLayers;
+    Settings.ExcludeLayers = VectorExcludeLayers;
+    Settings.UnitToCm = ScaleFactor / 10.0f;
+
+    FFloorPlanDXFReader Reader(Settings);
+    FFloorPlanVectorScene Scene;
+    {
+        FLOORPLAN_SCOPE_STAGE(STAT_FloorPlanExtract, &Profile, ExtractMs);
+        if (!Reader.Read(FilePath, Scene))
+        {
+            return false;
+        }
+    }
+
+    // Drawings without units are calibrated from their dimension labels like raster scans
+    return AnalyzeVectorScene(Scene, ScaleFactor, !Reader.HasUnits());
+}
+
+bool UFloorPlanAnalyzer::AnalyzeFloorPlanVectorFile(const FString& FilePath, float ScaleFactor)
+{
+    const FString Extension = FPaths::GetExtension(FilePath);
+    if (Extension.Equals(TEXT("dxf"), ESearchCase::IgnoreCase))
+    {
+        return AnalyzeFloorPlanDXF(FilePath, ScaleFactor);
+    }
+
+    const bool bSVG = Extension.Equals(TEXT("svg"), ESearchCase::IgnoreCase);
+    if (!bSVG && !Extension.Equals(TEXT("pdf"), ESearchCase::IgnoreCase))
+    {
+        UE_LOG(LogFloorPlan, Error, TEXT("FloorPlanAnalyzer: %s is not a DXF, SVG or PDF file"), *FilePath);
+        return false;
+    }
+
+    ResetResults();
+    FFloorPlanStageTimer TotalTimer(&Profile.TotalMs);
+    ImageDimensions = FVector2D::ZeroVector;
+
+    FFloorPlanVectorReadSettings Settings;
+    Settings.IncludeLayers = VectorIncludeLayers;
+    Settings.ExcludeLayers = VectorExcludeLayers;
+    Settings.UnitToCm = ScaleFactor / 10.0f;
+
+    FFloorPlanVectorScene Scene;
+    {
+        FLOORPLAN_SCOPE_STAGE(STAT_FloorPlanExtract, &Profile, ExtractMs);
+        const bool bRead = bSVG ? FFloorPlanSVGReader(Settings).Read(FilePath, Scene) : FFloorPlanPDFReader(Settings).Read(FilePath, Scene);
+        if (!bRead)
+        {
+            return false;
+        }
+    }
+
+    // Paper units never say how large the building is, only the dimension labels do
+    return AnalyzeVectorScene(Scene, ScaleFactor, true);
+}
+
+void UFloorPlanAnalyzer::SetMorphologyRadii(int32 OpenRadius, int32 CloseRadius)
+{
+    PreprocessSettings.OpenRadius = FMath::Max(0, OpenRadius);
+    PreprocessSettings.CloseRadius = FMath::Max(0, CloseRadius);
+}
+
+void UFloorPlanAnalyzer::SetDeskew(bool bDeskew, float MaxSkewDegrees)
+{
+    PreprocessSettings.bDeskew = bDeskew;
+    PreprocessSettings.MaxSkewDegrees = FMath::Clamp(MaxSkewDegrees, 0.5f, 45.0f);
+}
+
+void UFloorPlanAnalyzer::SetVectorLayerFilter(const TArray<FString>& IncludeLayers, const TArray<FString>& ExcludeLayers)
+{
+    VectorIncludeLayers = IncludeLayers;
+    VectorExcludeLayers = ExcludeLayers;
+}
+
+bool UFloorPlanAnalyzer::AnalyzeVectorScene(const FFloorPlanVectorScene& Scene, float ScaleFactor, bool bCalibrateFromLabels)
+{
+    TArray<TArray<FString>> RoomLines;
+    {
+        FLOORPLAN_SCOPE_STAGE(STAT_FloorPlanWalls, &Profile, WallsMs);
+
+        FFloorPlanVectorAnalyzer VectorAnalyzer(Scene, FFloorPlanVectorSettings());
+        VectorAnalyzer.Run();
+        VectorAnalyzer.MoveResults(WallSegments, OpeningData, RoomData, RoomLines);
+    }
+
+    for (const FWallSegmentData& Segment : WallSegments)
+    {
+        WallPoints.Add(Segment.Start);
+        WallPoints.Add(Segment.End);
+    }
+
+    if (bRecognizeText)
+    {
+        FLOORPLAN_SCOPE_STAGE(STAT_FloorPlanText, &Profile, TextMs);
+        ApplyRoomLabels(RoomLines, ScaleFactor, bCalibrateFromLabels);
+    }
+
+    Profile.PrimitiveCount = Scene.GetNumPrimitives();
+    Profile.PeakWorkingBytes = Scene.Lines.GetAllocatedSize() + Scene.Arcs.GetAllocatedSize() + Scene.Texts.GetAllocatedSize() + Scene.Polygons.GetAllocatedSize();
+    PublishResults();
+
+    UE_LOG(LogFloorPlan, Log, TEXT("FloorPlanAnalyzer: Found %d rooms, %d openings, %d wall segments from %d vector primitives"),
+           Result->Rooms.Num(), Result->Openings.Num(), Result->WallSegments.Num(), Scene.GetNumPrimitives());
 
     return true;
 }
 
+FFloorPlanRasterPlan UFloorPlanAnalyzer::PlanRasterAnalysis(int32 Width, int32 Height) const
+{
+    using namespace FloorPlanAnalyzerPrivate;
+
+    const int64 Pixels = static_cast<int64>(Width) * Height;
+
+    // Pyramid: 1 byte mask plus a third for the coarse levels, the RGBA strip it is read through,
+    // and the float distance transform when wall thickness is measured
+    FFloorPlanRasterPlan Plan;
+    Plan.Mode = EFloorPlanAnalysisMode::Pyramid;
+    Plan.StripRows = StreamingStripRows;
+    Plan.CoarseLevel = PyramidCoarseLevel;
+    Plan.bMeasureWallThickness = bMeasureWallThickness;
+    int64 PyramidBytes = Pixels + Pixels / 3 + static_cast<int64>(Width) * StreamingStripRows * sizeof(FColor);
+    if (PreprocessSettings.IsEnabled())
+    {
+        PyramidBytes += FFloorPlanPreprocessor::EstimateWorkingBytes(Width, Height, PreprocessSettings);
+    }
+    Plan.EstimatedBytes = PyramidBytes + (bMeasureWallThickness ? Pixels * static_cast<int64>(sizeof(float)) : 0);
+
+    if (AnalysisMode == EFloorPlanAnalysisMode::Pyramid || (AnalysisMode == EFloorPlanAnalysisMode::Auto && MemoryBudgetBytes <= 0))
+    {
+        return Plan;
+    }
+
+    if (AnalysisMode == EFloorPlanAnalysisMode::Auto)
+    {
+        if (Plan.EstimatedBytes <= MemoryBudgetBytes)
+        {
+            return Plan;
+        }
+        if (PyramidBytes <= MemoryBudgetBytes)
+        {
+            Plan.bMeasureWallThickness = false;
+            Plan.EstimatedBytes = PyramidBytes;
+            return Plan;
+        }
+    }
+
+    // Streaming: one RGBA strip plus row classes, runs and label stats proportional to the width.
+    // Under a budget the strip shrinks until it fits or reaches the minimum height.
+    const int64 RowStateBytes = static_cast<int64>(Width) * StreamingRowStateBytesPerPixel;
+    const int64 StripRowBytes = static_cast<int64>(Width) * sizeof(FColor);
+    Plan.Mode = EFloorPlanAnalysisMode::Streaming;
+    Plan.bMeasureWallThickness = false;
+    Plan.StripRows = StreamingStripRows;
+    if (MemoryBudgetBytes > 0)
+    {
+        const int64 FittingRows = (MemoryBudgetBytes - RowStateBytes) / FMath::Max<int64>(1, StripRowBytes);
+        Plan.StripRows = static_cast<int32>(FMath::Clamp<int64>(FittingRows, MinStreamingStripRows, StreamingStripRows));
+    }
+    Plan.EstimatedBytes = RowStateBytes + StripRowBytes * Plan.StripRows;
+    return Plan;
+}
+
+bool UFloorPlanAnalyzer::AnalyzeRaster(FFloorPlanStripReader& Reader, float ScaleFactor)
+{
+    const FFloorPlanRasterPlan Plan = PlanRasterAnalysis(Reader.GetWidth(), Reader.GetHeight());
+
+    Profile.MemoryBudgetBytes = MemoryBudgetBytes;
+    Profile.EstimatedWorkingBytes = Plan.EstimatedBytes;
+    Profile.Strategy = Plan.Mode == EFloorPlanAnalysisMode::Pyramid
+        ? FString::Printf(TEXT("Pyramid L%d%s"), Plan.CoarseLevel, Plan.bMeasureWallThickness ? TEXT("") : TEXT(" without wall thickness"))
+        : FString::Printf(TEXT("Streaming %d rows"), Plan.StripRows);
+
+    if (MemoryBudgetBytes > 0 && Plan.EstimatedBytes > MemoryBudgetBytes)
+    {
+        UE_LOG(LogFloorPlan, Warning, TEXT("FloorPlanAnalyzer: %s needs an estimated %.2f MB, over the %.2f MB budget"),
+               *Profile.Strategy, Plan.EstimatedBytes / (1024.0 * 1024.0), MemoryBudgetBytes / (1024.0 * 1024.0));
+    }
+    else
+    {
+        UE_LOG(LogFloorPlan, Log, TEXT("FloorPlanAnalyzer: Using %s, estimated working set %.2f MB"),
+               *Profile.Strategy, Plan.EstimatedBytes / (1024.0 * 1024.0));
+    }
+
+    if (Plan.Mode == EFloorPlanAnalysisMode::Pyramid)
+    {
+        return AnalyzePyramid(Reader, ScaleFactor, Plan);
+    }
+    if (PreprocessSettings.IsEnabled())
+    {
+        UE_LOG(LogFloorPlan, Warning, TEXT("FloorPlanAnalyzer: Streaming analysis classifies strips with the global thresholds, scan preprocessing is skipped"));
+    }
+    return AnalyzeStreaming(Reader, ScaleFactor, Plan);
+}
+
+bool UFloorPlanAnalyzer::AnalyzeStreaming(FFloorPlanStripReader& Reader, float ScaleFactor, const FFloorPlanRasterPlan& Plan)
+{
+    FFloorPlanStreamingSettings Settings;
+    Settings.StripRows = Plan.StripRows;
+    Settings.ScaleFactor = ScaleFactor;
+
+    FFloorPlanStreamingAnalyzer StreamingAnalyzer(Reader.GetWidth(), Reader.GetHeight(), Settings);
+    if (!StreamingAnalyzer.Run(Reader, &Profile))
+    {
+        return false;
+    }
+
+    StreamingAnalyzer.MoveResults(RoomData, WallPoints);
+    Profile.PeakWorkingBytes = StreamingAnalyzer.GetPeakWorkingBytes();
+    PublishResults();
+
+    UE_LOG(LogFloorPlan, Log, TEXT("FloorPlanAnalyzer: Found %d rooms, %d openings, %d wall points"), 
+           Result->Rooms.Num(), Result->Openings.Num(), Result->WallPoints.Num());
+
+    return true;
+}
+
+bool UFloorPlanAnalyzer::AnalyzePyramid(FFloorPlanStripReader& Reader, float ScaleFactor, const FFloorPlanRasterPlan& Plan)
+{
+    FFloorPlanMask Mask;
+    if (PreprocessSettings.IsEnabled())
+    {
+        FFloorPlanPreprocessor Preprocessor(PreprocessSettings);
+        if (!Preprocessor.Run(Reader, Plan.StripRows, Mask, &Profile))
+        {
+            return false;
+        }
+    }
+    else if (!Mask.ReadFrom(Reader, Plan.StripRows, 50, 200, &Profile))
+    {
+        return false;
+    }
+
+    FFloorPlanPyramidSettings Settings;
+    Settings.CoarseLevel = Plan.CoarseLevel;
+    Settings.ScaleFactor = ScaleFactor;
+
+    FFloorPlanPyramidAnalyzer PyramidAnalyzer(Mask, Settings);
+    PyramidAnalyzer.Run(&Profile);
+    PyramidAnalyzer.MoveResults(RoomData, OpeningData, WallPoints);
+
+    int64 DistanceTransformBytes = 0;
+    if (Plan.bMeasureWallThickness)
+    {
+        FLOORPLAN_SCOPE_STAGE(STAT_FloorPlanWalls, &Profile, WallsMs);
+
+        FFloorPlanWallSegmentSettings SegmentSettings;
+        SegmentSettings.ScaleFactor = ScaleFactor;
+
+        FFloorPlanDistanceTransform DistanceTransform;
+        DistanceTransform.Compute(Mask);
+        DistanceTransform.ExtractWallSegments(SegmentSettings, WallSegments);
+        DistanceTransformBytes = DistanceTransform.GetAllocatedSize();
+    }
+
+    // Symbol-based openings along measured walls replace the coarse gap candidates
+    if (WallSegments.Num() > 0)
+    {
+        FLOORPLAN_SCOPE_STAGE(STAT_FloorPlanOpenings, &Profile, OpeningsMs);
+
+        FFloorPlanOpeningSettings OpeningSettings;
+        OpeningSettings.ScaleFactor = ScaleFactor;
+
+        TArray<FOpeningData> SymbolOpenings;
+        FFloorPlanOpeningDetector OpeningDetector(Mask, OpeningSettings);
+        OpeningDetector.Detect(WallSegments, SymbolOpenings);
+        OpeningData = MoveTemp(SymbolOpenings);
+    }
+
+    if (bRecognizeText)
+    {
+        FLOORPLAN_SCOPE_STAGE(STAT_FloorPlanText, &Profile, TextMs);
+        RecognizeRoomLabels(Mask, ScaleFactor);
+    }
+
+    Profile.PeakWorkingBytes = Mask.Pixels.GetAllocatedSize() + DistanceTransformBytes;
+    PublishResults();
+
+    UE_LOG(LogFloorPlan, Log, TEXT("FloorPlanAnalyzer: Found %d rooms, %d openings, %d wall points, %d wall segments"), 
+           Result->Rooms.Num(), Result->Openings.Num(), Result->WallPoints.Num(), Result->WallSegments.Num());
+
+    return true;
+}
+
+void UFloorPlanAnalyzer::ResetResults()
+{
+    RoomData.Empty();
+    OpeningData.Empty();
+    WallPoints.Empty();
+    WallSegments.Empty();
+    CalibratedScaleFactor = 0.0f;
+    Profile = FFloorPlanProfile();
+
+    // Only this analyzer lets go of the last snapshot, whoever still holds it keeps reading it
+    Result = FFloorPlanAnalysisResult::GetEmpty();
+}
+
+void UFloorPlanAnalyzer::PublishResults()
+{
+    Profile.PixelCount = static_cast<int64>(ImageDimensions.X) * static_cast<int64>(ImageDimensions.Y);
+    Profile.RoomCount = RoomData.Num();
+    Profile.WallSegmentCount = WallSegments.Num();
+    Profile.OpeningCount = OpeningData.Num();
+
+    // The working arrays are moved, not copied, and the snapshot is immutable from here on
+    TSharedRef<FFloorPlanAnalysisResult, ESPMode::ThreadSafe> Published = MakeShared<FFloorPlanAnalysisResult, ESPMode::ThreadSafe>();
+    Published->Rooms = MoveTemp(RoomData);
+    Published->Openings = MoveTemp(OpeningData);
+    Published->WallPoints = MoveTemp(WallPoints);
+    Published->WallSegments = MoveTemp(WallSegments);
+    Published->ImageDimensions = ImageDimensions;
+    Published->CalibratedScaleFactor = CalibratedScaleFactor;
+    Result = Published;
+}
+
+int32 UFloorPlanAnalyzer::FindRoomAtPoint(const FVector2D& Point)
+{
+    return GetSpatialIndex().FindRoomAt(Point);
+}
+
+TArray<int32> UFloorPlanAnalyzer::FindWallsInRadius(const FVector2D& Point, float Radius)
+{
+    TArray<int32> Walls;
+    GetSpatialIndex().FindWallsInRadius(Point, Radius, Walls);
+    return Walls;
+}
+
+TArray<int32> UFloorPlanAnalyzer::FindOpeningsInRadius(const FVector2D& Point, float Radius)
+{
+    TArray<int32> Openings;
+    GetSpatialIndex().FindOpeningsInRadius(Point, Radius, Openings);
+    return Openings;
+}
+
+int32 UFloorPlanAnalyzer::FindNearestWallToOpening(int32 OpeningIndex, float MaxDistance)
+{
+    if (!Result->Openings.IsValidIndex(OpeningIndex))
+    {
+        UE_LOG(LogFloorPlan, Warning, TEXT("FloorPlanAnalyzer: Invalid opening index %d"), OpeningIndex);
+        return INDEX_NONE;
+    }
+    return GetSpatialIndex().FindNearestWall(Result->Openings[OpeningIndex].Position, MaxDistance);
+}
+
+TArray<int32> UFloorPlanAnalyzer::GetOpeningWallAssignments(float MaxDistance)
+{
+    TArray<int32> Assignments;
+    GetSpatialIndex().AssignOpeningsToWalls(MaxDistance, Assignments);
+    return Assignments;
+}
+
+bool UFloorPlanAnalyzer::GetRoom(int32 Index, FRoomData& OutRoom) const
+{
+    return FloorPlanAnalyzerPrivate::CopyAt(Result->Rooms, Index, OutRoom);
+}
+
+bool UFloorPlanAnalyzer::GetOpening(int32 Index, FOpeningData& OutOpening) const
+{
+    return FloorPlanAnalyzerPrivate::CopyAt(Result->Openings, Index, OutOpening);
+}
+
+bool UFloorPlanAnalyzer::GetWallPoint(int32 Index, FVector2D& OutPoint) const
+{
+    if (!Result->WallPoints.IsValidIndex(Index))
+    {
+        OutPoint = FVector2D::ZeroVector;
+        return false;
+    }
+    OutPoint = Result->WallPoints[Index];
+    return true;
+}
+
+bool UFloorPlanAnalyzer::GetWallSegment(int32 Index, FWallSegmentData& OutSegment) const
+{
+    return FloorPlanAnalyzerPrivate::CopyAt(Result->WallSegments, Index, OutSegment);
+}
+
+TArray<FRoomData> UFloorPlanAnalyzer::GetRoomRange(int32 First, int32 Count) const
+{
+    return FloorPlanAnalyzerPrivate::CopyRange(Result->Rooms, First, Count);
+}
+
+TArray<FOpeningData> UFloorPlanAnalyzer::GetOpeningRange(int32 First, int32 Count) const
+{
+    return FloorPlanAnalyzerPrivate::CopyRange(Result->Openings, First, Count);
+}
+
+TArray<FVector2D> UFloorPlanAnalyzer::GetWallPointRange(int32 First, int32 Count) const
+{
+    return FloorPlanAnalyzerPrivate::CopyRange(Result->WallPoints, First, Count);
+}
+
+TArray<FWallSegmentData> UFloorPlanAnalyzer::GetWallSegmentRange(int32 First, int32 Count) const
+{
+    return FloorPlanAnalyzerPrivate::CopyRange(Result->WallSegments, First, Count);
+}
+
+bool UFloorPlanAnalyzer::GetNextOpening(bool bDoors, int32& Cursor, FOpeningData& OutOpening) const
+{
+    const int32 Index = FloorPlanAnalyzerPrivate::FindNext(Result->Openings, Cursor,
+        [bDoors](const FOpeningData& Opening) { return Opening.bIsDoor == bDoors; });
+    if (Index == INDEX_NONE)
+    {
+        Cursor = Result->Openings.Num();
+        return false;
+    }
+    OutOpening = Result->Openings[Index];
+    Cursor = Index + 1;
+    return true;
+}
+
+bool UFloorPlanAnalyzer::GetNextRoomByName(const FString& NamePattern, int32& Cursor, FRoomData& OutRoom) const
+{
+    const int32 Index = FloorPlanAnalyzerPrivate::FindNext(Result->Rooms, Cursor,
+        [&NamePattern](const FRoomData& Room) { return Room.RoomName.MatchesWildcard(NamePattern); });
+    if (Index == INDEX_NONE)
+    {
+        Cursor = Result->Rooms.Num();
+        return false;
+    }
+    OutRoom = Result->Rooms[Index];
+    Cursor = Index + 1;
+    return true;
+}
+
+TArray<int32> UFloorPlanAnalyzer::FindOpeningsOfKind(bool bDoors) const
+{
+    TArray<int32> Indices;
+    for (int32 Index = 0; Index < Result->Openings.Num(); ++Index)
+    {
+        if (Result->Openings[Index].bIsDoor == bDoors)
+        {
+            Indices.Add(Index);
+        }
+    }
+    return Indices;
+}
+
+TArray<int32> UFloorPlanAnalyzer::FindRoomsByName(const FString& NamePattern) const
+{
+    TArray<int32> Indices;
+    for (int32 Index = 0; Index < Result->Rooms.Num(); ++Index)
+    {
+        if (Result->Rooms[Index].RoomName.MatchesWildcard(NamePattern))
+        {
+            Indices.Add(Index);
+        }
+    }
+    return Indices;
+}
+
+void UFloorPlanAnalyzer::RecognizeRoomLabels(const FFloorPlanMask& Mask, float ScaleFactor)
+{
+    const float PixelToWorld = ScaleFactor / 10.0f;
+
+    TArray<FIntRect> RoomRects;
+    for (const FRoomData& Room : RoomData)
+    {
+        FBox2D Bounds(Room.BoundaryPoints);
+        RoomRects.Add(FIntRect(
+            FMath::FloorToInt(Bounds.Min.X / PixelToWorld), FMath::FloorToInt(Bounds.Min.Y / PixelToWorld),
+            FMath::CeilToInt(Bounds.Max.X / PixelToWorld), FMath::CeilToInt(Bounds.Max.Y / PixelToWorld)));
+    }
+
+    TArray<TArray<FString>> RoomLines;
+    FFloorPlanTextRecognizer Recognizer;
+    Recognizer.RecognizeRooms(Mask, RoomRects, RoomLines);
+
+    ApplyRoomLabels(RoomLines, ScaleFactor, true);
+}
+
+void UFloorPlanAnalyzer::ApplyRoomLabels(const TArray<TArray<FString>>& RoomLines, float ScaleFactor, bool bCalibrate)
+{
+    // Ratio of drawn to measured size for every room with a readable dimension string
+    TArray<float> LabelToMeasured;
+    TArray<FVector2D> LabelDimensions;
+    LabelDimensions.SetNumZeroed(RoomData.Num());
+    for (int32 RoomIndex = 0; RoomIndex < RoomData.Num() && RoomIndex < RoomLines.Num(); ++RoomIndex)
+    {
+        FRoomData& Room = RoomData[RoomIndex];
+        TArray<FString> NameParts;
+        bool bHasDimensions = false;
+
+        for (const FString& Line : RoomLines[RoomIndex])
+        {
+            float DimensionWidth = 0.0f;
+            float DimensionHeight = 0.0f;
+            if (!bHasDimensions && ParseDimensionText(Line, DimensionWidth, DimensionHeight))
+            {
+                bHasDimensions = true;
+                LabelDimensions[RoomIndex] = FVector2D(DimensionWidth, DimensionHeight);
+            }
+            else
+            {
+                NameParts.Add(Line);
+            }
+        }
+
+        if (NameParts.Num() > 0)
+        {
+            Room.RoomName = FString::Join(NameParts, TEXT(" "));
+        }
+
+        const FVector2D Measured = FBox2D(Room.BoundaryPoints).GetSize();
+        if (bHasDimensions && Measured.X > 0.0f && Measured.Y > 0.0f)
+        {
+            // Labels may list the vertical extent first, keep the pairing whose two ratios agree best
+            FVector2D& Label = LabelDimensions[RoomIndex];
+            const float Straight = FMath::Abs(Label.X / Measured.X - Label.Y / Measured.Y);
+            const float Swapped = FMath::Abs(Label.Y / Measured.X - Label.X / Measured.Y);
+            if (Swapped < Straight)
+            {
+                Label = FVector2D(Label.Y, Label.X);
+            }
+            LabelToMeasured.Add(Label.X / Measured.X);
+            LabelToMeasured.Add(Label.Y / Measured.Y);
+        }
+    }
+
+    if (LabelToMeasured.Num() == 0)
+    {
+        UE_LOG(LogFloorPlan, Log, TEXT("FloorPlanAnalyzer: No dimension strings recognized, keeping scale factor %.2f"), ScaleFactor);
+        return;
+    }
+
+    if (bCalibrate)
+    {
+        // Median is robust against a single misread label
+        LabelToMeasured.Sort();
+        const float Ratio = LabelToMeasured[LabelToMeasured.Num() / 2];
+        CalibratedScaleFactor = ScaleFactor * Ratio;
+        RescaleResults(Ratio);
+
+        UE_LOG(LogFloorPlan, Log, TEXT("FloorPlanAnalyzer: Calibrated scale factor %.2f from %d dimension strings"),
+               CalibratedScaleFactor, LabelToMeasured.Num() / 2);
+    }
+
+    // Rooms that carry a label keep the drawn dimensions rather than the measured ones
+    for (int32 RoomIndex = 0; RoomIndex < RoomData.Num(); ++RoomIndex)
+    {
+        if (!LabelDimensions[RoomIndex].IsZero())
+        {
+            RoomData[RoomIndex].Dimensions = LabelDimensions[RoomIndex];
+        }
+    }
+}
+
+void UFloorPlanAnalyzer::RescaleResults(float Factor)
+{
+    for (FRoomData& Room : RoomData)
+    {
+        for (FVector2D& Point : Room.BoundaryPoints)
+        {
+            Point *= Factor;
+        }
+        Room.Center *= Factor;
+        Room.Dimensions *= Factor;
+    }
+
+    for (FOpeningData& Opening : OpeningData)
+    {
+        Opening.Position *= Factor;
+        Opening.Size *= Factor;
+    }
+
+    for (FVector2D& Point : WallPoints)
+    {
+        Point *= Factor;
+    }
+
+    for (FWallSegmentData& Segment : WallSegments)
+    {
+        Segment.Start *= Factor;
+        Segment.End *= Factor;
+        Segment.Thickness *= Factor;
+    }
+}
+
 void UFloorPlanAnalyzer::CreateSampleRoomsFromFloorPlan(float ScaleFactor)
 {
     // Kitchen
@@ -83,7 +900,7 @@ void UFloorPlanAnalyzer::CreateSampleRoomsFromFloorPlan(float ScaleFactor)
     Dining.BoundaryPoints.Add(FVector2D(100, 450));
     RoomData.Add(Dining);
 
-    UE_LOG(LogTemp, Log, TEXT("FloorPlanAnalyzer: Created %d sample rooms"), RoomData.Num());
+    UE_LOG(LogFloorPlan, Log, TEXT("FloorPlanAnalyzer: Created %d sample rooms"), RoomData.Num());
 }
 
 void UFloorPlanAnalyzer::CreateSampleWallPoints(float ScaleFactor)
@@ -102,7 +919,7 @@ void UFloorPlanAnalyzer::CreateSampleWallPoints(float ScaleFactor)
     WallPoints.Add(FVector2D(100, 250));
     WallPoints.Add(FVector2D(500, 450));
     
-    UE_LOG(LogTemp, Log, TEXT("FloorPlanAnalyzer: Created %d wall points"), WallPoints.Num());
+    UE_LOG(LogFloorPlan, Log, TEXT("FloorPlanAnalyzer: Created %d wall points"), WallPoints.Num());
 }
 
 void UFloorPlanAnalyzer::CreateSampleOpenings(float ScaleFactor)
@@ -131,7 +948,7 @@ void UFloorPlanAnalyzer::CreateSampleOpenings(float ScaleFactor)
     BedroomWindow.Rotation = 0.0f;
     OpeningData.Add(BedroomWindow);
 
-    UE_LOG(LogTemp, Log, TEXT("FloorPlanAnalyzer: Created %d openings"), OpeningData.Num());
+    UE_LOG(LogFloorPlan, Log, TEXT("FloorPlanAnalyzer: Created %d openings"), OpeningData.Num());
 }
 
 bool UFloorPlanAnalyzer::ExtractImageData(UTexture2D* Texture, TArray<FColor>& PixelData, int32& Width, int32& Height)
@@ -147,17 +964,17 @@ bool UFloorPlanAnalyzer::ExtractImageData(UTexture2D* Texture, TArray<FColor>& P
 
 void UFloorPlanAnalyzer::DetectWalls(const TArray<FColor>& PixelData, int32 Width, int32 Height, float ScaleFactor)
 {
-    UE_LOG(LogTemp, Log, TEXT("FloorPlanAnalyzer: Wall detection simplified - using sample data"));
+    UE_LOG(LogFloorPlan, Log, TEXT("FloorPlanAnalyzer: Wall detection simplified - using sample data"));
 }
 
 void UFloorPlanAnalyzer::DetectRooms(const TArray<FColor>& PixelData, int32 Width, int32 Height, float ScaleFactor)
 {
-    UE_LOG(LogTemp, Log, TEXT("FloorPlanAnalyzer: Room detection simplified - using sample data"));
+    UE_LOG(LogFloorPlan, Log, TEXT("FloorPlanAnalyzer: Room detection simplified - using sample data"));
 }
 
 void UFloorPlanAnalyzer::DetectOpenings(const TArray<FColor>& PixelData, int32 Width, int32 Height, float ScaleFactor)
 {
-    UE_LOG(LogTemp, Log, TEXT("FloorPlanAnalyzer: Opening detection simplified - using sample data"));
+    UE_LOG(LogFloorPlan, Log, TEXT("FloorPlanAnalyzer: Opening detection simplified - using sample data"));
 }
 
 bool UFloorPlanAnalyzer::IsBlackPixel(const FColor& Pixel) const
@@ -177,10 +994,28 @@ FVector2D UFloorPlanAnalyzer::PixelToWorldCoordinates(int32 X, int32 Y, float Sc
     return FVector2D(X * ScaleFactor / 10.0f, Y * ScaleFactor / 10.0f);
 }
 
-void UFloorPlanAnalyzer::ParseDimensionText(const FString& Text, float& Width, float& Height) const
+bool UFloorPlanAnalyzer::ParseDimensionText(const FString& Text, float& Width, float& Height) const
 {
     Width = 300.0f;  // Default width in cm
     Height = 300.0f; // Default height in cm
+
+    // Explicit feet/inch dimensions such as 11'-7.5" x 10'-9", inches are optional
+    static const FRegexPattern DimensionPattern(
+        TEXT("(\\d+)\\s*'\\s*-?\\s*(?:(\\d+(?:\\.\\d+)?)\\s*\")?\\s*[xX]\\s*(\\d+)\\s*'\\s*-?\\s*(?:(\\d+(?:\\.\\d+)?)\\s*\")?"));
+    FRegexMatcher Matcher(DimensionPattern, Text);
+    if (Matcher.FindNext())
+    {
+        auto ToCentimeters = [&Matcher](int32 FeetGroup, int32 InchGroup)
+        {
+            const FString Inches = Matcher.GetCaptureGroup(InchGroup);
+            return (FCString::Atof(*Matcher.GetCaptureGroup(FeetGroup)) * 12.0f + (Inches.IsEmpty() ? 0.0f : FCString::Atof(*Inches))) * 2.54f;
+        };
+
+        Width = ToCentimeters(1, 2);
+        Height = ToCentimeters(3, 4);
+        UE_LOG(LogFloorPlan, Log, TEXT("ParseDimensionText: %s -> %.1f x %.1f cm"), *Text, Width, Height);
+        return true;
+    }
     
     // Simple parsing for known room dimensions
     if (Text.Contains(TEXT("KITCHEN")))
@@ -204,7 +1039,8 @@ void UFloorPlanAnalyzer::ParseDimensionText(const FString& Text, float& Width, f
         Height = 259.08f; // 8'-6"
     }
     
-    UE_LOG(LogTemp, Log, TEXT("ParseDimensionText: %s -> %.1f x %.1f cm"), *Text, Width, Height);
+    UE_LOG(LogFloorPlan, Log, TEXT("ParseDimensionText: %s -> %.1f x %.1f cm"), *Text, Width, Height);
+    return false;
 }
 
 FString UFloorPlanAnalyzer::ExtractRoomNameFromRegion(const TArray<FColor>& PixelData, int32 Width, int32 Height, 
@@ -0,0 +1,148 @@
+#include "FloorPlanBenchmarkCommandlet.h"
+#include "FloorPlanLog.h"
+#include "FloorPlanAnalyzer.h"
+#include "FloorPlanParallel.h"
+#include "FloorPlanStripReader.h"
+#include "FloorPlanSyntheticGenerator.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+namespace FloorPlanBenchmarkPrivate
+{
+    TArray<int32> ParseIntList(const FString& Params, const TCHAR* Key, const TArray<int32>& Default)
+    {
+        FString Value;
+        if (!FParse::Value(*Params, Key, Value, false))
+        {
+            return Default;
+        }
+
+        TArray<FString> Parts;
+        Value.ParseIntoArray(Parts, TEXT(","));
+
+        TArray<int32> Result;
+        for (const FString& Part : Parts)
+        {
+            Result.Add(FCString::Atoi(*Part));
+        }
+        return Result.Num() > 0 ? Result : Default;
+    }
+}
+
+UFloorPlanBenchmarkCommandlet::UFloorPlanBenchmarkCommandlet()
+{
+    IsClient = false;
+    IsServer = false;
+    IsEditor = true;
+    LogToConsole = true;
+}
+
+int32 UFloorPlanBenchmarkCommandlet::Main(const FString& Params)
+{
+    using namespace FloorPlanBenchmarkPrivate;
+
+    const TArray<int32> Sizes = ParseIntList(Params, TEXT("Sizes="), { 1024, 4096, 16384 });
+    const TArray<int32> RoomCounts = ParseIntList(Params, TEXT("Rooms="), { 8, 32 });
+    const TArray<int32> ThreadCounts = ParseIntList(Params, TEXT("Threads="), { 1, 2, 4, 0 });
+
+    int32 Seed = 1;
+    int32 Repeat = 1;
+    FParse::Value(*Params, TEXT("Seed="), Seed);
+    FParse::Value(*Params, TEXT("Repeat="), Repeat);
+    Repeat = FMath::Max(1, Repeat);
+
+    FString ModeName = TEXT("Pyramid");
+    FParse::Value(*Params, TEXT("Mode="), ModeName);
+    const EFloorPlanAnalysisMode Mode = ModeName.Equals(TEXT("Streaming"), ESearchCase::IgnoreCase) ? EFloorPlanAnalysisMode::Streaming : EFloorPlanAnalysisMode::Pyramid;
+    const bool bDrawText = !FParse::Param(*Params, TEXT("NoText"));
+
+    FString CsvPath = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("FloorPlanBenchmark.csv"));
+    FParse::Value(*Params, TEXT("Csv="), CsvPath);
+
+    TArray<FString> CsvLines;
+    CsvLines.Add(TEXT("Size,Rooms,Threads,Mode,TotalMs,AnalysisMs,MegapixelsPerSecond,RoomsPerSecond,Speedup,PeakWorkingBytes,")
+                 TEXT("RoomRecall,RoomPrecision,RoomNameAccuracy,OpeningRecall,OpeningPrecision,OpeningTypeAccuracy,WallThicknessError"));
+
+    const int32 PreviousMaxThreads = FFloorPlanParallel::GetMaxThreads();
+
+    for (int32 Size : Sizes)
+    {
+        for (int32 NumRooms : RoomCounts)
+        {
+            FFloorPlanSyntheticSettings Settings;
+            Settings.Width = Size;
+            Settings.Height = Size;
+            Settings.NumRooms = NumRooms;
+            Settings.Seed = Seed;
+            Settings.bDrawText = bDrawText;
+
+            const FFloorPlanSyntheticGenerator Generator(Settings);
+            const FFloorPlanGroundTruth& Truth = Generator.GetGroundTruth();
+
+            // Speedup is relative to the first thread count of the sweep
+            float BaselineMs = 0.0f;
+
+            for (int32 Threads : ThreadCounts)
+            {
+                FFloorPlanParallel::SetMaxThreads(Threads);
+
+                // Best of the repeats, generation cost included in the extract stage
+                float BestTotalMs = MAX_flt;
+                FFloorPlanProfile BestProfile;
+                FFloorPlanAccuracy Accuracy;
+                for (int32 Run = 0; Run < Repeat; ++Run)
+                {
+                    UFloorPlanAnalyzer* Analyzer = NewObject<UFloorPlanAnalyzer>();
+                    Analyzer->SetAnalysisMode(Mode);
+
+                    TUniquePtr<FFloorPlanStripReader> Reader = Generator.CreateReader();
+                    if (!Analyzer->AnalyzeFloorPlanReader(*Reader, Truth.ScaleFactor))
+                    {
+                        UE_LOG(LogFloorPlan, Error, TEXT("FloorPlanBenchmark: Analysis failed for %d px, %d rooms"), Size, NumRooms);
+                        FFloorPlanParallel::SetMaxThreads(PreviousMaxThreads);
+                        return 1;
+                    }
+
+                    const FFloorPlanProfile& Profile = Analyzer->GetProfile();
+                    if (Profile.TotalMs < BestTotalMs)
+                    {
+                        BestTotalMs = Profile.TotalMs;
+                        BestProfile = Profile;
+                        Accuracy = FFloorPlanSyntheticGenerator::Score(Truth, Analyzer->GetRoomData(), Analyzer->GetOpeningData(), Analyzer->GetWallSegments());
+                    }
+                }
+
+                const float AnalysisMs = FMath::Max(BestProfile.TotalMs - BestProfile.ExtractMs, KINDA_SMALL_NUMBER);
+                const float Megapixels = static_cast<float>(BestProfile.PixelCount) / 1.0e6f;
+                const float MegapixelsPerSecond = Megapixels / (AnalysisMs / 1000.0f);
+                const float RoomsPerSecond = BestProfile.RoomCount / (AnalysisMs / 1000.0f);
+                BaselineMs = BaselineMs > 0.0f ? BaselineMs : BestProfile.TotalMs;
+                const float Speedup = BaselineMs / FMath::Max(BestProfile.TotalMs, KINDA_SMALL_NUMBER);
+
+                UE_LOG(LogFloorPlan, Display, TEXT("FloorPlanBenchmark: %5d px %3d rooms %2d threads | %9.1f ms (analysis %9.1f ms) %7.1f MP/s %8.1f rooms/s x%.2f | rooms %.2f/%.2f names %.2f openings %.2f/%.2f types %.2f thickness err %.2f"),
+                       Size, NumRooms, Threads, BestProfile.TotalMs, AnalysisMs, MegapixelsPerSecond, RoomsPerSecond, Speedup,
+                       Accuracy.RoomRecall, Accuracy.RoomPrecision, Accuracy.RoomNameAccuracy,
+                       Accuracy.OpeningRecall, Accuracy.OpeningPrecision, Accuracy.OpeningTypeAccuracy, Accuracy.WallThicknessError);
+
+                CsvLines.Add(FString::Printf(TEXT("%d,%d,%d,%s,%.2f,%.2f,%.3f,%.2f,%.3f,%lld,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.3f"),
+                    Size, NumRooms, Threads, *ModeName, BestProfile.TotalMs, AnalysisMs, MegapixelsPerSecond, RoomsPerSecond, Speedup,
+                    BestProfile.PeakWorkingBytes, Accuracy.RoomRecall, Accuracy.RoomPrecision, Accuracy.RoomNameAccuracy,
+                    Accuracy.OpeningRecall, Accuracy.OpeningPrecision, Accuracy.OpeningTypeAccuracy, Accuracy.WallThicknessError));
+
+                // Analyzers of large plans hold sizeable arrays, release them between runs
+                CollectGarbage(RF_NoFlags);
+            }
+        }
+    }
+
+    FFloorPlanParallel::SetMaxThreads(PreviousMaxThreads);
+
+    if (!FFileHelper::SaveStringArrayToFile(CsvLines, *CsvPath))
+    {
+        UE_LOG(LogFloorPlan, Error, TEXT("FloorPlanBenchmark: Could not write %s"), *CsvPath);
+        return 1;
+    }
+
+    UE_LOG(LogFloorPlan, Display, TEXT("FloorPlanBenchmark: Wrote %d results to %s"), CsvLines.Num() - 1, *CsvPath);
+    return 0;
+}
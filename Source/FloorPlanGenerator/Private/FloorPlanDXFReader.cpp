@@ -0,0 +1,507 @@
+#include "FloorPlanDXFReader.h"
+#include "FloorPlanLog.h"
+#include "HAL/PlatformFileManager.h"
+#include "GenericPlatform/GenericPlatformFile.h"
+#include "Misc/Paths.h"
+
+namespace FloorPlanDXFReaderPrivate
+{
+    constexpr int32 ChunkBytes = 64 * 1024;
+
+    // Centimeters per unit for the $INSUNITS codes that occur in building drawings, 0 when unknown
+    float UnitsToCentimeters(int32 Units)
+    {
+        switch (Units)
+        {
+        case 1: return 2.54f;     // Inches
+        case 2: return 30.48f;    // Feet
+        case 4: return 0.1f;      // Millimeters
+        case 5: return 1.0f;      // Centimeters
+        case 6: return 100.0f;    // Meters
+        case 14: return 10.0f;    // Decimeters
+        default: return 0.0f;
+        }
+    }
+
+    // Drops MTEXT formatting codes and splits paragraphs
+    void SplitMText(const FString& Raw, TArray<FString>& OutLines)
+    {
+        FString Line;
+        for (int32 Index = 0; Index < Raw.Len(); ++Index)
+        {
+            const TCHAR Character = Raw[Index];
+            if (Character == TEXT('{') || Character == TEXT('}'))
+            {
+                continue;
+            }
+
+            if (Character == TEXT('\\') && Index + 1 < Raw.Len())
+            {
+                const TCHAR Code = Raw[++Index];
+                if (Code == TEXT('P') || Code == TEXT('p'))
+                {
+                    OutLines.Add(Line.TrimStartAndEnd());
+                    Line.Reset();
+                }
+                else if (Code == TEXT('\\') || Code == TEXT('{') || Code == TEXT('}'))
+                {
+                    Line.AppendChar(Code);
+                }
+                else if (FChar::IsAlpha(Code) && Code != TEXT('~'))
+                {
+                    // Parameterized codes such as \A1; \H2.5x; \fArial|b0; run up to the semicolon
+                    const int32 Semicolon = Raw.Find(TEXT(";"), ESearchCase::CaseSensitive, ESearchDir::FromStart, Index);
+                    if (Code != TEXT('L') && Code != TEXT('l') && Code != TEXT('O') && Code != TEXT('o') && Semicolon != INDEX_NONE)
+                    {
+                        Index = Semicolon;
+                    }
+                }
+                else
+                {
+                    Line.AppendChar(TEXT(' '));
+                }
+                continue;
+            }
+
+            Line.AppendChar(Character);
+        }
+        OutLines.Add(Line.TrimStartAndEnd());
+    }
+}
+
+void FFloorPlanDXFReader::FEntity::Reset(const FString& InType)
+{
+    Type = InType;
+    Layer.Reset();
+    Text.Reset();
+    BlockName.Reset();
+    Vertices.Reset();
+    Bulges.Reset();
+    Point = FVector2D::ZeroVector;
+    Point2 = FVector2D::ZeroVector;
+    Scale = FVector2D(1.0f, 1.0f);
+    Radius = 0.0f;
+    Height = 0.0f;
+    Angle0 = 0.0f;
+    Angle1 = 360.0f;
+    Flags = 0;
+}
+
+FFloorPlanDXFReader::FFloorPlanDXFReader(const FFloorPlanDXFSettings& InSettings)
+    : Settings(InSettings)
+{
+}
+
+bool FFloorPlanDXFReader::Read(const FString& FilePath, FFloorPlanVectorScene& OutScene)
+{
+    using namespace FloorPlanDXFReaderPrivate;
+
+    TRACE_CPUPROFILER_EVENT_SCOPE(FFloorPlanDXFReader::Read);
+
+    File.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenRead(*FilePath));
+    if (!File)
+    {
+        UE_LOG(LogFloorPlan, Error, TEXT("FloorPlanDXFReader: Could not open %s"), *FilePath);
+        return false;
+    }
+
+    Buffer.SetNumUninitialized(ChunkBytes);
+    BufferStart = 0;
+    BufferEnd = 0;
+    bEndOfFile = false;
+    bParseError = false;
+
+    Scene = &OutScene;
+    Scene->Reset();
+    Section.Reset();
+    PendingHeaderVariable.Reset();
+    Blocks.Reset();
+    CurrentBlock = nullptr;
+    UnitToCm = Settings.UnitToCm;
+    bHasUnits = false;
+
+    FEntity Entity;
+    bool bInEntity = false;
+    bool bExpectSectionName = false;
+    int32 Code = 0;
+    FString Value;
+
+    while (ReadPair(Code, Value))
+    {
+        if (Code == 0)
+        {
+            if (bInEntity)
+            {
+                FinishEntity(Entity);
+                bInEntity = false;
+            }
+
+            if (Value == TEXT("SECTION"))
+            {
+                bExpectSectionName = true;
+            }
+            else if (Value == TEXT("ENDSEC"))
+            {
+                Section.Reset();
+            }
+            else if (Value == TEXT("EOF"))
+            {
+                break;
+            }
+            else if (Value == TEXT("ENDBLK"))
+            {
+                CurrentBlock = nullptr;
+            }
+            else if (Section == TEXT("ENTITIES") || Section == TEXT("BLOCKS"))
+            {
+                Entity.Reset(Value);
+                bInEntity = true;
+            }
+            continue;
+        }
+
+        if (bExpectSectionName && Code == 2)
+        {
+            Section = Value;
+            bExpectSectionName = false;
+        }
+        else if (Section == TEXT("HEADER"))
+        {
+            if (Code == 9)
+            {
+                PendingHeaderVariable = Value;
+            }
+            else if (Code == 70 && PendingHeaderVariable == TEXT("$INSUNITS"))
+            {
+                const float HeaderUnitToCm = UnitsToCentimeters(FCString::Atoi(*Value));
+                bHasUnits = HeaderUnitToCm > 0.0f;
+                UnitToCm = bHasUnits ? HeaderUnitToCm : Settings.UnitToCm;
+            }
+        }
+        else if (bInEntity)
+        {
+            ApplyGroup(Entity, Code, Value);
+        }
+    }
+
+    if (bInEntity)
+    {
+        FinishEntity(Entity);
+    }
+
+    File.Reset();
+    Buffer.Empty();
+    Blocks.Empty();
+
+    if (bParseError)
+    {
+        UE_LOG(LogFloorPlan, Error, TEXT("FloorPlanDXFReader: %s is not a readable ASCII DXF"), *FPaths::GetCleanFilename(FilePath));
+        Scene = nullptr;
+        return false;
+    }
+
+    Scene->NormalizeToOrigin(true);
+
+    UE_LOG(LogFloorPlan, Log, TEXT("FloorPlanDXFReader: %s -> %d lines, %d arcs, %d texts, %d polygons on %d layers, %.3f cm/unit%s"),
+           *FPaths::GetCleanFilename(FilePath), Scene->Lines.Num(), Scene->Arcs.Num(), Scene->Texts.Num(), Scene->Polygons.Num(),
+           Scene->Layers.Num(), UnitToCm, bHasUnits ? TEXT("") : TEXT(" (no $INSUNITS)"));
+
+    Scene = nullptr;
+    return true;
+}
+
+bool FFloorPlanDXFReader::ReadLine(FString& OutLine)
+{
+    while (true)
+    {
+        for (int32 Index = BufferStart; Index < BufferEnd; ++Index)
+        {
+            if (Buffer[Index] == '\n')
+            {
+                OutLine.Reset();
+                OutLine.AppendChars(Buffer.GetData() + BufferStart, Index - BufferStart);
+                OutLine.TrimStartAndEndInline();
+                BufferStart = Index + 1;
+                return true;
+            }
+        }
+
+        if (bEndOfFile)
+        {
+            if (BufferStart >= BufferEnd)
+            {
+                return false;
+            }
+
+            // Last line without a terminator
+            OutLine.Reset();
+            OutLine.AppendChars(Buffer.GetData() + BufferStart, BufferEnd - BufferStart);
+            OutLine.TrimStartAndEndInline();
+            BufferStart = BufferEnd;
+            return true;
+        }
+
+        // Keep the partial line, then refill behind it
+        const int32 Remaining = BufferEnd - BufferStart;
+        if (BufferStart > 0)
+        {
+            FMemory::Memmove(Buffer.GetData(), Buffer.GetData() + BufferStart, Remaining);
+        }
+        BufferStart = 0;
+        BufferEnd = Remaining;
+        if (BufferEnd == Buffer.Num())
+        {
+            Buffer.SetNumUninitialized(Buffer.Num() * 2);
+        }
+
+        const int64 FileRemaining = File->Size() - File->Tell();
+        const int32 BytesToRead = static_cast<int32>(FMath::Min<int64>(Buffer.Num() - BufferEnd, FileRemaining));
+        if (BytesToRead <= 0 || !File->Read(reinterpret_cast<uint8*>(Buffer.GetData() + BufferEnd), BytesToRead))
+        {
+            bEndOfFile = true;
+            continue;
+        }
+        BufferEnd += BytesToRead;
+    }
+}
+
+bool FFloorPlanDXFReader::ReadPair(int32& OutCode, FString& OutValue)
+{
+    if (!ReadLine(CodeLine))
+    {
+        return false;
+    }
+
+    if (!ReadLine(OutValue))
+    {
+        UE_LOG(LogFloorPlan, Error, TEXT("FloorPlanDXFReader: Group code '%s' has no value, file is truncated"), *CodeLine.Left(32));
+        bParseError = true;
+        return false;
+    }
+
+    if (!CodeLine.IsNumeric())
+    {
+        UE_LOG(LogFloorPlan, Error, TEXT("FloorPlanDXFReader: Unexpected group code '%s', only ASCII DXF is supported"), *CodeLine.Left(32));
+        bParseError = true;
+        return false;
+    }
+
+    OutCode = FCString::Atoi(*CodeLine);
+    return true;
+}
+
+void FFloorPlanDXFReader::ApplyGroup(FEntity& Entity, int32 Code, const FString& Value) const
+{
+    const bool bPolyline = Entity.Type == TEXT("LWPOLYLINE");
+    switch (Code)
+    {
+    case 1:
+    case 3:
+        // MTEXT splits long strings into 250 character chunks, group 1 carries the last one
+        Entity.Text += Value;
+        break;
+    case 2:
+        Entity.BlockName = Value;
+        break;
+    case 8:
+        Entity.Layer = Value;
+        break;
+    case 10:
+        if (bPolyline)
+        {
+            Entity.Vertices.Add(FVector2D(FCString::Atof(*Value), 0.0f));
+            Entity.Bulges.Add(0.0f);
+        }
+        else
+        {
+            Entity.Point.X = FCString::Atof(*Value);
+        }
+        break;
+    case 20:
+        if (bPolyline && Entity.Vertices.Num() > 0)
+        {
+            Entity.Vertices.Last().Y = FCString::Atof(*Value);
+        }
+        else
+        {
+            Entity.Point.Y = FCString::Atof(*Value);
+        }
+        break;
+    case 11:
+        Entity.Point2.X = FCString::Atof(*Value);
+        break;
+    case 21:
+        Entity.Point2.Y = FCString::Atof(*Value);
+        break;
+    case 40:
+        Entity.Radius = FCString::Atof(*Value);
+        Entity.Height = Entity.Radius;
+        break;
+    case 41:
+        Entity.Scale.X = FCString::Atof(*Value);
+        break;
+    case 42:
+        if (bPolyline)
+        {
+            if (Entity.Bulges.Num() > 0)
+            {
+                Entity.Bulges.Last() = FCString::Atof(*Value);
+            }
+        }
+        else
+        {
+            Entity.Scale.Y = FCString::Atof(*Value);
+        }
+        break;
+    case 50:
+        Entity.Angle0 = FCString::Atof(*Value);
+        break;
+    case 51:
+        Entity.Angle1 = FCString::Atof(*Value);
+        break;
+    case 70:
+        Entity.Flags = FCString::Atoi(*Value);
+        break;
+    default:
+        break;
+    }
+}
+
+void FFloorPlanDXFReader::FinishEntity(FEntity& Entity)
+{
+    if (Entity.Type == TEXT("BLOCK"))
+    {
+        CurrentBlock = &Blocks.Add(Entity.BlockName);
+        CurrentBlock->Base = Entity.Point;
+        return;
+    }
+
+    static const TCHAR* SupportedTypes[] = {
+        TEXT("LINE"), TEXT("LWPOLYLINE"), TEXT("ARC"), TEXT("CIRCLE"), TEXT("TEXT"), TEXT("MTEXT"), TEXT("INSERT")
+    };
+    bool bSupported = false;
+    for (const TCHAR* Type : SupportedTypes)
+    {
+        bSupported |= Entity.Type == Type;
+    }
+    if (!bSupported)
+    {
+        return;
+    }
+
+    if (CurrentBlock)
+    {
+        CurrentBlock->Entities.Add(Entity);
+    }
+    else if (Section == TEXT("ENTITIES"))
+    {
+        Emit(Entity, FFloorPlanVectorTransform(), FString(), 0);
+    }
+}
+
+void FFloorPlanDXFReader::Emit(const FEntity& Entity, const FFloorPlanVectorTransform& Transform, const FString& ParentLayer, int32 Depth)
+{
+    using namespace FloorPlanDXFReaderPrivate;
+
+    // Block content on layer 0 takes the layer of the INSERT that places it
+    const FString& LayerName = (Entity.Layer.IsEmpty() || Entity.Layer == TEXT("0")) && !ParentLayer.IsEmpty() ? ParentLayer : Entity.Layer;
+
+    const int32 Layer = Scene->FindOrAddFilteredLayer(LayerName, Settings);
+    if (Layer == INDEX_NONE)
+    {
+        return;
+    }
+
+    auto ToPlan = [this, &Transform](const FVector2D& Point)
+    {
+        return Transform.Apply(Point) * UnitToCm;
+    };
+    const float LengthScale = FMath::Sqrt(FMath::Abs(Transform.GetDeterminant())) * UnitToCm;
+    const bool bMirrored = Transform.GetDeterminant() < 0.0f;
+
+    if (Entity.Type == TEXT("LINE"))
+    {
+        Scene->AddLine(ToPlan(Entity.Point), ToPlan(Entity.Point2), Layer);
+    }
+    else if (Entity.Type == TEXT("LWPOLYLINE"))
+    {
+        const int32 NumVertices = Entity.Vertices.Num();
+        const bool bClosed = (Entity.Flags & 1) != 0;
+        const int32 NumEdges = bClosed ? NumVertices : NumVertices - 1;
+        bool bStraight = true;
+        for (int32 Edge = 0; Edge < NumEdges; ++Edge)
+        {
+            const float Bulge = bMirrored ? -Entity.Bulges[Edge] : Entity.Bulges[Edge];
+            Scene->AddBulgeSegment(ToPlan(Entity.Vertices[Edge]), ToPlan(Entity.Vertices[(Edge + 1) % NumVertices]), Bulge, Layer);
+            bStraight &= FMath::Abs(Bulge) < 1.0e-4f;
+        }
+
+        // Straight closed outlines are kept whole as room and area candidates
+        if (bClosed && bStraight && NumVertices >= 3)
+        {
+            TArray<FVector2D> Points;
+            Points.Reserve(NumVertices);
+            for (const FVector2D& Vertex : Entity.Vertices)
+            {
+                Points.Add(ToPlan(Vertex));
+            }
+            Scene->AddPolygon(MoveTemp(Points), Layer);
+        }
+    }
+    else if (Entity.Type == TEXT("ARC") || Entity.Type == TEXT("CIRCLE"))
+    {
+        const bool bCircle = Entity.Type == TEXT("CIRCLE");
+        const float Start = bCircle ? 0.0f : Entity.Angle0;
+        const float End = bCircle ? 360.0f : Entity.Angle1;
+        float Sweep = FMath::Fmod(End - Start, 360.0f);
+        Sweep = Sweep <= 0.0f ? Sweep + 360.0f : Sweep;
+
+        // A mirrored counter-clockwise arc runs clockwise, so it starts from the mapped end angle instead
+        const float PlanStart = Transform.ApplyAngle(bMirrored ? Start + Sweep : Start);
+        Scene->AddArc(ToPlan(Entity.Point), Entity.Radius * LengthScale, PlanStart, Sweep, Layer);
+    }
+    else if (Entity.Type == TEXT("TEXT"))
+    {
+        Scene->AddText(ToPlan(Entity.Point), Entity.Height * LengthScale, Entity.Text.TrimStartAndEnd(), Layer);
+    }
+    else if (Entity.Type == TEXT("MTEXT"))
+    {
+        // Paragraphs stack downward in drawing space from the insertion point
+        TArray<FString> Lines;
+        SplitMText(Entity.Text, Lines);
+        for (int32 LineIndex = 0; LineIndex < Lines.Num(); ++LineIndex)
+        {
+            const FVector2D Offset(0.0f, -Entity.Height * 1.5f * LineIndex);
+            Scene->AddText(ToPlan(Entity.Point + Offset), Entity.Height * LengthScale, Lines[LineIndex], Layer);
+        }
+    }
+    else if (Entity.Type == TEXT("INSERT"))
+    {
+        const FBlock* Block = Blocks.Find(Entity.BlockName);
+        if (!Block)
+        {
+            UE_LOG(LogFloorPlan, Verbose, TEXT("FloorPlanDXFReader: INSERT of unknown block %s"), *Entity.BlockName);
+            return;
+        }
+
+        if (Depth >= Settings.MaxBlockDepth)
+        {
+            UE_LOG(LogFloorPlan, Warning, TEXT("FloorPlanDXFReader: Block %s nested deeper than %d, skipped"), *Entity.BlockName, Settings.MaxBlockDepth);
+            return;
+        }
+
+        // Block space -> insert space: move the base point to the origin, scale, rotate, then place
+        const float Rotation = FMath::DegreesToRadians(Entity.Angle0);
+        const FVector2D Direction(FMath::Cos(Rotation), FMath::Sin(Rotation));
+        FFloorPlanVectorTransform Local;
+        Local.AxisX = Direction * Entity.Scale.X;
+        Local.AxisY = FVector2D(-Direction.Y, Direction.X) * Entity.Scale.Y;
+        Local.Translation = Entity.Point - (Local.AxisX * Block->Base.X + Local.AxisY * Block->Base.Y);
+
+        const FFloorPlanVectorTransform Combined = Local.Then(Transform);
+        for (const FEntity& Child : Block->Entities)
+        {
+            Emit(Child, Combined, LayerName, Depth + 1);
+        }
+    }
+}
@@ -0,0 +1,238 @@
+#include "FloorPlanDistanceTransform.h"
+#include "FloorPlanLog.h"
+#include "FloorPlanMask.h"
+#include "FloorPlanParallel.h"
+
+namespace FloorPlanDistanceTransformPrivate
+{
+    constexpr float Infinity = 1e20f;
+
+    // Splits NumLines into a few chunks per worker so each chunk reuses its scratch buffers
+    template <typename FunctionType>
+    void ParallelForLines(int32 NumLines, FunctionType Function)
+    {
+        const int32 NumChunks = FMath::Clamp(FFloorPlanParallel::GetNumWorkers() * 4, 1, FMath::Max(1, NumLines));
+        FFloorPlanParallel::For(NumChunks, [&](int32 Chunk)
+        {
+            const int32 First = static_cast<int32>(static_cast<int64>(NumLines) * Chunk / NumChunks);
+            const int32 Last = static_cast<int32>(static_cast<int64>(NumLines) * (Chunk + 1) / NumChunks);
+            Function(First, Last);
+        });
+    }
+}
+
+void FFloorPlanDistanceTransform::Compute(const FFloorPlanMask& Mask)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(FFloorPlanDistanceTransform::Compute);
+
+    using namespace FloorPlanDistanceTransformPrivate;
+
+    Width = Mask.Width;
+    Height = Mask.Height;
+    SquaredDistance.SetNumUninitialized(Mask.Pixels.Num());
+
+    // Non-wall pixels are the features the distance is measured to
+    for (int64 Index = 0; Index < Mask.Pixels.Num(); ++Index)
+    {
+        SquaredDistance[Index] = Mask.Pixels[Index] == FFloorPlanMask::Wall ? Infinity : 0.0f;
+    }
+
+    float* Data = SquaredDistance.GetData();
+
+    // Columns first, then rows over the column result
+    ParallelForLines(Width, [this, Data](int32 First, int32 Last)
+    {
+        TArray<float> Scratch;
+        TArray<int32> Vertices;
+        TArray<float> Boundaries;
+        for (int32 X = First; X < Last; ++X)
+        {
+            Transform1D(Data + X, Height, Width, Scratch, Vertices, Boundaries);
+        }
+    });
+
+    ParallelForLines(Height, [this, Data](int32 First, int32 Last)
+    {
+        TArray<float> Scratch;
+        TArray<int32> Vertices;
+        TArray<float> Boundaries;
+        for (int32 Y = First; Y < Last; ++Y)
+        {
+            Transform1D(Data + static_cast<int64>(Y) * Width, Width, 1, Scratch, Vertices, Boundaries);
+        }
+    });
+}
+
+void FFloorPlanDistanceTransform::Transform1D(float* Values, int32 Count, int64 Stride, TArray<float>& Scratch, TArray<int32>& Vertices, TArray<float>& Boundaries)
+{
+    using namespace FloorPlanDistanceTransformPrivate;
+
+    if (Count <= 0)
+    {
+        return;
+    }
+
+    Scratch.SetNumUninitialized(Count);
+    Vertices.SetNumUninitialized(Count);
+    Boundaries.SetNumUninitialized(Count + 1);
+
+    for (int32 Q = 0; Q < Count; ++Q)
+    {
+        Scratch[Q] = Values[Q * Stride];
+    }
+
+    // Lower envelope of the parabolas rooted at each sample
+    int32 K = 0;
+    Vertices[0] = 0;
+    Boundaries[0] = -Infinity;
+    Boundaries[1] = Infinity;
+    for (int32 Q = 1; Q < Count; ++Q)
+    {
+        // Boundaries[0] is -infinity, so K never drops below zero
+        float Intersection = ((Scratch[Q] + static_cast<float>(Q) * Q) - (Scratch[Vertices[K]] + static_cast<float>(Vertices[K]) * Vertices[K])) / (2.0f * (Q - Vertices[K]));
+        while (Intersection <= Boundaries[K])
+        {
+            --K;
+            Intersection = ((Scratch[Q] + static_cast<float>(Q) * Q) - (Scratch[Vertices[K]] + static_cast<float>(Vertices[K]) * Vertices[K])) / (2.0f * (Q - Vertices[K]));
+        }
+
+        ++K;
+        Vertices[K] = Q;
+        Boundaries[K] = Intersection;
+        Boundaries[K + 1] = Infinity;
+    }
+
+    // Sample the envelope
+    K = 0;
+    for (int32 Q = 0; Q < Count; ++Q)
+    {
+        while (Boundaries[K + 1] < Q)
+        {
+            ++K;
+        }
+        const float Offset = static_cast<float>(Q - Vertices[K]);
+        Values[Q * Stride] = Offset * Offset + Scratch[Vertices[K]];
+    }
+}
+
+void FFloorPlanDistanceTransform::ExtractWallSegments(const FFloorPlanWallSegmentSettings& Settings, TArray<FWallSegmentData>& OutSegments) const
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(FFloorPlanDistanceTransform::ExtractWallSegments);
+
+    OutSegments.Reset();
+    if (SquaredDistance.Num() == 0)
+    {
+        return;
+    }
+
+    ExtractRidges(true, Settings, OutSegments);
+    ExtractRidges(false, Settings, OutSegments);
+}
+
+void FFloorPlanDistanceTransform::ExtractRidges(bool bHorizontalWalls, const FFloorPlanWallSegmentSettings& Settings, TArray<FWallSegmentData>& OutSegments) const
+{
+    using namespace FloorPlanDistanceTransformPrivate;
+
+    // Horizontal walls are traced along rows with the ridge test across them, vertical walls the other way round
+    const int32 NumLines = bHorizontalWalls ? Height : Width;
+    const int32 LineLength = bHorizontalWalls ? Width : Height;
+    const float PixelToWorld = Settings.ScaleFactor / 10.0f;
+
+    auto DistanceAt = [this, bHorizontalWalls](int32 Along, int32 Line) -> float
+    {
+        const int32 X = bHorizontalWalls ? Along : Line;
+        const int32 Y = bHorizontalWalls ? Line : Along;
+        if (X < 0 || X >= Width || Y < 0 || Y >= Height)
+        {
+            return 0.0f;
+        }
+        return SquaredDistance[static_cast<int64>(Y) * Width + X];
+    };
+
+    // One bucket per line keeps the output order independent of the chunk scheduling
+    TArray<TArray<FWallSegmentData>> LineSegments;
+    LineSegments.SetNum(NumLines);
+
+    ParallelForLines(NumLines, [&](int32 First, int32 Last)
+    {
+        TArray<float> RunThickness;
+
+        for (int32 Line = First; Line < Last; ++Line)
+        {
+            TArray<FWallSegmentData>& LocalSegments = LineSegments[Line];
+            int32 RunStart = INDEX_NONE;
+            bool bEvenThickness = false;
+
+            auto FlushRun = [&](int32 RunEnd)
+            {
+                if (RunStart == INDEX_NONE)
+                {
+                    return;
+                }
+
+                const int32 RunLength = RunEnd - RunStart + 1;
+                if (RunLength >= Settings.MinSegmentPixels)
+                {
+                    RunThickness.Sort();
+                    const float ThicknessPixels = RunThickness[RunThickness.Num() / 2];
+
+                    // The ridge stops about half a thickness before the wall ends
+                    const float HalfThickness = ThicknessPixels * 0.5f;
+                    const float Across = Line + (bEvenThickness ? 0.5f : 0.0f);
+                    const float AlongStart = RunStart - HalfThickness + 0.5f;
+                    const float AlongEnd = RunEnd + HalfThickness - 0.5f;
+
+                    FWallSegmentData Segment;
+                    Segment.Start = bHorizontalWalls ? FVector2D(AlongStart, Across) : FVector2D(Across, AlongStart);
+                    Segment.End = bHorizontalWalls ? FVector2D(AlongEnd, Across) : FVector2D(Across, AlongEnd);
+                    Segment.Start *= PixelToWorld;
+                    Segment.End *= PixelToWorld;
+                    Segment.Thickness = ThicknessPixels * PixelToWorld;
+                    LocalSegments.Add(Segment);
+                }
+
+                RunStart = INDEX_NONE;
+                RunThickness.Reset();
+            };
+
+            for (int32 Along = 0; Along < LineLength; ++Along)
+            {
+                const float Distance = DistanceAt(Along, Line);
+                const float Before = DistanceAt(Along, Line - 1);
+                const float After = DistanceAt(Along, Line + 1);
+
+                // Strict on one side so even thicknesses produce a single ridge line
+                const bool bRidge = Distance > 0.0f && Distance < Infinity && Distance > Before && Distance >= After;
+                float ThicknessPixels = 0.0f;
+                if (bRidge)
+                {
+                    const bool bEven = After == Distance;
+                    ThicknessPixels = bEven ? 2.0f * FMath::Sqrt(Distance) : 2.0f * FMath::Sqrt(Distance) - 1.0f;
+                    if (RunStart != INDEX_NONE && bEven != bEvenThickness)
+                    {
+                        FlushRun(Along - 1);
+                    }
+                    bEvenThickness = bEven;
+                }
+
+                if (!bRidge || ThicknessPixels > Settings.MaxThicknessPixels)
+                {
+                    FlushRun(Along - 1);
+                    continue;
+                }
+
+                if (RunStart == INDEX_NONE)
+                {
+                    RunStart = Along;
+                }
+                RunThickness.Add(ThicknessPixels);
+            }
+            FlushRun(LineLength - 1);
+        }
+    });
+
+    for (TArray<FWallSegmentData>& Segments : LineSegments)
+    {
+        OutSegments.Append(MoveTemp(Segments));
+    }
+}
@@ -0,0 +1,102 @@
+#include "FloorPlanExportCommandlet.h"
+#include "FloorPlanLog.h"
+#include "FloorPlanAnalyzer.h"
+#include "StructureBuilder.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+
+UFloorPlanExportCommandlet::UFloorPlanExportCommandlet()
+{
+    IsClient = false;
+    IsServer = false;
+    IsEditor = true;
+    LogToConsole = true;
+}
+
+int32 UFloorPlanExportCommandlet::Main(const FString& Params)
+{
+    FString Input;
+    if (!FParse::Value(*Params, TEXT("Input="), Input, false))
+    {
+        UE_LOG(LogFloorPlan, Error, TEXT("FloorPlanExport: Missing -Input=<file or directory>"));
+        return 1;
+    }
+
+    FString Output = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("FloorPlanExport"));
+    FParse::Value(*Params, TEXT("Output="), Output, false);
+
+    float ScaleFactor = 1.0f;
+    float WallHeight = 300.0f;
+    FParse::Value(*Params, TEXT("Scale="), ScaleFactor);
+    FParse::Value(*Params, TEXT("WallHeight="), WallHeight);
+
+    FString ModeName = TEXT("Pyramid");
+    FParse::Value(*Params, TEXT("Mode="), ModeName);
+    const EFloorPlanAnalysisMode Mode = ModeName.Equals(TEXT("Streaming"), ESearchCase::IgnoreCase) ? EFloorPlanAnalysisMode::Streaming : EFloorPlanAnalysisMode::Pyramid;
+    const bool bQuantize = !FParse::Param(*Params, TEXT("NoQuantize"));
+
+    TArray<FString> Files;
+    const bool bInputDirectory = IFileManager::Get().DirectoryExists(*Input);
+    if (bInputDirectory)
+    {
+        for (const TCHAR* Extension : { TEXT("png"), TEXT("tif"), TEXT("tiff"), TEXT("dxf"), TEXT("svg"), TEXT("pdf") })
+        {
+            TArray<FString> Found;
+            IFileManager::Get().FindFilesRecursive(Found, *Input, *FString::Printf(TEXT("*.%s"), Extension), true, false);
+            Files.Append(Found);
+        }
+        Files.Sort();
+    }
+    else
+    {
+        Files.Add(Input);
+    }
+
+    IFileManager::Get().MakeDirectory(*Output, true);
+
+    // One analyzer and builder for the whole batch, every analysis resets the previous results
+    UFloorPlanAnalyzer* Analyzer = NewObject<UFloorPlanAnalyzer>();
+    Analyzer->SetAnalysisMode(Mode);
+    UStructureBuilder* Builder = NewObject<UStructureBuilder>();
+    Builder->SetWallHeight(WallHeight);
+
+    // Outputs mirror the input tree, and plans sharing a base name keep their extension apart
+    const FString InputRoot = FPaths::ConvertRelativePathToFull(Input) / TEXT("");
+    TSet<FString> UsedPaths;
+
+    int32 NumFailed = 0;
+    const double StartSeconds = FPlatformTime::Seconds();
+    for (const FString& File : Files)
+    {
+        FString OutputDir = Output;
+        if (bInputDirectory)
+        {
+            FString RelativeDir = FPaths::GetPath(FPaths::ConvertRelativePathToFull(File));
+            FPaths::MakePathRelativeTo(RelativeDir, *InputRoot);
+            OutputDir = FPaths::Combine(Output, RelativeDir);
+            IFileManager::Get().MakeDirectory(*OutputDir, true);
+        }
+
+        FString GlbPath = FPaths::Combine(OutputDir, FPaths::GetBaseFilename(File) + TEXT(".glb"));
+        if (UsedPaths.Contains(GlbPath))
+        {
+            GlbPath = FPaths::Combine(OutputDir, FPaths::GetBaseFilename(File) + TEXT("_") + FPaths::GetExtension(File) + TEXT(".glb"));
+        }
+        UsedPaths.Add(GlbPath);
+
+        if (!Analyzer->AnalyzeFloorPlanFile(File, ScaleFactor) || !Builder->ExportGLB(Analyzer, GlbPath, bQuantize))
+        {
+            UE_LOG(LogFloorPlan, Warning, TEXT("FloorPlanExport: Failed to convert %s"), *File);
+            ++NumFailed;
+            continue;
+        }
+
+        const FFloorPlanProfile& Profile = Builder->GetProfile();
+        UE_LOG(LogFloorPlan, Display, TEXT("FloorPlanExport: %s -> %s | analysis %.1f ms, export %.1f ms, %lld triangles"),
+               *File, *GlbPath, Analyzer->GetProfile().TotalMs, Profile.TotalMs, Profile.TriangleCount);
+    }
+
+    UE_LOG(LogFloorPlan, Display, TEXT("FloorPlanExport: Converted %d of %d plans in %.1f s"),
+           Files.Num() - NumFailed, Files.Num(), FPlatformTime::Seconds() - StartSeconds);
+    return NumFailed > 0 ? 1 : 0;
+}
@@ -0,0 +1,315 @@
+#include "FloorPlanGLBExporter.h"
+#include "FloorPlanLog.h"
+#include "FloorPlanMeshBuffers.h"
+#include "Misc/FileHelper.h"
+
+namespace FloorPlanGLBExporterPrivate
+{
+    // glTF enums
+    constexpr int32 ComponentByte = 5120;
+    constexpr int32 ComponentUnsignedShort = 5123;
+    constexpr int32 ComponentUnsignedInt = 5125;
+    constexpr int32 ComponentFloat = 5126;
+    constexpr int32 TargetArrayBuffer = 34962;
+    constexpr int32 TargetElementArrayBuffer = 34963;
+
+    // Centimeters, Z up, left-handed to meters, Y up, right-handed; swapping two axes flips handedness
+    FVector3f ToGLTF(const FVector3f& Position, float Scale)
+    {
+        return FVector3f(Position.X, Position.Z, Position.Y) * Scale;
+    }
+
+    FString Number(float Value)
+    {
+        return FString::Printf(TEXT("%.7g"), Value);
+    }
+
+    FString Vector(const FVector3f& Value)
+    {
+        return FString::Printf(TEXT("[%s,%s,%s]"), *Number(Value.X), *Number(Value.Y), *Number(Value.Z));
+    }
+
+    FString Escape(const FString& Text)
+    {
+        FString Result;
+        for (TCHAR Character : Text)
+        {
+            if (Character == TEXT('"') || Character == TEXT('\\'))
+            {
+                Result.AppendChar(TEXT('\\'));
+                Result.AppendChar(Character);
+            }
+            else if (Character < 32)
+            {
+                Result += FString::Printf(TEXT("\\u%04x"), static_cast<int32>(Character));
+            }
+            else
+            {
+                Result.AppendChar(Character);
+            }
+        }
+        return Result;
+    }
+
+    template <typename T>
+    void WriteAt(TArray<uint8>& Bytes, int64 Offset, const T& Value)
+    {
+        FMemory::Memcpy(Bytes.GetData() + Offset, &Value, sizeof(T));
+    }
+
+    void PadTo4(TArray<uint8>& Bytes, uint8 Fill)
+    {
+        while (Bytes.Num() % 4 != 0)
+        {
+            Bytes.Add(Fill);
+        }
+    }
+}
+
+bool FFloorPlanGLBExporter::Write(const FFloorPlanMeshBuffers& Buffers, const FString& FilePath, const FFloorPlanGLBSettings& Settings)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(FFloorPlanGLBExporter::Write);
+
+    TArray<uint8> Bytes;
+    if (!Serialize(Buffers, Settings, Bytes))
+    {
+        return false;
+    }
+
+    if (!FFileHelper::SaveArrayToFile(Bytes, *FilePath))
+    {
+        UE_LOG(LogFloorPlan, Error, TEXT("FloorPlanGLBExporter: Could not write %s"), *FilePath);
+        return false;
+    }
+
+    UE_LOG(LogFloorPlan, Log, TEXT("FloorPlanGLBExporter: Wrote %s (%d vertices, %lld triangles, %d sections, %d bytes)"),
+           *FilePath, Buffers.GetNumVertices(), Buffers.GetNumTriangles(), Buffers.Sections.Num(), Bytes.Num());
+    return true;
+}
+
+bool FFloorPlanGLBExporter::Serialize(const FFloorPlanMeshBuffers& Buffers, const FFloorPlanGLBSettings& Settings, TArray<uint8>& OutBytes)
+{
+    using namespace FloorPlanGLBExporterPrivate;
+
+    OutBytes.Reset();
+    const int32 NumVertices = Buffers.GetNumVertices();
+    if (NumVertices == 0 || Buffers.GetNumTriangles() == 0)
+    {
+        UE_LOG(LogFloorPlan, Error, TEXT("FloorPlanGLBExporter: No geometry to export"));
+        return false;
+    }
+
+    FBox3f Bounds(ForceInit);
+    for (const FVector3f& Position : Buffers.Positions)
+    {
+        Bounds += ToGLTF(Position, 0.01f);
+    }
+
+    bool bUVsNormalized = true;
+    for (const FVector2f& UV : Buffers.UVs)
+    {
+        bUVsNormalized &= UV.X >= 0.0f && UV.X <= 1.0f && UV.Y >= 0.0f && UV.Y <= 1.0f;
+    }
+
+    // Interleaved layout, every attribute starts on a 4-byte boundary as glTF requires
+    const bool bQuantize = Settings.bQuantize;
+    const bool bQuantizeUVs = bQuantize && bUVsNormalized;
+    const int32 NormalOffset = bQuantize ? 8 : 12;
+    const int32 UVOffset = bQuantize ? 12 : 24;
+    const int32 Stride = UVOffset + (bQuantizeUVs ? 4 : 8);
+
+    // Quantized positions are unsigned offsets from the minimum corner, the node transform maps them back
+    const FVector3f Extent(FMath::Max(Bounds.Max.X - Bounds.Min.X, UE_KINDA_SMALL_NUMBER),
+                           FMath::Max(Bounds.Max.Y - Bounds.Min.Y, UE_KINDA_SMALL_NUMBER),
+                           FMath::Max(Bounds.Max.Z - Bounds.Min.Z, UE_KINDA_SMALL_NUMBER));
+    const FVector3f QuantizeScale = FVector3f(65535.0f) / Extent;
+
+    TArray<uint8> Binary;
+    Binary.SetNumZeroed(static_cast<int64>(NumVertices) * Stride);
+    TArray<FIntVector> QuantizedPositions;
+    TArray<FVector3f> GLTFPositions;
+    QuantizedPositions.SetNumUninitialized(bQuantize ? NumVertices : 0);
+    GLTFPositions.SetNumUninitialized(NumVertices);
+
+    for (int32 Vertex = 0; Vertex < NumVertices; ++Vertex)
+    {
+        const int64 Base = static_cast<int64>(Vertex) * Stride;
+        const FVector3f Position = ToGLTF(Buffers.Positions[Vertex], 0.01f);
+        const FVector3f Normal = ToGLTF(Buffers.Normals.IsValidIndex(Vertex) ? Buffers.Normals[Vertex] : FVector3f::UpVector, 1.0f).GetSafeNormal();
+        const FVector2f UV = Buffers.UVs.IsValidIndex(Vertex) ? Buffers.UVs[Vertex] : FVector2f::ZeroVector;
+        GLTFPositions[Vertex] = Position;
+
+        if (bQuantize)
+        {
+            const FVector3f Scaled = (Position - Bounds.Min) * QuantizeScale;
+            const FIntVector Quantized(FMath::Clamp(FMath::RoundToInt32(Scaled.X), 0, 65535),
+                                       FMath::Clamp(FMath::RoundToInt32(Scaled.Y), 0, 65535),
+                                       FMath::Clamp(FMath::RoundToInt32(Scaled.Z), 0, 65535));
+            QuantizedPositions[Vertex] = Quantized;
+
+            WriteAt(Binary, Base + 0, static_cast<uint16>(Quantized.X));
+            WriteAt(Binary, Base + 2, static_cast<uint16>(Quantized.Y));
+            WriteAt(Binary, Base + 4, static_cast<uint16>(Quantized.Z));
+            WriteAt(Binary, Base + NormalOffset + 0, static_cast<int8>(FMath::RoundToInt32(Normal.X * 127.0f)));
+            WriteAt(Binary, Base + NormalOffset + 1, static_cast<int8>(FMath::RoundToInt32(Normal.Y * 127.0f)));
+            WriteAt(Binary, Base + NormalOffset + 2, static_cast<int8>(FMath::RoundToInt32(Normal.Z * 127.0f)));
+        }
+        else
+        {
+            WriteAt(Binary, Base + 0, Position);
+            WriteAt(Binary, Base + NormalOffset, Normal);
+        }
+
+        if (bQuantizeUVs)
+        {
+            WriteAt(Binary, Base + UVOffset + 0, static_cast<uint16>(FMath::RoundToInt32(UV.X * 65535.0f)));
+            WriteAt(Binary, Base + UVOffset + 2, static_cast<uint16>(FMath::RoundToInt32(UV.Y * 65535.0f)));
+        }
+        else
+        {
+            WriteAt(Binary, Base + UVOffset, UV);
+        }
+    }
+
+    // Index buffer view: every section indexes its own vertex range, rebased to the range start, so it is
+    // 16-bit whenever the range stays below the primitive restart value. Optimized buffers give each
+    // section one contiguous range.
+    const int32 VertexBytes = Binary.Num();
+    TArray<int64> IndexOffsets;
+    TArray<uint32> FirstVertices;
+    TArray<uint32> VertexCounts;
+    for (const FFloorPlanMeshSection& Section : Buffers.Sections)
+    {
+        uint32 MinIndex = Section.Indices.Num() > 0 ? MAX_uint32 : 0;
+        uint32 MaxIndex = 0;
+        for (uint32 Index : Section.Indices)
+        {
+            MinIndex = FMath::Min(MinIndex, Index);
+            MaxIndex = FMath::Max(MaxIndex, Index);
+        }
+        FirstVertices.Add(MinIndex);
+        VertexCounts.Add(MaxIndex - MinIndex + 1);
+        const bool bShortIndices = MaxIndex - MinIndex < 65535;
+
+        PadTo4(Binary, 0);
+        IndexOffsets.Add(Binary.Num() - VertexBytes);
+        const int64 Start = Binary.Num();
+        Binary.AddZeroed(static_cast<int64>(Section.Indices.Num()) * (bShortIndices ? 2 : 4));
+        for (int32 Index = 0; Index < Section.Indices.Num(); ++Index)
+        {
+            if (bShortIndices)
+            {
+                WriteAt(Binary, Start + Index * 2, static_cast<uint16>(Section.Indices[Index] - MinIndex));
+            }
+            else
+            {
+                WriteAt(Binary, Start + Index * 4, Section.Indices[Index] - MinIndex);
+            }
+        }
+    }
+    PadTo4(Binary, 0);
+
+    // Four accessors per non-empty section: its range of the three vertex attributes, then its indices
+    FString Accessors;
+    FString Primitives;
+    FString Materials;
+    int32 NumPrimitives = 0;
+    for (int32 SectionIndex = 0; SectionIndex < Buffers.Sections.Num(); ++SectionIndex)
+    {
+        const FFloorPlanMeshSection& Section = Buffers.Sections[SectionIndex];
+        const FLinearColor* Color = Settings.MaterialColors.Find(Section.MaterialName);
+        const FLinearColor BaseColor = Color ? *Color : FLinearColor(0.8f, 0.8f, 0.8f);
+        Materials += FString::Printf(TEXT("%s{\"name\":\"%s\",\"pbrMetallicRoughness\":{\"baseColorFactor\":[%s,%s,%s,%s],\"metallicFactor\":0,\"roughnessFactor\":0.9}}"),
+                                     SectionIndex > 0 ? TEXT(",") : TEXT(""), *Escape(Section.MaterialName),
+                                     *Number(BaseColor.R), *Number(BaseColor.G), *Number(BaseColor.B), *Number(BaseColor.A));
+        if (Section.Indices.Num() == 0)
+        {
+            continue;
+        }
+
+        const uint32 FirstVertex = FirstVertices[SectionIndex];
+        const uint32 Count = VertexCounts[SectionIndex];
+        const int64 RangeOffset = static_cast<int64>(FirstVertex) * Stride;
+        if (bQuantize)
+        {
+            FIntVector QuantizedMin(MAX_int32);
+            FIntVector QuantizedMax(MIN_int32);
+            for (uint32 Vertex = FirstVertex; Vertex < FirstVertex + Count; ++Vertex)
+            {
+                const FIntVector& Quantized = QuantizedPositions[Vertex];
+                QuantizedMin = FIntVector(FMath::Min(QuantizedMin.X, Quantized.X), FMath::Min(QuantizedMin.Y, Quantized.Y), FMath::Min(QuantizedMin.Z, Quantized.Z));
+                QuantizedMax = FIntVector(FMath::Max(QuantizedMax.X, Quantized.X), FMath::Max(QuantizedMax.Y, Quantized.Y), FMath::Max(QuantizedMax.Z, Quantized.Z));
+            }
+            Accessors += FString::Printf(TEXT("%s{\"bufferView\":0,\"byteOffset\":%lld,\"componentType\":%d,\"count\":%u,\"type\":\"VEC3\",\"min\":[%d,%d,%d],\"max\":[%d,%d,%d]}"),
+                                         NumPrimitives > 0 ? TEXT(",") : TEXT(""), RangeOffset, ComponentUnsignedShort, Count,
+                                         QuantizedMin.X, QuantizedMin.Y, QuantizedMin.Z, QuantizedMax.X, QuantizedMax.Y, QuantizedMax.Z);
+            Accessors += FString::Printf(TEXT(",{\"bufferView\":0,\"byteOffset\":%lld,\"componentType\":%d,\"normalized\":true,\"count\":%u,\"type\":\"VEC3\"}"),
+                                         RangeOffset + NormalOffset, ComponentByte, Count);
+        }
+        else
+        {
+            FBox3f RangeBounds(ForceInit);
+            for (uint32 Vertex = FirstVertex; Vertex < FirstVertex + Count; ++Vertex)
+            {
+                RangeBounds += GLTFPositions[Vertex];
+            }
+            Accessors += FString::Printf(TEXT("%s{\"bufferView\":0,\"byteOffset\":%lld,\"componentType\":%d,\"count\":%u,\"type\":\"VEC3\",\"min\":%s,\"max\":%s}"),
+                                         NumPrimitives > 0 ? TEXT(",") : TEXT(""), RangeOffset, ComponentFloat, Count, *Vector(RangeBounds.Min), *Vector(RangeBounds.Max));
+            Accessors += FString::Printf(TEXT(",{\"bufferView\":0,\"byteOffset\":%lld,\"componentType\":%d,\"count\":%u,\"type\":\"VEC3\"}"),
+                                         RangeOffset + NormalOffset, ComponentFloat, Count);
+        }
+        Accessors += FString::Printf(TEXT(",{\"bufferView\":0,\"byteOffset\":%lld,\"componentType\":%d,%s\"count\":%u,\"type\":\"VEC2\"}"),
+                                     RangeOffset + UVOffset, bQuantizeUVs ? ComponentUnsignedShort : ComponentFloat, bQuantizeUVs ? TEXT("\"normalized\":true,") : TEXT(""), Count);
+        Accessors += FString::Printf(TEXT(",{\"bufferView\":1,\"byteOffset\":%lld,\"componentType\":%d,\"count\":%d,\"type\":\"SCALAR\"}"),
+                                     IndexOffsets[SectionIndex], Count - 1 < 65535 ? ComponentUnsignedShort : ComponentUnsignedInt, Section.Indices.Num());
+
+        const int32 FirstAccessor = NumPrimitives * 4;
+        Primitives += FString::Printf(TEXT("%s{\"attributes\":{\"POSITION\":%d,\"NORMAL\":%d,\"TEXCOORD_0\":%d},\"indices\":%d,\"material\":%d}"),
+                                      NumPrimitives > 0 ? TEXT(",") : TEXT(""), FirstAccessor, FirstAccessor + 1, FirstAccessor + 2, FirstAccessor + 3, SectionIndex);
+        ++NumPrimitives;
+    }
+
+    const FString Node = bQuantize
+        ? FString::Printf(TEXT("{\"mesh\":0,\"translation\":%s,\"scale\":%s}"), *Vector(Bounds.Min), *Vector(Extent / 65535.0f))
+        : FString(TEXT("{\"mesh\":0}"));
+    const FString Extensions = bQuantize
+        ? FString(TEXT("\"extensionsUsed\":[\"KHR_mesh_quantization\"],\"extensionsRequired\":[\"KHR_mesh_quantization\"],"))
+        : FString();
+
+    const FString Json = FString::Printf(
+        TEXT("{\"asset\":{\"version\":\"2.0\",\"generator\":\"FloorPlanGenerator\"},%s")
+        TEXT("\"scene\":0,\"scenes\":[{\"nodes\":[0]}],\"nodes\":[%s],")
+        TEXT("\"meshes\":[{\"name\":\"Building\",\"primitives\":[%s]}],\"materials\":[%s],")
+        TEXT("\"buffers\":[{\"byteLength\":%d}],")
+        TEXT("\"bufferViews\":[{\"buffer\":0,\"byteOffset\":0,\"byteLength\":%d,\"byteStride\":%d,\"target\":%d},")
+        TEXT("{\"buffer\":0,\"byteOffset\":%d,\"byteLength\":%d,\"target\":%d}],")
+        TEXT("\"accessors\":[%s]}"),
+        *Extensions, *Node, *Primitives, *Materials, Binary.Num(),
+        VertexBytes, Stride, TargetArrayBuffer,
+        VertexBytes, Binary.Num() - VertexBytes, TargetElementArrayBuffer,
+        *Accessors);
+
+    const FTCHARToUTF8 Utf8(*Json);
+    TArray<uint8> JsonChunk;
+    JsonChunk.Append(reinterpret_cast<const uint8*>(Utf8.Get()), Utf8.Length());
+    PadTo4(JsonChunk, ' ');
+
+    // GLB container: 12-byte header, then the JSON and BIN chunks with their own 8-byte headers
+    const uint32 TotalLength = 12 + 8 + JsonChunk.Num() + 8 + Binary.Num();
+    OutBytes.Reserve(TotalLength);
+    auto AppendUint32 = [&OutBytes](uint32 Value)
+    {
+        OutBytes.Append(reinterpret_cast<const uint8*>(&Value), sizeof(uint32));
+    };
+
+    AppendUint32(0x46546C67); // "glTF"
+    AppendUint32(2);
+    AppendUint32(TotalLength);
+    AppendUint32(JsonChunk.Num());
+    AppendUint32(0x4E4F534A); // "JSON"
+    OutBytes.Append(JsonChunk);
+    AppendUint32(Binary.Num());
+    AppendUint32(0x004E4942); // "BIN\0"
+    OutBytes.Append(Binary);
+    return true;
+}
@@ -4,19 +4,42 @@
 #include "IContentBrowserSingleton.h"
 #include "Engine/Texture2D.h"
 #include "FloorPlanProcessor.h"
+#include "FloorPlanLog.h"
 
 #define LOCTEXT_NAMESPACE "FFloorPlanGeneratorModule"
 
+DEFINE_LOG_CATEGORY(LogFloorPlan);
+
+DEFINE_STAT(STAT_FloorPlanExtract);
+DEFINE_STAT(STAT_FloorPlanBinarize);
+DEFINE_STAT(STAT_FloorPlanLabel);
+DEFINE_STAT(STAT_FloorPlanWalls);
+DEFINE_STAT(STAT_FloorPlanOpenings);
+DEFINE_STAT(STAT_FloorPlanText);
+DEFINE_STAT(STAT_FloorPlanMeshBuild);
+DEFINE_STAT(STAT_FloorPlanAssetCreate);
+DEFINE_STAT(STAT_FloorPlanVertices);
+DEFINE_STAT(STAT_FloorPlanTriangles);
+
+LLM_DEFINE_TAG(STAT_FloorPlanExtract, TEXT("FloorPlan Extract"));
+LLM_DEFINE_TAG(STAT_FloorPlanBinarize, TEXT("FloorPlan Binarize"));
+LLM_DEFINE_TAG(STAT_FloorPlanLabel, TEXT("FloorPlan Label"));
+LLM_DEFINE_TAG(STAT_FloorPlanWalls, TEXT("FloorPlan Walls"));
+LLM_DEFINE_TAG(STAT_FloorPlanOpenings, TEXT("FloorPlan Openings"));
+LLM_DEFINE_TAG(STAT_FloorPlanText, TEXT("FloorPlan Text"));
+LLM_DEFINE_TAG(STAT_FloorPlanMeshBuild, TEXT("FloorPlan Mesh Build"));
+LLM_DEFINE_TAG(STAT_FloorPlanAssetCreate, TEXT("FloorPlan Asset Create"));
+
 void FFloorPlanGeneratorModule::StartupModule()
 {
-    UE_LOG(LogTemp, Log, TEXT("FloorPlanGenerator module started"));
+    UE_LOG(LogFloorPlan, Log, TEXT("FloorPlanGenerator module started"));
     RegisterMenuExtensions();
 }
 
 void FFloorPlanGeneratorModule::ShutdownModule()
 {
     UnregisterMenuExtensions();
-    UE_LOG(LogTemp, Log, TEXT("FloorPlanGenerator module shutdown"));
+    UE_LOG(LogFloorPlan, Log, TEXT("FloorPlanGenerator module shutdown"));
 }
 
 void FFloorPlanGeneratorModule::RegisterMenuExtensions()
@@ -60,7 +83,7 @@ void FFloorPlanGeneratorModule::OnGenerateFromFloorPlan()
     {
         if (UTexture2D* FloorPlanTexture = Cast<UTexture2D>(AssetData.GetAsset()))
         {
-            UE_LOG(LogTemp, Log, TEXT("Processing floor plan: %s"), *AssetData.AssetName.ToString());
+            UE_LOG(LogFloorPlan, Log, TEXT("Processing floor plan: %s"), *AssetData.AssetName.ToString());
             
             // Create and configure the floor plan processor
             UFloorPlanProcessor* Processor = NewObject<UFloorPlanProcessor>();
@@ -0,0 +1,79 @@
+#include "FloorPlanMask.h"
+#include "FloorPlanLog.h"
+#include "FloorPlanProfile.h"
+#include "FloorPlanStripReader.h"
+
+void FFloorPlanMask::Init(int32 InWidth, int32 InHeight, uint8 Value)
+{
+    Width = InWidth;
+    Height = InHeight;
+    Pixels.Init(Value, static_cast<int64>(Width) * Height);
+}
+
+bool FFloorPlanMask::ReadFrom(FFloorPlanStripReader& Reader, int32 StripRows, uint8 BlackThreshold, uint8 WhiteThreshold, FFloorPlanProfile* Profile)
+{
+    Width = Reader.GetWidth();
+    Height = Reader.GetHeight();
+    Pixels.SetNumUninitialized(static_cast<int64>(Width) * Height);
+
+    TArray<uint8> Strip;
+    int32 Y = 0;
+    while (true)
+    {
+        int32 NumRows = 0;
+        {
+            FLOORPLAN_SCOPE_STAGE(STAT_FloorPlanExtract, Profile, ExtractMs);
+            NumRows = Reader.ReadRows(FMath::Max(1, StripRows), Strip);
+        }
+        if (NumRows == 0)
+        {
+            break;
+        }
+
+        FLOORPLAN_SCOPE_STAGE(STAT_FloorPlanBinarize, Profile, BinarizeMs);
+        uint8* Dest = Pixels.GetData() + Index(0, Y);
+        const int32 NumPixels = NumRows * Width;
+        for (int32 Pixel = 0; Pixel < NumPixels; ++Pixel)
+        {
+            Dest[Pixel] = Classify(Strip[Pixel], BlackThreshold, WhiteThreshold);
+        }
+        Y += NumRows;
+    }
+
+    if (Y != Height)
+    {
+        UE_LOG(LogFloorPlan, Error, TEXT("FloorPlanMask: Image ended after %d of %d rows"), Y, Height);
+        Pixels.Empty();
+        return false;
+    }
+    return true;
+}
+
+FFloorPlanMask FFloorPlanMask::Downsample() const
+{
+    FFloorPlanMask Result;
+    Result.Init(FMath::DivideAndRoundUp(Width, 2), FMath::DivideAndRoundUp(Height, 2));
+
+    for (int32 Y = 0; Y < Result.Height; ++Y)
+    {
+        for (int32 X = 0; X < Result.Width; ++X)
+        {
+            bool bAnyWall = false;
+            bool bAllRoom = true;
+            for (int32 DY = 0; DY < 2; ++DY)
+            {
+                for (int32 DX = 0; DX < 2; ++DX)
+                {
+                    const int32 SX = FMath::Min(X * 2 + DX, Width - 1);
+                    const int32 SY = FMath::Min(Y * 2 + DY, Height - 1);
+                    const uint8 Class = Get(SX, SY);
+                    bAnyWall |= Class == Wall;
+                    bAllRoom &= Class == Room;
+                }
+            }
+            Result.Pixels[Result.Index(X, Y)] = bAnyWall ? Wall : (bAllRoom ? Room : Other);
+        }
+    }
+
+    return Result;
+}
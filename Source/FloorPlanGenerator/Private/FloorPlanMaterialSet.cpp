@@ -0,0 +1,72 @@
+#include "FloorPlanMaterialSet.h"
+#include "FloorPlanLog.h"
+#include "Materials/MaterialInterface.h"
+#include "Components/PrimitiveComponent.h"
+
+UFloorPlanMaterialSet::UFloorPlanMaterialSet()
+{
+    MaterialPaths.Add(TEXT("Wall"), TSoftObjectPtr<UMaterialInterface>(FSoftObjectPath(TEXT("/FloorPlanGenerator/Materials/M_Wall.M_Wall"))));
+    MaterialPaths.Add(TEXT("Floor"), TSoftObjectPtr<UMaterialInterface>(FSoftObjectPath(TEXT("/FloorPlanGenerator/Materials/M_Floor.M_Floor"))));
+    MaterialPaths.Add(TEXT("Ceiling"), TSoftObjectPtr<UMaterialInterface>(FSoftObjectPath(TEXT("/FloorPlanGenerator/Materials/M_Ceiling.M_Ceiling"))));
+}
+
+void UFloorPlanMaterialSet::SetMaterialPath(FName Slot, const TSoftObjectPtr<UMaterialInterface>& Material)
+{
+    MaterialPaths.Add(Slot, Material);
+    ResolvedMaterials.Remove(Slot);
+}
+
+void UFloorPlanMaterialSet::SetMaterial(FName Slot, UMaterialInterface* Material)
+{
+    MaterialPaths.Add(Slot, Material);
+    ResolvedMaterials.Add(Slot, Material);
+}
+
+UMaterialInterface* UFloorPlanMaterialSet::GetMaterial(FName Slot)
+{
+    if (UMaterialInterface** Resolved = ResolvedMaterials.Find(Slot))
+    {
+        return *Resolved;
+    }
+
+    const TSoftObjectPtr<UMaterialInterface>* Path = MaterialPaths.Find(Slot);
+    UMaterialInterface* Material = Path ? Path->LoadSynchronous() : nullptr;
+    if (Path && !Material)
+    {
+        UE_LOG(LogFloorPlan, Warning, TEXT("FloorPlanMaterialSet: Could not load %s for slot %s"), *Path->ToString(), *Slot.ToString());
+    }
+    ResolvedMaterials.Add(Slot, Material);
+    return Material;
+}
+
+void UFloorPlanMaterialSet::ResolveAll()
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(UFloorPlanMaterialSet::ResolveAll);
+
+    for (const TPair<FName, TSoftObjectPtr<UMaterialInterface>>& Pair : MaterialPaths)
+    {
+        GetMaterial(Pair.Key);
+    }
+}
+
+void UFloorPlanMaterialSet::SetRoomTint(const FString& RoomName, FLinearColor Tint)
+{
+    RoomTints.Add(RoomName, Tint);
+}
+
+FLinearColor UFloorPlanMaterialSet::GetRoomTint(const FString& RoomName) const
+{
+    const FLinearColor* Tint = RoomTints.Find(RoomName);
+    return Tint ? *Tint : FLinearColor::White;
+}
+
+void UFloorPlanMaterialSet::ApplyRoomData(UPrimitiveComponent* Primitive, const FString& RoomName) const
+{
+    if (!Primitive)
+    {
+        return;
+    }
+
+    const FLinearColor Tint = GetRoomTint(RoomName);
+    Primitive->SetCustomPrimitiveDataVector3(RoomTintDataIndex, FVector(Tint.R, Tint.G, Tint.B));
+}
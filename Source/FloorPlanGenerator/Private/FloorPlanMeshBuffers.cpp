@@ -0,0 +1,782 @@
+#include "FloorPlanMeshBuffers.h"
+#include "FloorPlanLog.h"
+#include "Algo/Sort.h"
+#include "Algo/StableSort.h"
+
+namespace FloorPlanMeshBuffersPrivate
+{
+    // Forsyth's linear-speed vertex cache optimization, with his published constants
+    constexpr int32 ForsythCacheSize = 32;
+    constexpr float ForsythCacheDecayPower = 1.5f;
+    constexpr float ForsythLastTriangleScore = 0.75f;
+    constexpr float ForsythValenceBoostScale = 2.0f;
+    constexpr float ForsythValenceBoostPower = 0.5f;
+
+    // Triangles per overdraw cluster, and how much ACMR the cluster order may cost before it is dropped
+    constexpr int32 OverdrawClusterTriangles = 64;
+    constexpr float OverdrawMaxCacheCost = 1.05f;
+
+    // Everything that makes two vertices interchangeable; no padding, so it hashes and compares as bytes
+    struct FWeldKey
+    {
+        FVector3f Position;
+        FVector3f Normal;
+        FVector2f UV;
+        FVector2f LightmapUV;
+        int32 Section;
+
+        bool operator==(const FWeldKey& Other) const
+        {
+            return FMemory::Memcmp(this, &Other, sizeof(FWeldKey)) == 0;
+        }
+
+        friend uint32 GetTypeHash(const FWeldKey& Key)
+        {
+            return FCrc::MemCrc32(&Key, sizeof(FWeldKey));
+        }
+    };
+    static_assert(sizeof(FWeldKey) == 44, "FWeldKey must not contain padding");
+
+    // Adding zero turns -0 into +0, so both weld
+    FVector3f Canonical(const FVector3f& Value)
+    {
+        return FVector3f(Value.X + 0.0f, Value.Y + 0.0f, Value.Z + 0.0f);
+    }
+
+    FVector2f Canonical(const FVector2f& Value)
+    {
+        return FVector2f(Value.X + 0.0f, Value.Y + 0.0f);
+    }
+
+    // Vertices transformed by a FIFO cache of CacheSize entries
+    int64 CountCacheMisses(const TArray<uint32>& Indices, int32 NumVertices, int32 CacheSize)
+    {
+        // A vertex is cached while fewer than CacheSize misses happened since it was loaded
+        TArray<int64> LoadedAt;
+        LoadedAt.Init(MIN_int64 / 2, NumVertices);
+        int64 Misses = 0;
+        for (uint32 Vertex : Indices)
+        {
+            if (Misses - LoadedAt[Vertex] >= CacheSize)
+            {
+                LoadedAt[Vertex] = Misses++;
+            }
+        }
+        return Misses;
+    }
+
+    float ForsythVertexScore(int32 CachePosition, int32 RemainingTriangles)
+    {
+        if (RemainingTriangles == 0)
+        {
+            return -1.0f;
+        }
+
+        float Score = 0.0f;
+        if (CachePosition >= 0)
+        {
+            // The last triangle's vertices get a fixed score, so the next one does not just reuse its edge
+            Score = CachePosition < 3
+                ? ForsythLastTriangleScore
+                : FMath::Pow(1.0f - static_cast<float>(CachePosition - 3) / (ForsythCacheSize - 3), ForsythCacheDecayPower);
+        }
+
+        // Vertices with few triangles left are finished first, so they leave the working set
+        return Score + ForsythValenceBoostScale * FMath::Pow(static_cast<float>(RemainingTriangles), -ForsythValenceBoostPower);
+    }
+
+    // Reorders the triangles of one index list in place; indices are below NumVertices, no triangle is degenerate
+    void OptimizeVertexCache(TArray<uint32>& Indices, int32 NumVertices)
+    {
+        const int32 NumTriangles = Indices.Num() / 3;
+        if (NumTriangles < 2)
+        {
+            return;
+        }
+
+        // Live triangles of every vertex, the first Remaining[Vertex] entries of its adjacency range
+        TArray<int32> Remaining;
+        Remaining.SetNumZeroed(NumVertices);
+        for (uint32 Vertex : Indices)
+        {
+            ++Remaining[Vertex];
+        }
+
+        TArray<int32> AdjacencyOffset;
+        AdjacencyOffset.SetNumUninitialized(NumVertices + 1);
+        AdjacencyOffset[0] = 0;
+        for (int32 Vertex = 0; Vertex < NumVertices; ++Vertex)
+        {
+            AdjacencyOffset[Vertex + 1] = AdjacencyOffset[Vertex] + Remaining[Vertex];
+        }
+
+        TArray<int32> Adjacency;
+        Adjacency.SetNumUninitialized(NumTriangles * 3);
+        {
+            TArray<int32> Fill(AdjacencyOffset.GetData(), NumVertices);
+            for (int32 Index = 0; Index < NumTriangles * 3; ++Index)
+            {
+                Adjacency[Fill[Indices[Index]]++] = Index / 3;
+            }
+        }
+
+        TArray<int32> CachePosition;
+        CachePosition.Init(INDEX_NONE, NumVertices);
+        TArray<float> VertexScore;
+        VertexScore.SetNumUninitialized(NumVertices);
+        for (int32 Vertex = 0; Vertex < NumVertices; ++Vertex)
+        {
+            VertexScore[Vertex] = ForsythVertexScore(INDEX_NONE, Remaining[Vertex]);
+        }
+
+        TArray<float> TriangleScore;
+        TriangleScore.SetNumUninitialized(NumTriangles);
+        int32 Best = 0;
+        for (int32 Triangle = 0; Triangle < NumTriangles; ++Triangle)
+        {
+            TriangleScore[Triangle] = VertexScore[Indices[Triangle * 3]] + VertexScore[Indices[Triangle * 3 + 1]] + VertexScore[Indices[Triangle * 3 + 2]];
+            if (TriangleScore[Triangle] > TriangleScore[Best])
+            {
+                Best = Triangle;
+            }
+        }
+
+        TBitArray<> Emitted(false, NumTriangles);
+        TArray<uint32> Result;
+        Result.Reserve(Indices.Num());
+        int32 Cache[ForsythCacheSize + 3];
+        int32 CacheCount = 0;
+        int32 ScanCursor = 0;
+
+        while (Result.Num() < NumTriangles * 3)
+        {
+            if (Best == INDEX_NONE)
+            {
+                // Nothing next to the cache is left, continue with the next triangle in input order
+                while (Emitted[ScanCursor])
+                {
+                    ++ScanCursor;
+                }
+                Best = ScanCursor;
+            }
+
+            const int32 Triangle = Best;
+            Emitted[Triangle] = true;
+
+            // The emitted triangle's vertices move to the front of the cache, the rest shift back
+            int32 NewCache[ForsythCacheSize + 3];
+            int32 NewCount = 0;
+            for (int32 Corner = 0; Corner < 3; ++Corner)
+            {
+                const uint32 Vertex = Indices[Triangle * 3 + Corner];
+                Result.Add(Vertex);
+                NewCache[NewCount++] = static_cast<int32>(Vertex);
+
+                int32* Live = Adjacency.GetData() + AdjacencyOffset[Vertex];
+                for (int32 Slot = 0; Slot < Remaining[Vertex]; ++Slot)
+                {
+                    if (Live[Slot] == Triangle)
+                    {
+                        Swap(Live[Slot], Live[Remaining[Vertex] - 1]);
+                        --Remaining[Vertex];
+                        break;
+                    }
+                }
+            }
+            for (int32 Slot = 0; Slot < CacheCount; ++Slot)
+            {
+                if (Cache[Slot] != NewCache[0] && Cache[Slot] != NewCache[1] && Cache[Slot] != NewCache[2])
+                {
+                    NewCache[NewCount++] = Cache[Slot];
+                }
+            }
+
+            // Entries pushed past the cache are evicted, every entry's score changes with its position
+            for (int32 Slot = 0; Slot < NewCount; ++Slot)
+            {
+                const int32 Vertex = NewCache[Slot];
+                CachePosition[Vertex] = Slot < ForsythCacheSize ? Slot : INDEX_NONE;
+                VertexScore[Vertex] = ForsythVertexScore(CachePosition[Vertex], Remaining[Vertex]);
+            }
+
+            Best = INDEX_NONE;
+            float BestScore = 0.0f;
+            for (int32 Slot = 0; Slot < NewCount; ++Slot)
+            {
+                const int32 Vertex = NewCache[Slot];
+                const int32* Live = Adjacency.GetData() + AdjacencyOffset[Vertex];
+                for (int32 Entry = 0; Entry < Remaining[Vertex]; ++Entry)
+                {
+                    const int32 Candidate = Live[Entry];
+                    TriangleScore[Candidate] = VertexScore[Indices[Candidate * 3]] + VertexScore[Indices[Candidate * 3 + 1]] + VertexScore[Indices[Candidate * 3 + 2]];
+                    if (Slot < ForsythCacheSize && TriangleScore[Candidate] > BestScore)
+                    {
+                        Best = Candidate;
+                        BestScore = TriangleScore[Candidate];
+                    }
+                }
+            }
+
+            CacheCount = FMath::Min(NewCount, ForsythCacheSize);
+            FMemory::Memcpy(Cache, NewCache, CacheCount * sizeof(int32));
+        }
+
+        Indices = MoveTemp(Result);
+    }
+
+    // Splits the cache-ordered list into clusters and draws the ones facing away from the mesh center first:
+    // those are the outer surfaces, which occlude the inner ones from most viewpoints
+    void OptimizeOverdraw(TArray<uint32>& Indices, const TArray<FVector3f>& Positions, const TArray<FVector3f>& Normals, const FVector3f& Center)
+    {
+        const int32 NumTriangles = Indices.Num() / 3;
+        const int32 NumClusters = FMath::DivideAndRoundUp(NumTriangles, OverdrawClusterTriangles);
+        if (NumClusters < 2)
+        {
+            return;
+        }
+
+        TArray<float> ClusterKey;
+        ClusterKey.SetNumUninitialized(NumClusters);
+        for (int32 Cluster = 0; Cluster < NumClusters; ++Cluster)
+        {
+            const int32 First = Cluster * OverdrawClusterTriangles;
+            const int32 Last = FMath::Min(First + OverdrawClusterTriangles, NumTriangles);
+
+            // Area-weighted centroid and normal of the cluster
+            FVector3f Centroid = FVector3f::ZeroVector;
+            FVector3f Normal = FVector3f::ZeroVector;
+            float Area = 0.0f;
+            for (int32 Triangle = First; Triangle < Last; ++Triangle)
+            {
+                const FVector3f& A = Positions[Indices[Triangle * 3]];
+                const FVector3f& B = Positions[Indices[Triangle * 3 + 1]];
+                const FVector3f& C = Positions[Indices[Triangle * 3 + 2]];
+                const float TriangleArea = FMath::Max(((B - A) ^ (C - A)).Size() * 0.5f, UE_SMALL_NUMBER);
+                Centroid += (A + B + C) * (TriangleArea / 3.0f);
+                Normal += (Normals[Indices[Triangle * 3]] + Normals[Indices[Triangle * 3 + 1]] + Normals[Indices[Triangle * 3 + 2]]) * TriangleArea;
+                Area += TriangleArea;
+            }
+            ClusterKey[Cluster] = ((Centroid / Area) - Center) | Normal.GetSafeNormal();
+        }
+
+        TArray<int32> Order;
+        Order.SetNumUninitialized(NumClusters);
+        for (int32 Cluster = 0; Cluster < NumClusters; ++Cluster)
+        {
+            Order[Cluster] = Cluster;
+        }
+        Algo::StableSort(Order, [&ClusterKey](int32 A, int32 B) { return ClusterKey[A] > ClusterKey[B]; });
+
+        TArray<uint32> Result;
+        Result.Reserve(Indices.Num());
+        for (int32 Cluster : Order)
+        {
+            const int32 First = Cluster * OverdrawClusterTriangles * 3;
+            const int32 Last = FMath::Min(First + OverdrawClusterTriangles * 3, NumTriangles * 3);
+            Result.Append(Indices.GetData() + First, Last - First);
+        }
+
+        // Cluster seams cost a few cache misses; the order is kept only while that stays small
+        const int32 NumVertices = Positions.Num();
+        const int64 CacheOrderMisses = CountCacheMisses(Indices, NumVertices, FFloorPlanMeshOptimizeStats::CacheSize);
+        const int64 ClusterOrderMisses = CountCacheMisses(Result, NumVertices, FFloorPlanMeshOptimizeStats::CacheSize);
+        if (ClusterOrderMisses <= CacheOrderMisses * OverdrawMaxCacheCost)
+        {
+            Indices = MoveTemp(Result);
+        }
+    }
+
+    int64 GetIndexBytes(const TArray<uint32>& Indices)
+    {
+        if (Indices.Num() == 0)
+        {
+            return 0;
+        }
+
+        uint32 MinIndex = MAX_uint32;
+        uint32 MaxIndex = 0;
+        for (uint32 Index : Indices)
+        {
+            MinIndex = FMath::Min(MinIndex, Index);
+            MaxIndex = FMath::Max(MaxIndex, Index);
+        }
+        return static_cast<int64>(Indices.Num()) * (MaxIndex - MinIndex < 65535 ? 2 : 4);
+    }
+}
+
+void FFloorPlanMeshOptimizeStats::Append(const FFloorPlanMeshOptimizeStats& Other)
+{
+    VerticesBefore += Other.VerticesBefore;
+    VerticesAfter += Other.VerticesAfter;
+    Triangles += Other.Triangles;
+    CacheMissesBefore += Other.CacheMissesBefore;
+    CacheMissesAfter += Other.CacheMissesAfter;
+    IndexBytesBefore += Other.IndexBytesBefore;
+    IndexBytesAfter += Other.IndexBytesAfter;
+}
+
+int32 FFloorPlanMeshBuffers::FindOrAddSection(const FString& MaterialName)
+{
+    const int32 Existing = Sections.IndexOfByPredicate([&MaterialName](const FFloorPlanMeshSection& Section)
+    {
+        return Section.MaterialName == MaterialName;
+    });
+    if (Existing != INDEX_NONE)
+    {
+        return Existing;
+    }
+
+    FFloorPlanMeshSection& Section = Sections.AddDefaulted_GetRef();
+    Section.MaterialName = MaterialName;
+    return Sections.Num() - 1;
+}
+
+void FFloorPlanMeshBuffers::Append(const TArray<FVector>& Vertices, const TArray<int32>& Triangles, const TArray<FVector2D>& InUVs,
+                                   const TArray<FVector>& InNormals, int32 Section, const FTransform& Transform)
+{
+    check(Sections.IsValidIndex(Section));
+
+    const uint32 BaseIndex = static_cast<uint32>(Positions.Num());
+    Positions.Reserve(Positions.Num() + Vertices.Num());
+    Normals.Reserve(Normals.Num() + Vertices.Num());
+    UVs.Reserve(UVs.Num() + Vertices.Num());
+
+    for (int32 Index = 0; Index < Vertices.Num(); ++Index)
+    {
+        Positions.Add(FVector3f(Transform.TransformPosition(Vertices[Index])));
+        Normals.Add(FVector3f(Transform.TransformVectorNoScale(InNormals.IsValidIndex(Index) ? InNormals[Index] : FVector::UpVector)));
+        UVs.Add(FVector2f(InUVs.IsValidIndex(Index) ? InUVs[Index] : FVector2D::ZeroVector));
+    }
+
+    TArray<uint32>& Indices = Sections[Section].Indices;
+    Indices.Reserve(Indices.Num() + Triangles.Num());
+    for (int32 Index : Triangles)
+    {
+        Indices.Add(BaseIndex + static_cast<uint32>(Index));
+    }
+}
+
+void FFloorPlanMeshBuffers::Append(const FFloorPlanMeshBuffers& Other, const FTransform& Transform)
+{
+    const uint32 BaseIndex = static_cast<uint32>(Positions.Num());
+    const int32 NumVertices = Other.Positions.Num();
+    Positions.Reserve(Positions.Num() + NumVertices);
+    Normals.Reserve(Normals.Num() + NumVertices);
+    UVs.Reserve(UVs.Num() + NumVertices);
+
+    for (int32 Index = 0; Index < NumVertices; ++Index)
+    {
+        Positions.Add(FVector3f(Transform.TransformPosition(FVector(Other.Positions[Index]))));
+        Normals.Add(FVector3f(Transform.TransformVectorNoScale(FVector(Other.Normals.IsValidIndex(Index) ? Other.Normals[Index] : FVector3f::UpVector))));
+        UVs.Add(Other.UVs.IsValidIndex(Index) ? Other.UVs[Index] : FVector2f::ZeroVector);
+    }
+
+    // Lightmap charts are packed per buffer, so a merged buffer has to be repacked
+    LightmapUVs.Reset();
+
+    for (const FFloorPlanMeshSection& OtherSection : Other.Sections)
+    {
+        TArray<uint32>& Indices = Sections[FindOrAddSection(OtherSection.MaterialName)].Indices;
+        Indices.Reserve(Indices.Num() + OtherSection.Indices.Num());
+        for (uint32 Index : OtherSection.Indices)
+        {
+            Indices.Add(BaseIndex + Index);
+        }
+    }
+}
+
+void FFloorPlanMeshBuffers::SplitSpatially(int32 MaxTriangles, TArray<FFloorPlanMeshBuffers>& OutChunks) const
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(FFloorPlanMeshBuffers::SplitSpatially);
+
+    struct FTriangleRef
+    {
+        FVector3f Centroid;
+        int32 Section;
+        int32 FirstIndex;
+    };
+
+    TArray<FTriangleRef> Triangles;
+    Triangles.Reserve(static_cast<int32>(GetNumTriangles()));
+    for (int32 SectionIndex = 0; SectionIndex < Sections.Num(); ++SectionIndex)
+    {
+        const TArray<uint32>& Indices = Sections[SectionIndex].Indices;
+        for (int32 Index = 0; Index + 2 < Indices.Num(); Index += 3)
+        {
+            const FVector3f Centroid = (Positions[Indices[Index]] + Positions[Indices[Index + 1]] + Positions[Indices[Index + 2]]) / 3.0f;
+            Triangles.Add({ Centroid, SectionIndex, Index });
+        }
+    }
+
+    // Ranges still too large are cut at the median of their longest centroid axis
+    MaxTriangles = FMath::Max(1, MaxTriangles);
+    TArray<TPair<int32, int32>> Pending;
+    TArray<TPair<int32, int32>> Ranges;
+    Pending.Add(TPair<int32, int32>(0, Triangles.Num()));
+    while (Pending.Num() > 0)
+    {
+        const TPair<int32, int32> Range = Pending.Pop();
+        if (Range.Value - Range.Key <= MaxTriangles)
+        {
+            Ranges.Add(Range);
+            continue;
+        }
+
+        TArrayView<FTriangleRef> View(Triangles.GetData() + Range.Key, Range.Value - Range.Key);
+        FBox3f CentroidBounds(ForceInit);
+        for (const FTriangleRef& Triangle : View)
+        {
+            CentroidBounds += Triangle.Centroid;
+        }
+        const FVector3f Size = CentroidBounds.GetSize();
+        const int32 Axis = Size.X >= Size.Y && Size.X >= Size.Z ? 0 : (Size.Y >= Size.Z ? 1 : 2);
+        Algo::SortBy(View, [Axis](const FTriangleRef& Triangle) { return Triangle.Centroid[Axis]; });
+
+        const int32 Middle = Range.Key + (Range.Value - Range.Key) / 2;
+        Pending.Add(TPair<int32, int32>(Middle, Range.Value));
+        Pending.Add(TPair<int32, int32>(Range.Key, Middle));
+    }
+
+    // Each chunk gets its own compact vertex range, Remap is reset for the vertices it touched
+    TArray<int32> Remap;
+    Remap.Init(INDEX_NONE, Positions.Num());
+    TArray<uint32> Touched;
+    OutChunks.Reset(Ranges.Num());
+    for (const TPair<int32, int32>& Range : Ranges)
+    {
+        FFloorPlanMeshBuffers& Chunk = OutChunks.AddDefaulted_GetRef();
+        TArray<int32> ChunkSections;
+        ChunkSections.Init(INDEX_NONE, Sections.Num());
+
+        for (int32 TriangleIndex = Range.Key; TriangleIndex < Range.Value; ++TriangleIndex)
+        {
+            const FTriangleRef& Triangle = Triangles[TriangleIndex];
+            if (ChunkSections[Triangle.Section] == INDEX_NONE)
+            {
+                ChunkSections[Triangle.Section] = Chunk.FindOrAddSection(Sections[Triangle.Section].MaterialName);
+            }
+
+            TArray<uint32>& ChunkIndices = Chunk.Sections[ChunkSections[Triangle.Section]].Indices;
+            for (int32 Corner = 0; Corner < 3; ++Corner)
+            {
+                const uint32 Vertex = Sections[Triangle.Section].Indices[Triangle.FirstIndex + Corner];
+                if (Remap[Vertex] == INDEX_NONE)
+                {
+                    Remap[Vertex] = Chunk.Positions.Add(Positions[Vertex]);
+                    Chunk.Normals.Add(Normals.IsValidIndex(Vertex) ? Normals[Vertex] : FVector3f::UpVector);
+                    Chunk.UVs.Add(UVs.IsValidIndex(Vertex) ? UVs[Vertex] : FVector2f::ZeroVector);
+                    Touched.Add(Vertex);
+                }
+                ChunkIndices.Add(static_cast<uint32>(Remap[Vertex]));
+            }
+        }
+
+        for (uint32 Vertex : Touched)
+        {
+            Remap[Vertex] = INDEX_NONE;
+        }
+        Touched.Reset();
+    }
+}
+
+void FFloorPlanMeshBuffers::PackLightmapUVs(int32 Resolution)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(FFloorPlanMeshBuffers::PackLightmapUVs);
+
+    const int32 NumVertices = Positions.Num();
+    LightmapUVs.Reset();
+    if (NumVertices == 0)
+    {
+        return;
+    }
+
+    // Charts are the connected components of the index buffer
+    TArray<int32> Parent;
+    Parent.SetNumUninitialized(NumVertices);
+    for (int32 Vertex = 0; Vertex < NumVertices; ++Vertex)
+    {
+        Parent[Vertex] = Vertex;
+    }
+    auto FindRoot = [&Parent](int32 Vertex)
+    {
+        while (Parent[Vertex] != Vertex)
+        {
+            Parent[Vertex] = Parent[Parent[Vertex]];
+            Vertex = Parent[Vertex];
+        }
+        return Vertex;
+    };
+    for (const FFloorPlanMeshSection& Section : Sections)
+    {
+        for (int32 Index = 0; Index + 2 < Section.Indices.Num(); Index += 3)
+        {
+            const int32 Root = FindRoot(static_cast<int32>(Section.Indices[Index]));
+            for (int32 Corner = 1; Corner < 3; ++Corner)
+            {
+                const int32 Other = FindRoot(static_cast<int32>(Section.Indices[Index + Corner]));
+                if (Other != Root)
+                {
+                    Parent[Other] = Root;
+                }
+            }
+        }
+    }
+
+    struct FChart
+    {
+        FVector3f Normal = FVector3f::ZeroVector;
+        FVector3f AxisU;
+        FVector3f AxisV;
+        FBox2f Bounds = FBox2f(ForceInit);
+        bool bRotated = false;
+        FVector2f Offset = FVector2f::ZeroVector;
+    };
+
+    TArray<int32> ChartOfVertex;
+    ChartOfVertex.SetNumUninitialized(NumVertices);
+    TMap<int32, int32> ChartOfRoot;
+    TArray<FChart> Charts;
+    for (int32 Vertex = 0; Vertex < NumVertices; ++Vertex)
+    {
+        const int32 Root = FindRoot(Vertex);
+        int32* Existing = ChartOfRoot.Find(Root);
+        const int32 Chart = Existing ? *Existing : ChartOfRoot.Add(Root, Charts.AddDefaulted());
+        ChartOfVertex[Vertex] = Chart;
+        Charts[Chart].Normal += Normals.IsValidIndex(Vertex) ? Normals[Vertex] : FVector3f::UpVector;
+    }
+
+    // Each chart is flattened onto the plane of its average normal, in centimeters
+    TArray<FVector2f> Planar;
+    Planar.SetNumUninitialized(NumVertices);
+    for (FChart& Chart : Charts)
+    {
+        const FVector3f Normal = Chart.Normal.GetSafeNormal(UE_SMALL_NUMBER, FVector3f::UpVector);
+        Chart.AxisU = FMath::Abs(Normal.Z) > 0.7f ? FVector3f::ForwardVector : FVector3f::CrossProduct(FVector3f::UpVector, Normal).GetSafeNormal();
+        Chart.AxisV = FVector3f::CrossProduct(Normal, Chart.AxisU).GetSafeNormal();
+    }
+    for (int32 Vertex = 0; Vertex < NumVertices; ++Vertex)
+    {
+        FChart& Chart = Charts[ChartOfVertex[Vertex]];
+        Planar[Vertex] = FVector2f(FVector3f::DotProduct(Positions[Vertex], Chart.AxisU), FVector3f::DotProduct(Positions[Vertex], Chart.AxisV));
+        Chart.Bounds += Planar[Vertex];
+    }
+
+    // Charts lie with their long side horizontal, shelves are filled tallest first
+    double TotalArea = 0.0;
+    TArray<int32> Order;
+    Order.SetNumUninitialized(Charts.Num());
+    for (int32 ChartIndex = 0; ChartIndex < Charts.Num(); ++ChartIndex)
+    {
+        FChart& Chart = Charts[ChartIndex];
+        const FVector2f Size = Chart.Bounds.GetSize();
+        Chart.bRotated = Size.Y > Size.X;
+        TotalArea += static_cast<double>(FMath::Max(Size.X, 1.0f)) * FMath::Max(Size.Y, 1.0f);
+        Order[ChartIndex] = ChartIndex;
+    }
+    auto GetChartSize = [&Charts](int32 ChartIndex)
+    {
+        const FVector2f Size = Charts[ChartIndex].Bounds.GetSize();
+        return Charts[ChartIndex].bRotated ? FVector2f(Size.Y, Size.X) : Size;
+    };
+    Algo::SortBy(Order, [&GetChartSize](int32 ChartIndex) { return -GetChartSize(ChartIndex).Y; });
+
+    // The gutter is measured in texels, so it depends on the atlas size; grow the square until all shelves fit
+    Resolution = FMath::Max(Resolution, 4);
+    float AtlasSize = static_cast<float>(FMath::Sqrt(TotalArea));
+    for (const FChart& Chart : Charts)
+    {
+        AtlasSize = FMath::Max(AtlasSize, Chart.Bounds.GetSize().GetMax());
+    }
+    AtlasSize = FMath::Max(AtlasSize, 1.0f);
+
+    for (int32 Attempt = 0; Attempt < 64; ++Attempt)
+    {
+        const float Gutter = 2.0f * AtlasSize / Resolution;
+        FVector2f Cursor(Gutter, Gutter);
+        float ShelfHeight = 0.0f;
+        bool bFits = true;
+        for (int32 ChartIndex : Order)
+        {
+            const FVector2f Size = GetChartSize(ChartIndex);
+            if (Cursor.X + Size.X + Gutter > AtlasSize && Cursor.X > Gutter)
+            {
+                Cursor = FVector2f(Gutter, Cursor.Y + ShelfHeight + Gutter);
+                ShelfHeight = 0.0f;
+            }
+            if (Cursor.X + Size.X + Gutter > AtlasSize || Cursor.Y + Size.Y + Gutter > AtlasSize)
+            {
+                bFits = false;
+                break;
+            }
+            Charts[ChartIndex].Offset = Cursor;
+            Cursor.X += Size.X + Gutter;
+            ShelfHeight = FMath::Max(ShelfHeight, Size.Y);
+        }
+        if (bFits)
+        {
+            break;
+        }
+        AtlasSize *= 1.1f;
+    }
+
+    LightmapUVs.SetNumUninitialized(NumVertices);
+    for (int32 Vertex = 0; Vertex < NumVertices; ++Vertex)
+    {
+        const FChart& Chart = Charts[ChartOfVertex[Vertex]];
+        FVector2f Local = Planar[Vertex] - Chart.Bounds.Min;
+        if (Chart.bRotated)
+        {
+            Local = FVector2f(Local.Y, Local.X);
+        }
+        LightmapUVs[Vertex] = (Chart.Offset + Local) / AtlasSize;
+    }
+
+    UE_LOG(LogFloorPlan, Verbose, TEXT("FloorPlanMeshBuffers: Packed %d lightmap charts for %d vertices at %d texels"),
+           Charts.Num(), NumVertices, Resolution);
+}
+
+void FFloorPlanMeshBuffers::Optimize(FFloorPlanMeshOptimizeStats* OutStats)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(FFloorPlanMeshBuffers::Optimize);
+    using namespace FloorPlanMeshBuffersPrivate;
+
+    FFloorPlanMeshOptimizeStats Stats;
+    Stats.VerticesBefore = Positions.Num();
+    for (const FFloorPlanMeshSection& Section : Sections)
+    {
+        Stats.CacheMissesBefore += CountCacheMisses(Section.Indices, Positions.Num(), FFloorPlanMeshOptimizeStats::CacheSize);
+        Stats.IndexBytesBefore += static_cast<int64>(Section.Indices.Num()) * sizeof(uint32);
+    }
+
+    // Weld: every distinct attribute set within a section becomes one vertex, triangles that collapse are dropped
+    const bool bHasLightmapUVs = LightmapUVs.Num() == Positions.Num();
+    TArray<FWeldKey> Welded;
+    TMap<FWeldKey, uint32> WeldedIndexOf;
+    Welded.Reserve(Positions.Num());
+    WeldedIndexOf.Reserve(Positions.Num());
+    for (int32 SectionIndex = 0; SectionIndex < Sections.Num(); ++SectionIndex)
+    {
+        TArray<uint32>& Indices = Sections[SectionIndex].Indices;
+        int32 Kept = 0;
+        for (int32 Index = 0; Index + 2 < Indices.Num(); Index += 3)
+        {
+            uint32 Corners[3];
+            for (int32 Corner = 0; Corner < 3; ++Corner)
+            {
+                const uint32 Vertex = Indices[Index + Corner];
+                FWeldKey Key;
+                Key.Position = Canonical(Positions[Vertex]);
+                Key.Normal = Canonical(Normals.IsValidIndex(Vertex) ? Normals[Vertex] : FVector3f::UpVector);
+                Key.UV = Canonical(UVs.IsValidIndex(Vertex) ? UVs[Vertex] : FVector2f::ZeroVector);
+                Key.LightmapUV = bHasLightmapUVs ? Canonical(LightmapUVs[Vertex]) : FVector2f::ZeroVector;
+                Key.Section = SectionIndex;
+
+                const uint32* Existing = WeldedIndexOf.Find(Key);
+                Corners[Corner] = Existing ? *Existing : WeldedIndexOf.Add(Key, static_cast<uint32>(Welded.Add(Key)));
+            }
+
+            if (Corners[0] != Corners[1] && Corners[1] != Corners[2] && Corners[0] != Corners[2])
+            {
+                Indices[Kept++] = Corners[0];
+                Indices[Kept++] = Corners[1];
+                Indices[Kept++] = Corners[2];
+            }
+        }
+        Indices.RemoveAt(Kept, Indices.Num() - Kept);
+    }
+    WeldedIndexOf.Empty();
+
+    TArray<FVector3f> WeldedPositions;
+    TArray<FVector3f> WeldedNormals;
+    WeldedPositions.SetNumUninitialized(Welded.Num());
+    WeldedNormals.SetNumUninitialized(Welded.Num());
+    FBox3f Bounds(ForceInit);
+    for (int32 Vertex = 0; Vertex < Welded.Num(); ++Vertex)
+    {
+        WeldedPositions[Vertex] = Welded[Vertex].Position;
+        WeldedNormals[Vertex] = Welded[Vertex].Normal;
+        Bounds += Welded[Vertex].Position;
+    }
+
+    // Triangle order per section: vertex cache first, then overdraw where it keeps the cache gains
+    const FVector3f Center = Bounds.IsValid ? Bounds.GetCenter() : FVector3f::ZeroVector;
+    for (FFloorPlanMeshSection& Section : Sections)
+    {
+        OptimizeVertexCache(Section.Indices, Welded.Num());
+        OptimizeOverdraw(Section.Indices, WeldedPositions, WeldedNormals, Center);
+    }
+
+    // Vertex fetch order: vertices are renumbered as the sections first use them
+    TArray<uint32> Remap;
+    Remap.Init(MAX_uint32, Welded.Num());
+    Positions.Reset(Welded.Num());
+    Normals.Reset(Welded.Num());
+    UVs.Reset(Welded.Num());
+    LightmapUVs.Reset(bHasLightmapUVs ? Welded.Num() : 0);
+    for (FFloorPlanMeshSection& Section : Sections)
+    {
+        for (uint32& Index : Section.Indices)
+        {
+            if (Remap[Index] == MAX_uint32)
+            {
+                const FWeldKey& Key = Welded[Index];
+                Remap[Index] = static_cast<uint32>(Positions.Add(Key.Position));
+                Normals.Add(Key.Normal);
+                UVs.Add(Key.UV);
+                if (bHasLightmapUVs)
+                {
+                    LightmapUVs.Add(Key.LightmapUV);
+                }
+            }
+            Index = Remap[Index];
+        }
+    }
+
+    Stats.VerticesAfter = Positions.Num();
+    Stats.Triangles = GetNumTriangles();
+    for (const FFloorPlanMeshSection& Section : Sections)
+    {
+        Stats.CacheMissesAfter += CountCacheMisses(Section.Indices, Positions.Num(), FFloorPlanMeshOptimizeStats::CacheSize);
+        Stats.IndexBytesAfter += GetIndexBytes(Section.Indices);
+    }
+
+    UE_LOG(LogFloorPlan, Verbose, TEXT("FloorPlanMeshBuffers: Optimized %lld triangles, %d -> %d vertices, ACMR %.3f -> %.3f, %lld -> %lld index bytes"),
+           Stats.Triangles, Stats.VerticesBefore, Stats.VerticesAfter,
+           Stats.Triangles > 0 ? static_cast<double>(Stats.CacheMissesBefore) / Stats.Triangles : 0.0,
+           Stats.Triangles > 0 ? static_cast<double>(Stats.CacheMissesAfter) / Stats.Triangles : 0.0,
+           Stats.IndexBytesBefore, Stats.IndexBytesAfter);
+
+    if (OutStats)
+    {
+        OutStats->Append(Stats);
+    }
+}
+
+int64 FFloorPlanMeshBuffers::GetNumTriangles() const
+{
+    int64 NumTriangles = 0;
+    for (const FFloorPlanMeshSection& Section : Sections)
+    {
+        NumTriangles += Section.Indices.Num() / 3;
+    }
+    return NumTriangles;
+}
+
+FBox3f FFloorPlanMeshBuffers::GetBounds() const
+{
+    FBox3f Bounds(ForceInit);
+    for (const FVector3f& Position : Positions)
+    {
+        Bounds += Position;
+    }
+    return Bounds;
+}
+
+void FFloorPlanMeshBuffers::Reset()
+{
+    Positions.Reset();
+    Normals.Reset();
+    UVs.Reset();
+    LightmapUVs.Reset();
+    Sections.Reset();
+}
@@ -0,0 +1,245 @@
+#include "FloorPlanOpeningDetector.h"
+#include "FloorPlanLog.h"
+#include "FloorPlanMask.h"
+#include "FloorPlanParallel.h"
+
+FFloorPlanOpeningDetector::FFloorPlanOpeningDetector(const FFloorPlanMask& Mask, const FFloorPlanOpeningSettings& InSettings)
+    : Settings(InSettings)
+    , PixelToWorld(InSettings.ScaleFactor / 10.0f)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(FFloorPlanOpeningDetector::BuildInkTable);
+
+    // Door arcs and window lines are thin and often anti-aliased, so anything that is not paper counts as ink
+    Ink.Build(Mask.Width, Mask.Height, [&Mask](int32 X, int32 Y)
+    {
+        return Mask.Get(X, Y) != FFloorPlanMask::Room ? 1u : 0u;
+    });
+}
+
+void FFloorPlanOpeningDetector::Detect(const TArray<FWallSegmentData>& Segments, TArray<FOpeningData>& OutOpenings) const
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(FFloorPlanOpeningDetector::Detect);
+
+    TArray<FGap> Gaps;
+    FindGaps(Segments, true, Gaps);
+    FindGaps(Segments, false, Gaps);
+
+    TArray<FOpeningData> Candidates;
+    Candidates.SetNum(Gaps.Num());
+    TArray<uint8> Accepted;
+    Accepted.SetNumZeroed(Gaps.Num());
+
+    FFloorPlanParallel::For(Gaps.Num(), [this, &Gaps, &Candidates, &Accepted](int32 GapIndex)
+    {
+        Accepted[GapIndex] = ClassifyGap(Gaps[GapIndex], Candidates[GapIndex]) ? 1 : 0;
+    });
+
+    // Spatial hash with one duplicate radius per cell, so each candidate only checks its 3x3 neighborhood
+    const float CellSize = FMath::Max(Settings.DuplicateDistance, 1.0f);
+    TMap<FIntPoint, TArray<int32>> Grid;
+
+    for (int32 CandidateIndex = 0; CandidateIndex < Candidates.Num(); ++CandidateIndex)
+    {
+        if (!Accepted[CandidateIndex])
+        {
+            continue;
+        }
+
+        const FOpeningData& Candidate = Candidates[CandidateIndex];
+        const FIntPoint Cell(FMath::FloorToInt(Candidate.Position.X / CellSize), FMath::FloorToInt(Candidate.Position.Y / CellSize));
+
+        bool bDuplicate = false;
+        for (int32 DY = -1; DY <= 1 && !bDuplicate; ++DY)
+        {
+            for (int32 DX = -1; DX <= 1 && !bDuplicate; ++DX)
+            {
+                if (const TArray<int32>* Bucket = Grid.Find(FIntPoint(Cell.X + DX, Cell.Y + DY)))
+                {
+                    for (int32 ExistingIndex : *Bucket)
+                    {
+                        if (FVector2D::Distance(OutOpenings[ExistingIndex].Position, Candidate.Position) < Settings.DuplicateDistance)
+                        {
+                            bDuplicate = true;
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+
+        if (!bDuplicate)
+        {
+            Grid.FindOrAdd(Cell).Add(OutOpenings.Add(Candidate));
+        }
+    }
+
+    UE_LOG(LogFloorPlan, Log, TEXT("FloorPlanOpeningDetector: %d wall gaps -> %d openings"), Gaps.Num(), OutOpenings.Num());
+}
+
+void FFloorPlanOpeningDetector::FindGaps(const TArray<FWallSegmentData>& Segments, bool bHorizontalWalls, TArray<FGap>& OutGaps) const
+{
+    // Segments of one orientation in (along, across) pixel coordinates
+    TArray<FGap> Lines;
+    for (const FWallSegmentData& Segment : Segments)
+    {
+        const FVector2D Delta = Segment.End - Segment.Start;
+        const bool bHorizontal = FMath::Abs(Delta.X) >= FMath::Abs(Delta.Y);
+        if (bHorizontal != bHorizontalWalls)
+        {
+            continue;
+        }
+
+        const FVector2D Start = Segment.Start / PixelToWorld;
+        const FVector2D End = Segment.End / PixelToWorld;
+
+        FGap Line;
+        Line.bHorizontalWall = bHorizontalWalls;
+        Line.Across = bHorizontalWalls ? (Start.Y + End.Y) * 0.5f : (Start.X + End.X) * 0.5f;
+        Line.AlongStart = bHorizontalWalls ? FMath::Min(Start.X, End.X) : FMath::Min(Start.Y, End.Y);
+        Line.AlongEnd = bHorizontalWalls ? FMath::Max(Start.X, End.X) : FMath::Max(Start.Y, End.Y);
+        Line.ThicknessPixels = Segment.Thickness / PixelToWorld;
+        Lines.Add(Line);
+    }
+
+    Lines.Sort([](const FGap& A, const FGap& B)
+    {
+        return A.Across < B.Across;
+    });
+
+    // Group collinear segments, then look at the space between neighbors along each group
+    const float MinGap = Settings.MinOpeningWidth / PixelToWorld;
+    const float MaxGap = Settings.MaxOpeningWidth / PixelToWorld;
+    TArray<FGap> Group;
+
+    int32 LineIndex = 0;
+    while (LineIndex < Lines.Num())
+    {
+        Group.Reset();
+        Group.Add(Lines[LineIndex++]);
+        while (LineIndex < Lines.Num() &&
+               Lines[LineIndex].Across - Group[0].Across <= FMath::Max(Group[0].ThicknessPixels * 0.5f, 1.0f))
+        {
+            Group.Add(Lines[LineIndex++]);
+        }
+
+        Group.Sort([](const FGap& A, const FGap& B)
+        {
+            return A.AlongStart < B.AlongStart;
+        });
+
+        for (int32 Index = 0; Index + 1 < Group.Num(); ++Index)
+        {
+            const FGap& Before = Group[Index];
+            const FGap& After = Group[Index + 1];
+            const float GapLength = After.AlongStart - Before.AlongEnd;
+            if (GapLength < MinGap || GapLength > MaxGap)
+            {
+                continue;
+            }
+
+            FGap Gap;
+            Gap.bHorizontalWall = bHorizontalWalls;
+            Gap.Across = (Before.Across + After.Across) * 0.5f;
+            Gap.AlongStart = Before.AlongEnd;
+            Gap.AlongEnd = After.AlongStart;
+            Gap.ThicknessPixels = FMath::Max(Before.ThicknessPixels, After.ThicknessPixels);
+            OutGaps.Add(Gap);
+        }
+    }
+}
+
+bool FFloorPlanOpeningDetector::ClassifyGap(const FGap& Gap, FOpeningData& OutOpening) const
+{
+    const float AlongCenter = (Gap.AlongStart + Gap.AlongEnd) * 0.5f;
+    const FVector2D CenterPixel = Gap.bHorizontalWall ? FVector2D(AlongCenter, Gap.Across) : FVector2D(Gap.Across, AlongCenter);
+
+    OutOpening.Position = CenterPixel * PixelToWorld;
+    OutOpening.Size = FVector2D(Gap.AlongEnd - Gap.AlongStart, Gap.ThicknessPixels) * PixelToWorld;
+    OutOpening.Rotation = Gap.bHorizontalWall ? 0.0f : 90.0f;
+
+    // Windows are drawn as parallel lines spanning the gap, doors leave it empty and draw a swing arc
+    const int32 WindowLines = CountWindowLines(Gap);
+    if (WindowLines >= Settings.MinWindowLines)
+    {
+        OutOpening.bIsDoor = false;
+        return true;
+    }
+
+    // Gaps without a swing arc are plain passages: the walls stay open there, but no door is placed
+    if (DoorArcScore(Gap) < Settings.DoorArcHitRatio)
+    {
+        UE_LOG(LogFloorPlan, Verbose, TEXT("FloorPlanOpeningDetector: Gap at %s has no door arc, keeping it as a passage"), *OutOpening.Position.ToString());
+        return false;
+    }
+
+    OutOpening.bIsDoor = true;
+    return true;
+}
+
+int32 FFloorPlanOpeningDetector::CountWindowLines(const FGap& Gap) const
+{
+    // Skip the wall end caps so only the interior of the gap is measured
+    const int32 Along0 = FMath::CeilToInt(Gap.AlongStart) + 1;
+    const int32 Along1 = FMath::FloorToInt(Gap.AlongEnd) - 1;
+    if (Along1 <= Along0)
+    {
+        return 0;
+    }
+
+    const float HalfThickness = Gap.ThicknessPixels * 0.5f;
+    const int32 Across0 = FMath::FloorToInt(Gap.Across - HalfThickness) - 1;
+    const int32 Across1 = FMath::CeilToInt(Gap.Across + HalfThickness) + 1;
+    const int32 Length = Along1 - Along0 + 1;
+
+    int32 NumLines = 0;
+    bool bInLine = false;
+    for (int32 Across = Across0; Across <= Across1; ++Across)
+    {
+        const bool bFilled = InkInBox(Gap.bHorizontalWall, Along0, Across, Along1, Across) >= Settings.WindowLineFill * Length;
+        NumLines += (bFilled && !bInLine) ? 1 : 0;
+        bInLine = bFilled;
+    }
+    return NumLines;
+}
+
+float FFloorPlanOpeningDetector::DoorArcScore(const FGap& Gap) const
+{
+    constexpr int32 NumSamples = 9;
+    const float Radius = Gap.AlongEnd - Gap.AlongStart;
+    const float HalfThickness = Gap.ThicknessPixels * 0.5f;
+
+    // Try the hinge at either end of the gap swinging to either side of the wall
+    float BestScore = 0.0f;
+    for (int32 Hinge = 0; Hinge < 2; ++Hinge)
+    {
+        const float HingeAlong = Hinge == 0 ? Gap.AlongStart : Gap.AlongEnd;
+        const float TowardGap = Hinge == 0 ? 1.0f : -1.0f;
+
+        for (int32 Side = -1; Side <= 1; Side += 2)
+        {
+            int32 Hits = 0;
+            for (int32 Sample = 0; Sample < NumSamples; ++Sample)
+            {
+                const float Angle = FMath::DegreesToRadians(10.0f + 70.0f * Sample / (NumSamples - 1));
+                const float Along = HingeAlong + TowardGap * Radius * FMath::Cos(Angle);
+                const float Across = Gap.Across + Side * (HalfThickness + Radius * FMath::Sin(Angle));
+                const FVector2D Pixel = Gap.bHorizontalWall ? FVector2D(Along, Across) : FVector2D(Across, Along);
+                Hits += HasInkNear(Pixel, 2) ? 1 : 0;
+            }
+            BestScore = FMath::Max(BestScore, static_cast<float>(Hits) / NumSamples);
+        }
+    }
+    return BestScore;
+}
+
+int32 FFloorPlanOpeningDetector::InkInBox(bool bHorizontalWall, int32 Along0, int32 Across0, int32 Along1, int32 Across1) const
+{
+    return bHorizontalWall ? Ink.BoxSum(Along0, Across0, Along1, Across1) : Ink.BoxSum(Across0, Along0, Across1, Along1);
+}
+
+bool FFloorPlanOpeningDetector::HasInkNear(const FVector2D& Pixel, int32 Radius) const
+{
+    const int32 X = FMath::RoundToInt(Pixel.X);
+    const int32 Y = FMath::RoundToInt(Pixel.Y);
+    return Ink.BoxSum(X - Radius, Y - Radius, X + Radius, Y + Radius) > 0;
+}
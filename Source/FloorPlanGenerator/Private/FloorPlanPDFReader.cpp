@@ -0,0 +1,1132 @@
+#include "FloorPlanPDFReader.h"
+#include "FloorPlanLog.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+THIRD_PARTY_INCLUDES_START
+#include "zlib.h"
+THIRD_PARTY_INCLUDES_END
+
+namespace FloorPlanPDFReaderPrivate
+{
+    // Form XObjects nested deeper than this are ignored, guards against self-referencing forms
+    constexpr int32 MaxFormDepth = 8;
+
+    bool IsWhitespace(uint8 Character)
+    {
+        return Character == ' ' || Character == '\n' || Character == '\r' || Character == '\t' || Character == '\f' || Character == 0;
+    }
+
+    bool IsDelimiter(uint8 Character)
+    {
+        return IsWhitespace(Character) || Character == '(' || Character == ')' || Character == '<' || Character == '>' ||
+               Character == '[' || Character == ']' || Character == '{' || Character == '}' || Character == '/' || Character == '%';
+    }
+
+    bool IsNumeric(const FString& Text)
+    {
+        return !Text.IsEmpty() && (FChar::IsDigit(Text[0]) || Text[0] == TEXT('-') || Text[0] == TEXT('+') || Text[0] == TEXT('.'));
+    }
+
+    // Literal strings keep their raw bytes, escapes and octal codes resolved
+    FString DecodeLiteral(const FString& Raw)
+    {
+        FString Result;
+        Result.Reserve(Raw.Len());
+        for (int32 Index = 0; Index < Raw.Len(); ++Index)
+        {
+            if (Raw[Index] != TEXT('\\') || Index + 1 >= Raw.Len())
+            {
+                Result.AppendChar(Raw[Index]);
+                continue;
+            }
+
+            const TCHAR Escaped = Raw[++Index];
+            switch (Escaped)
+            {
+            case TEXT('n'): Result.AppendChar(TEXT('\n')); break;
+            case TEXT('r'): Result.AppendChar(TEXT('\r')); break;
+            case TEXT('t'): Result.AppendChar(TEXT('\t')); break;
+            case TEXT('b'): Result.AppendChar(TEXT('\b')); break;
+            case TEXT('f'): Result.AppendChar(TEXT('\f')); break;
+            case TEXT('\r'):
+                if (Index + 1 < Raw.Len() && Raw[Index + 1] == TEXT('\n'))
+                {
+                    ++Index;
+                }
+                break;
+            case TEXT('\n'):
+                break;
+            default:
+                if (Escaped >= TEXT('0') && Escaped <= TEXT('7'))
+                {
+                    int32 Code = Escaped - TEXT('0');
+                    for (int32 Digit = 0; Digit < 2 && Index + 1 < Raw.Len() && Raw[Index + 1] >= TEXT('0') && Raw[Index + 1] <= TEXT('7'); ++Digit)
+                    {
+                        Code = Code * 8 + (Raw[++Index] - TEXT('0'));
+                    }
+                    Result.AppendChar(static_cast<TCHAR>(Code & 0xFF));
+                }
+                else
+                {
+                    Result.AppendChar(Escaped);
+                }
+                break;
+            }
+        }
+        return Result;
+    }
+
+    // Hex strings; two-byte codes with a zero high byte (Identity-H fonts subset to Latin text) are folded to one byte
+    FString DecodeHex(const FString& Hex)
+    {
+        TArray<uint8> Bytes;
+        int32 Nibble = -1;
+        for (TCHAR Character : Hex)
+        {
+            if (!FChar::IsHexDigit(Character))
+            {
+                continue;
+            }
+            const int32 Value = FParse::HexDigit(Character);
+            if (Nibble < 0)
+            {
+                Nibble = Value;
+            }
+            else
+            {
+                Bytes.Add(static_cast<uint8>(Nibble * 16 + Value));
+                Nibble = -1;
+            }
+        }
+        if (Nibble >= 0)
+        {
+            Bytes.Add(static_cast<uint8>(Nibble * 16));
+        }
+
+        bool bWide = Bytes.Num() > 0 && Bytes.Num() % 2 == 0;
+        for (int32 Index = 0; bWide && Index < Bytes.Num(); Index += 2)
+        {
+            bWide = Bytes[Index] == 0;
+        }
+
+        FString Result;
+        for (int32 Index = bWide ? 1 : 0; Index < Bytes.Num(); Index += bWide ? 2 : 1)
+        {
+            Result.AppendChar(static_cast<TCHAR>(Bytes[Index]));
+        }
+        return Result;
+    }
+
+    FString DecodeString(const FString& Value)
+    {
+        if (Value.StartsWith(TEXT("(")) && Value.EndsWith(TEXT(")")))
+        {
+            return DecodeLiteral(Value.Mid(1, Value.Len() - 2));
+        }
+        if (Value.StartsWith(TEXT("<")) && Value.EndsWith(TEXT(">")))
+        {
+            return DecodeHex(Value.Mid(1, Value.Len() - 2));
+        }
+        return Value;
+    }
+
+    // Keeps only printable characters and collapses whitespace
+    FString CleanText(const FString& Text)
+    {
+        FString Result;
+        for (TCHAR Character : Text)
+        {
+            const bool bSpace = Character < 32 || FChar::IsWhitespace(Character);
+            if (bSpace ? (Result.Len() > 0 && Result[Result.Len() - 1] != TEXT(' ')) : Character != 127)
+            {
+                Result.AppendChar(bSpace ? TEXT(' ') : Character);
+            }
+        }
+        return Result.TrimStartAndEnd();
+    }
+}
+
+FFloorPlanPDFReader::FFloorPlanPDFReader(const FFloorPlanVectorReadSettings& InSettings)
+    : Settings(InSettings)
+{
+}
+
+bool FFloorPlanPDFReader::Read(const FString& FilePath, FFloorPlanVectorScene& OutScene)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(FFloorPlanPDFReader::Read);
+
+    if (!FFileHelper::LoadFileToArray(Data, *FilePath) || Data.Num() < 8 || FMemory::Memcmp(Data.GetData(), "%PDF", 4) != 0)
+    {
+        UE_LOG(LogFloorPlan, Error, TEXT("FloorPlanPDFReader: %s is not a readable PDF file"), *FilePath);
+        return false;
+    }
+
+    Scene = &OutScene;
+    Scene->Reset();
+    LayerStack.Reset();
+    LayerCache.Reset();
+    DefaultLayer = Scene->FindOrAddFilteredLayer(TEXT("0"), Settings);
+
+    IndexObjects();
+
+    // PDF user space is in points with Y up, scaled here and mirrored by the final normalization
+    const FFloorPlanVectorTransform Root(Settings.UnitToCm, 0.0f, 0.0f, Settings.UnitToCm, 0.0f, 0.0f);
+    int32 NumStreams = 0;
+
+    FString Page;
+    FString Resources;
+    if (FindFirstPage(Page, Resources))
+    {
+        // Content arrays are one stream split at arbitrary token boundaries, so the parts are joined first
+        TArray<uint8> Content;
+        TArray<uint8> Part;
+        for (int32 Contents : GetReferences(GetValue(Page, TEXT("/Contents"))))
+        {
+            if (GetStream(Contents, Part))
+            {
+                Content.Append(Part);
+                Content.Add('\n');
+                ++NumStreams;
+            }
+        }
+        ParseContent(Content, Resources, Root, 0);
+    }
+    else
+    {
+        // Page tree inside compressed object streams: interpret every stream that looks like content
+        UE_LOG(LogFloorPlan, Warning, TEXT("FloorPlanPDFReader: No page object found in %s, scanning all content streams"), *FPaths::GetCleanFilename(FilePath));
+
+        TArray<int32> Objects;
+        ObjectOffsets.GetKeys(Objects);
+        Objects.Sort();
+        for (int32 Object : Objects)
+        {
+            const FString Dictionary = GetDictionary(Object);
+            const bool bForm = GetValue(Dictionary, TEXT("/Subtype")) == TEXT("/Form");
+            const bool bPlain = GetValue(Dictionary, TEXT("/Type")).IsEmpty() && GetValue(Dictionary, TEXT("/Subtype")).IsEmpty() &&
+                                GetValue(Dictionary, TEXT("/Length1")).IsEmpty() && GetValue(Dictionary, TEXT("/N")).IsEmpty() &&
+                                GetValue(Dictionary, TEXT("/FunctionType")).IsEmpty();
+
+            TArray<uint8> Content;
+            if ((bForm || bPlain) && GetStream(Object, Content))
+            {
+                Content.Add('\n');
+                ParseContent(Content, FString(), Root, 0);
+                ++NumStreams;
+            }
+        }
+    }
+
+    FlushText();
+    Scene->NormalizeToOrigin(true);
+    Scene = nullptr;
+    Data.Empty();
+    ObjectOffsets.Empty();
+
+    UE_LOG(LogFloorPlan, Log, TEXT("FloorPlanPDFReader: %s -> %d streams, %d lines, %d arcs, %d texts, %d polygons on %d layers"),
+           *FPaths::GetCleanFilename(FilePath), NumStreams, OutScene.Lines.Num(), OutScene.Arcs.Num(), OutScene.Texts.Num(),
+           OutScene.Polygons.Num(), OutScene.Layers.Num());
+    return NumStreams > 0;
+}
+
+int32 FFloorPlanPDFReader::FindBytes(const ANSICHAR* Pattern, int32 Start, int32 End) const
+{
+    const int32 Length = FCStringAnsi::Strlen(Pattern);
+    End = FMath::Min(End, Data.Num()) - Length;
+    for (int32 Index = FMath::Max(Start, 0); Index <= End; ++Index)
+    {
+        if (Data[Index] == Pattern[0] && FMemory::Memcmp(&Data[Index], Pattern, Length) == 0)
+        {
+            return Index;
+        }
+    }
+    return INDEX_NONE;
+}
+
+void FFloorPlanPDFReader::IndexObjects()
+{
+    using namespace FloorPlanPDFReaderPrivate;
+
+    // Scans for "N G obj" headers instead of trusting the xref table, which is often stale after edits;
+    // later definitions win like incremental updates do, and stream bodies are skipped
+    ObjectOffsets.Reset();
+    const int32 Size = Data.Num();
+    for (int32 Index = 1; Index + 3 <= Size; ++Index)
+    {
+        if (Data[Index] == 's' && Index + 6 < Size && FMemory::Memcmp(&Data[Index], "stream", 6) == 0 && Data[Index - 1] != 'd' &&
+            (Data[Index + 6] == '\r' || Data[Index + 6] == '\n'))
+        {
+            const int32 End = FindBytes("endstream", Index + 6, Size);
+            if (End == INDEX_NONE)
+            {
+                break;
+            }
+            Index = End + 8;
+            continue;
+        }
+
+        if (Data[Index] != 'o' || FMemory::Memcmp(&Data[Index], "obj", 3) != 0 || !IsWhitespace(Data[Index - 1]) ||
+            (Index + 3 < Size && !IsDelimiter(Data[Index + 3])))
+        {
+            continue;
+        }
+
+        // Walk back over the generation and the object number
+        int32 Cursor = Index - 1;
+        int32 Numbers[2] = { 0, 0 };
+        bool bValid = true;
+        for (int32 Field = 0; Field < 2 && bValid; ++Field)
+        {
+            while (Cursor >= 0 && IsWhitespace(Data[Cursor]))
+            {
+                --Cursor;
+            }
+            const int32 DigitsEnd = Cursor;
+            while (Cursor >= 0 && FChar::IsDigit(static_cast<TCHAR>(Data[Cursor])))
+            {
+                --Cursor;
+            }
+            bValid = Cursor < DigitsEnd && DigitsEnd - Cursor <= 10;
+            for (int32 Digit = Cursor + 1; bValid && Digit <= DigitsEnd; ++Digit)
+            {
+                Numbers[Field] = Numbers[Field] * 10 + (Data[Digit] - '0');
+            }
+        }
+
+        if (bValid && (Cursor < 0 || IsDelimiter(Data[Cursor])))
+        {
+            ObjectOffsets.Add(Numbers[1], Index + 3);
+        }
+    }
+}
+
+FString FFloorPlanPDFReader::GetDictionary(int32 ObjectNumber) const
+{
+    const int32* Offset = ObjectOffsets.Find(ObjectNumber);
+    if (!Offset)
+    {
+        return FString();
+    }
+
+    // Object body up to its stream data or endobj, dictionaries of interest are small
+    const int32 Limit = FMath::Min(Data.Num(), *Offset + 1024 * 1024);
+    int32 End = FindBytes("endobj", *Offset, Limit);
+    const int32 Stream = FindBytes("stream", *Offset, End == INDEX_NONE ? Limit : End);
+    End = Stream != INDEX_NONE ? Stream : (End != INDEX_NONE ? End : Limit);
+
+    FString Result;
+    Result.Reserve(End - *Offset);
+    for (int32 Index = *Offset; Index < End; ++Index)
+    {
+        Result.AppendChar(static_cast<TCHAR>(Data[Index]));
+    }
+    return Result.TrimStartAndEnd();
+}
+
+FString FFloorPlanPDFReader::ResolveDictionary(const FString& Value) const
+{
+    if (Value.StartsWith(TEXT("<<")))
+    {
+        return Value;
+    }
+
+    const TArray<int32> References = GetReferences(Value);
+    return References.Num() > 0 ? GetDictionary(References[0]) : FString();
+}
+
+bool FFloorPlanPDFReader::GetStream(int32 ObjectNumber, TArray<uint8>& OutData) const
+{
+    using namespace FloorPlanPDFReaderPrivate;
+
+    OutData.Reset();
+    const int32* Offset = ObjectOffsets.Find(ObjectNumber);
+    const FString Dictionary = GetDictionary(ObjectNumber);
+    const int32 Keyword = Offset ? FindBytes("stream", *Offset, Data.Num()) : INDEX_NONE;
+    if (Keyword == INDEX_NONE)
+    {
+        return false;
+    }
+
+    int32 Start = Keyword + 6;
+    Start += Start < Data.Num() && Data[Start] == '\r' ? 1 : 0;
+    Start += Start < Data.Num() && Data[Start] == '\n' ? 1 : 0;
+
+    // /Length may be an indirect number; fall back to endstream when it is missing or wrong
+    const FString LengthValue = GetValue(Dictionary, TEXT("/Length"));
+    const TArray<int32> LengthReferences = GetReferences(LengthValue);
+    int32 Length = FCString::Atoi(LengthReferences.Num() > 0 ? *GetDictionary(LengthReferences[0]) : *LengthValue);
+    if (Length <= 0 || Start + Length > Data.Num() || FindBytes("endstream", Start + Length, Start + Length + 32) == INDEX_NONE)
+    {
+        const int32 End = FindBytes("endstream", Start, Data.Num());
+        if (End == INDEX_NONE)
+        {
+            return false;
+        }
+        Length = End - Start;
+        while (Length > 0 && (Data[Start + Length - 1] == '\n' || Data[Start + Length - 1] == '\r'))
+        {
+            --Length;
+        }
+    }
+
+    const FString Filter = GetValue(Dictionary, TEXT("/Filter"));
+    if (Filter.IsEmpty())
+    {
+        OutData.Append(&Data[Start], Length);
+        return true;
+    }
+
+    // Only Flate alone is supported, images and other encodings carry no geometry
+    const FString Filters = Filter.Replace(TEXT("["), TEXT("")).Replace(TEXT("]"), TEXT("")).TrimStartAndEnd();
+    if (Filters != TEXT("/FlateDecode") && Filters != TEXT("/Fl"))
+    {
+        return false;
+    }
+    return Inflate(&Data[Start], Length, OutData);
+}
+
+bool FFloorPlanPDFReader::FindFirstPage(FString& OutPage, FString& OutResources) const
+{
+    // Catalog from the last trailer, or the catalog object itself when the trailer is an xref stream
+    FString Catalog;
+    for (int32 Trailer = Data.Num() - 7; Trailer >= 0 && Catalog.IsEmpty(); --Trailer)
+    {
+        if (Data[Trailer] == 't' && FMemory::Memcmp(&Data[Trailer], "trailer", 7) == 0)
+        {
+            FString TrailerText;
+            for (int32 Index = Trailer + 7; Index < FMath::Min(Data.Num(), Trailer + 4096); ++Index)
+            {
+                TrailerText.AppendChar(static_cast<TCHAR>(Data[Index]));
+            }
+            Catalog = ResolveDictionary(GetValue(TrailerText.TrimStartAndEnd(), TEXT("/Root")));
+            break;
+        }
+    }
+
+    for (const TPair<int32, int32>& Object : ObjectOffsets)
+    {
+        if (!Catalog.IsEmpty())
+        {
+            break;
+        }
+        const FString Dictionary = GetDictionary(Object.Key);
+        if (GetValue(Dictionary, TEXT("/Type")) == TEXT("/Catalog"))
+        {
+            Catalog = Dictionary;
+        }
+    }
+
+    // Descend through the first kid of each page tree node, inheriting resources on the way
+    FString Node = ResolveDictionary(GetValue(Catalog, TEXT("/Pages")));
+    FString Inherited;
+    for (int32 Depth = 0; Depth < 32 && !Node.IsEmpty(); ++Depth)
+    {
+        const FString Resources = ResolveDictionary(GetValue(Node, TEXT("/Resources")));
+        Inherited = Resources.IsEmpty() ? Inherited : Resources;
+
+        if (GetValue(Node, TEXT("/Type")) == TEXT("/Page"))
+        {
+            OutPage = Node;
+            OutResources = Inherited;
+            return true;
+        }
+
+        const TArray<int32> Kids = GetReferences(GetValue(Node, TEXT("/Kids")));
+        Node = Kids.Num() > 0 ? GetDictionary(Kids[0]) : FString();
+    }
+    return false;
+}
+
+void FFloorPlanPDFReader::ParseContent(const TArray<uint8>& Content, const FString& Resources, const FFloorPlanVectorTransform& Transform, int32 Depth)
+{
+    using namespace FloorPlanPDFReaderPrivate;
+
+    TArray<FFloorPlanVectorTransform> StateStack;
+    FFloorPlanVectorTransform Ctm = Transform;
+
+    FFloorPlanVectorTransform TextMatrix;
+    FFloorPlanVectorTransform LineMatrix;
+    float FontSize = 12.0f;
+    float Leading = 0.0f;
+    bool bTextMoved = true;
+
+    Path.Reset();
+    Subpath.Reset();
+    ClosedOutlines.Reset();
+
+    TArray<FToken> Operands;
+    FToken Token;
+    bool bOperator = false;
+    int32 Cursor = 0;
+
+    auto Number = [&Operands](int32 FromEnd)
+    {
+        const int32 Index = Operands.Num() - 1 - FromEnd;
+        return Operands.IsValidIndex(Index) && Operands[Index].Type == FToken::Number ? Operands[Index].Number : 0.0f;
+    };
+
+    auto MoveTo = [&](const FVector2D& Point)
+    {
+        Current = SubpathStart = Ctm.Apply(Point);
+        Subpath.Reset();
+        Subpath.Add(Current);
+        bSubpathStraight = true;
+    };
+
+    auto LineTo = [&](const FVector2D& Point)
+    {
+        FSegment& Segment = Path.AddDefaulted_GetRef();
+        Segment.Points[0] = Current;
+        Segment.Points[1] = Ctm.Apply(Point);
+        Current = Segment.Points[1];
+        Subpath.Add(Current);
+    };
+
+    auto CurveTo = [&](const FVector2D& Control1, const FVector2D& Control2, const FVector2D& End, bool bControl1IsCurrent, bool bControl2IsEnd)
+    {
+        FSegment& Segment = Path.AddDefaulted_GetRef();
+        Segment.bCubic = true;
+        Segment.Points[0] = Current;
+        Segment.Points[3] = Ctm.Apply(End);
+        Segment.Points[1] = bControl1IsCurrent ? Current : Ctm.Apply(Control1);
+        Segment.Points[2] = bControl2IsEnd ? Segment.Points[3] : Ctm.Apply(Control2);
+        Current = Segment.Points[3];
+        Subpath.Add(Current);
+        bSubpathStraight = false;
+    };
+
+    auto ShowText = [&](const FString& Text)
+    {
+        const FString Clean = CleanText(Text);
+        if (Clean.IsEmpty())
+        {
+            return;
+        }
+
+        if (bTextMoved || PendingText.IsEmpty())
+        {
+            FlushText();
+            const FFloorPlanVectorTransform Device = TextMatrix.Then(Ctm);
+            PendingText = Clean;
+            PendingTextPosition = Device.Apply(FVector2D::ZeroVector);
+            PendingTextHeight = FontSize * FMath::Sqrt(FMath::Abs(Device.GetDeterminant()));
+            PendingTextLayer = GetCurrentLayer();
+        }
+        else
+        {
+            PendingText += Clean;
+        }
+        bTextMoved = false;
+    };
+
+    auto NextLine = [&](float OffsetX, float OffsetY)
+    {
+        LineMatrix = FFloorPlanVectorTransform(1.0f, 0.0f, 0.0f, 1.0f, OffsetX, OffsetY).Then(LineMatrix);
+        TextMatrix = LineMatrix;
+        bTextMoved = true;
+    };
+
+    while (NextToken(Content, Cursor, Token, bOperator))
+    {
+        if (!bOperator)
+        {
+            Operands.Add(MoveTemp(Token));
+            continue;
+        }
+
+        const FString& Op = Token.Text;
+        if (Op == TEXT("q"))
+        {
+            StateStack.Add(Ctm);
+        }
+        else if (Op == TEXT("Q"))
+        {
+            if (StateStack.Num() > 0)
+            {
+                Ctm = StateStack.Pop();
+            }
+        }
+        else if (Op == TEXT("cm"))
+        {
+            Ctm = FFloorPlanVectorTransform(Number(5), Number(4), Number(3), Number(2), Number(1), Number(0)).Then(Ctm);
+        }
+        else if (Op == TEXT("m"))
+        {
+            MoveTo(FVector2D(Number(1), Number(0)));
+        }
+        else if (Op == TEXT("l"))
+        {
+            LineTo(FVector2D(Number(1), Number(0)));
+        }
+        else if (Op == TEXT("c"))
+        {
+            CurveTo(FVector2D(Number(5), Number(4)), FVector2D(Number(3), Number(2)), FVector2D(Number(1), Number(0)), false, false);
+        }
+        else if (Op == TEXT("v"))
+        {
+            CurveTo(FVector2D::ZeroVector, FVector2D(Number(3), Number(2)), FVector2D(Number(1), Number(0)), true, false);
+        }
+        else if (Op == TEXT("y"))
+        {
+            CurveTo(FVector2D(Number(3), Number(2)), FVector2D::ZeroVector, FVector2D(Number(1), Number(0)), false, true);
+        }
+        else if (Op == TEXT("h"))
+        {
+            CloseSubpath();
+        }
+        else if (Op == TEXT("re"))
+        {
+            const FVector2D Corner(Number(3), Number(2));
+            const FVector2D Size(Number(1), Number(0));
+            MoveTo(Corner);
+            LineTo(Corner + FVector2D(Size.X, 0.0f));
+            LineTo(Corner + Size);
+            LineTo(Corner + FVector2D(0.0f, Size.Y));
+            CloseSubpath();
+        }
+        else if (Op == TEXT("S"))
+        {
+            PaintPath(true);
+        }
+        else if (Op == TEXT("s") || Op == TEXT("f") || Op == TEXT("F") || Op == TEXT("f*") || Op == TEXT("B") || Op == TEXT("B*") || Op == TEXT("b") || Op == TEXT("b*"))
+        {
+            // Closing strokes and fills close the open subpath, fills implicitly
+            CloseSubpath();
+            PaintPath(true);
+        }
+        else if (Op == TEXT("n"))
+        {
+            PaintPath(false);
+        }
+        else if (Op == TEXT("Do") && Operands.Num() > 0 && Operands.Last().Type == FToken::Name && Depth < MaxFormDepth)
+        {
+            const FString XObjects = ResolveDictionary(GetValue(Resources, TEXT("/XObject")));
+            const TArray<int32> References = GetReferences(GetValue(XObjects, *(TEXT("/") + Operands.Last().Text)));
+            const FString Form = References.Num() > 0 ? GetDictionary(References[0]) : FString();
+            TArray<uint8> FormContent;
+            if (GetValue(Form, TEXT("/Subtype")) == TEXT("/Form") && GetStream(References[0], FormContent))
+            {
+                TArray<float> Matrix;
+                TArray<FString> Parts;
+                GetValue(Form, TEXT("/Matrix")).Replace(TEXT("["), TEXT(" ")).Replace(TEXT("]"), TEXT(" ")).ParseIntoArrayWS(Parts);
+                for (const FString& Part : Parts)
+                {
+                    Matrix.Add(FCString::Atof(*Part));
+                }
+                const FFloorPlanVectorTransform FormMatrix = Matrix.Num() == 6
+                    ? FFloorPlanVectorTransform(Matrix[0], Matrix[1], Matrix[2], Matrix[3], Matrix[4], Matrix[5])
+                    : FFloorPlanVectorTransform();
+                const FString FormResources = ResolveDictionary(GetValue(Form, TEXT("/Resources")));
+
+                // The form runs with its own path state, paths are never open across Do
+                FormContent.Add('\n');
+                ParseContent(FormContent, FormResources.IsEmpty() ? Resources : FormResources, FormMatrix.Then(Ctm), Depth + 1);
+            }
+        }
+        else if (Op == TEXT("BDC"))
+        {
+            const bool bOptionalContent = Operands.Num() >= 2 && Operands[Operands.Num() - 2].Text == TEXT("OC") && Operands.Last().Type == FToken::Name;
+            LayerStack.Add(bOptionalContent ? GetLayer(Resources, Operands.Last().Text) : GetCurrentLayer());
+        }
+        else if (Op == TEXT("BMC"))
+        {
+            LayerStack.Add(GetCurrentLayer());
+        }
+        else if (Op == TEXT("EMC"))
+        {
+            if (LayerStack.Num() > 0)
+            {
+                LayerStack.Pop();
+            }
+        }
+        else if (Op == TEXT("BT"))
+        {
+            TextMatrix = LineMatrix = FFloorPlanVectorTransform();
+            bTextMoved = true;
+        }
+        else if (Op == TEXT("ET"))
+        {
+            FlushText();
+        }
+        else if (Op == TEXT("Tf"))
+        {
+            FontSize = Number(0);
+        }
+        else if (Op == TEXT("TL"))
+        {
+            Leading = Number(0);
+        }
+        else if (Op == TEXT("Td"))
+        {
+            NextLine(Number(1), Number(0));
+        }
+        else if (Op == TEXT("TD"))
+        {
+            Leading = -Number(0);
+            NextLine(Number(1), Number(0));
+        }
+        else if (Op == TEXT("Tm"))
+        {
+            TextMatrix = LineMatrix = FFloorPlanVectorTransform(Number(5), Number(4), Number(3), Number(2), Number(1), Number(0));
+            bTextMoved = true;
+        }
+        else if (Op == TEXT("T*"))
+        {
+            NextLine(0.0f, -Leading);
+        }
+        else if (Op == TEXT("Tj") || Op == TEXT("TJ") || Op == TEXT("'") || Op == TEXT("\""))
+        {
+            if (Op == TEXT("'") || Op == TEXT("\""))
+            {
+                NextLine(0.0f, -Leading);
+            }
+            if (Operands.Num() > 0 && Operands.Last().Type == FToken::String)
+            {
+                ShowText(Operands.Last().Text);
+            }
+        }
+        else if (Op == TEXT("ID"))
+        {
+            // Inline image data runs up to a whitespace-delimited EI
+            Cursor += 1;
+            while (Cursor + 2 < Content.Num() && !(IsWhitespace(Content[Cursor - 1]) && Content[Cursor] == 'E' && Content[Cursor + 1] == 'I' && IsDelimiter(Content[Cursor + 2])))
+            {
+                ++Cursor;
+            }
+            Cursor += 2;
+        }
+
+        Operands.Reset();
+    }
+
+    // Unpainted leftovers are discarded like at the end of a PDF content stream
+    PaintPath(false);
+}
+
+bool FFloorPlanPDFReader::NextToken(const TArray<uint8>& Content, int32& Cursor, FToken& OutToken, bool& bOutOperator) const
+{
+    using namespace FloorPlanPDFReaderPrivate;
+
+    const int32 Size = Content.Num();
+    while (Cursor < Size)
+    {
+        if (IsWhitespace(Content[Cursor]))
+        {
+            ++Cursor;
+        }
+        else if (Content[Cursor] == '%')
+        {
+            while (Cursor < Size && Content[Cursor] != '\n' && Content[Cursor] != '\r')
+            {
+                ++Cursor;
+            }
+        }
+        else
+        {
+            break;
+        }
+    }
+    if (Cursor >= Size)
+    {
+        return false;
+    }
+
+    OutToken = FToken();
+    bOutOperator = false;
+    const uint8 First = Content[Cursor];
+
+    if (First == '(')
+    {
+        // Balanced parentheses, escaped ones do not count
+        const int32 Start = ++Cursor;
+        int32 Nesting = 1;
+        while (Cursor < Size && Nesting > 0)
+        {
+            if (Content[Cursor] == '\\')
+            {
+                ++Cursor;
+            }
+            else
+            {
+                Nesting += Content[Cursor] == '(' ? 1 : (Content[Cursor] == ')' ? -1 : 0);
+            }
+            ++Cursor;
+        }
+
+        FString Raw;
+        for (int32 Index = Start; Index < FMath::Min(Cursor - 1, Size); ++Index)
+        {
+            Raw.AppendChar(static_cast<TCHAR>(Content[Index]));
+        }
+        OutToken.Type = FToken::String;
+        OutToken.Text = DecodeLiteral(Raw);
+    }
+    else if (First == '<' && Cursor + 1 < Size && Content[Cursor + 1] == '<')
+    {
+        // Inline dictionary (marked content properties), skipped as a whole
+        int32 Nesting = 0;
+        do
+        {
+            if (Cursor + 1 < Size && Content[Cursor] == '<' && Content[Cursor + 1] == '<')
+            {
+                ++Nesting;
+                Cursor += 2;
+            }
+            else if (Cursor + 1 < Size && Content[Cursor] == '>' && Content[Cursor + 1] == '>')
+            {
+                --Nesting;
+                Cursor += 2;
+            }
+            else
+            {
+                ++Cursor;
+            }
+        } while (Cursor < Size && Nesting > 0);
+    }
+    else if (First == '<')
+    {
+        const int32 Start = ++Cursor;
+        while (Cursor < Size && Content[Cursor] != '>')
+        {
+            ++Cursor;
+        }
+
+        FString Hex;
+        for (int32 Index = Start; Index < Cursor; ++Index)
+        {
+            Hex.AppendChar(static_cast<TCHAR>(Content[Index]));
+        }
+        ++Cursor;
+        OutToken.Type = FToken::String;
+        OutToken.Text = DecodeHex(Hex);
+    }
+    else if (First == '[')
+    {
+        // TJ arrays: strings joined, large negative kerning read as a word space
+        ++Cursor;
+        FToken Element;
+        bool bElementOperator = false;
+        OutToken.Type = FToken::String;
+        while (Cursor < Size)
+        {
+            while (Cursor < Size && IsWhitespace(Content[Cursor]))
+            {
+                ++Cursor;
+            }
+            if (Cursor >= Size || Content[Cursor] == ']')
+            {
+                ++Cursor;
+                break;
+            }
+            if (!NextToken(Content, Cursor, Element, bElementOperator))
+            {
+                break;
+            }
+            if (Element.Type == FToken::String)
+            {
+                OutToken.Text += Element.Text;
+            }
+            else if (Element.Type == FToken::Number && Element.Number < -200.0f)
+            {
+                OutToken.Text += TEXT(" ");
+            }
+        }
+    }
+    else if (First == '/')
+    {
+        const int32 Start = ++Cursor;
+        while (Cursor < Size && !IsDelimiter(Content[Cursor]))
+        {
+            ++Cursor;
+        }
+        OutToken.Type = FToken::Name;
+        for (int32 Index = Start; Index < Cursor; ++Index)
+        {
+            OutToken.Text.AppendChar(static_cast<TCHAR>(Content[Index]));
+        }
+    }
+    else if (IsDelimiter(First))
+    {
+        // Stray closing delimiters
+        ++Cursor;
+    }
+    else
+    {
+        const int32 Start = Cursor;
+        while (Cursor < Size && !IsDelimiter(Content[Cursor]))
+        {
+            ++Cursor;
+        }
+        for (int32 Index = Start; Index < Cursor; ++Index)
+        {
+            OutToken.Text.AppendChar(static_cast<TCHAR>(Content[Index]));
+        }
+
+        if (IsNumeric(OutToken.Text))
+        {
+            OutToken.Type = FToken::Number;
+            OutToken.Number = FCString::Atof(*OutToken.Text);
+        }
+        else
+        {
+            bOutOperator = true;
+        }
+    }
+    return true;
+}
+
+void FFloorPlanPDFReader::CloseSubpath()
+{
+    if (Subpath.Num() == 0)
+    {
+        return;
+    }
+
+    if (!Current.Equals(SubpathStart))
+    {
+        FSegment& Segment = Path.AddDefaulted_GetRef();
+        Segment.Points[0] = Current;
+        Segment.Points[1] = SubpathStart;
+    }
+
+    // Straight closed subpaths are kept as outlines too (room and area shapes)
+    if (bSubpathStraight && Subpath.Num() >= 3)
+    {
+        ClosedOutlines.Add(Subpath);
+    }
+
+    Current = SubpathStart;
+    Subpath.Reset();
+    bSubpathStraight = true;
+}
+
+void FFloorPlanPDFReader::PaintPath(bool bEmit)
+{
+    const int32 Layer = GetCurrentLayer();
+    if (bEmit && Layer != INDEX_NONE)
+    {
+        for (const FSegment& Segment : Path)
+        {
+            if (Segment.bCubic)
+            {
+                Scene->AddCubic(Segment.Points[0], Segment.Points[1], Segment.Points[2], Segment.Points[3], Layer);
+            }
+            else
+            {
+                Scene->AddLine(Segment.Points[0], Segment.Points[1], Layer);
+            }
+        }
+
+        for (TArray<FVector2D>& Outline : ClosedOutlines)
+        {
+            Scene->AddPolygon(MoveTemp(Outline), Layer);
+        }
+    }
+
+    Path.Reset();
+    Subpath.Reset();
+    ClosedOutlines.Reset();
+    bSubpathStraight = true;
+}
+
+void FFloorPlanPDFReader::FlushText()
+{
+    if (!PendingText.IsEmpty() && PendingTextLayer != INDEX_NONE)
+    {
+        Scene->AddText(PendingTextPosition, PendingTextHeight, PendingText, PendingTextLayer);
+    }
+    PendingText.Reset();
+}
+
+int32 FFloorPlanPDFReader::GetLayer(const FString& Resources, const FString& PropertyName)
+{
+    using namespace FloorPlanPDFReaderPrivate;
+
+    const FString CacheKey = FString::Printf(TEXT("%u/%s"), GetTypeHash(Resources), *PropertyName);
+    if (const int32* Cached = LayerCache.Find(CacheKey))
+    {
+        return *Cached;
+    }
+
+    // /Properties maps the marked content name to an optional content group, or a membership dictionary listing groups
+    const FString Properties = ResolveDictionary(GetValue(Resources, TEXT("/Properties")));
+    FString Group = ResolveDictionary(GetValue(Properties, *(TEXT("/") + PropertyName)));
+    if (GetValue(Group, TEXT("/Name")).IsEmpty())
+    {
+        const TArray<int32> Members = GetReferences(GetValue(Group, TEXT("/OCGs")));
+        Group = Members.Num() > 0 ? GetDictionary(Members[0]) : Group;
+    }
+
+    const FString Name = CleanText(DecodeString(GetValue(Group, TEXT("/Name"))));
+    return LayerCache.Add(CacheKey, Scene->FindOrAddFilteredLayer(Name.IsEmpty() ? PropertyName : Name, Settings));
+}
+
+FString FFloorPlanPDFReader::GetValue(const FString& Dictionary, const TCHAR* Key)
+{
+    using namespace FloorPlanPDFReaderPrivate;
+
+    // Keys are only matched at the top level of the dictionary, never inside nested ones or strings
+    const int32 KeyLength = FCString::Strlen(Key);
+    const int32 TopLevel = Dictionary.StartsWith(TEXT("<<")) ? 1 : 0;
+    int32 Nesting = 0;
+    int32 Index = 0;
+    while (Index < Dictionary.Len())
+    {
+        const TCHAR Character = Dictionary[Index];
+        if (Character == TEXT('(') || (Character == TEXT('<') && (Index + 1 >= Dictionary.Len() || Dictionary[Index + 1] != TEXT('<'))))
+        {
+            // Skip strings
+            const TCHAR Close = Character == TEXT('(') ? TEXT(')') : TEXT('>');
+            int32 Depth = 0;
+            for (; Index < Dictionary.Len(); ++Index)
+            {
+                if (Dictionary[Index] == TEXT('\\'))
+                {
+                    ++Index;
+                    continue;
+                }
+                Depth += Dictionary[Index] == Character && Character == TEXT('(') ? 1 : 0;
+                if (Dictionary[Index] == Close && (Close == TEXT('>') || --Depth == 0))
+                {
+                    break;
+                }
+            }
+            ++Index;
+            continue;
+        }
+        if (Dictionary.Mid(Index, 2) == TEXT("<<"))
+        {
+            ++Nesting;
+            Index += 2;
+            continue;
+        }
+        if (Dictionary.Mid(Index, 2) == TEXT(">>"))
+        {
+            --Nesting;
+            Index += 2;
+            continue;
+        }
+
+        const bool bKeyHere = Nesting == TopLevel && Character == TEXT('/') && FCString::Strncmp(*Dictionary + Index, Key, KeyLength) == 0 &&
+                              (Index + KeyLength >= Dictionary.Len() || IsDelimiter(static_cast<uint8>(Dictionary[Index + KeyLength])));
+        if (!bKeyHere)
+        {
+            // Names are skipped whole so a value name like /Pages never matches a key /Page
+            if (Character == TEXT('/'))
+            {
+                ++Index;
+                while (Index < Dictionary.Len() && !IsDelimiter(static_cast<uint8>(Dictionary[Index])))
+                {
+                    ++Index;
+                }
+                continue;
+            }
+            ++Index;
+            continue;
+        }
+
+        // Value: nested dictionary, array, string, name, or a number that may start an "N G R" reference
+        int32 Start = Index + KeyLength;
+        while (Start < Dictionary.Len() && FChar::IsWhitespace(Dictionary[Start]))
+        {
+            ++Start;
+        }
+        if (Start >= Dictionary.Len())
+        {
+            return FString();
+        }
+
+        int32 End = Start;
+        const TCHAR Open = Dictionary[Start];
+        if (Open == TEXT('<') || Open == TEXT('[') || Open == TEXT('('))
+        {
+            const TCHAR Close = Open == TEXT('<') ? TEXT('>') : (Open == TEXT('[') ? TEXT(']') : TEXT(')'));
+            int32 Depth = 0;
+            for (; End < Dictionary.Len(); ++End)
+            {
+                if (Dictionary[End] == TEXT('\\') && Open == TEXT('('))
+                {
+                    ++End;
+                    continue;
+                }
+                Depth += Dictionary[End] == Open ? 1 : (Dictionary[End] == Close ? -1 : 0);
+                if (Depth == 0)
+                {
+                    ++End;
+                    break;
+                }
+            }
+            return Dictionary.Mid(Start, End - Start);
+        }
+
+        End = Open == TEXT('/') ? Start + 1 : Start;
+        while (End < Dictionary.Len() && !IsDelimiter(static_cast<uint8>(Dictionary[End])))
+        {
+            ++End;
+        }
+        FString Value = Dictionary.Mid(Start, End - Start);
+
+        // Indirect reference
+        TArray<FString> Following;
+        Dictionary.Mid(End, 32).ParseIntoArrayWS(Following);
+        if (IsNumeric(Value) && Following.Num() >= 2 && IsNumeric(Following[0]) && Following[1].StartsWith(TEXT("R")))
+        {
+            Value += FString::Printf(TEXT(" %s R"), *Following[0]);
+        }
+        return Value;
+    }
+    return FString();
+}
+
+TArray<int32> FFloorPlanPDFReader::GetReferences(const FString& Value)
+{
+    using namespace FloorPlanPDFReaderPrivate;
+
+    TArray<FString> Parts;
+    Value.Replace(TEXT("["), TEXT(" ")).Replace(TEXT("]"), TEXT(" ")).ParseIntoArrayWS(Parts);
+
+    TArray<int32> References;
+    for (int32 Index = 0; Index + 2 < Parts.Num(); ++Index)
+    {
+        if (IsNumeric(Parts[Index]) && IsNumeric(Parts[Index + 1]) && Parts[Index + 2] == TEXT("R"))
+        {
+            References.Add(FCString::Atoi(*Parts[Index]));
+            Index += 2;
+        }
+    }
+    return References;
+}
+
+bool FFloorPlanPDFReader::Inflate(const uint8* Source, int32 Size, TArray<uint8>& OutData)
+{
+    z_stream Stream;
+    FMemory::Memzero(Stream);
+    if (inflateInit(&Stream) != Z_OK)
+    {
+        return false;
+    }
+
+    Stream.next_in = const_cast<Bytef*>(Source);
+    Stream.avail_in = static_cast<uInt>(Size);
+
+    // Grows the output in steps, content streams typically inflate 4-10x
+    int32 Result = Z_OK;
+    OutData.SetNumUninitialized(FMath::Max(Size * 4, 4096));
+    while (Result == Z_OK)
+    {
+        if (Stream.total_out >= static_cast<uLong>(OutData.Num()))
+        {
+            OutData.SetNumUninitialized(OutData.Num() * 2);
+        }
+        Stream.next_out = OutData.GetData() + Stream.total_out;
+        Stream.avail_out = static_cast<uInt>(OutData.Num() - Stream.total_out);
+        Result = inflate(&Stream, Z_NO_FLUSH);
+    }
+
+    // Truncated or slightly corrupt streams still yield their decoded prefix
+    const int32 Decoded = static_cast<int32>(Stream.total_out);
+    inflateEnd(&Stream);
+    OutData.SetNum(Decoded);
+    return Result == Z_STREAM_END || Decoded > 0;
+}
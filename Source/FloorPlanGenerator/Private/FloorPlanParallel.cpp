@@ -0,0 +1,24 @@
+#include "FloorPlanParallel.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<int32> CVarFloorPlanMaxThreads(
+    TEXT("FloorPlan.MaxThreads"),
+    0,
+    TEXT("Caps the worker threads used by floor plan analysis loops, 0 uses every worker"));
+
+int32 FFloorPlanParallel::GetMaxThreads()
+{
+    return CVarFloorPlanMaxThreads.GetValueOnAnyThread();
+}
+
+void FFloorPlanParallel::SetMaxThreads(int32 MaxThreads)
+{
+    CVarFloorPlanMaxThreads->Set(FMath::Max(0, MaxThreads), ECVF_SetByCode);
+}
+
+int32 FFloorPlanParallel::GetNumWorkers()
+{
+    const int32 NumWorkers = FMath::Max(1, FTaskGraphInterface::Get().GetNumWorkerThreads());
+    const int32 MaxThreads = GetMaxThreads();
+    return MaxThreads > 0 ? FMath::Min(NumWorkers, MaxThreads) : NumWorkers;
+}
@@ -0,0 +1,712 @@
+#include "FloorPlanPolygonUnion.h"
+#include "FloorPlanLog.h"
+#include "Algo/Reverse.h"
+#include "Algo/Sort.h"
+
+namespace FloorPlanPolygonUnionPrivate
+{
+    // Corners sharper than this are bevelled to this miter length, in multiples of the outset
+    constexpr double MaxMiterRatio = 4.0;
+
+    // Rings smaller than this (in grid cells) are rounding slivers
+    constexpr int64 MinRingArea2 = 8;
+
+    struct FGridPoint
+    {
+        int64 X = 0;
+        int64 Y = 0;
+
+        bool operator==(const FGridPoint& Other) const { return X == Other.X && Y == Other.Y; }
+        bool operator!=(const FGridPoint& Other) const { return !(*this == Other); }
+
+        friend uint32 GetTypeHash(const FGridPoint& Point)
+        {
+            return HashCombine(GetTypeHash(Point.X), GetTypeHash(Point.Y));
+        }
+    };
+
+    // Directed edge piece of an input ring, the covered side is on its left
+    struct FEdge
+    {
+        FGridPoint A;
+        FGridPoint B;
+        int32 Ring = INDEX_NONE;
+    };
+
+    // Twice the signed area of A, B, C, positive when C is left of A->B; exact for plan-sized coordinates
+    int64 Orient(const FGridPoint& A, const FGridPoint& B, const FGridPoint& C)
+    {
+        return (B.X - A.X) * (C.Y - A.Y) - (B.Y - A.Y) * (C.X - A.X);
+    }
+
+    bool OnSegment(const FGridPoint& A, const FGridPoint& B, const FGridPoint& Point)
+    {
+        return Orient(A, B, Point) == 0
+            && Point.X >= FMath::Min(A.X, B.X) && Point.X <= FMath::Max(A.X, B.X)
+            && Point.Y >= FMath::Min(A.Y, B.Y) && Point.Y <= FMath::Max(A.Y, B.Y);
+    }
+
+    int64 SignedArea2(const TArray<FGridPoint>& Ring)
+    {
+        int64 Area = 0;
+        for (int32 Index = 0, Previous = Ring.Num() - 1; Index < Ring.Num(); Previous = Index++)
+        {
+            Area += Ring[Previous].X * Ring[Index].Y - Ring[Index].X * Ring[Previous].Y;
+        }
+        return Area;
+    }
+
+    double SignedArea(const TArray<FVector2D>& Ring)
+    {
+        double Area = 0.0;
+        for (int32 Index = 0, Previous = Ring.Num() - 1; Index < Ring.Num(); Previous = Index++)
+        {
+            Area += Ring[Previous].X * Ring[Index].Y - Ring[Index].X * Ring[Previous].Y;
+        }
+        return Area * 0.5;
+    }
+
+    // Crossing test for a point given in half grid steps (coordinates doubled), so edge midpoints stay exact
+    bool ContainsDoubled(const TArray<FGridPoint>& Ring, int64 PointX2, int64 PointY2)
+    {
+        bool bInside = false;
+        for (int32 Index = 0, Previous = Ring.Num() - 1; Index < Ring.Num(); Previous = Index++)
+        {
+            const int64 AX = Ring[Previous].X * 2;
+            const int64 AY = Ring[Previous].Y * 2;
+            const int64 BX = Ring[Index].X * 2;
+            const int64 BY = Ring[Index].Y * 2;
+            if ((AY > PointY2) != (BY > PointY2))
+            {
+                // Point.X < X of the edge at Point.Y, without the division
+                const int64 Lhs = (PointX2 - AX) * (BY - AY);
+                const int64 Rhs = (PointY2 - AY) * (BX - AX);
+                if (BY > AY ? Lhs < Rhs : Lhs > Rhs)
+                {
+                    bInside = !bInside;
+                }
+            }
+        }
+        return bInside;
+    }
+
+    // Drops repeated and collinear points; the ring may shrink below three points
+    void Simplify(TArray<FGridPoint>& Ring)
+    {
+        bool bChanged = true;
+        while (bChanged && Ring.Num() >= 3)
+        {
+            bChanged = false;
+            for (int32 Index = 0; Index < Ring.Num() && Ring.Num() >= 3; )
+            {
+                const FGridPoint& Previous = Ring[(Index + Ring.Num() - 1) % Ring.Num()];
+                const FGridPoint& Next = Ring[(Index + 1) % Ring.Num()];
+                if (Ring[Index] == Previous || Orient(Previous, Ring[Index], Next) == 0)
+                {
+                    Ring.RemoveAt(Index);
+                    bChanged = true;
+                }
+                else
+                {
+                    ++Index;
+                }
+            }
+        }
+    }
+
+    // Moves every edge of a counter-clockwise ring outwards by Outset, corners are mitred
+    TArray<FVector2D> Grow(const TArray<FVector2D>& Ring, double Outset)
+    {
+        const int32 Num = Ring.Num();
+        TArray<FVector2D> Grown;
+        Grown.Reserve(Num);
+        for (int32 Index = 0; Index < Num; ++Index)
+        {
+            const FVector2D& Previous = Ring[(Index + Num - 1) % Num];
+            const FVector2D& Current = Ring[Index];
+            const FVector2D& Next = Ring[(Index + 1) % Num];
+
+            // Outward normals are on the right of a counter-clockwise ring
+            const FVector2D InDirection = (Current - Previous).GetSafeNormal();
+            const FVector2D OutDirection = (Next - Current).GetSafeNormal();
+            const FVector2D InNormal(InDirection.Y, -InDirection.X);
+            const FVector2D OutNormal(OutDirection.Y, -OutDirection.X);
+            const FVector2D Miter = (InNormal + OutNormal).GetSafeNormal();
+            const double Cosine = FVector2D::DotProduct(Miter, OutNormal);
+            Grown.Add(Miter.IsNearlyZero() ? Current + OutNormal * Outset
+                                           : Current + Miter * (Outset / FMath::Max(Cosine, 1.0 / MaxMiterRatio)));
+        }
+        return Grown;
+    }
+
+    // Proper crossing point of two segments rounded to the grid, or the vertices of one lying on the other
+    void AddSplitPoints(const FEdge& E, const FEdge& F, TArray<FGridPoint>& OutOnE, TArray<FGridPoint>& OutOnF)
+    {
+        const int64 EFA = Orient(E.A, E.B, F.A);
+        const int64 EFB = Orient(E.A, E.B, F.B);
+        const int64 FEA = Orient(F.A, F.B, E.A);
+        const int64 FEB = Orient(F.A, F.B, E.B);
+
+        if (((EFA > 0 && EFB < 0) || (EFA < 0 && EFB > 0)) && ((FEA > 0 && FEB < 0) || (FEA < 0 && FEB > 0)))
+        {
+            const double T = static_cast<double>(FEA) / static_cast<double>(FEA - FEB);
+            const FGridPoint Crossing { E.A.X + FMath::RoundToInt64(T * static_cast<double>(E.B.X - E.A.X)),
+                                        E.A.Y + FMath::RoundToInt64(T * static_cast<double>(E.B.Y - E.A.Y)) };
+            OutOnE.Add(Crossing);
+            OutOnF.Add(Crossing);
+            return;
+        }
+
+        // Touching and collinear overlaps
+        if (OnSegment(E.A, E.B, F.A)) { OutOnE.Add(F.A); }
+        if (OnSegment(E.A, E.B, F.B)) { OutOnE.Add(F.B); }
+        if (OnSegment(F.A, F.B, E.A)) { OutOnF.Add(E.A); }
+        if (OnSegment(F.A, F.B, E.B)) { OutOnF.Add(E.B); }
+    }
+
+    // Segment-segment test for the triangulator: true when the open segments cross or one passes through
+    // a vertex of the other
+    bool SegmentsIntersect(const FVector2D& A, const FVector2D& B, const FVector2D& C, const FVector2D& D)
+    {
+        const double ABC = FVector2D::CrossProduct(B - A, C - A);
+        const double ABD = FVector2D::CrossProduct(B - A, D - A);
+        const double CDA = FVector2D::CrossProduct(D - C, A - C);
+        const double CDB = FVector2D::CrossProduct(D - C, B - C);
+        if (((ABC > 0.0 && ABD < 0.0) || (ABC < 0.0 && ABD > 0.0)) && ((CDA > 0.0 && CDB < 0.0) || (CDA < 0.0 && CDB > 0.0)))
+        {
+            return true;
+        }
+
+        auto Between = [](const FVector2D& P, const FVector2D& Q, const FVector2D& Point)
+        {
+            return FVector2D::DotProduct(Point - P, Point - Q) < 0.0;
+        };
+        return (ABC == 0.0 && Between(A, B, C)) || (ABD == 0.0 && Between(A, B, D))
+            || (CDA == 0.0 && Between(C, D, A)) || (CDB == 0.0 && Between(C, D, B));
+    }
+
+    bool ContainsPoint(const TArray<FVector2D>& Ring, const FVector2D& Point)
+    {
+        bool bInside = false;
+        for (int32 Index = 0, Previous = Ring.Num() - 1; Index < Ring.Num(); Previous = Index++)
+        {
+            const FVector2D& A = Ring[Index];
+            const FVector2D& B = Ring[Previous];
+            if ((A.Y > Point.Y) != (B.Y > Point.Y) && Point.X < (B.X - A.X) * (Point.Y - A.Y) / (B.Y - A.Y) + A.X)
+            {
+                bInside = !bInside;
+            }
+        }
+        return bInside;
+    }
+
+    bool InTriangle(const FVector2D& Point, const FVector2D& A, const FVector2D& B, const FVector2D& C)
+    {
+        return FVector2D::CrossProduct(B - A, Point - A) >= 0.0
+            && FVector2D::CrossProduct(C - B, Point - B) >= 0.0
+            && FVector2D::CrossProduct(A - C, Point - C) >= 0.0;
+    }
+}
+
+void FFloorPlanPolygonUnion::Union(const TArray<TArray<FVector2D>>& Footprints, double Outset, TArray<FFloorPlanPolygon>& OutPolygons)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(FFloorPlanPolygonUnion::Union);
+    using namespace FloorPlanPolygonUnionPrivate;
+
+    OutPolygons.Reset();
+
+    // Grow, snap and orient every footprint counter-clockwise; degenerate ones are skipped
+    TArray<TArray<FGridPoint>> Rings;
+    TArray<FBox2D> RingBounds;
+    for (const TArray<FVector2D>& Footprint : Footprints)
+    {
+        if (Footprint.Num() < 3)
+        {
+            continue;
+        }
+
+        TArray<FVector2D> Oriented = Footprint;
+        if (SignedArea(Oriented) < 0.0)
+        {
+            Algo::Reverse(Oriented);
+        }
+        if (Outset != 0.0)
+        {
+            Oriented = Grow(Oriented, Outset);
+        }
+
+        TArray<FGridPoint> Ring;
+        Ring.Reserve(Oriented.Num());
+        FBox2D Bounds(ForceInit);
+        for (const FVector2D& Point : Oriented)
+        {
+            Ring.Add({ FMath::RoundToInt64(Point.X / GridSize), FMath::RoundToInt64(Point.Y / GridSize) });
+            Bounds += FVector2D(static_cast<double>(Ring.Last().X), static_cast<double>(Ring.Last().Y));
+        }
+        Simplify(Ring);
+        if (Ring.Num() < 3 || SignedArea2(Ring) <= 0)
+        {
+            continue;
+        }
+        Rings.Add(MoveTemp(Ring));
+        RingBounds.Add(Bounds);
+    }
+
+    TArray<FEdge> Edges;
+    for (int32 RingIndex = 0; RingIndex < Rings.Num(); ++RingIndex)
+    {
+        const TArray<FGridPoint>& Ring = Rings[RingIndex];
+        for (int32 Index = 0; Index < Ring.Num(); ++Index)
+        {
+            Edges.Add({ Ring[Index], Ring[(Index + 1) % Ring.Num()], RingIndex });
+        }
+    }
+
+    // Split points of every edge: its own ends, crossings and touching vertices. Pairs are found by a
+    // sweep over the edges sorted by their smallest X.
+    TArray<TArray<FGridPoint>> Splits;
+    Splits.SetNum(Edges.Num());
+    TArray<int32> SweepOrder;
+    SweepOrder.SetNumUninitialized(Edges.Num());
+    for (int32 EdgeIndex = 0; EdgeIndex < Edges.Num(); ++EdgeIndex)
+    {
+        SweepOrder[EdgeIndex] = EdgeIndex;
+        Splits[EdgeIndex] = { Edges[EdgeIndex].A, Edges[EdgeIndex].B };
+    }
+    Algo::SortBy(SweepOrder, [&Edges](int32 EdgeIndex) { return FMath::Min(Edges[EdgeIndex].A.X, Edges[EdgeIndex].B.X); });
+
+    for (int32 Position = 0; Position < SweepOrder.Num(); ++Position)
+    {
+        const FEdge& E = Edges[SweepOrder[Position]];
+        const int64 MaxX = FMath::Max(E.A.X, E.B.X);
+        const int64 MinY = FMath::Min(E.A.Y, E.B.Y);
+        const int64 MaxY = FMath::Max(E.A.Y, E.B.Y);
+        for (int32 Other = Position + 1; Other < SweepOrder.Num(); ++Other)
+        {
+            const FEdge& F = Edges[SweepOrder[Other]];
+            if (FMath::Min(F.A.X, F.B.X) > MaxX)
+            {
+                break;
+            }
+            if (FMath::Max(F.A.Y, F.B.Y) < MinY || FMath::Min(F.A.Y, F.B.Y) > MaxY)
+            {
+                continue;
+            }
+            AddSplitPoints(E, F, Splits[SweepOrder[Position]], Splits[SweepOrder[Other]]);
+        }
+    }
+
+    // Edge pieces, grouped by their undirected end points so coincident pieces are classified together
+    TArray<FEdge> Pieces;
+    TMap<TPair<FGridPoint, FGridPoint>, TArray<int32>> PiecesByKey;
+    for (int32 EdgeIndex = 0; EdgeIndex < Edges.Num(); ++EdgeIndex)
+    {
+        const FEdge& Edge = Edges[EdgeIndex];
+        TArray<FGridPoint>& Points = Splits[EdgeIndex];
+        const int64 DX = Edge.B.X - Edge.A.X;
+        const int64 DY = Edge.B.Y - Edge.A.Y;
+        Algo::SortBy(Points, [&Edge, DX, DY](const FGridPoint& Point) { return (Point.X - Edge.A.X) * DX + (Point.Y - Edge.A.Y) * DY; });
+
+        for (int32 Index = 0; Index + 1 < Points.Num(); ++Index)
+        {
+            if (Points[Index] == Points[Index + 1])
+            {
+                continue;
+            }
+
+            const FEdge Piece { Points[Index], Points[Index + 1], Edge.Ring };
+            const bool bOrdered = Piece.A.X < Piece.B.X || (Piece.A.X == Piece.B.X && Piece.A.Y < Piece.B.Y);
+            const TPair<FGridPoint, FGridPoint> Key = bOrdered ? MakeTuple(Piece.A, Piece.B) : MakeTuple(Piece.B, Piece.A);
+            PiecesByKey.FindOrAdd(Key).Add(Pieces.Add(Piece));
+        }
+    }
+
+    // A piece is on the union boundary when its right side is covered by no other footprint. Coincident
+    // pieces in opposite directions are a shared boundary with coverage on both sides.
+    TArray<FEdge> Boundary;
+    TArray<int32> GroupRings;
+    for (const TPair<TPair<FGridPoint, FGridPoint>, TArray<int32>>& Group : PiecesByKey)
+    {
+        bool bForward = false;
+        bool bBackward = false;
+        GroupRings.Reset();
+        for (int32 PieceIndex : Group.Value)
+        {
+            if (Pieces[PieceIndex].A == Group.Key.Key)
+            {
+                bForward = true;
+            }
+            else
+            {
+                bBackward = true;
+            }
+            GroupRings.AddUnique(Pieces[PieceIndex].Ring);
+        }
+        if (bForward && bBackward)
+        {
+            continue;
+        }
+
+        const FEdge& Piece = Pieces[Group.Value[0]];
+        const int64 MidX2 = Piece.A.X + Piece.B.X;
+        const int64 MidY2 = Piece.A.Y + Piece.B.Y;
+        const FVector2D Mid(MidX2 * 0.5, MidY2 * 0.5);
+        bool bCovered = false;
+        for (int32 RingIndex = 0; RingIndex < Rings.Num() && !bCovered; ++RingIndex)
+        {
+            bCovered = !GroupRings.Contains(RingIndex) && RingBounds[RingIndex].IsInside(Mid) && ContainsDoubled(Rings[RingIndex], MidX2, MidY2);
+        }
+        if (!bCovered)
+        {
+            Boundary.Add(Piece);
+        }
+    }
+
+    // Link the boundary into rings; at a vertex shared by several rings the sharpest left turn keeps
+    // each ring to its own region
+    TMap<FGridPoint, TArray<int32>> Outgoing;
+    for (int32 EdgeIndex = 0; EdgeIndex < Boundary.Num(); ++EdgeIndex)
+    {
+        Outgoing.FindOrAdd(Boundary[EdgeIndex].A).Add(EdgeIndex);
+    }
+
+    TArray<TArray<FGridPoint>> Outers;
+    TArray<TArray<FGridPoint>> Holes;
+    TBitArray<> Used(false, Boundary.Num());
+    int32 NumOpen = 0;
+    for (int32 Start = 0; Start < Boundary.Num(); ++Start)
+    {
+        if (Used[Start])
+        {
+            continue;
+        }
+
+        TArray<FGridPoint> Ring;
+        int32 Edge = Start;
+        bool bClosed = false;
+        while (true)
+        {
+            Used[Edge] = true;
+            Ring.Add(Boundary[Edge].A);
+
+            const FVector2D In(static_cast<double>(Boundary[Edge].B.X - Boundary[Edge].A.X), static_cast<double>(Boundary[Edge].B.Y - Boundary[Edge].A.Y));
+            int32 Next = INDEX_NONE;
+            double BestTurn = -UE_DOUBLE_BIG_NUMBER;
+            const TArray<int32>* Candidates = Outgoing.Find(Boundary[Edge].B);
+            for (int32 Candidate : Candidates ? *Candidates : TArray<int32>())
+            {
+                if (Used[Candidate] && Candidate != Start)
+                {
+                    continue;
+                }
+                const FVector2D Out(static_cast<double>(Boundary[Candidate].B.X - Boundary[Candidate].A.X), static_cast<double>(Boundary[Candidate].B.Y - Boundary[Candidate].A.Y));
+                const double Turn = FMath::Atan2(FVector2D::CrossProduct(In, Out), FVector2D::DotProduct(In, Out));
+                if (Turn > BestTurn)
+                {
+                    BestTurn = Turn;
+                    Next = Candidate;
+                }
+            }
+
+            if (Next == Start)
+            {
+                bClosed = true;
+                break;
+            }
+            if (Next == INDEX_NONE)
+            {
+                break;
+            }
+            Edge = Next;
+        }
+
+        Simplify(Ring);
+        const int64 Area2 = Ring.Num() >= 3 ? SignedArea2(Ring) : 0;
+        if (!bClosed)
+        {
+            ++NumOpen;
+        }
+        else if (Area2 >= MinRingArea2)
+        {
+            Outers.Add(MoveTemp(Ring));
+        }
+        else if (Area2 <= -MinRingArea2)
+        {
+            Holes.Add(MoveTemp(Ring));
+        }
+    }
+    if (NumOpen > 0)
+    {
+        UE_LOG(LogFloorPlan, Warning, TEXT("FloorPlanPolygonUnion: Dropped %d open boundary chains, footprints may self-intersect"), NumOpen);
+    }
+
+    auto ToPlan = [](const TArray<FGridPoint>& Ring)
+    {
+        TArray<FVector2D> Points;
+        Points.Reserve(Ring.Num());
+        for (const FGridPoint& Point : Ring)
+        {
+            Points.Add(FVector2D(Point.X * GridSize, Point.Y * GridSize));
+        }
+        return Points;
+    };
+
+    TArray<int64> OuterAreas;
+    for (const TArray<FGridPoint>& Outer : Outers)
+    {
+        OutPolygons.AddDefaulted_GetRef().Outer = ToPlan(Outer);
+        OuterAreas.Add(SignedArea2(Outer));
+    }
+
+    // Each hole belongs to the smallest outer ring around a point just inside it, half a grid step to the
+    // right of its first edge's midpoint
+    for (const TArray<FGridPoint>& Hole : Holes)
+    {
+        const FGridPoint& A = Hole[0];
+        const FGridPoint& B = Hole[1];
+        const int64 PointX2 = A.X + B.X + FMath::Sign(B.Y - A.Y);
+        const int64 PointY2 = A.Y + B.Y - FMath::Sign(B.X - A.X);
+
+        int32 Owner = INDEX_NONE;
+        for (int32 OuterIndex = 0; OuterIndex < Outers.Num(); ++OuterIndex)
+        {
+            if ((Owner == INDEX_NONE || OuterAreas[OuterIndex] < OuterAreas[Owner]) && ContainsDoubled(Outers[OuterIndex], PointX2, PointY2))
+            {
+                Owner = OuterIndex;
+            }
+        }
+        if (Owner != INDEX_NONE)
+        {
+            OutPolygons[Owner].Holes.Add(ToPlan(Hole));
+        }
+    }
+
+    UE_LOG(LogFloorPlan, Verbose, TEXT("FloorPlanPolygonUnion: %d footprints -> %d polygons with %d holes (%d edges, %d pieces)"),
+           Footprints.Num(), Outers.Num(), Holes.Num(), Edges.Num(), Pieces.Num());
+}
+
+bool FFloorPlanPolygonUnion::Triangulate(const FFloorPlanPolygon& Polygon, TArray<FVector2D>& OutVertices, TArray<int32>& OutTriangles)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(FFloorPlanPolygonUnion::Triangulate);
+    using namespace FloorPlanPolygonUnionPrivate;
+
+    OutVertices.Reset();
+    OutTriangles.Reset();
+    if (Polygon.Outer.Num() < 3)
+    {
+        return false;
+    }
+
+    OutVertices.Append(Polygon.Outer);
+    TArray<int32> HoleStarts;
+    for (const TArray<FVector2D>& Hole : Polygon.Holes)
+    {
+        HoleStarts.Add(OutVertices.Num());
+        OutVertices.Append(Hole);
+    }
+
+    // Working ring of vertex indices, holes are spliced in by bridges
+    TArray<int32> Ring;
+    Ring.Reserve(OutVertices.Num() + Polygon.Holes.Num() * 2);
+    for (int32 Index = 0; Index < Polygon.Outer.Num(); ++Index)
+    {
+        Ring.Add(Index);
+    }
+
+    // Rightmost holes first, each bridged from its rightmost vertex to the nearest ring vertex it sees
+    TArray<int32> HoleOrder;
+    TArray<int32> HoleRightmost;
+    for (int32 HoleIndex = 0; HoleIndex < Polygon.Holes.Num(); ++HoleIndex)
+    {
+        HoleOrder.Add(HoleIndex);
+        int32 Rightmost = 0;
+        for (int32 Index = 1; Index < Polygon.Holes[HoleIndex].Num(); ++Index)
+        {
+            if (Polygon.Holes[HoleIndex][Index].X > Polygon.Holes[HoleIndex][Rightmost].X)
+            {
+                Rightmost = Index;
+            }
+        }
+        HoleRightmost.Add(Rightmost);
+    }
+    Algo::SortBy(HoleOrder, [&](int32 HoleIndex) { return -Polygon.Holes[HoleIndex][HoleRightmost[HoleIndex]].X; });
+
+    TBitArray<> Bridged(false, Polygon.Holes.Num());
+    for (int32 HoleIndex : HoleOrder)
+    {
+        const TArray<FVector2D>& Hole = Polygon.Holes[HoleIndex];
+        if (Hole.Num() < 3)
+        {
+            continue;
+        }
+        const FVector2D& M = Hole[HoleRightmost[HoleIndex]];
+
+        // A bridge may not cross the ring or any hole, and must run inside the polygon
+        auto IsVisible = [&](const FVector2D& Target)
+        {
+            for (int32 Index = 0; Index < Ring.Num(); ++Index)
+            {
+                const FVector2D& A = OutVertices[Ring[Index]];
+                const FVector2D& B = OutVertices[Ring[(Index + 1) % Ring.Num()]];
+                if (!A.Equals(Target, 0.0) && !B.Equals(Target, 0.0) && SegmentsIntersect(M, Target, A, B))
+                {
+                    return false;
+                }
+            }
+            for (int32 Other = 0; Other < Polygon.Holes.Num(); ++Other)
+            {
+                if (Bridged[Other])
+                {
+                    continue;
+                }
+                const TArray<FVector2D>& OtherHole = Polygon.Holes[Other];
+                for (int32 Index = 0; Index < OtherHole.Num(); ++Index)
+                {
+                    const FVector2D& A = OtherHole[Index];
+                    const FVector2D& B = OtherHole[(Index + 1) % OtherHole.Num()];
+                    if (!A.Equals(M, 0.0) && !B.Equals(M, 0.0) && SegmentsIntersect(M, Target, A, B))
+                    {
+                        return false;
+                    }
+                }
+            }
+
+            const FVector2D Mid = (M + Target) * 0.5;
+            if (!ContainsPoint(Polygon.Outer, Mid))
+            {
+                return false;
+            }
+            for (const TArray<FVector2D>& OtherHole : Polygon.Holes)
+            {
+                if (ContainsPoint(OtherHole, Mid))
+                {
+                    return false;
+                }
+            }
+            return true;
+        };
+
+        int32 Best = INDEX_NONE;
+        double BestDistance = UE_DOUBLE_BIG_NUMBER;
+        for (int32 Index = 0; Index < Ring.Num(); ++Index)
+        {
+            const double Distance = FVector2D::DistSquared(OutVertices[Ring[Index]], M);
+            if (Distance < BestDistance && IsVisible(OutVertices[Ring[Index]]))
+            {
+                Best = Index;
+                BestDistance = Distance;
+            }
+        }
+        if (Best == INDEX_NONE)
+        {
+            UE_LOG(LogFloorPlan, Warning, TEXT("FloorPlanPolygonUnion: No bridge found for a hole with %d points, it is left out"), Hole.Num());
+            continue;
+        }
+
+        // Ring ... V, M, hole ..., M, V ...
+        TArray<int32> Splice;
+        Splice.Reserve(Hole.Num() + 2);
+        for (int32 Step = 0; Step <= Hole.Num(); ++Step)
+        {
+            Splice.Add(HoleStarts[HoleIndex] + (HoleRightmost[HoleIndex] + Step) % Hole.Num());
+        }
+        Splice.Add(Ring[Best]);
+        Ring.Insert(Splice, Best + 1);
+        Bridged[HoleIndex] = true;
+    }
+
+    // Ear clipping over a linked list of ring positions
+    const int32 Num = Ring.Num();
+    TArray<int32> Previous;
+    TArray<int32> Next;
+    Previous.SetNumUninitialized(Num);
+    Next.SetNumUninitialized(Num);
+    for (int32 Index = 0; Index < Num; ++Index)
+    {
+        Previous[Index] = (Index + Num - 1) % Num;
+        Next[Index] = (Index + 1) % Num;
+    }
+
+    auto Corner = [&](int32 Position) { return OutVertices[Ring[Position]]; };
+    auto Turn = [&](int32 Position)
+    {
+        return FVector2D::CrossProduct(Corner(Position) - Corner(Previous[Position]), Corner(Next[Position]) - Corner(Position));
+    };
+    auto IsEar = [&](int32 Position)
+    {
+        if (Turn(Position) <= 0.0)
+        {
+            return false;
+        }
+        const FVector2D A = Corner(Previous[Position]);
+        const FVector2D B = Corner(Position);
+        const FVector2D C = Corner(Next[Position]);
+        for (int32 Other = Next[Next[Position]]; Other != Previous[Position]; Other = Next[Other])
+        {
+            const FVector2D P = Corner(Other);
+            if (!P.Equals(A, 0.0) && !P.Equals(B, 0.0) && !P.Equals(C, 0.0) && InTriangle(P, A, B, C))
+            {
+                return false;
+            }
+        }
+        return true;
+    };
+    auto Remove = [&](int32 Position)
+    {
+        Next[Previous[Position]] = Next[Position];
+        Previous[Next[Position]] = Previous[Position];
+    };
+
+    OutTriangles.Reserve((Num - 2) * 3);
+    int32 Remaining = Num;
+    int32 Position = 0;
+    int32 Stalled = 0;
+    while (Remaining > 3)
+    {
+        if (IsEar(Position))
+        {
+            OutTriangles.Add(Ring[Previous[Position]]);
+            OutTriangles.Add(Ring[Position]);
+            OutTriangles.Add(Ring[Next[Position]]);
+            Remove(Position);
+            --Remaining;
+            Stalled = 0;
+            Position = Next[Position];
+            continue;
+        }
+
+        Position = Next[Position];
+        if (++Stalled <= Remaining)
+        {
+            continue;
+        }
+
+        // No ear left: a zero-area spike (collinear corner or a bridge doubling back) is cut without a triangle
+        int32 Spike = INDEX_NONE;
+        for (int32 Candidate = Position, Step = 0; Step < Remaining && Spike == INDEX_NONE; Candidate = Next[Candidate], ++Step)
+        {
+            const double Scale = FVector2D::Distance(Corner(Previous[Candidate]), Corner(Candidate)) * FVector2D::Distance(Corner(Candidate), Corner(Next[Candidate]));
+            if (FMath::Abs(Turn(Candidate)) <= UE_KINDA_SMALL_NUMBER * Scale)
+            {
+                Spike = Candidate;
+            }
+        }
+        if (Spike == INDEX_NONE)
+        {
+            UE_LOG(LogFloorPlan, Warning, TEXT("FloorPlanPolygonUnion: Ear clipping stalled with %d of %d corners left"), Remaining, Num);
+            return false;
+        }
+        Position = Next[Spike];
+        Remove(Spike);
+        --Remaining;
+        Stalled = 0;
+    }
+
+    if (Turn(Position) > 0.0)
+    {
+        OutTriangles.Add(Ring[Previous[Position]]);
+        OutTriangles.Add(Ring[Position]);
+        OutTriangles.Add(Ring[Next[Position]]);
+    }
+    return OutTriangles.Num() > 0;
+}
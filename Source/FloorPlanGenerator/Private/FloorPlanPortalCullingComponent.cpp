@@ -0,0 +1,122 @@
+#include "FloorPlanPortalCullingComponent.h"
+#include "FloorPlanLog.h"
+#include "Components/PrimitiveComponent.h"
+#include "Camera/PlayerCameraManager.h"
+#include "GameFramework/PlayerController.h"
+#include "Engine/World.h"
+
+UFloorPlanPortalCullingComponent::UFloorPlanPortalCullingComponent()
+{
+    PrimaryComponentTick.bCanEverTick = true;
+    PrimaryComponentTick.TickGroup = TG_PostUpdateWork;
+}
+
+void UFloorPlanPortalCullingComponent::SetPortalGraph(const FFloorPlanPortalGraph& InGraph)
+{
+    // Whatever the old graph hid is shown again before its cells are forgotten
+    SetCullingEnabled(false);
+    Graph = InGraph;
+    CellPrimitives.Reset();
+    CellPrimitives.SetNum(Graph.Cells.Num());
+    AppliedVisibility.Init(true, Graph.Cells.Num());
+    NumVisibleCells = Graph.Cells.Num();
+    bCullingEnabled = true;
+}
+
+void UFloorPlanPortalCullingComponent::RegisterCellPrimitive(int32 Cell, UPrimitiveComponent* Primitive)
+{
+    if (!Primitive || !CellPrimitives.IsValidIndex(Cell))
+    {
+        UE_LOG(LogFloorPlan, Warning, TEXT("FloorPlanPortalCullingComponent: Invalid cell %d or primitive"), Cell);
+        return;
+    }
+    CellPrimitives[Cell].AddUnique(Primitive);
+    Primitive->SetVisibility(AppliedVisibility[Cell]);
+}
+
+int32 UFloorPlanPortalCullingComponent::AssignPrimitivesToCells(const TArray<UPrimitiveComponent*>& Primitives)
+{
+    int32 NumAssigned = 0;
+    for (UPrimitiveComponent* Primitive : Primitives)
+    {
+        if (!Primitive)
+        {
+            continue;
+        }
+
+        const int32 Cell = Graph.FindCell(FVector2D(Primitive->Bounds.Origin));
+        if (Cell != INDEX_NONE)
+        {
+            RegisterCellPrimitive(Cell, Primitive);
+            ++NumAssigned;
+        }
+    }
+
+    UE_LOG(LogFloorPlan, Log, TEXT("FloorPlanPortalCullingComponent: Assigned %d of %d primitives to %d cells"),
+           NumAssigned, Primitives.Num(), Graph.Cells.Num());
+    return NumAssigned;
+}
+
+void UFloorPlanPortalCullingComponent::SetCullingEnabled(bool bEnabled)
+{
+    bCullingEnabled = bEnabled;
+    if (!bEnabled)
+    {
+        TBitArray<> AllVisible(true, Graph.Cells.Num());
+        ApplyVisibility(AllVisible);
+    }
+}
+
+void UFloorPlanPortalCullingComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+    Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+    TRACE_CPUPROFILER_EVENT_SCOPE(UFloorPlanPortalCullingComponent::TickComponent);
+
+    const APlayerController* PlayerController = GetWorld() ? GetWorld()->GetFirstPlayerController() : nullptr;
+    const APlayerCameraManager* Camera = PlayerController ? PlayerController->PlayerCameraManager.Get() : nullptr;
+    if (!bCullingEnabled || !Camera || Graph.Cells.Num() == 0)
+    {
+        return;
+    }
+
+    // Half the horizontal field of view plus a 50% margin, so portals at the screen edge are never culled early
+    const FVector Eye = Camera->GetCameraLocation();
+    const float HalfFov = FMath::Min(Camera->GetFOVAngle() * 0.75f, 179.0f);
+
+    TBitArray<> Visible;
+    if (!Graph.FindVisibleCells(FVector2D(Eye), Camera->GetCameraRotation().Yaw, HalfFov, Visible))
+    {
+        // Outside the building every room may be seen through the exterior openings
+        Visible.Init(true, Graph.Cells.Num());
+    }
+    ApplyVisibility(Visible);
+}
+
+void UFloorPlanPortalCullingComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    SetCullingEnabled(false);
+    Super::EndPlay(EndPlayReason);
+}
+
+void UFloorPlanPortalCullingComponent::ApplyVisibility(const TBitArray<>& Visible)
+{
+    NumVisibleCells = 0;
+    for (int32 Cell = 0; Cell < CellPrimitives.Num() && Cell < Visible.Num(); ++Cell)
+    {
+        const bool bVisible = Visible[Cell];
+        NumVisibleCells += bVisible ? 1 : 0;
+        if (AppliedVisibility[Cell] == bVisible)
+        {
+            continue;
+        }
+
+        AppliedVisibility[Cell] = bVisible;
+        for (const TWeakObjectPtr<UPrimitiveComponent>& Primitive : CellPrimitives[Cell])
+        {
+            if (Primitive.IsValid())
+            {
+                Primitive->SetVisibility(bVisible);
+            }
+        }
+    }
+}
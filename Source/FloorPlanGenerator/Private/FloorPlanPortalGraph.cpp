@@ -0,0 +1,202 @@
+#include "FloorPlanPortalGraph.h"
+#include "FloorPlanLog.h"
+#include "FloorPlanAnalyzer.h"
+#include "FloorPlanSpatialIndex.h"
+
+namespace FloorPlanPortalGraphPrivate
+{
+    // Openings farther than this from every wall are oriented by their own rotation
+    constexpr float HostWallSearchDistance = 100.0f;
+
+    // Closer than this to a portal the eye counts as standing in it, so the cone passes unchanged
+    constexpr float PortalNearDistance = 30.0f;
+
+    // Bounds the traversal on plans with many cycles, cells are still marked on every path
+    constexpr int32 MaxPortalDepth = 16;
+    constexpr int32 MaxTraversalSteps = 4096;
+
+    bool ContainsPoint(const TArray<FVector2D>& Polygon, const FVector2D& Point)
+    {
+        bool bInside = false;
+        for (int32 Index = 0, Previous = Polygon.Num() - 1; Index < Polygon.Num(); Previous = Index++)
+        {
+            const FVector2D& A = Polygon[Index];
+            const FVector2D& B = Polygon[Previous];
+            if ((A.Y > Point.Y) != (B.Y > Point.Y) && Point.X < (B.X - A.X) * (Point.Y - A.Y) / (B.Y - A.Y) + A.X)
+            {
+                bInside = !bInside;
+            }
+        }
+        return bInside;
+    }
+
+    // Angle of Point seen from Eye, relative to the view direction, in (-PI, PI]
+    double GetViewAngle(const FVector2D& Eye, double ViewYaw, const FVector2D& Point)
+    {
+        const FVector2D Direction = Point - Eye;
+        return FMath::UnwindRadians(FMath::Atan2(Direction.Y, Direction.X) - ViewYaw);
+    }
+}
+
+void FFloorPlanPortalGraph::Build(const FFloorPlanAnalysisResult& Result, float WallThickness)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(FFloorPlanPortalGraph::Build);
+    using namespace FloorPlanPortalGraphPrivate;
+
+    Cells.Reset();
+    Portals.Reset();
+
+    // Cell indices are room indices
+    for (const FRoomData& Room : Result.Rooms)
+    {
+        FFloorPlanCell& Cell = Cells.AddDefaulted_GetRef();
+        Cell.RoomName = Room.RoomName;
+        Cell.Boundary = Room.BoundaryPoints;
+        if (Cell.Boundary.Num() < 3)
+        {
+            const FVector2D HalfSize = Room.Dimensions * 0.5;
+            Cell.Boundary = { Room.Center - HalfSize, FVector2D(Room.Center.X + HalfSize.X, Room.Center.Y - HalfSize.Y),
+                              Room.Center + HalfSize, FVector2D(Room.Center.X - HalfSize.X, Room.Center.Y + HalfSize.Y) };
+        }
+        Cell.Bounds = FBox2D(Cell.Boundary);
+    }
+
+    const TArray<FOpeningData>& Openings = Result.Openings;
+    const TArray<FWallSegmentData>& Walls = Result.WallSegments;
+    const FFloorPlanSpatialIndex& SpatialIndex = Result.GetSpatialIndex();
+    TArray<int32> Hosts;
+    SpatialIndex.AssignOpeningsToWalls(HostWallSearchDistance, Hosts);
+    for (int32 OpeningIndex = 0; OpeningIndex < Openings.Num(); ++OpeningIndex)
+    {
+        const FOpeningData& Opening = Openings[OpeningIndex];
+
+        // The portal lies along the host wall, or along the opening's own rotation without one
+        FVector2D Center = Opening.Position;
+        FVector2D Direction(FMath::Cos(FMath::DegreesToRadians(Opening.Rotation)), FMath::Sin(FMath::DegreesToRadians(Opening.Rotation)));
+        float Thickness = WallThickness;
+        if (Walls.IsValidIndex(Hosts[OpeningIndex]))
+        {
+            // Gap openings lie beyond the host's end, so project onto the wall line rather than the segment
+            const FWallSegmentData& Wall = Walls[Hosts[OpeningIndex]];
+            Direction = (Wall.End - Wall.Start).GetSafeNormal();
+            Center = Wall.Start + Direction * FVector2D::DotProduct(Opening.Position - Wall.Start, Direction);
+            Thickness = Wall.Thickness > 0.0f ? Wall.Thickness : WallThickness;
+        }
+        const FVector2D Normal(-Direction.Y, Direction.X);
+        const double Probe = FMath::Max(Thickness, static_cast<float>(Opening.Size.Y));
+
+        const int32 CellA = SpatialIndex.FindRoomAt(Center + Normal * Probe);
+        const int32 CellB = SpatialIndex.FindRoomAt(Center - Normal * Probe);
+        if (CellA == CellB)
+        {
+            continue;
+        }
+
+        const int32 PortalIndex = Portals.AddDefaulted();
+        FFloorPlanPortal& Portal = Portals[PortalIndex];
+        Portal.CellA = CellA;
+        Portal.CellB = CellB;
+        Portal.Start = Center - Direction * Opening.Size.X * 0.5;
+        Portal.End = Center + Direction * Opening.Size.X * 0.5;
+        Portal.bIsDoor = Opening.bIsDoor;
+        Portal.Opening = OpeningIndex;
+        for (int32 Cell : { CellA, CellB })
+        {
+            if (Cells.IsValidIndex(Cell))
+            {
+                Cells[Cell].Portals.Add(PortalIndex);
+            }
+        }
+    }
+
+    UE_LOG(LogFloorPlan, Log, TEXT("FloorPlanPortalGraph: Built %d cells and %d portals from %d openings"),
+           Cells.Num(), Portals.Num(), Openings.Num());
+}
+
+int32 FFloorPlanPortalGraph::FindCell(const FVector2D& Point) const
+{
+    using namespace FloorPlanPortalGraphPrivate;
+
+    // Room counts per floor are small, a bounds test in front of the polygon test is enough
+    for (int32 CellIndex = 0; CellIndex < Cells.Num(); ++CellIndex)
+    {
+        const FFloorPlanCell& Cell = Cells[CellIndex];
+        if (Cell.Bounds.IsInside(Point) && ContainsPoint(Cell.Boundary, Point))
+        {
+            return CellIndex;
+        }
+    }
+    return INDEX_NONE;
+}
+
+bool FFloorPlanPortalGraph::FindVisibleCells(const FVector2D& Eye, float ViewYawDegrees, float HalfFovDegrees, TBitArray<>& OutVisible) const
+{
+    using namespace FloorPlanPortalGraphPrivate;
+
+    OutVisible.Init(false, Cells.Num());
+    const int32 EyeCell = FindCell(Eye);
+    if (EyeCell == INDEX_NONE)
+    {
+        return false;
+    }
+
+    struct FStep
+    {
+        int32 Cell;
+        int32 FromPortal;
+        int32 Depth;
+        double MinAngle;
+        double MaxAngle;
+    };
+
+    const double ViewYaw = FMath::DegreesToRadians(ViewYawDegrees);
+    const double HalfFov = FMath::DegreesToRadians(FMath::Clamp(HalfFovDegrees, 1.0f, 179.0f));
+    const double NearDistanceSq = FMath::Square(PortalNearDistance);
+
+    TArray<FStep, TInlineAllocator<32>> Stack;
+    Stack.Add({ EyeCell, INDEX_NONE, 0, -HalfFov, HalfFov });
+    OutVisible[EyeCell] = true;
+
+    int32 NumSteps = 0;
+    while (Stack.Num() > 0 && NumSteps++ < MaxTraversalSteps)
+    {
+        const FStep Step = Stack.Pop();
+        if (Step.Depth >= MaxPortalDepth)
+        {
+            continue;
+        }
+
+        for (int32 PortalIndex : Cells[Step.Cell].Portals)
+        {
+            const FFloorPlanPortal& Portal = Portals[PortalIndex];
+            const int32 Next = Portal.CellA == Step.Cell ? Portal.CellB : Portal.CellA;
+            if (PortalIndex == Step.FromPortal || !Cells.IsValidIndex(Next))
+            {
+                continue;
+            }
+
+            // Narrow the cone to the portal's angular extent; a portal spanning more than half a turn lies behind the eye
+            double MinAngle = Step.MinAngle;
+            double MaxAngle = Step.MaxAngle;
+            if (FVector2D::DistSquared(Eye, FMath::ClosestPointOnSegment2D(Eye, Portal.Start, Portal.End)) > NearDistanceSq)
+            {
+                const double AngleA = GetViewAngle(Eye, ViewYaw, Portal.Start);
+                const double AngleB = GetViewAngle(Eye, ViewYaw, Portal.End);
+                if (FMath::Abs(AngleA - AngleB) >= PI)
+                {
+                    continue;
+                }
+                MinAngle = FMath::Max(MinAngle, FMath::Min(AngleA, AngleB));
+                MaxAngle = FMath::Min(MaxAngle, FMath::Max(AngleA, AngleB));
+            }
+            if (MinAngle >= MaxAngle)
+            {
+                continue;
+            }
+
+            OutVisible[Next] = true;
+            Stack.Add({ Next, PortalIndex, Step.Depth + 1, MinAngle, MaxAngle });
+        }
+    }
+    return true;
+}
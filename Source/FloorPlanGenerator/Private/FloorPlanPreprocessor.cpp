@@ -0,0 +1,443 @@
+#include "FloorPlanPreprocessor.h"
+#include "FloorPlanLog.h"
+#include "FloorPlanProfile.h"
+#include "FloorPlanMask.h"
+#include "FloorPlanStripReader.h"
+#include "FloorPlanIntegralImage.h"
+#include "FloorPlanParallel.h"
+
+namespace FloorPlanPreprocessorPrivate
+{
+    // Rows thresholded per band; the band's integral images cover it plus half a window above and below
+    constexpr int32 BandRows = 512;
+
+    // Wall pixels sampled for the skew search, enough for a stable profile on any plan
+    constexpr int64 MaxSkewSamples = 1 << 20;
+
+    // Coarse step over the full skew range, then a fine search around the best coarse angle
+    constexpr float CoarseSkewStepDegrees = 0.5f;
+    constexpr float FineSkewStepDegrees = 0.05f;
+
+    // Structuring elements larger than this are not worth the bit shifts, real specks are smaller
+    constexpr int32 MaxMorphologyRadius = 16;
+
+    // Wall bits of one mask row packed into 64-bit words, bit X % 64 of word X / 64
+    struct FBitRows
+    {
+        int32 Width = 0;
+        int32 Height = 0;
+        int32 Words = 0;
+        TArray64<uint64> Bits;
+
+        void Init(int32 InWidth, int32 InHeight)
+        {
+            Width = InWidth;
+            Height = InHeight;
+            Words = FMath::DivideAndRoundUp(Width, 64);
+            Bits.SetNumZeroed(static_cast<int64>(Words) * Height);
+        }
+
+        uint64* Row(int32 Y) { return Bits.GetData() + static_cast<int64>(Y) * Words; }
+        const uint64* Row(int32 Y) const { return Bits.GetData() + static_cast<int64>(Y) * Words; }
+
+        // Bits past the image width in the last word, cleared so they never leak into a neighbour
+        uint64 TailMask() const { return Width % 64 == 0 ? ~0ull : (1ull << (Width % 64)) - 1; }
+    };
+
+    // Word W of the row moved K pixels towards higher X (Up) or lower X (Down), zeros shifted in
+    uint64 ShiftUp(const uint64* Row, int32 Word, int32 K)
+    {
+        return (Row[Word] << K) | (Word > 0 ? Row[Word - 1] >> (64 - K) : 0);
+    }
+
+    uint64 ShiftDown(const uint64* Row, int32 Word, int32 Words, int32 K)
+    {
+        return (Row[Word] >> K) | (Word + 1 < Words ? Row[Word + 1] << (64 - K) : 0);
+    }
+
+    // Separable square dilation (bDilate) or erosion; pixels outside the image count as background
+    void MorphologyPass(const FBitRows& Source, FBitRows& Scratch, FBitRows& Dest, int32 Radius, bool bDilate)
+    {
+        const uint64 TailMask = Source.TailMask();
+
+        // Horizontal: 64 pixels per word operation
+        FFloorPlanParallel::For(Source.Height, [&](int32 Y)
+        {
+            const uint64* In = Source.Row(Y);
+            uint64* Out = Scratch.Row(Y);
+            for (int32 Word = 0; Word < Source.Words; ++Word)
+            {
+                uint64 Value = In[Word];
+                for (int32 K = 1; K <= Radius; ++K)
+                {
+                    const uint64 Up = ShiftUp(In, Word, K);
+                    const uint64 Down = ShiftDown(In, Word, Source.Words, K);
+                    Value = bDilate ? (Value | Up | Down) : (Value & Up & Down);
+                }
+                Out[Word] = Value;
+            }
+            Out[Source.Words - 1] &= TailMask;
+        });
+
+        // Vertical: whole words of the rows above and below
+        FFloorPlanParallel::For(Source.Height, [&](int32 Y)
+        {
+            uint64* Out = Dest.Row(Y);
+            FMemory::Memcpy(Out, Scratch.Row(Y), Source.Words * sizeof(uint64));
+            for (int32 K = 1; K <= Radius; ++K)
+            {
+                const uint64* Above = Y - K >= 0 ? Scratch.Row(Y - K) : nullptr;
+                const uint64* Below = Y + K < Source.Height ? Scratch.Row(Y + K) : nullptr;
+                for (int32 Word = 0; Word < Source.Words; ++Word)
+                {
+                    const uint64 A = Above ? Above[Word] : 0;
+                    const uint64 B = Below ? Below[Word] : 0;
+                    Out[Word] = bDilate ? (Out[Word] | A | B) : (Out[Word] & A & B);
+                }
+            }
+        });
+    }
+}
+
+FFloorPlanPreprocessor::FFloorPlanPreprocessor(const FFloorPlanPreprocessSettings& InSettings)
+    : Settings(InSettings)
+{
+    Settings.WindowSize = FMath::Max(3, Settings.WindowSize | 1);
+}
+
+int64 FFloorPlanPreprocessor::EstimateWorkingBytes(int32 Width, int32 Height, const FFloorPlanPreprocessSettings& Settings)
+{
+    using namespace FloorPlanPreprocessorPrivate;
+
+    const int64 Pixels = static_cast<int64>(Width) * Height;
+    int64 Bytes = Pixels;
+    if (Settings.bDeskew)
+    {
+        Bytes += Pixels;
+    }
+    if (Settings.Method != EFloorPlanThresholdMethod::Global)
+    {
+        // Sum and sum of squares, 8 bytes per entry each
+        Bytes += 2 * (static_cast<int64>(Width) + 1) * (BandRows + Settings.WindowSize + 1) * sizeof(uint64);
+    }
+    if (Settings.OpenRadius > 0 || Settings.CloseRadius > 0)
+    {
+        // Three bit planes: source, scratch and destination
+        Bytes += 3 * static_cast<int64>(FMath::DivideAndRoundUp(Width, 64)) * Height * sizeof(uint64);
+    }
+    return Bytes;
+}
+
+bool FFloorPlanPreprocessor::Run(FFloorPlanStripReader& Reader, int32 StripRows, FFloorPlanMask& OutMask, FFloorPlanProfile* Profile)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(FFloorPlanPreprocessor::Run);
+
+    const int32 Width = Reader.GetWidth();
+    const int32 Height = Reader.GetHeight();
+    SkewDegrees = 0.0f;
+
+    // Local thresholds and the skew search need the whole frame, as luminance only
+    TArray64<uint8> Luminance;
+    {
+        FLOORPLAN_SCOPE_STAGE(STAT_FloorPlanExtract, Profile, ExtractMs);
+        Luminance.SetNumUninitialized(static_cast<int64>(Width) * Height);
+
+        TArray<uint8> Strip;
+        int64 Offset = 0;
+        while (int32 NumRows = Reader.ReadRows(FMath::Max(1, StripRows), Strip))
+        {
+            NumRows = static_cast<int32>(FMath::Min<int64>(NumRows, (Luminance.Num() - Offset) / FMath::Max(1, Width)));
+            if (NumRows == 0)
+            {
+                break;
+            }
+            FMemory::Memcpy(Luminance.GetData() + Offset, Strip.GetData(), static_cast<int64>(NumRows) * Width);
+            Offset += static_cast<int64>(NumRows) * Width;
+        }
+
+        if (Offset != Luminance.Num())
+        {
+            UE_LOG(LogFloorPlan, Error, TEXT("FloorPlanPreprocessor: Image ended after %lld of %d rows"), Offset / FMath::Max(1, Width), Height);
+            return false;
+        }
+    }
+
+    FLOORPLAN_SCOPE_STAGE(STAT_FloorPlanBinarize, Profile, BinarizeMs);
+    Threshold(Luminance, Width, Height, OutMask);
+
+    // The skew is measured on the thresholded walls, then the frame is rotated and thresholded again
+    if (Settings.bDeskew)
+    {
+        const float Skew = EstimateSkew(OutMask);
+        if (FMath::Abs(Skew) >= Settings.MinSkewDegrees)
+        {
+            TArray64<uint8> Rotated;
+            Rotate(Luminance, Width, Height, Skew, Rotated);
+            Luminance = MoveTemp(Rotated);
+            Threshold(Luminance, Width, Height, OutMask);
+            SkewDegrees = Skew;
+        }
+    }
+    Luminance.Empty();
+
+    OpenClose(OutMask, FMath::Min(Settings.OpenRadius, FloorPlanPreprocessorPrivate::MaxMorphologyRadius),
+              FMath::Min(Settings.CloseRadius, FloorPlanPreprocessorPrivate::MaxMorphologyRadius));
+
+    UE_LOG(LogFloorPlan, Log, TEXT("FloorPlanPreprocessor: %s threshold, skew %.2f degrees, open %d / close %d on %dx%d"),
+           *UEnum::GetDisplayValueAsText(Settings.Method).ToString(), SkewDegrees, Settings.OpenRadius, Settings.CloseRadius, Width, Height);
+    return true;
+}
+
+void FFloorPlanPreprocessor::Threshold(const TArray64<uint8>& Luminance, int32 Width, int32 Height, FFloorPlanMask& OutMask) const
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(FFloorPlanPreprocessor::Threshold);
+    using namespace FloorPlanPreprocessorPrivate;
+
+    OutMask.Width = Width;
+    OutMask.Height = Height;
+    OutMask.Pixels.SetNumUninitialized(static_cast<int64>(Width) * Height);
+
+    if (Settings.Method == EFloorPlanThresholdMethod::Global)
+    {
+        FFloorPlanParallel::For(Height, [&](int32 Y)
+        {
+            const int64 Row = static_cast<int64>(Y) * Width;
+            for (int32 X = 0; X < Width; ++X)
+            {
+                OutMask.Pixels[Row + X] = FFloorPlanMask::Classify(Luminance[Row + X], Settings.BlackThreshold, Settings.WhiteThreshold);
+            }
+        });
+        return;
+    }
+
+    const int32 Half = Settings.WindowSize / 2;
+    const bool bSauvola = Settings.Method == EFloorPlanThresholdMethod::Sauvola;
+    TFloorPlanIntegralImage<uint64> Sum;
+    TFloorPlanIntegralImage<uint64> SumSq;
+
+    for (int32 BandTop = 0; BandTop < Height; BandTop += BandRows)
+    {
+        const int32 BandBottom = FMath::Min(BandTop + BandRows, Height);
+        const int32 HaloTop = FMath::Max(0, BandTop - Half);
+        const int32 HaloBottom = FMath::Min(Height, BandBottom + Half);
+        const uint8* HaloPixels = Luminance.GetData() + static_cast<int64>(HaloTop) * Width;
+
+        Sum.Build(Width, HaloBottom - HaloTop, [HaloPixels, Width](int32 X, int32 Y)
+        {
+            return HaloPixels[static_cast<int64>(Y) * Width + X];
+        });
+        if (bSauvola)
+        {
+            SumSq.Build(Width, HaloBottom - HaloTop, [HaloPixels, Width](int32 X, int32 Y)
+            {
+                const uint32 Value = HaloPixels[static_cast<int64>(Y) * Width + X];
+                return Value * Value;
+            });
+        }
+
+        FFloorPlanParallel::For(BandBottom - BandTop, [&](int32 Row)
+        {
+            const int32 Y = BandTop + Row;
+            const int32 LocalY0 = FMath::Max(Y - Half, 0) - HaloTop;
+            const int32 LocalY1 = FMath::Min(Y + Half, Height - 1) - HaloTop;
+            const int64 RowOffset = static_cast<int64>(Y) * Width;
+            for (int32 X = 0; X < Width; ++X)
+            {
+                const int32 X0 = FMath::Max(X - Half, 0);
+                const int32 X1 = FMath::Min(X + Half, Width - 1);
+                const double Area = static_cast<double>(TFloorPlanIntegralImage<uint64>::BoxArea(X0, LocalY0, X1, LocalY1));
+                const double Mean = Sum.BoxSum(X0, LocalY0, X1, LocalY1) / Area;
+
+                double Threshold = Mean * (1.0 - Settings.BradleyFraction);
+                if (bSauvola)
+                {
+                    const double Variance = FMath::Max(0.0, SumSq.BoxSum(X0, LocalY0, X1, LocalY1) / Area - Mean * Mean);
+                    Threshold = Mean * (1.0 + Settings.SauvolaK * (FMath::Sqrt(Variance) / Settings.SauvolaRange - 1.0));
+                }
+
+                // Very dark pixels stay ink inside blobs wider than the window, where the local mean is dark too;
+                // between the threshold and halfway to the mean lies the gray band the global classes call Other
+                const uint8 Value = Luminance[RowOffset + X];
+                uint8 Class = FFloorPlanMask::Other;
+                if (Value < Threshold || Value < Settings.BlackThreshold)
+                {
+                    Class = FFloorPlanMask::Wall;
+                }
+                else if (Value >= (Threshold + Mean) * 0.5)
+                {
+                    Class = FFloorPlanMask::Room;
+                }
+                OutMask.Pixels[RowOffset + X] = Class;
+            }
+        });
+    }
+}
+
+float FFloorPlanPreprocessor::EstimateSkew(const FFloorPlanMask& Mask) const
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(FFloorPlanPreprocessor::EstimateSkew);
+    using namespace FloorPlanPreprocessorPrivate;
+
+    // Wall pixels on a regular grid, coarse enough to cap the sample count
+    const int64 NumPixels = static_cast<int64>(Mask.Width) * Mask.Height;
+    const int32 Stride = FMath::Max(1, FMath::CeilToInt(FMath::Sqrt(static_cast<double>(NumPixels) / MaxSkewSamples)));
+    TArray<FVector2f> Samples;
+    for (int32 Y = 0; Y < Mask.Height; Y += Stride)
+    {
+        for (int32 X = 0; X < Mask.Width; X += Stride)
+        {
+            if (Mask.Get(X, Y) == FFloorPlanMask::Wall)
+            {
+                Samples.Emplace(X - Mask.Width * 0.5f, Y - Mask.Height * 0.5f);
+            }
+        }
+    }
+    if (Samples.Num() < 16)
+    {
+        return 0.0f;
+    }
+
+    // Walls rotated onto the axes pile up in few rows and columns of the projection profile, so the
+    // sum of squared bin counts peaks at the skew angle
+    const float Diagonal = FMath::Sqrt(static_cast<float>(Mask.Width) * Mask.Width + static_cast<float>(Mask.Height) * Mask.Height);
+    const int32 NumBins = FMath::CeilToInt(Diagonal / Stride) + 2;
+    auto Score = [&Samples, NumBins, Stride](float Degrees)
+    {
+        float Sin, Cos;
+        FMath::SinCos(&Sin, &Cos, FMath::DegreesToRadians(Degrees));
+
+        TArray<int32> Rows;
+        TArray<int32> Columns;
+        Rows.SetNumZeroed(NumBins);
+        Columns.SetNumZeroed(NumBins);
+        for (const FVector2f& Sample : Samples)
+        {
+            const int32 Row = FMath::Clamp(FMath::FloorToInt((Sample.X * Sin + Sample.Y * Cos) / Stride + NumBins * 0.5f), 0, NumBins - 1);
+            const int32 Column = FMath::Clamp(FMath::FloorToInt((Sample.X * Cos - Sample.Y * Sin) / Stride + NumBins * 0.5f), 0, NumBins - 1);
+            ++Rows[Row];
+            ++Columns[Column];
+        }
+
+        double Total = 0.0;
+        for (int32 Bin = 0; Bin < NumBins; ++Bin)
+        {
+            Total += static_cast<double>(Rows[Bin]) * Rows[Bin] + static_cast<double>(Columns[Bin]) * Columns[Bin];
+        }
+        return Total;
+    };
+
+    auto Search = [&Score](float Center, float Range, float Step)
+    {
+        const int32 NumSteps = FMath::RoundToInt(Range / Step);
+        TArray<double> Scores;
+        Scores.SetNumZeroed(NumSteps * 2 + 1);
+        FFloorPlanParallel::For(Scores.Num(), [&](int32 Index)
+        {
+            Scores[Index] = Score(Center + (Index - NumSteps) * Step);
+        });
+
+        int32 Best = NumSteps;
+        for (int32 Index = 0; Index < Scores.Num(); ++Index)
+        {
+            // Ties go to the smallest rotation
+            if (Scores[Index] > Scores[Best] || (Scores[Index] == Scores[Best] && FMath::Abs(Index - NumSteps) < FMath::Abs(Best - NumSteps)))
+            {
+                Best = Index;
+            }
+        }
+        return Center + (Best - NumSteps) * Step;
+    };
+
+    const float Coarse = Search(0.0f, Settings.MaxSkewDegrees, CoarseSkewStepDegrees);
+    const float Fine = Search(Coarse, CoarseSkewStepDegrees, FineSkewStepDegrees);
+    return FMath::Clamp(Fine, -Settings.MaxSkewDegrees, Settings.MaxSkewDegrees);
+}
+
+void FFloorPlanPreprocessor::Rotate(const TArray64<uint8>& Source, int32 Width, int32 Height, float Degrees, TArray64<uint8>& OutRotated)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(FFloorPlanPreprocessor::Rotate);
+
+    // Inverse mapping around the image center with nearest sampling; corners rotated in from outside are paper white
+    float Sin, Cos;
+    FMath::SinCos(&Sin, &Cos, FMath::DegreesToRadians(Degrees));
+    const float CenterX = Width * 0.5f;
+    const float CenterY = Height * 0.5f;
+
+    OutRotated.SetNumUninitialized(static_cast<int64>(Width) * Height);
+    FFloorPlanParallel::For(Height, [&](int32 Y)
+    {
+        const float DY = Y + 0.5f - CenterY;
+        uint8* Out = OutRotated.GetData() + static_cast<int64>(Y) * Width;
+        for (int32 X = 0; X < Width; ++X)
+        {
+            const float DX = X + 0.5f - CenterX;
+            const int32 SX = FMath::FloorToInt(DX * Cos + DY * Sin + CenterX);
+            const int32 SY = FMath::FloorToInt(-DX * Sin + DY * Cos + CenterY);
+            Out[X] = (SX >= 0 && SX < Width && SY >= 0 && SY < Height) ? Source[static_cast<int64>(SY) * Width + SX] : 255;
+        }
+    });
+}
+
+void FFloorPlanPreprocessor::OpenClose(FFloorPlanMask& Mask, int32 OpenRadius, int32 CloseRadius)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(FFloorPlanPreprocessor::OpenClose);
+    using namespace FloorPlanPreprocessorPrivate;
+
+    if (OpenRadius <= 0 && CloseRadius <= 0)
+    {
+        return;
+    }
+
+    FBitRows Bits;
+    FBitRows Scratch;
+    FBitRows Temp;
+    Bits.Init(Mask.Width, Mask.Height);
+    Scratch.Init(Mask.Width, Mask.Height);
+    Temp.Init(Mask.Width, Mask.Height);
+
+    FFloorPlanParallel::For(Mask.Height, [&](int32 Y)
+    {
+        uint64* Row = Bits.Row(Y);
+        const uint8* Pixels = Mask.Pixels.GetData() + Mask.Index(0, Y);
+        for (int32 X = 0; X < Mask.Width; ++X)
+        {
+            Row[X >> 6] |= static_cast<uint64>(Pixels[X] == FFloorPlanMask::Wall) << (X & 63);
+        }
+    });
+
+    // Opening drops specks smaller than the element, closing then bridges hairline breaks in walls
+    if (OpenRadius > 0)
+    {
+        MorphologyPass(Bits, Scratch, Temp, OpenRadius, /*bDilate=*/ false);
+        MorphologyPass(Temp, Scratch, Bits, OpenRadius, /*bDilate=*/ true);
+    }
+    if (CloseRadius > 0)
+    {
+        // Erosion counts the outside as background, so walls touching the border are kept from before
+        MorphologyPass(Bits, Scratch, Temp, CloseRadius, /*bDilate=*/ true);
+        MorphologyPass(Temp, Scratch, Temp, CloseRadius, /*bDilate=*/ false);
+        for (int64 Word = 0; Word < Bits.Bits.Num(); ++Word)
+        {
+            Bits.Bits[Word] |= Temp.Bits[Word];
+        }
+    }
+
+    // Removed ink becomes paper, bridged gaps become wall; gray pixels outside both stay as they are
+    FFloorPlanParallel::For(Mask.Height, [&](int32 Y)
+    {
+        const uint64* Row = Bits.Row(Y);
+        uint8* Pixels = Mask.Pixels.GetData() + Mask.Index(0, Y);
+        for (int32 X = 0; X < Mask.Width; ++X)
+        {
+            const bool bWall = (Row[X >> 6] >> (X & 63)) & 1;
+            if (bWall)
+            {
+                Pixels[X] = FFloorPlanMask::Wall;
+            }
+            else if (Pixels[X] == FFloorPlanMask::Wall)
+            {
+                Pixels[X] = FFloorPlanMask::Room;
+            }
+        }
+    });
+}
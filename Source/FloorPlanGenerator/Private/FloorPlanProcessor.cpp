@@ -1,9 +1,91 @@
 #include "FloorPlanProcessor.h"
+#include "FloorPlanLog.h"
+#include "HAL/PlatformMemory.h"
 #include "FloorPlanAnalyzer.h"
 #include "StructureBuilder.h"
+#include "MeshGenerator.h"
+#include "FloorPlanMaterialSet.h"
+#include "FloorPlanMeshBuffers.h"
+#include "ProceduralMeshComponent.h"
 #include "Engine/World.h"
 #include "Editor.h"
 
+namespace FloorPlanProcessorPrivate
+{
+    // Uploads merged buffers of one surface kind as one proxy section per buffer section. Every section
+    // gets the whole vertex stream, which is exact for the single-kind buffers live edit builds.
+    void UploadProxy(UProceduralMeshComponent* Component, const FFloorPlanMeshBuffers& Buffers, UFloorPlanMaterialSet* Materials)
+    {
+        TRACE_CPUPROFILER_EVENT_SCOPE(FloorPlanProcessorPrivate::UploadProxy);
+
+        TArray<FVector> Vertices;
+        TArray<FVector> Normals;
+        TArray<FVector2D> UVs;
+        Vertices.Reserve(Buffers.Positions.Num());
+        Normals.Reserve(Buffers.Normals.Num());
+        UVs.Reserve(Buffers.UVs.Num());
+        for (const FVector3f& Position : Buffers.Positions)
+        {
+            Vertices.Add(FVector(Position));
+        }
+        for (const FVector3f& Normal : Buffers.Normals)
+        {
+            Normals.Add(FVector(Normal));
+        }
+        for (const FVector2f& UV : Buffers.UVs)
+        {
+            UVs.Add(FVector2D(UV));
+        }
+
+        Component->ClearAllMeshSections();
+        for (int32 SectionIndex = 0; SectionIndex < Buffers.Sections.Num(); ++SectionIndex)
+        {
+            const FFloorPlanMeshSection& Section = Buffers.Sections[SectionIndex];
+            TArray<int32> Triangles;
+            Triangles.Reserve(Section.Indices.Num());
+            for (uint32 Index : Section.Indices)
+            {
+                Triangles.Add(static_cast<int32>(Index));
+            }
+
+            Component->CreateMeshSection(SectionIndex, Vertices, Triangles, Normals, UVs, TArray<FColor>(), TArray<FProcMeshTangent>(), /*bCreateCollision=*/ false);
+            Component->SetMaterial(SectionIndex, Materials->GetMaterial(*Section.MaterialName));
+        }
+    }
+
+    // Merges the pieces of one kind into buffers with a single section
+    void MergePieces(const TArray<FFloorPlanMeshPiece>& Pieces, EFloorPlanMeshKind Kind, FFloorPlanMeshBuffers& OutBuffers)
+    {
+        OutBuffers.Reset();
+        OutBuffers.FindOrAddSection(UMeshGenerator::GetSlotName(Kind));
+        for (const FFloorPlanMeshPiece& Piece : Pieces)
+        {
+            if (Piece.Kind == Kind)
+            {
+                OutBuffers.Append(Piece.Buffers, Piece.Placement);
+            }
+        }
+    }
+
+    UProceduralMeshComponent* AddProxyComponent(AActor* Owner, const TCHAR* Name)
+    {
+        UProceduralMeshComponent* Component = NewObject<UProceduralMeshComponent>(Owner, Name);
+        Component->bUseAsyncCooking = true;
+        Component->SetCastShadow(true);
+        if (!Owner->GetRootComponent())
+        {
+            Owner->SetRootComponent(Component);
+        }
+        else
+        {
+            Component->SetupAttachment(Owner->GetRootComponent());
+        }
+        Owner->AddInstanceComponent(Component);
+        Component->RegisterComponent();
+        return Component;
+    }
+}
+
 UFloorPlanProcessor::UFloorPlanProcessor()
 {
     // Objects will be created when needed
@@ -11,14 +93,58 @@ UFloorPlanProcessor::UFloorPlanProcessor()
     Builder = nullptr;
 }
 
-void UFloorPlanProcessor::ProcessFloorPlan(UTexture2D* FloorPlanImage)
+FFloorPlanProfile UFloorPlanProcessor::ProcessFloorPlan(UTexture2D* FloorPlanImage)
 {
     if (!FloorPlanImage)
     {
-        UE_LOG(LogTemp, Error, TEXT("FloorPlanProcessor: No floor plan image provided"));
-        return;
+        UE_LOG(LogFloorPlan, Error, TEXT("FloorPlanProcessor: No floor plan image provided"));
+        return FFloorPlanProfile();
+    }
+
+    if (!EnsureAnalyzerAndBuilder())
+    {
+        return FFloorPlanProfile();
     }
 
+    UE_LOG(LogFloorPlan, Log, TEXT("FloorPlanProcessor: Starting floor plan processing"));
+    CancelLiveEdit();
+
+    // Step 1: Analyze the floor plan image
+    bHasAnalysis = Analyzer->AnalyzeFloorPlan(FloorPlanImage, ScaleFactor);
+    if (!bHasAnalysis)
+    {
+        UE_LOG(LogFloorPlan, Error, TEXT("FloorPlanProcessor: Failed to analyze floor plan"));
+        return Analyzer->GetProfile();
+    }
+
+    BuildFromAnalysis();
+    return CollectProfile();
+}
+
+FFloorPlanProfile UFloorPlanProcessor::ProcessFloorPlanFile(const FString& FilePath)
+{
+    if (!EnsureAnalyzerAndBuilder())
+    {
+        return FFloorPlanProfile();
+    }
+
+    UE_LOG(LogFloorPlan, Log, TEXT("FloorPlanProcessor: Starting floor plan processing for %s"), *FilePath);
+    CancelLiveEdit();
+
+    // Step 1: Analyze the image file
+    bHasAnalysis = Analyzer->AnalyzeFloorPlanFile(FilePath, ScaleFactor);
+    if (!bHasAnalysis)
+    {
+        UE_LOG(LogFloorPlan, Error, TEXT("FloorPlanProcessor: Failed to analyze floor plan"));
+        return Analyzer->GetProfile();
+    }
+
+    BuildFromAnalysis();
+    return CollectProfile();
+}
+
+bool UFloorPlanProcessor::EnsureAnalyzerAndBuilder()
+{
     // Create analyzer and builder if not already created
     if (!Analyzer)
     {
@@ -31,34 +157,270 @@ void UFloorPlanProcessor::ProcessFloorPlan(UTexture2D* FloorPlanImage)
     
     if (!Analyzer || !Builder)
     {
-        UE_LOG(LogTemp, Error, TEXT("FloorPlanProcessor: Failed to create Analyzer or Builder"));
-        return;
+        UE_LOG(LogFloorPlan, Error, TEXT("FloorPlanProcessor: Failed to create Analyzer or Builder"));
+        return false;
     }
 
-    UE_LOG(LogTemp, Log, TEXT("FloorPlanProcessor: Starting floor plan processing"));
-
-    // Step 1: Analyze the floor plan image
-    if (!Analyzer->AnalyzeFloorPlan(FloorPlanImage, ScaleFactor))
-    {
-        UE_LOG(LogTemp, Error, TEXT("FloorPlanProcessor: Failed to analyze floor plan"));
-        return;
-    }
+    Analyzer->SetAnalysisMode(AnalysisMode);
+    Analyzer->SetAnalysisServer(AnalysisServerAddress);
+    Analyzer->SetMemoryBudget(static_cast<int64>(MemoryBudgetMB) * 1024 * 1024);
+    Analyzer->SetStreamingStripRows(StreamingStripRows);
+    Analyzer->SetPyramidCoarseLevel(PyramidCoarseLevel);
+    Analyzer->SetMeasureWallThickness(bMeasureWallThickness);
+    Analyzer->SetThresholdMethod(ThresholdMethod);
+    Analyzer->SetMorphologyRadii(SpeckRemovalRadius, GapBridgingRadius);
+    Analyzer->SetDeskew(bDeskew);
+    Analyzer->SetRecognizeText(bRecognizeText);
+    return true;
+}
 
-    // Step 2: Configure builder parameters
+void UFloorPlanProcessor::ApplyBuilderParameters()
+{
     Builder->SetWallHeight(WallHeight);
     Builder->SetDoorHeight(DoorHeight);
     Builder->SetWindowHeight(WindowHeight);
     Builder->SetWallThickness(WallThickness);
+    Builder->SetOverrideMeasuredThickness(bOverrideMeasuredWallThickness || bLiveThicknessOverride);
+    Builder->SetStoreySlabs(bStoreySlabs);
+}
+
+void UFloorPlanProcessor::BuildFromAnalysis()
+{
+    // Step 2: Configure builder parameters
+    ApplyBuilderParameters();
 
     // Step 3: Build the 3D structure
     UWorld* World = GEditor->GetEditorWorldContext().World();
     if (!World)
     {
-        UE_LOG(LogTemp, Error, TEXT("FloorPlanProcessor: No valid world context"));
+        UE_LOG(LogFloorPlan, Error, TEXT("FloorPlanProcessor: No valid world context"));
         return;
     }
 
     Builder->BuildStructure(World, Analyzer);
 
-    UE_LOG(LogTemp, Log, TEXT("FloorPlanProcessor: Floor plan processing completed"));
+    UE_LOG(LogFloorPlan, Log, TEXT("FloorPlanProcessor: Floor plan processing completed"));
+}
+
+FFloorPlanProfile UFloorPlanProcessor::CollectProfile() const
+{
+    FFloorPlanProfile Profile = Analyzer->GetProfile();
+    Profile.Append(Builder->GetProfile());
+    Profile.PeakMemoryBytes = FPlatformMemory::GetStats().PeakUsedPhysical;
+
+    Profile.LogSummary(TEXT("FloorPlanProcessor"));
+    return Profile;
+}
+
+void UFloorPlanProcessor::SetWallHeight(float Height)
+{
+    WallHeight = Height;
+    MarkLiveEditDirty(/*bWalls=*/ true, /*bCeilings=*/ true);
+}
+
+void UFloorPlanProcessor::SetDoorHeight(float Height)
+{
+    DoorHeight = Height;
+    MarkLiveEditDirty(/*bWalls=*/ true, /*bCeilings=*/ false);
+}
+
+void UFloorPlanProcessor::SetWindowHeight(float Height)
+{
+    WindowHeight = Height;
+    MarkLiveEditDirty(/*bWalls=*/ true, /*bCeilings=*/ false);
+}
+
+void UFloorPlanProcessor::SetWallThickness(float Thickness)
+{
+    WallThickness = Thickness;
+
+    // Measured walls keep their own thickness unless overridden, which is what a live thickness edit asks for.
+    // The override only lasts for the session, the saved setting stays as it is.
+    bLiveThicknessOverride |= IsLiveEditing();
+    MarkLiveEditDirty(/*bWalls=*/ true, /*bCeilings=*/ false);
+}
+
+bool UFloorPlanProcessor::BeginLiveEdit()
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(UFloorPlanProcessor::BeginLiveEdit);
+    using namespace FloorPlanProcessorPrivate;
+
+    if (IsLiveEditing())
+    {
+        return true;
+    }
+    if (!bHasAnalysis || !EnsureAnalyzerAndBuilder())
+    {
+        UE_LOG(LogFloorPlan, Error, TEXT("FloorPlanProcessor: Live edit needs a processed floor plan"));
+        return false;
+    }
+
+    UWorld* World = GEditor ? GEditor->GetEditorWorldContext().World() : nullptr;
+    if (!World)
+    {
+        UE_LOG(LogFloorPlan, Error, TEXT("FloorPlanProcessor: No valid world context"));
+        return false;
+    }
+
+    FActorSpawnParameters SpawnParameters;
+    SpawnParameters.Name = MakeUniqueObjectName(World->GetCurrentLevel(), AActor::StaticClass(), TEXT("FloorPlanLivePreview"));
+    SpawnParameters.ObjectFlags = RF_Transient;
+    LivePreviewActor = World->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity, SpawnParameters);
+    if (!LivePreviewActor)
+    {
+        return false;
+    }
+
+    // The floor component is the root, walls and ceilings move relative to it
+    LiveFloors = AddProxyComponent(LivePreviewActor, TEXT("Floors"));
+    LiveWalls = AddProxyComponent(LivePreviewActor, TEXT("Walls"));
+    LiveCeilings = AddProxyComponent(LivePreviewActor, TEXT("Ceilings"));
+
+    // Opening hosting queries the spatial index, so the wall graph is resolved once for the session
+    ApplyBuilderParameters();
+    Builder->GetMeshGenerator()->GetMaterialSet()->ResolveAll();
+    LiveWallLayout = Builder->CreateWallLayout(*Analyzer->GetResult());
+
+    const uint64 StartCycles = FPlatformTime::Cycles64();
+    UpdateLiveRooms();
+    UpdateLiveWalls();
+    LastLiveEditMs = static_cast<float>(FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles));
+
+    LiveEditTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &UFloorPlanProcessor::TickLiveEdit));
+
+    UE_LOG(LogFloorPlan, Log, TEXT("FloorPlanProcessor: Live edit started with %d walls and %d rooms (%.1f ms)"),
+           LiveWallLayout.Num(), Analyzer->GetRoomData().Num(), LastLiveEditMs);
+    return true;
+}
+
+FFloorPlanProfile UFloorPlanProcessor::FinalizeLiveEdit()
+{
+    if (!IsLiveEditing())
+    {
+        UE_LOG(LogFloorPlan, Warning, TEXT("FloorPlanProcessor: FinalizeLiveEdit without a live edit session"));
+        return FFloorPlanProfile();
+    }
+
+    // The final build keeps the session's thickness override, later runs do not
+    const bool bThicknessEdited = bLiveThicknessOverride;
+    CancelLiveEdit();
+    bLiveThicknessOverride = bThicknessEdited;
+    BuildFromAnalysis();
+    bLiveThicknessOverride = false;
+    return CollectProfile();
+}
+
+void UFloorPlanProcessor::CancelLiveEdit()
+{
+    if (LiveEditTickerHandle.IsValid())
+    {
+        FTSTicker::GetCoreTicker().RemoveTicker(LiveEditTickerHandle);
+        LiveEditTickerHandle.Reset();
+    }
+
+    if (LivePreviewActor)
+    {
+        LivePreviewActor->Destroy();
+    }
+    LivePreviewActor = nullptr;
+    LiveWalls = nullptr;
+    LiveFloors = nullptr;
+    LiveCeilings = nullptr;
+    LiveWallLayout.Reset();
+    bLiveWallsDirty = false;
+    bLiveCeilingsDirty = false;
+    bLiveThicknessOverride = false;
+}
+
+void UFloorPlanProcessor::BeginDestroy()
+{
+    if (LiveEditTickerHandle.IsValid())
+    {
+        FTSTicker::GetCoreTicker().RemoveTicker(LiveEditTickerHandle);
+        LiveEditTickerHandle.Reset();
+    }
+    Super::BeginDestroy();
+}
+
+void UFloorPlanProcessor::MarkLiveEditDirty(bool bWalls, bool bCeilings)
+{
+    // Several setters in one frame (a slider drag) coalesce into one update on the next tick
+    bLiveWallsDirty |= bWalls && IsLiveEditing();
+    bLiveCeilingsDirty |= bCeilings && IsLiveEditing();
+}
+
+bool UFloorPlanProcessor::TickLiveEdit(float DeltaTime)
+{
+    if (!IsValid(LivePreviewActor))
+    {
+        // The preview was deleted from the level, the session ends with it
+        CancelLiveEdit();
+        return false;
+    }
+    if (!bLiveWallsDirty && !bLiveCeilingsDirty)
+    {
+        return true;
+    }
+
+    TRACE_CPUPROFILER_EVENT_SCOPE(UFloorPlanProcessor::TickLiveEdit);
+    const uint64 StartCycles = FPlatformTime::Cycles64();
+
+    ApplyBuilderParameters();
+    if (bLiveWallsDirty)
+    {
+        UpdateLiveWalls();
+    }
+    if (bLiveCeilingsDirty)
+    {
+        UpdateLiveCeilingHeight();
+    }
+    bLiveWallsDirty = false;
+    bLiveCeilingsDirty = false;
+
+    LastLiveEditMs = static_cast<float>(FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles));
+    if (LastLiveEditMs > LiveEditFrameBudgetMs)
+    {
+        UE_LOG(LogFloorPlan, Warning, TEXT("FloorPlanProcessor: Live edit update took %.1f ms, over the %.1f ms frame budget"),
+               LastLiveEditMs, LiveEditFrameBudgetMs);
+    }
+    return true;
+}
+
+void UFloorPlanProcessor::UpdateLiveWalls()
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(UFloorPlanProcessor::UpdateLiveWalls);
+    using namespace FloorPlanProcessorPrivate;
+
+    // Heights and thickness only change the extrusion of each wall, the layout and its openings stay
+    TArray<FFloorPlanMeshPiece> Pieces;
+    Builder->BuildMeshPieces(*Analyzer->GetResult(), LiveWallLayout, /*bIncludeRooms=*/ false, Pieces, /*bPackLightmapUVs=*/ false);
+
+    FFloorPlanMeshBuffers Buffers;
+    MergePieces(Pieces, EFloorPlanMeshKind::Wall, Buffers);
+    UploadProxy(LiveWalls, Buffers, Builder->GetMeshGenerator()->GetMaterialSet());
+}
+
+void UFloorPlanProcessor::UpdateLiveRooms()
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(UFloorPlanProcessor::UpdateLiveRooms);
+    using namespace FloorPlanProcessorPrivate;
+
+    TArray<FFloorPlanMeshPiece> Pieces;
+    Builder->BuildMeshPieces(*Analyzer->GetResult(), TArray<FWallDefinition>(), /*bIncludeRooms=*/ true, Pieces, /*bPackLightmapUVs=*/ false);
+
+    UFloorPlanMaterialSet* Materials = Builder->GetMeshGenerator()->GetMaterialSet();
+    FFloorPlanMeshBuffers Buffers;
+    MergePieces(Pieces, EFloorPlanMeshKind::Floor, Buffers);
+    UploadProxy(LiveFloors, Buffers, Materials);
+    MergePieces(Pieces, EFloorPlanMeshKind::Ceiling, Buffers);
+    UploadProxy(LiveCeilings, Buffers, Materials);
+
+    LiveCeilingBuildHeight = WallHeight;
+    LiveCeilings->SetRelativeLocation(FVector::ZeroVector);
+}
+
+void UFloorPlanProcessor::UpdateLiveCeilingHeight()
+{
+    // Ceilings keep their geometry, only their elevation follows the wall height
+    LiveCeilings->SetRelativeLocation(FVector(0.0f, 0.0f, WallHeight - LiveCeilingBuildHeight));
 }
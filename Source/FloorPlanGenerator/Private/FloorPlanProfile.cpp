@@ -0,0 +1,75 @@
+#include "FloorPlanProfile.h"
+#include "FloorPlanMeshBuffers.h"
+
+void FFloorPlanProfile::Append(const FFloorPlanProfile& Other)
+{
+    ExtractMs += Other.ExtractMs;
+    BinarizeMs += Other.BinarizeMs;
+    LabelMs += Other.LabelMs;
+    WallsMs += Other.WallsMs;
+    OpeningsMs += Other.OpeningsMs;
+    TextMs += Other.TextMs;
+    MeshBuildMs += Other.MeshBuildMs;
+    AssetCreateMs += Other.AssetCreateMs;
+    TotalMs += Other.TotalMs;
+
+    PixelCount += Other.PixelCount;
+    PrimitiveCount += Other.PrimitiveCount;
+    RoomCount += Other.RoomCount;
+    WallSegmentCount += Other.WallSegmentCount;
+    OpeningCount += Other.OpeningCount;
+    MeshCount += Other.MeshCount;
+    VertexCount += Other.VertexCount;
+    TriangleCount += Other.TriangleCount;
+
+    PeakWorkingBytes = FMath::Max(PeakWorkingBytes, Other.PeakWorkingBytes);
+    PeakMemoryBytes = FMath::Max(PeakMemoryBytes, Other.PeakMemoryBytes);
+
+    if (!Other.Strategy.IsEmpty())
+    {
+        Strategy = Strategy.IsEmpty() ? Other.Strategy : Strategy + TEXT(", ") + Other.Strategy;
+    }
+    MemoryBudgetBytes = FMath::Max(MemoryBudgetBytes, Other.MemoryBudgetBytes);
+    EstimatedWorkingBytes = FMath::Max(EstimatedWorkingBytes, Other.EstimatedWorkingBytes);
+
+    OptimizedTriangleCount += Other.OptimizedTriangleCount;
+    UnweldedVertexCount += Other.UnweldedVertexCount;
+    WeldedVertexCount += Other.WeldedVertexCount;
+    CacheMissesBefore += Other.CacheMissesBefore;
+    CacheMissesAfter += Other.CacheMissesAfter;
+    IndexBytesBefore += Other.IndexBytesBefore;
+    IndexBytesAfter += Other.IndexBytesAfter;
+}
+
+void FFloorPlanProfile::AddMeshOptimization(const FFloorPlanMeshOptimizeStats& Stats)
+{
+    OptimizedTriangleCount += Stats.Triangles;
+    UnweldedVertexCount += Stats.VerticesBefore;
+    WeldedVertexCount += Stats.VerticesAfter;
+    CacheMissesBefore += Stats.CacheMissesBefore;
+    CacheMissesAfter += Stats.CacheMissesAfter;
+    IndexBytesBefore += Stats.IndexBytesBefore;
+    IndexBytesAfter += Stats.IndexBytesAfter;
+}
+
+void FFloorPlanProfile::LogSummary(const TCHAR* Label) const
+{
+    UE_LOG(LogFloorPlan, Log, TEXT("%s: %.1f ms total (extract %.1f, binarize %.1f, label %.1f, walls %.1f, openings %.1f, text %.1f, mesh %.1f, assets %.1f)"),
+           Label, TotalMs, ExtractMs, BinarizeMs, LabelMs, WallsMs, OpeningsMs, TextMs, MeshBuildMs, AssetCreateMs);
+    UE_LOG(LogFloorPlan, Log, TEXT("%s: %lld pixels, %lld primitives, %d rooms, %d wall segments, %d openings, %d meshes, %lld vertices, %lld triangles, peak working set %.2f MB, process peak %.2f MB"),
+           Label, PixelCount, PrimitiveCount, RoomCount, WallSegmentCount, OpeningCount, MeshCount, VertexCount, TriangleCount,
+           PeakWorkingBytes / (1024.0 * 1024.0), PeakMemoryBytes / (1024.0 * 1024.0));
+    if (!Strategy.IsEmpty())
+    {
+        UE_LOG(LogFloorPlan, Log, TEXT("%s: strategy %s, estimated working set %.2f MB of %s budget"),
+               Label, *Strategy, EstimatedWorkingBytes / (1024.0 * 1024.0),
+               MemoryBudgetBytes > 0 ? *FString::Printf(TEXT("%.0f MB"), MemoryBudgetBytes / (1024.0 * 1024.0)) : TEXT("unlimited"));
+    }
+    if (OptimizedTriangleCount > 0)
+    {
+        UE_LOG(LogFloorPlan, Log, TEXT("%s: mesh optimization %lld -> %lld vertices, ACMR %.3f -> %.3f, index buffers %.2f -> %.2f MB"),
+               Label, UnweldedVertexCount, WeldedVertexCount,
+               static_cast<double>(CacheMissesBefore) / OptimizedTriangleCount, static_cast<double>(CacheMissesAfter) / OptimizedTriangleCount,
+               IndexBytesBefore / (1024.0 * 1024.0), IndexBytesAfter / (1024.0 * 1024.0));
+    }
+}
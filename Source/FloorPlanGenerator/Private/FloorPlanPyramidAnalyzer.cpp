@@ -0,0 +1,406 @@
+#include "FloorPlanPyramidAnalyzer.h"
+#include "FloorPlanLog.h"
+#include "FloorPlanProfile.h"
+
+FFloorPlanPyramidAnalyzer::FFloorPlanPyramidAnalyzer(const FFloorPlanMask& InFullMask, const FFloorPlanPyramidSettings& InSettings)
+    : FullMask(InFullMask)
+    , Settings(InSettings)
+{
+    Settings.CoarseLevel = FMath::Max(1, Settings.CoarseLevel);
+    Settings.WallPointSpacingPixels = FMath::Max(1, Settings.WallPointSpacingPixels);
+    Settings.RoomEdgeSamples = FMath::Max(1, Settings.RoomEdgeSamples);
+}
+
+void FFloorPlanPyramidAnalyzer::Run(FFloorPlanProfile* Profile)
+{
+    if (!FullMask.IsValid())
+    {
+        UE_LOG(LogFloorPlan, Error, TEXT("FloorPlanPyramidAnalyzer: Invalid mask"));
+        return;
+    }
+
+    {
+        FLOORPLAN_SCOPE_STAGE(STAT_FloorPlanLabel, Profile, LabelMs);
+        BuildPyramid();
+        if (Levels.Num() == 0)
+        {
+            UE_LOG(LogFloorPlan, Error, TEXT("FloorPlanPyramidAnalyzer: Image %dx%d is too small for a pyramid"), FullMask.Width, FullMask.Height);
+            return;
+        }
+
+        DetectRooms();
+    }
+
+    {
+        FLOORPLAN_SCOPE_STAGE(STAT_FloorPlanWalls, Profile, WallsMs);
+        RefineWalls();
+    }
+
+    {
+        FLOORPLAN_SCOPE_STAGE(STAT_FloorPlanOpenings, Profile, OpeningsMs);
+        DetectOpenings();
+    }
+
+    const int64 FullPixels = static_cast<int64>(FullMask.Width) * FullMask.Height;
+    UE_LOG(LogFloorPlan, Log, TEXT("FloorPlanPyramidAnalyzer: Level %d (%dx%d) -> %d rooms, %d openings, %d wall points, refined %lld of %lld pixels (%.1f%%)"),
+           CoarseLevel, GetCoarse().Width, GetCoarse().Height, Rooms.Num(), Openings.Num(), WallPoints.Num(),
+           RefinedPixels, FullPixels, FullPixels > 0 ? 100.0 * RefinedPixels / FullPixels : 0.0);
+}
+
+void FFloorPlanPyramidAnalyzer::BuildPyramid()
+{
+    // Stop early on small images so the coarse level keeps a usable resolution
+    constexpr int32 MinCoarseSize = 16;
+
+    Levels.Reserve(Settings.CoarseLevel);
+    const FFloorPlanMask* Source = &FullMask;
+    for (int32 Level = 1; Level <= Settings.CoarseLevel; ++Level)
+    {
+        if (Source->Width / 2 < MinCoarseSize || Source->Height / 2 < MinCoarseSize)
+        {
+            break;
+        }
+        Levels.Add(Source->Downsample());
+        Source = &Levels.Last();
+    }
+
+    CoarseLevel = Levels.Num();
+    CellSize = 1 << CoarseLevel;
+}
+
+void FFloorPlanPyramidAnalyzer::DetectRooms()
+{
+    const FFloorPlanMask& Coarse = GetCoarse();
+
+    TBitArray<> Visited(false, static_cast<int32>(Coarse.Pixels.Num()));
+    TArray<FIntPoint> Stack;
+
+    for (int32 Y = 0; Y < Coarse.Height; ++Y)
+    {
+        for (int32 X = 0; X < Coarse.Width; ++X)
+        {
+            const int32 StartIndex = static_cast<int32>(Coarse.Index(X, Y));
+            if (Visited[StartIndex] || Coarse.Get(X, Y) != FFloorPlanMask::Room)
+            {
+                continue;
+            }
+
+            // Flood fill the coarse room cells
+            FIntPoint MinPoint(X, Y);
+            FIntPoint MaxPoint(X, Y);
+            bool bTouchesBorder = false;
+
+            Visited[StartIndex] = true;
+            Stack.Reset();
+            Stack.Add(FIntPoint(X, Y));
+            while (Stack.Num() > 0)
+            {
+                const FIntPoint Cell = Stack.Pop();
+                MinPoint = MinPoint.ComponentMin(Cell);
+                MaxPoint = MaxPoint.ComponentMax(Cell);
+                bTouchesBorder |= Cell.X == 0 || Cell.Y == 0 || Cell.X == Coarse.Width - 1 || Cell.Y == Coarse.Height - 1;
+
+                const FIntPoint Neighbors[] = {
+                    FIntPoint(Cell.X - 1, Cell.Y), FIntPoint(Cell.X + 1, Cell.Y),
+                    FIntPoint(Cell.X, Cell.Y - 1), FIntPoint(Cell.X, Cell.Y + 1)
+                };
+                for (const FIntPoint& Neighbor : Neighbors)
+                {
+                    if (!Coarse.IsRoom(Neighbor.X, Neighbor.Y))
+                    {
+                        continue;
+                    }
+
+                    const int32 NeighborIndex = static_cast<int32>(Coarse.Index(Neighbor.X, Neighbor.Y));
+                    if (!Visited[NeighborIndex])
+                    {
+                        Visited[NeighborIndex] = true;
+                        Stack.Add(Neighbor);
+                    }
+                }
+            }
+
+            // White regions connected to the image border are the paper around the plan, not rooms
+            if (bTouchesBorder)
+            {
+                continue;
+            }
+
+            // Partial boundary cells are not counted as room, so allow one cell of slack per side
+            const int32 MaxExtentPixels = (MaxPoint.X - MinPoint.X + 3) * CellSize;
+            const int32 MaxHeightPixels = (MaxPoint.Y - MinPoint.Y + 3) * CellSize;
+            if (MaxExtentPixels > Settings.MinRoomSizePixels && MaxHeightPixels > Settings.MinRoomSizePixels)
+            {
+                RefineRoom(MinPoint, MaxPoint);
+            }
+        }
+    }
+}
+
+void FFloorPlanPyramidAnalyzer::RefineRoom(const FIntPoint& CoarseMin, const FIntPoint& CoarseMax)
+{
+    // Coarse room cells are entirely room, the true edge lies within the boundary band around them
+    const int32 S = CellSize;
+    const int32 X0 = CoarseMin.X * S;
+    const int32 Y0 = CoarseMin.Y * S;
+    const int32 X1 = FMath::Min((CoarseMax.X + 1) * S, FullMask.Width) - 1;
+    const int32 Y1 = FMath::Min((CoarseMax.Y + 1) * S, FullMask.Height) - 1;
+
+    int32 Left = X0;
+    int32 Right = X1;
+    int32 Top = Y0;
+    int32 Bottom = Y1;
+
+    for (int32 Sample = 0; Sample < Settings.RoomEdgeSamples; ++Sample)
+    {
+        const int32 Y = Y0 + (Y1 - Y0) * (Sample + 1) / (Settings.RoomEdgeSamples + 1);
+        const int32 X = X0 + (X1 - X0) * (Sample + 1) / (Settings.RoomEdgeSamples + 1);
+
+        int32 Edge = X0;
+        while (Edge > X0 - 2 * S && FullMask.IsRoom(Edge - 1, Y))
+        {
+            --Edge;
+        }
+        Left = FMath::Min(Left, Edge);
+        RefinedPixels += X0 - Edge + 1;
+
+        Edge = X1;
+        while (Edge < X1 + 2 * S && FullMask.IsRoom(Edge + 1, Y))
+        {
+            ++Edge;
+        }
+        Right = FMath::Max(Right, Edge);
+        RefinedPixels += Edge - X1 + 1;
+
+        Edge = Y0;
+        while (Edge > Y0 - 2 * S && FullMask.IsRoom(X, Edge - 1))
+        {
+            --Edge;
+        }
+        Top = FMath::Min(Top, Edge);
+        RefinedPixels += Y0 - Edge + 1;
+
+        Edge = Y1;
+        while (Edge < Y1 + 2 * S && FullMask.IsRoom(X, Edge + 1))
+        {
+            ++Edge;
+        }
+        Bottom = FMath::Max(Bottom, Edge);
+        RefinedPixels += Edge - Y1 + 1;
+    }
+
+    const int32 RoomWidth = Right - Left;
+    const int32 RoomHeight = Bottom - Top;
+    if (RoomWidth <= Settings.MinRoomSizePixels || RoomHeight <= Settings.MinRoomSizePixels)
+    {
+        return;
+    }
+
+    FRoomData Room;
+    Room.RoomName = FString::Printf(TEXT("Room_%d"), Rooms.Num() + 1);
+    Room.BoundaryPoints.Add(PixelToWorld(Left, Top));
+    Room.BoundaryPoints.Add(PixelToWorld(Right, Top));
+    Room.BoundaryPoints.Add(PixelToWorld(Right, Bottom));
+    Room.BoundaryPoints.Add(PixelToWorld(Left, Bottom));
+    Room.Center = PixelToWorld((Left + Right) / 2, (Top + Bottom) / 2);
+    Room.Dimensions = PixelToWorld(RoomWidth, RoomHeight);
+    Rooms.Add(Room);
+}
+
+void FFloorPlanPyramidAnalyzer::RefineWalls()
+{
+    const FFloorPlanMask& Coarse = GetCoarse();
+    const int32 S = CellSize;
+    const int32 Spacing = Settings.WallPointSpacingPixels;
+    const int32 CellsPerSide = FMath::DivideAndRoundUp(S, Spacing);
+
+    TBitArray<> SpacingCells(false, CellsPerSide * CellsPerSide);
+
+    for (int32 CY = 0; CY < Coarse.Height; ++CY)
+    {
+        for (int32 CX = 0; CX < Coarse.Width; ++CX)
+        {
+            if (Coarse.Get(CX, CY) != FFloorPlanMask::Wall)
+            {
+                continue;
+            }
+
+            // Only coarse wall cells are scanned at full resolution
+            SpacingCells.SetRange(0, SpacingCells.Num(), false);
+            const int32 BlockX = CX * S;
+            const int32 BlockY = CY * S;
+            const int32 BlockX1 = FMath::Min(BlockX + S, FullMask.Width);
+            const int32 BlockY1 = FMath::Min(BlockY + S, FullMask.Height);
+            RefinedPixels += static_cast<int64>(BlockX1 - BlockX) * (BlockY1 - BlockY);
+
+            for (int32 Y = BlockY; Y < BlockY1; ++Y)
+            {
+                for (int32 X = BlockX; X < BlockX1; ++X)
+                {
+                    const int32 SpacingCell = ((Y - BlockY) / Spacing) * CellsPerSide + (X - BlockX) / Spacing;
+                    if (SpacingCells[SpacingCell] || FullMask.Get(X, Y) != FFloorPlanMask::Wall)
+                    {
+                        continue;
+                    }
+
+                    // A wall pixel needs at least one black 8-neighbor
+                    bool bHasNeighbor = false;
+                    for (int32 DY = -1; DY <= 1 && !bHasNeighbor; ++DY)
+                    {
+                        for (int32 DX = -1; DX <= 1 && !bHasNeighbor; ++DX)
+                        {
+                            bHasNeighbor = (DX != 0 || DY != 0) && FullMask.IsWall(X + DX, Y + DY);
+                        }
+                    }
+
+                    if (bHasNeighbor)
+                    {
+                        SpacingCells[SpacingCell] = true;
+                        WallPoints.Add(PixelToWorld(X, Y));
+                    }
+                }
+            }
+        }
+    }
+}
+
+void FFloorPlanPyramidAnalyzer::DetectOpenings()
+{
+    const FFloorPlanMask& Coarse = GetCoarse();
+    const float CellWorldSize = CellSize * Settings.ScaleFactor / 10.0f;
+    const int32 MaxGapCells = FMath::Max(1, FMath::FloorToInt(Settings.MaxOpeningWidth / CellWorldSize));
+
+    // A gap is a short run of non-wall cells between two wall runs along the same coarse line
+    auto ScanLine = [&](int32 Line, int32 Length, bool bHorizontalWall)
+    {
+        auto IsWallCell = [&](int32 Along)
+        {
+            return bHorizontalWall ? Coarse.Get(Along, Line) == FFloorPlanMask::Wall : Coarse.Get(Line, Along) == FFloorPlanMask::Wall;
+        };
+
+        int32 PrevRunStart = INDEX_NONE;
+        int32 PrevRunEnd = INDEX_NONE;
+        int32 Along = 0;
+        while (Along < Length)
+        {
+            if (!IsWallCell(Along))
+            {
+                ++Along;
+                continue;
+            }
+
+            const int32 RunStart = Along;
+            while (Along < Length && IsWallCell(Along))
+            {
+                ++Along;
+            }
+            const int32 RunEnd = Along - 1;
+
+            if (PrevRunEnd != INDEX_NONE)
+            {
+                const int32 GapCells = RunStart - PrevRunEnd - 1;
+                const bool bFlanked = PrevRunEnd - PrevRunStart + 1 >= Settings.MinFlankingWallCells &&
+                                      RunEnd - RunStart + 1 >= Settings.MinFlankingWallCells;
+                if (GapCells > 0 && GapCells <= MaxGapCells && bFlanked)
+                {
+                    RefineOpening(Line, PrevRunEnd + 1, RunStart - 1, bHorizontalWall);
+                }
+            }
+
+            PrevRunStart = RunStart;
+            PrevRunEnd = RunEnd;
+        }
+    };
+
+    for (int32 Y = 0; Y < Coarse.Height; ++Y)
+    {
+        ScanLine(Y, Coarse.Width, true);
+    }
+    for (int32 X = 0; X < Coarse.Width; ++X)
+    {
+        ScanLine(X, Coarse.Height, false);
+    }
+}
+
+void FFloorPlanPyramidAnalyzer::RefineOpening(int32 Line, int32 GapStart, int32 GapEnd, bool bHorizontalWall)
+{
+    const int32 S = CellSize;
+    const int32 AlongLimit = bHorizontalWall ? FullMask.Width : FullMask.Height;
+    const int32 AcrossLimit = bHorizontalWall ? FullMask.Height : FullMask.Width;
+
+    auto IsWallAt = [&](int32 Along, int32 Across)
+    {
+        return bHorizontalWall ? FullMask.IsWall(Along, Across) : FullMask.IsWall(Across, Along);
+    };
+
+    // Search one cell beyond the gap along the wall and one cell either side across it
+    const int32 AlongMin = FMath::Max(0, (GapStart - 1) * S);
+    const int32 AlongMax = FMath::Min(AlongLimit - 1, (GapEnd + 2) * S - 1);
+    const int32 AcrossMin = FMath::Max(0, (Line - 1) * S);
+    const int32 AcrossMax = FMath::Min(AcrossLimit - 1, (Line + 2) * S - 1);
+    const int32 Center = ((GapStart + GapEnd + 1) * S) / 2;
+
+    TArray<int32> Starts;
+    TArray<int32> Ends;
+    int32 FirstRow = INDEX_NONE;
+    int32 LastRow = INDEX_NONE;
+
+    for (int32 Across = AcrossMin; Across <= AcrossMax; ++Across)
+    {
+        RefinedPixels += AlongMax - AlongMin + 1;
+        if (IsWallAt(Center, Across))
+        {
+            continue;
+        }
+
+        int32 Start = Center;
+        while (Start > AlongMin && !IsWallAt(Start - 1, Across))
+        {
+            --Start;
+        }
+        int32 End = Center;
+        while (End < AlongMax && !IsWallAt(End + 1, Across))
+        {
+            ++End;
+        }
+
+        // Both ends must hit the wall, otherwise this scanline runs through the room beside the wall
+        if (Start > AlongMin && End < AlongMax)
+        {
+            Starts.Add(Start);
+            Ends.Add(End);
+            FirstRow = FirstRow == INDEX_NONE ? Across : FirstRow;
+            LastRow = Across;
+        }
+    }
+
+    if (Starts.Num() == 0)
+    {
+        return;
+    }
+
+    Starts.Sort();
+    Ends.Sort();
+    const int32 OpeningStart = Starts[Starts.Num() / 2];
+    const int32 OpeningEnd = Ends[Ends.Num() / 2];
+    const float AlongCenter = (OpeningStart + OpeningEnd) * 0.5f;
+    const float AcrossCenter = (FirstRow + LastRow) * 0.5f;
+
+    FOpeningData Opening;
+    Opening.bIsDoor = true;
+    Opening.Position = bHorizontalWall ? PixelToWorld(AlongCenter, AcrossCenter) : PixelToWorld(AcrossCenter, AlongCenter);
+    Opening.Size = PixelToWorld(OpeningEnd - OpeningStart + 1, LastRow - FirstRow + 1);
+    Opening.Rotation = bHorizontalWall ? 0.0f : 90.0f;
+
+    // Thick walls span two coarse lines and report the same gap twice
+    const float DuplicateDistance = S * Settings.ScaleFactor / 10.0f * 2.0f;
+    for (const FOpeningData& Existing : Openings)
+    {
+        if (Existing.Rotation == Opening.Rotation && FVector2D::Distance(Existing.Position, Opening.Position) < DuplicateDistance)
+        {
+            return;
+        }
+    }
+
+    Openings.Add(Opening);
+}
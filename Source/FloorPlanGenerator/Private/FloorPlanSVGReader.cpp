@@ -0,0 +1,786 @@
+#include "FloorPlanSVGReader.h"
+#include "FloorPlanLog.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+namespace FloorPlanSVGReaderPrivate
+{
+    bool IsSeparator(TCHAR Character)
+    {
+        return FChar::IsWhitespace(Character) || Character == TEXT(',');
+    }
+
+    void SkipSeparators(const TCHAR*& Cursor)
+    {
+        while (*Cursor && IsSeparator(*Cursor))
+        {
+            ++Cursor;
+        }
+    }
+
+    // SVG numbers may follow each other without separators, e.g. "1.5.5" or "10-5e-1"
+    bool ParseNumber(const TCHAR*& Cursor, float& OutValue)
+    {
+        SkipSeparators(Cursor);
+        const TCHAR* Start = Cursor;
+        if (*Cursor == TEXT('+') || *Cursor == TEXT('-'))
+        {
+            ++Cursor;
+        }
+
+        bool bDigits = false;
+        bool bDot = false;
+        while (FChar::IsDigit(*Cursor) || (*Cursor == TEXT('.') && !bDot))
+        {
+            bDot |= *Cursor == TEXT('.');
+            bDigits |= FChar::IsDigit(*Cursor);
+            ++Cursor;
+        }
+
+        if (bDigits && (*Cursor == TEXT('e') || *Cursor == TEXT('E')) &&
+            (FChar::IsDigit(Cursor[1]) || ((Cursor[1] == TEXT('-') || Cursor[1] == TEXT('+')) && FChar::IsDigit(Cursor[2]))))
+        {
+            Cursor += 2;
+            while (FChar::IsDigit(*Cursor))
+            {
+                ++Cursor;
+            }
+        }
+
+        if (!bDigits)
+        {
+            Cursor = Start;
+            return false;
+        }
+
+        OutValue = FCString::Atof(*FString::ConstructFromPtrSize(Start, static_cast<int32>(Cursor - Start)));
+        return true;
+    }
+
+    // Arc flags are single characters and may be packed together, e.g. "a10 10 0 0110 10"
+    bool ParseFlag(const TCHAR*& Cursor, bool& OutFlag)
+    {
+        SkipSeparators(Cursor);
+        if (*Cursor != TEXT('0') && *Cursor != TEXT('1'))
+        {
+            return false;
+        }
+        OutFlag = *Cursor++ == TEXT('1');
+        return true;
+    }
+
+    void ParseNumbers(const FString& Text, TArray<float>& OutNumbers)
+    {
+        const TCHAR* Cursor = *Text;
+        float Value = 0.0f;
+        while (*Cursor)
+        {
+            if (ParseNumber(Cursor, Value))
+            {
+                OutNumbers.Add(Value);
+            }
+            else
+            {
+                ++Cursor;
+            }
+        }
+    }
+
+    float GetNumber(const TMap<FString, FString>& Attributes, const TCHAR* Name, float Default = 0.0f)
+    {
+        const FString* Value = Attributes.Find(Name);
+        const TCHAR* Cursor = Value ? **Value : TEXT("");
+        float Number = Default;
+        return ParseNumber(Cursor, Number) ? Number : Default;
+    }
+
+    FString DecodeEntities(const FString& Text)
+    {
+        FString Result;
+        Result.Reserve(Text.Len());
+        for (int32 Index = 0; Index < Text.Len(); ++Index)
+        {
+            const int32 Semicolon = Text[Index] == TEXT('&') ? Text.Find(TEXT(";"), ESearchCase::CaseSensitive, ESearchDir::FromStart, Index) : INDEX_NONE;
+            if (Semicolon == INDEX_NONE || Semicolon - Index > 8)
+            {
+                Result.AppendChar(FChar::IsWhitespace(Text[Index]) ? TEXT(' ') : Text[Index]);
+                continue;
+            }
+
+            const FString Entity = Text.Mid(Index + 1, Semicolon - Index - 1);
+            if (Entity == TEXT("amp")) { Result.AppendChar(TEXT('&')); }
+            else if (Entity == TEXT("lt")) { Result.AppendChar(TEXT('<')); }
+            else if (Entity == TEXT("gt")) { Result.AppendChar(TEXT('>')); }
+            else if (Entity == TEXT("quot")) { Result.AppendChar(TEXT('"')); }
+            else if (Entity == TEXT("apos")) { Result.AppendChar(TEXT('\'')); }
+            else if (Entity.StartsWith(TEXT("#x"))) { Result.AppendChar(static_cast<TCHAR>(FParse::HexNumber(*Entity.Mid(2)))); }
+            else if (Entity.StartsWith(TEXT("#"))) { Result.AppendChar(static_cast<TCHAR>(FCString::Atoi(*Entity.Mid(1)))); }
+            else { Result.AppendChar(TEXT(' ')); }
+            Index = Semicolon;
+        }
+
+        // Collapse runs of whitespace like SVG rendering does
+        FString Collapsed;
+        for (TCHAR Character : Result)
+        {
+            if (Character != TEXT(' ') || (Collapsed.Len() > 0 && Collapsed[Collapsed.Len() - 1] != TEXT(' ')))
+            {
+                Collapsed.AppendChar(Character);
+            }
+        }
+        return Collapsed.TrimStartAndEnd();
+    }
+
+    // Arcs stay arcs only under rotations, uniform scales and mirrors
+    bool IsSimilarity(const FFloorPlanVectorTransform& Transform)
+    {
+        const float LengthX = Transform.AxisX.Size();
+        const float LengthY = Transform.AxisY.Size();
+        return FMath::Abs(LengthX - LengthY) <= 1.0e-3f * LengthX &&
+               FMath::Abs(FVector2D::DotProduct(Transform.AxisX, Transform.AxisY)) <= 1.0e-3f * LengthX * LengthY;
+    }
+}
+
+FFloorPlanSVGReader::FFloorPlanSVGReader(const FFloorPlanVectorReadSettings& InSettings)
+    : Settings(InSettings)
+{
+}
+
+bool FFloorPlanSVGReader::Read(const FString& FilePath, FFloorPlanVectorScene& OutScene)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(FFloorPlanSVGReader::Read);
+
+    FString Markup;
+    if (!FFileHelper::LoadFileToString(Markup, *FilePath))
+    {
+        UE_LOG(LogFloorPlan, Error, TEXT("FloorPlanSVGReader: Could not open %s"), *FilePath);
+        return false;
+    }
+
+    Parse(Markup, OutScene);
+
+    UE_LOG(LogFloorPlan, Log, TEXT("FloorPlanSVGReader: %s -> %d lines, %d arcs, %d texts, %d polygons on %d layers"),
+           *FPaths::GetCleanFilename(FilePath), OutScene.Lines.Num(), OutScene.Arcs.Num(), OutScene.Texts.Num(),
+           OutScene.Polygons.Num(), OutScene.Layers.Num());
+    return true;
+}
+
+void FFloorPlanSVGReader::Parse(const FString& Markup, FFloorPlanVectorScene& OutScene)
+{
+    using namespace FloorPlanSVGReaderPrivate;
+
+    Scene = &OutScene;
+    Scene->Reset();
+
+    TArray<FElementState> Stack;
+    FElementState& Root = Stack.AddDefaulted_GetRef();
+    Root.Transform = FFloorPlanVectorTransform(Settings.UnitToCm, 0.0f, 0.0f, Settings.UnitToCm, 0.0f, 0.0f);
+
+    // Text content is collected between <text> and </text>, nested tspans included
+    bool bInText = false;
+    int32 TextDepth = 0;
+    int32 TextLayer = INDEX_NONE;
+    FVector2D TextPosition = FVector2D::ZeroVector;
+    float TextHeight = 0.0f;
+    FString TextContent;
+
+    TMap<FString, FString> Attributes;
+    FString Name;
+    const int32 Length = Markup.Len();
+    int32 Index = 0;
+
+    while (Index < Length)
+    {
+        const int32 TagStart = Markup.Find(TEXT("<"), ESearchCase::CaseSensitive, ESearchDir::FromStart, Index);
+        if (TagStart == INDEX_NONE)
+        {
+            break;
+        }
+
+        if (bInText)
+        {
+            TextContent += Markup.Mid(Index, TagStart - Index);
+        }
+
+        // Comments, declarations and processing instructions; CDATA counts as text
+        const TCHAR* Tag = *Markup + TagStart;
+        if (FCString::Strncmp(Tag, TEXT("<!--"), 4) == 0 || FCString::Strncmp(Tag, TEXT("<![CDATA["), 9) == 0 || Tag[1] == TEXT('?') || Tag[1] == TEXT('!'))
+        {
+            const bool bComment = Tag[2] == TEXT('-');
+            const bool bCData = Tag[2] == TEXT('[');
+            const TCHAR* Terminator = bComment ? TEXT("-->") : (bCData ? TEXT("]]>") : TEXT(">"));
+            const int32 End = Markup.Find(Terminator, ESearchCase::CaseSensitive, ESearchDir::FromStart, TagStart);
+            if (bCData && bInText && End != INDEX_NONE)
+            {
+                TextContent += Markup.Mid(TagStart + 9, End - TagStart - 9);
+            }
+            Index = End == INDEX_NONE ? Length : End + FCString::Strlen(Terminator);
+            continue;
+        }
+
+        const int32 TagEnd = Markup.Find(TEXT(">"), ESearchCase::CaseSensitive, ESearchDir::FromStart, TagStart);
+        if (TagEnd == INDEX_NONE)
+        {
+            break;
+        }
+        Index = TagEnd + 1;
+
+        const bool bClosing = Tag[1] == TEXT('/');
+        const bool bSelfClosing = Markup[TagEnd - 1] == TEXT('/');
+
+        // Element name without any namespace prefix
+        int32 Cursor = TagStart + (bClosing ? 2 : 1);
+        const int32 NameStart = Cursor;
+        while (Cursor < TagEnd && !FChar::IsWhitespace(Markup[Cursor]) && Markup[Cursor] != TEXT('/') && Markup[Cursor] != TEXT('>'))
+        {
+            ++Cursor;
+        }
+        Name = Markup.Mid(NameStart, Cursor - NameStart);
+        int32 Colon = INDEX_NONE;
+        if (Name.FindChar(TEXT(':'), Colon))
+        {
+            Name.RightChopInline(Colon + 1);
+        }
+
+        if (bClosing)
+        {
+            if (bInText && Name == TEXT("text") && Stack.Num() == TextDepth)
+            {
+                if (TextLayer != INDEX_NONE)
+                {
+                    Scene->AddText(TextPosition, TextHeight, DecodeEntities(TextContent), TextLayer);
+                }
+                bInText = false;
+            }
+            if (Stack.Num() > 1)
+            {
+                Stack.Pop();
+            }
+            continue;
+        }
+
+        // Attributes, values in single or double quotes
+        Attributes.Reset();
+        while (Cursor < TagEnd)
+        {
+            while (Cursor < TagEnd && (FChar::IsWhitespace(Markup[Cursor]) || Markup[Cursor] == TEXT('/')))
+            {
+                ++Cursor;
+            }
+            const int32 KeyStart = Cursor;
+            while (Cursor < TagEnd && Markup[Cursor] != TEXT('=') && !FChar::IsWhitespace(Markup[Cursor]))
+            {
+                ++Cursor;
+            }
+            const FString Key = Markup.Mid(KeyStart, Cursor - KeyStart);
+            while (Cursor < TagEnd && Markup[Cursor] != TEXT('"') && Markup[Cursor] != TEXT('\''))
+            {
+                ++Cursor;
+            }
+            if (Cursor >= TagEnd)
+            {
+                break;
+            }
+
+            const TCHAR Quote = Markup[Cursor];
+            const int32 ValueEnd = Markup.Find(FString(1, &Quote), ESearchCase::CaseSensitive, ESearchDir::FromStart, Cursor + 1);
+            if (ValueEnd == INDEX_NONE)
+            {
+                break;
+            }
+            Attributes.Add(Key, Markup.Mid(Cursor + 1, ValueEnd - Cursor - 1));
+            Cursor = ValueEnd + 1;
+
+            // A quoted '>' ends the search early, continue behind the real end of the tag
+            if (ValueEnd > TagEnd)
+            {
+                const int32 RealEnd = Markup.Find(TEXT(">"), ESearchCase::CaseSensitive, ESearchDir::FromStart, ValueEnd);
+                Index = RealEnd == INDEX_NONE ? Length : RealEnd + 1;
+                break;
+            }
+        }
+
+        FElementState Child = Stack.Last();
+        if (const FString* Transform = Attributes.Find(TEXT("transform")))
+        {
+            Child.Transform = ParseTransform(*Transform).Then(Child.Transform);
+        }
+
+        static const TCHAR* NonRendered[] = {
+            TEXT("defs"), TEXT("symbol"), TEXT("clipPath"), TEXT("mask"), TEXT("pattern"), TEXT("marker"), TEXT("title"), TEXT("desc"), TEXT("metadata")
+        };
+        for (const TCHAR* Skipped : NonRendered)
+        {
+            Child.bSkip |= Name == Skipped;
+        }
+        const FString* Display = Attributes.Find(TEXT("display"));
+        const FString* Style = Attributes.Find(TEXT("style"));
+        Child.bSkip |= (Display && *Display == TEXT("none")) || (Style && Style->Contains(TEXT("display:none")));
+
+        // Top-level named groups are the layers of exported plans
+        if (Name == TEXT("g") && Child.Layer.IsEmpty())
+        {
+            const FString* Label = Attributes.Find(TEXT("inkscape:label"));
+            Label = Label ? Label : Attributes.Find(TEXT("id"));
+            Child.Layer = Label ? *Label : FString();
+        }
+
+        if (!Child.bSkip)
+        {
+            if (Name == TEXT("text") && !bSelfClosing)
+            {
+                bInText = true;
+                TextDepth = Stack.Num() + 1;
+                TextContent.Reset();
+                TextLayer = Scene->FindOrAddFilteredLayer(Child.Layer.IsEmpty() ? FString(TEXT("0")) : Child.Layer, Settings);
+                TextPosition = Child.Transform.Apply(FVector2D(GetNumber(Attributes, TEXT("x")), GetNumber(Attributes, TEXT("y"))));
+                TextHeight = GetFontSize(Attributes, 16.0f) * FMath::Sqrt(FMath::Abs(Child.Transform.GetDeterminant()));
+            }
+            else if (Name == TEXT("tspan") && bInText && TextContent.TrimStartAndEnd().IsEmpty() && Attributes.Contains(TEXT("x")))
+            {
+                TextPosition = Child.Transform.Apply(FVector2D(GetNumber(Attributes, TEXT("x")), GetNumber(Attributes, TEXT("y"))));
+            }
+            else
+            {
+                HandleElement(Name, Attributes, Child);
+            }
+        }
+
+        if (!bSelfClosing)
+        {
+            Stack.Add(Child);
+        }
+    }
+
+    Scene->NormalizeToOrigin(false);
+    Scene = nullptr;
+}
+
+void FFloorPlanSVGReader::HandleElement(const FString& Name, const TMap<FString, FString>& Attributes, const FElementState& State)
+{
+    using namespace FloorPlanSVGReaderPrivate;
+
+    const int32 Layer = Scene->FindOrAddFilteredLayer(State.Layer.IsEmpty() ? FString(TEXT("0")) : State.Layer, Settings);
+    if (Layer == INDEX_NONE)
+    {
+        return;
+    }
+
+    const FFloorPlanVectorTransform& Transform = State.Transform;
+    if (Name == TEXT("path"))
+    {
+        if (const FString* Data = Attributes.Find(TEXT("d")))
+        {
+            ParsePath(*Data, Transform, Layer);
+        }
+    }
+    else if (Name == TEXT("line"))
+    {
+        Scene->AddLine(Transform.Apply(FVector2D(GetNumber(Attributes, TEXT("x1")), GetNumber(Attributes, TEXT("y1")))),
+                       Transform.Apply(FVector2D(GetNumber(Attributes, TEXT("x2")), GetNumber(Attributes, TEXT("y2")))), Layer);
+    }
+    else if (Name == TEXT("polyline") || Name == TEXT("polygon"))
+    {
+        TArray<float> Numbers;
+        if (const FString* Points = Attributes.Find(TEXT("points")))
+        {
+            ParseNumbers(*Points, Numbers);
+        }
+
+        TArray<FVector2D> Points;
+        for (int32 Number = 0; Number + 1 < Numbers.Num(); Number += 2)
+        {
+            Points.Add(FVector2D(Numbers[Number], Numbers[Number + 1]));
+        }
+        AddPolyline(Points, Name == TEXT("polygon"), Transform, Layer);
+    }
+    else if (Name == TEXT("rect"))
+    {
+        const float X = GetNumber(Attributes, TEXT("x"));
+        const float Y = GetNumber(Attributes, TEXT("y"));
+        const float Width = GetNumber(Attributes, TEXT("width"));
+        const float Height = GetNumber(Attributes, TEXT("height"));
+        if (Width > 0.0f && Height > 0.0f)
+        {
+            AddPolyline({ FVector2D(X, Y), FVector2D(X + Width, Y), FVector2D(X + Width, Y + Height), FVector2D(X, Y + Height) }, true, Transform, Layer);
+        }
+    }
+    else if (Name == TEXT("circle") || Name == TEXT("ellipse"))
+    {
+        const FVector2D Center(GetNumber(Attributes, TEXT("cx")), GetNumber(Attributes, TEXT("cy")));
+        const float RadiusX = Name == TEXT("circle") ? GetNumber(Attributes, TEXT("r")) : GetNumber(Attributes, TEXT("rx"));
+        const float RadiusY = Name == TEXT("circle") ? RadiusX : GetNumber(Attributes, TEXT("ry"), RadiusX);
+        if (RadiusX <= 0.0f || RadiusY <= 0.0f)
+        {
+            return;
+        }
+
+        if (FMath::IsNearlyEqual(RadiusX, RadiusY, RadiusX * 0.01f) && IsSimilarity(Transform))
+        {
+            Scene->AddArc(Transform.Apply(Center), RadiusX * FMath::Sqrt(FMath::Abs(Transform.GetDeterminant())), 0.0f, 360.0f, Layer);
+            return;
+        }
+
+        TArray<FVector2D> Points;
+        for (int32 Step = 0; Step < 32; ++Step)
+        {
+            const float Angle = UE_TWO_PI * Step / 32.0f;
+            Points.Add(Center + FVector2D(RadiusX * FMath::Cos(Angle), RadiusY * FMath::Sin(Angle)));
+        }
+        AddPolyline(Points, true, Transform, Layer);
+    }
+}
+
+void FFloorPlanSVGReader::ParsePath(const FString& Data, const FFloorPlanVectorTransform& Transform, int32 Layer)
+{
+    using namespace FloorPlanSVGReaderPrivate;
+
+    const TCHAR* Cursor = *Data;
+    TCHAR Command = 0;
+    TCHAR PreviousCommand = 0;
+    FVector2D Current = FVector2D::ZeroVector;
+    FVector2D SubpathStart = FVector2D::ZeroVector;
+    FVector2D LastControl = FVector2D::ZeroVector;
+
+    // Straight closed subpaths are kept as outlines too (room and area shapes)
+    TArray<FVector2D> Subpath;
+    bool bSubpathStraight = true;
+
+    auto LineTo = [&](const FVector2D& Point)
+    {
+        Scene->AddLine(Transform.Apply(Current), Transform.Apply(Point), Layer);
+        Subpath.Add(Point);
+        Current = Point;
+    };
+
+    while (true)
+    {
+        SkipSeparators(Cursor);
+        if (!*Cursor)
+        {
+            break;
+        }
+
+        if (FChar::IsAlpha(*Cursor))
+        {
+            Command = *Cursor++;
+            if (Command == TEXT('Z') || Command == TEXT('z'))
+            {
+                if (!Current.Equals(SubpathStart))
+                {
+                    Scene->AddLine(Transform.Apply(Current), Transform.Apply(SubpathStart), Layer);
+                }
+                if (bSubpathStraight && Subpath.Num() >= 3)
+                {
+                    TArray<FVector2D> Outline;
+                    for (const FVector2D& Point : Subpath)
+                    {
+                        Outline.Add(Transform.Apply(Point));
+                    }
+                    Scene->AddPolygon(MoveTemp(Outline), Layer);
+                }
+                Current = SubpathStart;
+                Subpath.Reset();
+                Subpath.Add(Current);
+                bSubpathStraight = true;
+                PreviousCommand = Command;
+                continue;
+            }
+        }
+        else if (!Command)
+        {
+            break;
+        }
+
+        const bool bRelative = FChar::IsLower(Command);
+        const FVector2D Origin = bRelative ? Current : FVector2D::ZeroVector;
+        const TCHAR Upper = FChar::ToUpper(Command);
+        float Values[7];
+        auto Read = [&Cursor, &Values](int32 Count)
+        {
+            for (int32 Value = 0; Value < Count; ++Value)
+            {
+                if (!ParseNumber(Cursor, Values[Value]))
+                {
+                    return false;
+                }
+            }
+            return true;
+        };
+
+        bool bParsed = true;
+        switch (Upper)
+        {
+        case TEXT('M'):
+            if ((bParsed = Read(2)))
+            {
+                Current = SubpathStart = Origin + FVector2D(Values[0], Values[1]);
+                Subpath.Reset();
+                Subpath.Add(Current);
+                bSubpathStraight = true;
+
+                // Further pairs after a moveto are implicit linetos
+                Command = bRelative ? TEXT('l') : TEXT('L');
+            }
+            break;
+        case TEXT('L'):
+            if ((bParsed = Read(2)))
+            {
+                LineTo(Origin + FVector2D(Values[0], Values[1]));
+            }
+            break;
+        case TEXT('H'):
+            if ((bParsed = Read(1)))
+            {
+                LineTo(FVector2D(bRelative ? Current.X + Values[0] : Values[0], Current.Y));
+            }
+            break;
+        case TEXT('V'):
+            if ((bParsed = Read(1)))
+            {
+                LineTo(FVector2D(Current.X, bRelative ? Current.Y + Values[0] : Values[0]));
+            }
+            break;
+        case TEXT('C'):
+        case TEXT('S'):
+        case TEXT('Q'):
+        case TEXT('T'):
+        {
+            const TCHAR PreviousUpper = FChar::ToUpper(PreviousCommand);
+            const bool bSmooth = Upper == TEXT('S') || Upper == TEXT('T');
+            const bool bQuadratic = Upper == TEXT('Q') || Upper == TEXT('T');
+            const int32 Count = Upper == TEXT('C') ? 6 : (Upper == TEXT('T') ? 2 : 4);
+            if (!(bParsed = Read(Count)))
+            {
+                break;
+            }
+
+            // Smooth segments reflect the previous control point when the previous segment was of the same kind
+            const bool bReflect = bQuadratic ? (PreviousUpper == TEXT('Q') || PreviousUpper == TEXT('T')) : (PreviousUpper == TEXT('C') || PreviousUpper == TEXT('S'));
+            const FVector2D Reflected = bReflect ? Current * 2.0f - LastControl : Current;
+            const FVector2D First = bSmooth ? Reflected : Origin + FVector2D(Values[0], Values[1]);
+            const int32 Next = bSmooth ? 0 : 2;
+            const FVector2D Second = Upper == TEXT('C') || Upper == TEXT('S') ? Origin + FVector2D(Values[Next], Values[Next + 1]) : First;
+            const int32 EndIndex = Count - 2;
+            const FVector2D End = Origin + FVector2D(Values[EndIndex], Values[EndIndex + 1]);
+
+            if (bQuadratic)
+            {
+                Scene->AddCubic(Transform.Apply(Current), Transform.Apply(Current + (First - Current) * (2.0f / 3.0f)),
+                                Transform.Apply(End + (First - End) * (2.0f / 3.0f)), Transform.Apply(End), Layer);
+                LastControl = First;
+            }
+            else
+            {
+                Scene->AddCubic(Transform.Apply(Current), Transform.Apply(First), Transform.Apply(Second), Transform.Apply(End), Layer);
+                LastControl = Second;
+            }
+            Subpath.Add(End);
+            bSubpathStraight = false;
+            Current = End;
+            break;
+        }
+        case TEXT('A'):
+        {
+            bool bLargeArc = false;
+            bool bSweep = false;
+            if (!(bParsed = Read(3) && ParseFlag(Cursor, bLargeArc) && ParseFlag(Cursor, bSweep) && ParseNumber(Cursor, Values[3]) && ParseNumber(Cursor, Values[4])))
+            {
+                break;
+            }
+
+            const FVector2D End = Origin + FVector2D(Values[3], Values[4]);
+            AddEllipticalArc(Current, FVector2D(Values[0], Values[1]), Values[2], bLargeArc, bSweep, End, Transform, Layer);
+            Subpath.Add(End);
+            bSubpathStraight = false;
+            Current = End;
+            break;
+        }
+        default:
+            bParsed = false;
+            break;
+        }
+
+        if (!bParsed)
+        {
+            UE_LOG(LogFloorPlan, Verbose, TEXT("FloorPlanSVGReader: Stopped at malformed path data near '%s'"), *FString(Cursor).Left(16));
+            break;
+        }
+        PreviousCommand = Command;
+    }
+}
+
+void FFloorPlanSVGReader::AddEllipticalArc(const FVector2D& From, const FVector2D& Radii, float XAxisRotation, bool bLargeArc, bool bSweep,
+                                           const FVector2D& To, const FFloorPlanVectorTransform& Transform, int32 Layer)
+{
+    using namespace FloorPlanSVGReaderPrivate;
+
+    float RadiusX = FMath::Abs(Radii.X);
+    float RadiusY = FMath::Abs(Radii.Y);
+    if (RadiusX <= 0.0f || RadiusY <= 0.0f || From.Equals(To))
+    {
+        Scene->AddLine(Transform.Apply(From), Transform.Apply(To), Layer);
+        return;
+    }
+
+    // Endpoint to center parameterization (SVG implementation notes, F.6.5)
+    const float Phi = FMath::DegreesToRadians(XAxisRotation);
+    const float CosPhi = FMath::Cos(Phi);
+    const float SinPhi = FMath::Sin(Phi);
+    const FVector2D Half = (From - To) * 0.5f;
+    const FVector2D Prime(CosPhi * Half.X + SinPhi * Half.Y, -SinPhi * Half.X + CosPhi * Half.Y);
+
+    const float Lambda = FMath::Square(Prime.X / RadiusX) + FMath::Square(Prime.Y / RadiusY);
+    if (Lambda > 1.0f)
+    {
+        RadiusX *= FMath::Sqrt(Lambda);
+        RadiusY *= FMath::Sqrt(Lambda);
+    }
+
+    const float Numerator = FMath::Square(RadiusX * RadiusY) - FMath::Square(RadiusX * Prime.Y) - FMath::Square(RadiusY * Prime.X);
+    const float Denominator = FMath::Square(RadiusX * Prime.Y) + FMath::Square(RadiusY * Prime.X);
+    const float Coefficient = FMath::Sqrt(FMath::Max(0.0f, Numerator / Denominator)) * (bLargeArc == bSweep ? -1.0f : 1.0f);
+    const FVector2D CenterPrime(Coefficient * RadiusX * Prime.Y / RadiusY, -Coefficient * RadiusY * Prime.X / RadiusX);
+    const FVector2D Center(CosPhi * CenterPrime.X - SinPhi * CenterPrime.Y + (From.X + To.X) * 0.5f,
+                           SinPhi * CenterPrime.X + CosPhi * CenterPrime.Y + (From.Y + To.Y) * 0.5f);
+
+    const float Theta = FMath::Atan2((Prime.Y - CenterPrime.Y) / RadiusY, (Prime.X - CenterPrime.X) / RadiusX);
+    float Delta = FMath::Atan2((-Prime.Y - CenterPrime.Y) / RadiusY, (-Prime.X - CenterPrime.X) / RadiusX) - Theta;
+    if (bSweep && Delta < 0.0f)
+    {
+        Delta += UE_TWO_PI;
+    }
+    else if (!bSweep && Delta > 0.0f)
+    {
+        Delta -= UE_TWO_PI;
+    }
+
+    auto PointAt = [&](float Angle)
+    {
+        return FVector2D(Center.X + RadiusX * CosPhi * FMath::Cos(Angle) - RadiusY * SinPhi * FMath::Sin(Angle),
+                         Center.Y + RadiusX * SinPhi * FMath::Cos(Angle) + RadiusY * CosPhi * FMath::Sin(Angle));
+    };
+
+    if (FMath::IsNearlyEqual(RadiusX, RadiusY, RadiusX * 0.01f) && IsSimilarity(Transform))
+    {
+        Scene->AddArcThroughPoints(Transform.Apply(From), Transform.Apply(PointAt(Theta + Delta * 0.5f)), Transform.Apply(To), Layer);
+        return;
+    }
+
+    FVector2D Previous = From;
+    for (int32 Step = 1; Step <= 16; ++Step)
+    {
+        const FVector2D Next = Step == 16 ? To : PointAt(Theta + Delta * Step / 16.0f);
+        Scene->AddLine(Transform.Apply(Previous), Transform.Apply(Next), Layer);
+        Previous = Next;
+    }
+}
+
+void FFloorPlanSVGReader::AddPolyline(const TArray<FVector2D>& Points, bool bClosed, const FFloorPlanVectorTransform& Transform, int32 Layer)
+{
+    TArray<FVector2D> Mapped;
+    Mapped.Reserve(Points.Num());
+    for (const FVector2D& Point : Points)
+    {
+        Mapped.Add(Transform.Apply(Point));
+    }
+
+    for (int32 Index = 0; Index + 1 < Mapped.Num(); ++Index)
+    {
+        Scene->AddLine(Mapped[Index], Mapped[Index + 1], Layer);
+    }
+
+    if (bClosed && Mapped.Num() >= 3)
+    {
+        Scene->AddLine(Mapped.Last(), Mapped[0], Layer);
+        Scene->AddPolygon(MoveTemp(Mapped), Layer);
+    }
+}
+
+FFloorPlanVectorTransform FFloorPlanSVGReader::ParseTransform(const FString& Text)
+{
+    using namespace FloorPlanSVGReaderPrivate;
+
+    // Functions apply right to left, so each one is composed in front of the ones before it
+    FFloorPlanVectorTransform Result;
+    int32 Index = 0;
+    while (Index < Text.Len())
+    {
+        const int32 Open = Text.Find(TEXT("("), ESearchCase::CaseSensitive, ESearchDir::FromStart, Index);
+        const int32 Close = Open == INDEX_NONE ? INDEX_NONE : Text.Find(TEXT(")"), ESearchCase::CaseSensitive, ESearchDir::FromStart, Open);
+        if (Close == INDEX_NONE)
+        {
+            break;
+        }
+
+        const FString Function = Text.Mid(Index, Open - Index).TrimStartAndEnd().Replace(TEXT(","), TEXT(""));
+        TArray<float> Arguments;
+        ParseNumbers(Text.Mid(Open + 1, Close - Open - 1), Arguments);
+        while (Arguments.Num() < 6)
+        {
+            Arguments.Add(0.0f);
+        }
+        Index = Close + 1;
+
+        FFloorPlanVectorTransform Step;
+        if (Function == TEXT("matrix"))
+        {
+            Step = FFloorPlanVectorTransform(Arguments[0], Arguments[1], Arguments[2], Arguments[3], Arguments[4], Arguments[5]);
+        }
+        else if (Function == TEXT("translate"))
+        {
+            Step.Translation = FVector2D(Arguments[0], Arguments[1]);
+        }
+        else if (Function == TEXT("scale"))
+        {
+            const FString Inner = Text.Mid(Open + 1, Close - Open - 1);
+            TArray<float> Given;
+            ParseNumbers(Inner, Given);
+            const float ScaleX = Given.Num() > 0 ? Given[0] : 1.0f;
+            Step.AxisX = FVector2D(ScaleX, 0.0f);
+            Step.AxisY = FVector2D(0.0f, Given.Num() > 1 ? Given[1] : ScaleX);
+        }
+        else if (Function == TEXT("rotate"))
+        {
+            const float Radians = FMath::DegreesToRadians(Arguments[0]);
+            const FVector2D Pivot(Arguments[1], Arguments[2]);
+            Step.AxisX = FVector2D(FMath::Cos(Radians), FMath::Sin(Radians));
+            Step.AxisY = FVector2D(-Step.AxisX.Y, Step.AxisX.X);
+            Step.Translation = Pivot - (Step.AxisX * Pivot.X + Step.AxisY * Pivot.Y);
+        }
+        else if (Function == TEXT("skewX"))
+        {
+            Step.AxisY = FVector2D(FMath::Tan(FMath::DegreesToRadians(Arguments[0])), 1.0f);
+        }
+        else if (Function == TEXT("skewY"))
+        {
+            Step.AxisX = FVector2D(1.0f, FMath::Tan(FMath::DegreesToRadians(Arguments[0])));
+        }
+
+        Result = Step.Then(Result);
+    }
+    return Result;
+}
+
+float FFloorPlanSVGReader::GetFontSize(const TMap<FString, FString>& Attributes, float Default)
+{
+    using namespace FloorPlanSVGReaderPrivate;
+
+    if (Attributes.Contains(TEXT("font-size")))
+    {
+        return GetNumber(Attributes, TEXT("font-size"), Default);
+    }
+
+    if (const FString* Style = Attributes.Find(TEXT("style")))
+    {
+        const int32 Key = Style->Find(TEXT("font-size:"));
+        if (Key != INDEX_NONE)
+        {
+            const FString Value = Style->Mid(Key + 10);
+            const TCHAR* Cursor = *Value;
+            float Size = Default;
+            return ParseNumber(Cursor, Size) ? Size : Default;
+        }
+    }
+    return Default;
+}
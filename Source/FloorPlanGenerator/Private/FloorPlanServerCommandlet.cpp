@@ -0,0 +1,46 @@
+#include "FloorPlanServerCommandlet.h"
+#include "FloorPlanLog.h"
+#include "FloorPlanAnalysisServer.h"
+
+UFloorPlanServerCommandlet::UFloorPlanServerCommandlet()
+{
+    IsClient = false;
+    IsServer = false;
+    IsEditor = true;
+    LogToConsole = true;
+}
+
+int32 UFloorPlanServerCommandlet::Main(const FString& Params)
+{
+    FString Address = FString::Printf(TEXT("127.0.0.1:%d"), FFloorPlanAnalysisServer::DefaultPort);
+    FParse::Value(*Params, TEXT("Address="), Address, false);
+
+    int32 CacheMB = 2048;
+    FParse::Value(*Params, TEXT("CacheMB="), CacheMB);
+
+    FFloorPlanAnalysisServer Server;
+    if (!Server.Start(Address, static_cast<int64>(CacheMB) * 1024 * 1024))
+    {
+        return 1;
+    }
+
+    // Jobs run on this thread between short sleeps, so an idle server costs next to nothing
+    double NextReportSeconds = FPlatformTime::Seconds() + 60.0;
+    while (!IsEngineExitRequested())
+    {
+        if (Server.Tick() == 0)
+        {
+            FPlatformProcess::Sleep(0.005f);
+        }
+
+        if (FPlatformTime::Seconds() >= NextReportSeconds)
+        {
+            UE_LOG(LogFloorPlan, Display, TEXT("FloorPlanServer: %d cached results, %lld hits, %lld misses"),
+                   Server.GetNumCached(), Server.GetNumHits(), Server.GetNumMisses());
+            NextReportSeconds = FPlatformTime::Seconds() + 60.0;
+        }
+    }
+
+    Server.Stop();
+    return 0;
+}
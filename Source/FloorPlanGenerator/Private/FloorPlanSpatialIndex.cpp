@@ -0,0 +1,306 @@
+#include "FloorPlanSpatialIndex.h"
+#include "FloorPlanLog.h"
+#include "Algo/Sort.h"
+
+namespace FloorPlanSpatialIndexPrivate
+{
+    double GetBoxDistanceSq(const FBox2D& Box, const FVector2D& Point)
+    {
+        const double DX = FMath::Max3(Box.Min.X - Point.X, 0.0, Point.X - Box.Max.X);
+        const double DY = FMath::Max3(Box.Min.Y - Point.Y, 0.0, Point.Y - Box.Max.Y);
+        return DX * DX + DY * DY;
+    }
+
+    bool ContainsPoint(const TArray<FVector2D>& Polygon, const FVector2D& Point)
+    {
+        bool bInside = false;
+        for (int32 Index = 0, Previous = Polygon.Num() - 1; Index < Polygon.Num(); Previous = Index++)
+        {
+            const FVector2D& A = Polygon[Index];
+            const FVector2D& B = Polygon[Previous];
+            if ((A.Y > Point.Y) != (B.Y > Point.Y) && Point.X < (B.X - A.X) * (Point.Y - A.Y) / (B.Y - A.Y) + A.X)
+            {
+                bInside = !bInside;
+            }
+        }
+        return bInside;
+    }
+
+    double GetPolygonArea(const TArray<FVector2D>& Polygon)
+    {
+        double Area = 0.0;
+        for (int32 Index = 0, Previous = Polygon.Num() - 1; Index < Polygon.Num(); Previous = Index++)
+        {
+            Area += FVector2D::CrossProduct(Polygon[Previous], Polygon[Index]);
+        }
+        return FMath::Abs(Area) * 0.5;
+    }
+}
+
+void FFloorPlanBVH2D::Build(const TArray<FBox2D>& Boxes)
+{
+    Reset();
+    ItemBounds = Boxes;
+    Items.SetNumUninitialized(Boxes.Num());
+    for (int32 Index = 0; Index < Boxes.Num(); ++Index)
+    {
+        Items[Index] = Index;
+    }
+
+    if (Boxes.Num() > 0)
+    {
+        Nodes.Reserve(2 * Boxes.Num() / LeafSize + 1);
+        BuildNode(0, Boxes.Num());
+    }
+}
+
+void FFloorPlanBVH2D::Reset()
+{
+    Nodes.Reset();
+    Items.Reset();
+    ItemBounds.Reset();
+}
+
+int32 FFloorPlanBVH2D::BuildNode(int32 First, int32 Count)
+{
+    const int32 NodeIndex = Nodes.AddDefaulted();
+
+    FBox2D Bounds(ForceInit);
+    FBox2D CenterBounds(ForceInit);
+    for (int32 Index = First; Index < First + Count; ++Index)
+    {
+        Bounds += ItemBounds[Items[Index]];
+        CenterBounds += ItemBounds[Items[Index]].GetCenter();
+    }
+    Nodes[NodeIndex].Bounds = Bounds;
+
+    if (Count <= LeafSize)
+    {
+        Nodes[NodeIndex].First = First;
+        Nodes[NodeIndex].Count = Count;
+        return NodeIndex;
+    }
+
+    const FVector2D Size = CenterBounds.GetSize();
+    const int32 Axis = Size.X >= Size.Y ? 0 : 1;
+    TArrayView<int32> View(Items.GetData() + First, Count);
+    Algo::SortBy(View, [this, Axis](int32 Item) { return ItemBounds[Item].GetCenter()[Axis]; });
+
+    const int32 LeftCount = Count / 2;
+    BuildNode(First, LeftCount);
+    const int32 Right = BuildNode(First + LeftCount, Count - LeftCount);
+    Nodes[NodeIndex].Right = Right;
+    return NodeIndex;
+}
+
+void FFloorPlanBVH2D::QueryBox(const FBox2D& Box, TFunctionRef<void(int32)> Visitor) const
+{
+    if (Nodes.Num() == 0)
+    {
+        return;
+    }
+
+    TArray<int32, TInlineAllocator<64>> Stack;
+    Stack.Add(0);
+    while (Stack.Num() > 0)
+    {
+        const FNode& Node = Nodes[Stack.Pop()];
+        if (!Node.Bounds.Intersect(Box))
+        {
+            continue;
+        }
+
+        if (Node.Count > 0)
+        {
+            for (int32 Index = Node.First; Index < Node.First + Node.Count; ++Index)
+            {
+                if (ItemBounds[Items[Index]].Intersect(Box))
+                {
+                    Visitor(Items[Index]);
+                }
+            }
+            continue;
+        }
+
+        const int32 NodeIndex = static_cast<int32>(&Node - Nodes.GetData());
+        Stack.Add(Node.Right);
+        Stack.Add(NodeIndex + 1);
+    }
+}
+
+int32 FFloorPlanBVH2D::FindNearest(const FVector2D& Point, float MaxDistance, TFunctionRef<double(int32)> DistanceSq) const
+{
+    using namespace FloorPlanSpatialIndexPrivate;
+
+    int32 BestItem = INDEX_NONE;
+    double BestDistanceSq = static_cast<double>(MaxDistance) * MaxDistance;
+    if (Nodes.Num() == 0)
+    {
+        return BestItem;
+    }
+
+    // Min-heap of nodes by their box distance
+    typedef TPair<double, int32> FEntry;
+    auto Closer = [](const FEntry& A, const FEntry& B) { return A.Key < B.Key; };
+    TArray<FEntry, TInlineAllocator<64>> Heap;
+    Heap.HeapPush(FEntry(GetBoxDistanceSq(Nodes[0].Bounds, Point), 0), Closer);
+
+    while (Heap.Num() > 0)
+    {
+        FEntry Entry;
+        Heap.HeapPop(Entry, Closer);
+        if (Entry.Key > BestDistanceSq)
+        {
+            break;
+        }
+
+        const FNode& Node = Nodes[Entry.Value];
+        if (Node.Count > 0)
+        {
+            for (int32 Index = Node.First; Index < Node.First + Node.Count; ++Index)
+            {
+                const int32 Item = Items[Index];
+                if (GetBoxDistanceSq(ItemBounds[Item], Point) > BestDistanceSq)
+                {
+                    continue;
+                }
+                const double ItemDistanceSq = DistanceSq(Item);
+                if (ItemDistanceSq <= BestDistanceSq)
+                {
+                    BestDistanceSq = ItemDistanceSq;
+                    BestItem = Item;
+                }
+            }
+            continue;
+        }
+
+        for (const int32 Child : { Entry.Value + 1, Node.Right })
+        {
+            const double ChildDistanceSq = GetBoxDistanceSq(Nodes[Child].Bounds, Point);
+            if (ChildDistanceSq <= BestDistanceSq)
+            {
+                Heap.HeapPush(FEntry(ChildDistanceSq, Child), Closer);
+            }
+        }
+    }
+    return BestItem;
+}
+
+void FFloorPlanSpatialIndex::Build(const TArray<FRoomData>& InRooms, const TArray<FWallSegmentData>& InWalls, const TArray<FOpeningData>& InOpenings)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(FFloorPlanSpatialIndex::Build);
+    using namespace FloorPlanSpatialIndexPrivate;
+
+    TArray<FBox2D> Boxes;
+
+    // Rooms without a usable outline fall back to their center and dimensions
+    RoomBoundaries.Reset(InRooms.Num());
+    RoomAreas.Reset(InRooms.Num());
+    Boxes.Reset(InRooms.Num());
+    for (const FRoomData& Room : InRooms)
+    {
+        TArray<FVector2D>& Boundary = RoomBoundaries.Add_GetRef(Room.BoundaryPoints);
+        if (Boundary.Num() < 3)
+        {
+            const FVector2D HalfSize = Room.Dimensions * 0.5;
+            Boundary = { Room.Center - HalfSize, FVector2D(Room.Center.X + HalfSize.X, Room.Center.Y - HalfSize.Y),
+                         Room.Center + HalfSize, FVector2D(Room.Center.X - HalfSize.X, Room.Center.Y + HalfSize.Y) };
+        }
+        RoomAreas.Add(GetPolygonArea(Boundary));
+        Boxes.Add(FBox2D(Boundary));
+    }
+    RoomTree.Build(Boxes);
+
+    Walls = InWalls;
+    Boxes.Reset(Walls.Num());
+    for (const FWallSegmentData& Wall : Walls)
+    {
+        FBox2D Box(ForceInit);
+        Box += Wall.Start;
+        Box += Wall.End;
+        Boxes.Add(Box);
+    }
+    WallTree.Build(Boxes);
+
+    OpeningBounds.Reset(InOpenings.Num());
+    OpeningCenters.Reset(InOpenings.Num());
+    for (const FOpeningData& Opening : InOpenings)
+    {
+        const double HalfExtent = FMath::Max(Opening.Size.X, Opening.Size.Y) * 0.5;
+        OpeningBounds.Add(FBox2D(Opening.Position - FVector2D(HalfExtent), Opening.Position + FVector2D(HalfExtent)));
+        OpeningCenters.Add(Opening.Position);
+    }
+    OpeningTree.Build(OpeningBounds);
+
+    UE_LOG(LogFloorPlan, Verbose, TEXT("FloorPlanSpatialIndex: Indexed %d rooms, %d walls, %d openings"),
+           RoomBoundaries.Num(), Walls.Num(), OpeningBounds.Num());
+}
+
+int32 FFloorPlanSpatialIndex::FindRoomAt(const FVector2D& Point) const
+{
+    using namespace FloorPlanSpatialIndexPrivate;
+
+    int32 BestRoom = INDEX_NONE;
+    RoomTree.QueryBox(FBox2D(Point, Point), [&](int32 Room)
+    {
+        if ((BestRoom == INDEX_NONE || RoomAreas[Room] < RoomAreas[BestRoom]) && ContainsPoint(RoomBoundaries[Room], Point))
+        {
+            BestRoom = Room;
+        }
+    });
+    return BestRoom;
+}
+
+double FFloorPlanSpatialIndex::GetWallDistanceSq(int32 Wall, const FVector2D& Point) const
+{
+    const FVector2D Closest = FMath::ClosestPointOnSegment2D(Point, Walls[Wall].Start, Walls[Wall].End);
+    return FVector2D::DistSquared(Point, Closest);
+}
+
+void FFloorPlanSpatialIndex::FindWallsInRadius(const FVector2D& Point, float Radius, TArray<int32>& OutWalls) const
+{
+    OutWalls.Reset();
+    const double RadiusSq = static_cast<double>(Radius) * Radius;
+    WallTree.QueryBox(FBox2D(Point - FVector2D(Radius), Point + FVector2D(Radius)), [&](int32 Wall)
+    {
+        if (GetWallDistanceSq(Wall, Point) <= RadiusSq)
+        {
+            OutWalls.Add(Wall);
+        }
+    });
+}
+
+void FFloorPlanSpatialIndex::FindOpeningsInRadius(const FVector2D& Point, float Radius, TArray<int32>& OutOpenings) const
+{
+    using namespace FloorPlanSpatialIndexPrivate;
+
+    OutOpenings.Reset();
+    const double RadiusSq = static_cast<double>(Radius) * Radius;
+    OpeningTree.QueryBox(FBox2D(Point - FVector2D(Radius), Point + FVector2D(Radius)), [&](int32 Opening)
+    {
+        if (GetBoxDistanceSq(OpeningBounds[Opening], Point) <= RadiusSq)
+        {
+            OutOpenings.Add(Opening);
+        }
+    });
+}
+
+int32 FFloorPlanSpatialIndex::FindNearestWall(const FVector2D& Point, float MaxDistance) const
+{
+    return WallTree.FindNearest(Point, MaxDistance, [this, &Point](int32 Wall) { return GetWallDistanceSq(Wall, Point); });
+}
+
+void FFloorPlanSpatialIndex::AssignOpeningsToWalls(float MaxDistance, TArray<int32>& OutWallPerOpening) const
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(FFloorPlanSpatialIndex::AssignOpeningsToWalls);
+
+    OutWallPerOpening.SetNumUninitialized(OpeningCenters.Num());
+    int32 NumAssigned = 0;
+    for (int32 Opening = 0; Opening < OpeningCenters.Num(); ++Opening)
+    {
+        OutWallPerOpening[Opening] = FindNearestWall(OpeningCenters[Opening], MaxDistance);
+        NumAssigned += OutWallPerOpening[Opening] != INDEX_NONE ? 1 : 0;
+    }
+
+    UE_LOG(LogFloorPlan, Verbose, TEXT("FloorPlanSpatialIndex: Assigned %d of %d openings to walls"), NumAssigned, OpeningCenters.Num());
+}
@@ -0,0 +1,300 @@
+#include "FloorPlanStreamingAnalyzer.h"
+#include "FloorPlanLog.h"
+#include "FloorPlanProfile.h"
+#include "FloorPlanStripReader.h"
+
+FFloorPlanStreamingAnalyzer::FFloorPlanStreamingAnalyzer(int32 InWidth, int32 InHeight, const FFloorPlanStreamingSettings& InSettings)
+    : Width(InWidth)
+    , Height(InHeight)
+    , Settings(InSettings)
+{
+    Settings.StripRows = FMath::Max(1, Settings.StripRows);
+    Settings.WallPointSpacingPixels = FMath::Max(1, Settings.WallPointSpacingPixels);
+
+    ClassRows.SetNumZeroed(Width * 3);
+    WallCells.Init(false, FMath::DivideAndRoundUp(Width, Settings.WallPointSpacingPixels));
+}
+
+bool FFloorPlanStreamingAnalyzer::Run(FFloorPlanStripReader& Reader, FFloorPlanProfile* Profile)
+{
+    if (Reader.GetWidth() != Width || Reader.GetHeight() != Height)
+    {
+        UE_LOG(LogFloorPlan, Error, TEXT("FloorPlanStreamingAnalyzer: Reader size %dx%d does not match %dx%d"),
+               Reader.GetWidth(), Reader.GetHeight(), Width, Height);
+        return false;
+    }
+
+    TArray<uint8> Strip;
+    int32 RowsRead = 0;
+    while (true)
+    {
+        int32 NumRows = 0;
+        {
+            FLOORPLAN_SCOPE_STAGE(STAT_FloorPlanExtract, Profile, ExtractMs);
+            NumRows = Reader.ReadRows(Settings.StripRows, Strip);
+        }
+        if (NumRows == 0)
+        {
+            break;
+        }
+
+        // Binarization is fused into the row labeling here, so both count as labeling
+        FLOORPLAN_SCOPE_STAGE(STAT_FloorPlanLabel, Profile, LabelMs);
+        ConsumeRows(Strip.GetData(), NumRows);
+        TrackWorkingSet(Strip.GetAllocatedSize());
+        RowsRead += NumRows;
+    }
+
+    {
+        FLOORPLAN_SCOPE_STAGE(STAT_FloorPlanLabel, Profile, LabelMs);
+        Finish();
+    }
+
+    if (RowsRead != Height)
+    {
+        UE_LOG(LogFloorPlan, Error, TEXT("FloorPlanStreamingAnalyzer: Image ended after %d of %d rows"), RowsRead, Height);
+        return false;
+    }
+    return true;
+}
+
+void FFloorPlanStreamingAnalyzer::ConsumeRows(const uint8* Luminance, int32 NumRows)
+{
+    for (int32 Row = 0; Row < NumRows; ++Row)
+    {
+        const int32 Y = RowsClassified;
+        uint8* Classes = GetClassRow(Y);
+        ClassifyRow(Luminance + Row * Width, Classes);
+        LabelRow(Y, Classes);
+        ++RowsClassified;
+
+        // The wall test for row Y-1 needs row Y as its lower neighbor
+        if (Y > 0)
+        {
+            DetectWallsInRow(Y - 1);
+        }
+    }
+
+    TrackWorkingSet();
+}
+
+void FFloorPlanStreamingAnalyzer::Finish()
+{
+    if (RowsClassified > RowsWallScanned)
+    {
+        DetectWallsInRow(RowsClassified - 1);
+    }
+
+    // Every component still open touches the last row
+    for (const FComponentStats& Stats : ActiveStats)
+    {
+        EmitRoom(Stats);
+    }
+    ActiveStats.Empty();
+    PrevRuns.Empty();
+
+    UE_LOG(LogFloorPlan, Log, TEXT("FloorPlanStreamingAnalyzer: %d rows -> %d rooms, %d wall points, peak working set %.2f MB"),
+           RowsClassified, Rooms.Num(), WallPoints.Num(), PeakWorkingBytes / (1024.0 * 1024.0));
+}
+
+void FFloorPlanStreamingAnalyzer::ClassifyRow(const uint8* Luminance, uint8* OutClasses) const
+{
+    for (int32 X = 0; X < Width; ++X)
+    {
+        OutClasses[X] = FFloorPlanMask::Classify(Luminance[X], Settings.BlackThreshold, Settings.WhiteThreshold);
+    }
+}
+
+void FFloorPlanStreamingAnalyzer::LabelRow(int32 Y, const uint8* Classes)
+{
+    // Extract white runs of this row
+    CurRuns.Reset();
+    for (int32 X = 0; X < Width; ++X)
+    {
+        if (Classes[X] != FFloorPlanMask::Room)
+        {
+            continue;
+        }
+
+        FRun Run;
+        Run.Start = X;
+        while (X + 1 < Width && Classes[X + 1] == FFloorPlanMask::Room)
+        {
+            ++X;
+        }
+        Run.End = X;
+        Run.Label = INDEX_NONE;
+        CurRuns.Add(Run);
+    }
+
+    // Union-find nodes: [0, P) are the previous row's components, [P, P + C) the new runs
+    const int32 NumPrev = ActiveStats.Num();
+    const int32 NumCur = CurRuns.Num();
+    Parent.SetNumUninitialized(NumPrev + NumCur);
+    NodeStats.SetNumUninitialized(NumPrev + NumCur);
+
+    for (int32 Index = 0; Index < NumPrev; ++Index)
+    {
+        Parent[Index] = Index;
+        NodeStats[Index] = ActiveStats[Index];
+    }
+
+    for (int32 Index = 0; Index < NumCur; ++Index)
+    {
+        const FRun& Run = CurRuns[Index];
+        FComponentStats& Stats = NodeStats[NumPrev + Index];
+        Stats.Min = FIntPoint(Run.Start, Y);
+        Stats.Max = FIntPoint(Run.End, Y);
+        Stats.Area = Run.End - Run.Start + 1;
+        Stats.bTouchesBorder = Y == 0 || Y == Height - 1 || Run.Start == 0 || Run.End == Width - 1;
+        Parent[NumPrev + Index] = NumPrev + Index;
+    }
+
+    // 4-connectivity: a run joins every run of the previous row that overlaps it horizontally
+    int32 PrevIndex = 0;
+    for (int32 Index = 0; Index < NumCur; ++Index)
+    {
+        const FRun& Run = CurRuns[Index];
+        while (PrevIndex < PrevRuns.Num() && PrevRuns[PrevIndex].End < Run.Start)
+        {
+            ++PrevIndex;
+        }
+
+        for (int32 Overlap = PrevIndex; Overlap < PrevRuns.Num() && PrevRuns[Overlap].Start <= Run.End; ++Overlap)
+        {
+            UnionNodes(PrevRuns[Overlap].Label, NumPrev + Index);
+        }
+    }
+
+    // Compact the surviving components into new labels
+    RootToLabel.Init(INDEX_NONE, NumPrev + NumCur);
+    NextStats.Reset();
+    for (int32 Index = 0; Index < NumCur; ++Index)
+    {
+        const int32 Root = FindRoot(NumPrev + Index);
+        if (RootToLabel[Root] == INDEX_NONE)
+        {
+            RootToLabel[Root] = NextStats.Add(NodeStats[Root]);
+        }
+        CurRuns[Index].Label = RootToLabel[Root];
+    }
+
+    // Components not continued by this row are complete
+    constexpr int32 Emitted = -2;
+    for (int32 Index = 0; Index < NumPrev; ++Index)
+    {
+        const int32 Root = FindRoot(Index);
+        if (RootToLabel[Root] == INDEX_NONE)
+        {
+            EmitRoom(NodeStats[Root]);
+            RootToLabel[Root] = Emitted;
+        }
+    }
+
+    Swap(ActiveStats, NextStats);
+    Swap(PrevRuns, CurRuns);
+}
+
+void FFloorPlanStreamingAnalyzer::DetectWallsInRow(int32 Y)
+{
+    const uint8* Above = Y > 0 ? GetClassRow(Y - 1) : nullptr;
+    const uint8* Center = GetClassRow(Y);
+    const uint8* Below = Y + 1 < RowsClassified ? GetClassRow(Y + 1) : nullptr;
+    RowsWallScanned = Y + 1;
+
+    const int32 Spacing = Settings.WallPointSpacingPixels;
+    const int32 CellRow = Y / Spacing;
+    if (CellRow != WallCellRow)
+    {
+        WallCells.SetRange(0, WallCells.Num(), false);
+        WallCellRow = CellRow;
+    }
+
+    auto IsWallAt = [this](const uint8* Row, int32 X)
+    {
+        return Row && X >= 0 && X < Width && Row[X] == FFloorPlanMask::Wall;
+    };
+
+    for (int32 X = 0; X < Width; ++X)
+    {
+        if (Center[X] != FFloorPlanMask::Wall || WallCells[X / Spacing])
+        {
+            continue;
+        }
+
+        // A wall pixel needs at least one black 8-neighbor
+        const bool bHasNeighbor =
+            IsWallAt(Center, X - 1) || IsWallAt(Center, X + 1) ||
+            IsWallAt(Above, X - 1) || IsWallAt(Above, X) || IsWallAt(Above, X + 1) ||
+            IsWallAt(Below, X - 1) || IsWallAt(Below, X) || IsWallAt(Below, X + 1);
+
+        if (bHasNeighbor)
+        {
+            WallCells[X / Spacing] = true;
+            WallPoints.Add(FVector2D(X * Settings.ScaleFactor / 10.0f, Y * Settings.ScaleFactor / 10.0f));
+        }
+    }
+}
+
+void FFloorPlanStreamingAnalyzer::EmitRoom(const FComponentStats& Stats)
+{
+    // White regions connected to the image border are the paper around the plan, not rooms
+    if (Stats.bTouchesBorder)
+    {
+        return;
+    }
+
+    const int32 RoomWidth = Stats.Max.X - Stats.Min.X;
+    const int32 RoomHeight = Stats.Max.Y - Stats.Min.Y;
+    if (RoomWidth <= Settings.MinRoomSizePixels || RoomHeight <= Settings.MinRoomSizePixels)
+    {
+        return;
+    }
+
+    const float PixelToWorld = Settings.ScaleFactor / 10.0f;
+
+    FRoomData Room;
+    Room.RoomName = FString::Printf(TEXT("Room_%d"), Rooms.Num() + 1);
+    Room.BoundaryPoints.Add(FVector2D(Stats.Min.X, Stats.Min.Y) * PixelToWorld);
+    Room.BoundaryPoints.Add(FVector2D(Stats.Max.X, Stats.Min.Y) * PixelToWorld);
+    Room.BoundaryPoints.Add(FVector2D(Stats.Max.X, Stats.Max.Y) * PixelToWorld);
+    Room.BoundaryPoints.Add(FVector2D(Stats.Min.X, Stats.Max.Y) * PixelToWorld);
+    Room.Center = FVector2D((Stats.Min.X + Stats.Max.X) / 2, (Stats.Min.Y + Stats.Max.Y) / 2) * PixelToWorld;
+    Room.Dimensions = FVector2D(RoomWidth, RoomHeight) * PixelToWorld;
+    Rooms.Add(Room);
+}
+
+int32 FFloorPlanStreamingAnalyzer::FindRoot(int32 Node)
+{
+    while (Parent[Node] != Node)
+    {
+        Parent[Node] = Parent[Parent[Node]];
+        Node = Parent[Node];
+    }
+    return Node;
+}
+
+void FFloorPlanStreamingAnalyzer::UnionNodes(int32 A, int32 B)
+{
+    const int32 RootA = FindRoot(A);
+    const int32 RootB = FindRoot(B);
+    if (RootA == RootB)
+    {
+        return;
+    }
+
+    Parent[RootB] = RootA;
+    NodeStats[RootA].Merge(NodeStats[RootB]);
+}
+
+void FFloorPlanStreamingAnalyzer::TrackWorkingSet(int64 ExtraBytes)
+{
+    const int64 WorkingBytes = ExtraBytes +
+        ClassRows.GetAllocatedSize() +
+        PrevRuns.GetAllocatedSize() + CurRuns.GetAllocatedSize() +
+        ActiveStats.GetAllocatedSize() + NextStats.GetAllocatedSize() +
+        Parent.GetAllocatedSize() + NodeStats.GetAllocatedSize() + RootToLabel.GetAllocatedSize() +
+        WallCells.GetAllocatedSize();
+
+    PeakWorkingBytes = FMath::Max(PeakWorkingBytes, WorkingBytes);
+}
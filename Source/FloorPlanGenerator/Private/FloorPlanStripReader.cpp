@@ -0,0 +1,470 @@
+#include "FloorPlanStripReader.h"
+#include "FloorPlanLog.h"
+#include "Engine/Texture2D.h"
+#include "TextureResource.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Modules/ModuleManager.h"
+#include "IImageWrapper.h"
+#include "IImageWrapperModule.h"
+
+THIRD_PARTY_INCLUDES_START
+#include "png.h"
+#if WITH_FLOORPLAN_LIBTIFF
+#include "tiffio.h"
+#endif
+THIRD_PARTY_INCLUDES_END
+
+namespace FloorPlanStripReaderPrivate
+{
+    // Row-by-row PNG decoding through libpng, only one decoded row is alive at a time
+    class FPngStripReader : public FFloorPlanStripReader
+    {
+    public:
+        virtual ~FPngStripReader()
+        {
+            if (PngPtr)
+            {
+                png_destroy_read_struct(&PngPtr, InfoPtr ? &InfoPtr : nullptr, nullptr);
+            }
+        }
+
+        bool Open(const FString& FilePath)
+        {
+            FileReader.Reset(IFileManager::Get().CreateFileReader(*FilePath));
+            if (!FileReader || FileReader->TotalSize() < 8)
+            {
+                return false;
+            }
+
+            uint8 Signature[8];
+            FileReader->Serialize(Signature, 8);
+            if (png_sig_cmp(Signature, 0, 8) != 0)
+            {
+                return false;
+            }
+
+            PngPtr = png_create_read_struct(PNG_LIBPNG_VER_STRING, this, &FPngStripReader::ErrorCallback, &FPngStripReader::WarningCallback);
+            if (!PngPtr)
+            {
+                return false;
+            }
+
+            InfoPtr = png_create_info_struct(PngPtr);
+            if (!InfoPtr)
+            {
+                return false;
+            }
+
+            if (setjmp(png_jmpbuf(PngPtr)))
+            {
+                return false;
+            }
+
+            png_set_read_fn(PngPtr, this, &FPngStripReader::ReadCallback);
+            png_set_sig_bytes(PngPtr, 8);
+            png_read_info(PngPtr, InfoPtr);
+
+            // Interlaced images need every pass before a single row is final, so they cannot be streamed
+            if (png_get_interlace_type(PngPtr, InfoPtr) != PNG_INTERLACE_NONE)
+            {
+                UE_LOG(LogFloorPlan, Warning, TEXT("FloorPlanStripReader: Interlaced PNG cannot be decoded in strips: %s"), *FilePath);
+                return false;
+            }
+
+            // Normalize every PNG flavor to 8-bit RGB rows
+            png_set_expand(PngPtr);
+            png_set_strip_16(PngPtr);
+            png_set_strip_alpha(PngPtr);
+            png_set_gray_to_rgb(PngPtr);
+            png_read_update_info(PngPtr, InfoPtr);
+
+            Width = static_cast<int32>(png_get_image_width(PngPtr, InfoPtr));
+            Height = static_cast<int32>(png_get_image_height(PngPtr, InfoPtr));
+            RowBuffer.SetNumUninitialized(png_get_rowbytes(PngPtr, InfoPtr));
+            return Width > 0 && Height > 0;
+        }
+
+        virtual int32 ReadRows(int32 MaxRows, TArray<uint8>& OutLuminance) override
+        {
+            const int32 RowsToRead = FMath::Min(MaxRows, Height - NextRow);
+            if (RowsToRead <= 0 || bFailed)
+            {
+                OutLuminance.Reset();
+                return 0;
+            }
+
+            OutLuminance.SetNumUninitialized(RowsToRead * Width);
+
+            if (setjmp(png_jmpbuf(PngPtr)))
+            {
+                bFailed = true;
+                OutLuminance.Reset();
+                return 0;
+            }
+
+            for (int32 Row = 0; Row < RowsToRead; ++Row)
+            {
+                png_read_row(PngPtr, RowBuffer.GetData(), nullptr);
+
+                const uint8* Src = RowBuffer.GetData();
+                uint8* Dest = OutLuminance.GetData() + Row * Width;
+                for (int32 X = 0; X < Width; ++X)
+                {
+                    Dest[X] = ToLuminance(Src[X * 3], Src[X * 3 + 1], Src[X * 3 + 2]);
+                }
+            }
+
+            NextRow += RowsToRead;
+            return RowsToRead;
+        }
+
+    private:
+        static void ReadCallback(png_structp Png, png_bytep Data, png_size_t Length)
+        {
+            FPngStripReader* Reader = static_cast<FPngStripReader*>(png_get_io_ptr(Png));
+            if (Reader->FileReader->Tell() + static_cast<int64>(Length) > Reader->FileReader->TotalSize())
+            {
+                png_error(Png, "Unexpected end of file");
+            }
+            Reader->FileReader->Serialize(Data, Length);
+        }
+
+        static void ErrorCallback(png_structp Png, png_const_charp Message)
+        {
+            UE_LOG(LogFloorPlan, Error, TEXT("FloorPlanStripReader: libpng error: %s"), ANSI_TO_TCHAR(Message));
+            longjmp(png_jmpbuf(Png), 1);
+        }
+
+        static void WarningCallback(png_structp Png, png_const_charp Message)
+        {
+            UE_LOG(LogFloorPlan, Log, TEXT("FloorPlanStripReader: libpng warning: %s"), ANSI_TO_TCHAR(Message));
+        }
+
+        TUniquePtr<FArchive> FileReader;
+        png_structp PngPtr = nullptr;
+        png_infop InfoPtr = nullptr;
+        TArray<uint8> RowBuffer;
+        int32 NextRow = 0;
+        bool bFailed = false;
+    };
+
+#if WITH_FLOORPLAN_LIBTIFF
+    // Scanline TIFF decoding, covers the 1-bit and 8-bit striped files produced by document scanners
+    class FTiffStripReader : public FFloorPlanStripReader
+    {
+    public:
+        virtual ~FTiffStripReader()
+        {
+            if (Tiff)
+            {
+                TIFFClose(Tiff);
+            }
+        }
+
+        bool Open(const FString& FilePath)
+        {
+            Tiff = TIFFOpen(TCHAR_TO_UTF8(*FilePath), "r");
+            if (!Tiff)
+            {
+                return false;
+            }
+
+            if (TIFFIsTiled(Tiff))
+            {
+                UE_LOG(LogFloorPlan, Warning, TEXT("FloorPlanStripReader: Tiled TIFF is not supported for strip decoding: %s"), *FilePath);
+                return false;
+            }
+
+            uint32 TiffWidth = 0;
+            uint32 TiffHeight = 0;
+            uint16 PlanarConfig = PLANARCONFIG_CONTIG;
+            TIFFGetField(Tiff, TIFFTAG_IMAGEWIDTH, &TiffWidth);
+            TIFFGetField(Tiff, TIFFTAG_IMAGELENGTH, &TiffHeight);
+            TIFFGetFieldDefaulted(Tiff, TIFFTAG_BITSPERSAMPLE, &BitsPerSample);
+            TIFFGetFieldDefaulted(Tiff, TIFFTAG_SAMPLESPERPIXEL, &SamplesPerPixel);
+            TIFFGetFieldDefaulted(Tiff, TIFFTAG_PLANARCONFIG, &PlanarConfig);
+            TIFFGetField(Tiff, TIFFTAG_PHOTOMETRIC, &Photometric);
+
+            const bool bSupportedBits = BitsPerSample == 1 || BitsPerSample == 8;
+            const bool bSupportedLayout = PlanarConfig == PLANARCONFIG_CONTIG &&
+                ((SamplesPerPixel == 1 && (Photometric == PHOTOMETRIC_MINISWHITE || Photometric == PHOTOMETRIC_MINISBLACK)) ||
+                 (SamplesPerPixel >= 3 && Photometric == PHOTOMETRIC_RGB && BitsPerSample == 8));
+            if (!bSupportedBits || !bSupportedLayout)
+            {
+                UE_LOG(LogFloorPlan, Warning, TEXT("FloorPlanStripReader: Unsupported TIFF layout (%d bits, %d samples, photometric %d): %s"),
+                       BitsPerSample, SamplesPerPixel, Photometric, *FilePath);
+                return false;
+            }
+
+            Width = static_cast<int32>(TiffWidth);
+            Height = static_cast<int32>(TiffHeight);
+            ScanlineBuffer.SetNumUninitialized(TIFFScanlineSize(Tiff));
+            return Width > 0 && Height > 0;
+        }
+
+        virtual int32 ReadRows(int32 MaxRows, TArray<uint8>& OutLuminance) override
+        {
+            const int32 RowsToRead = FMath::Min(MaxRows, Height - NextRow);
+            if (RowsToRead <= 0)
+            {
+                OutLuminance.Reset();
+                return 0;
+            }
+
+            OutLuminance.SetNumUninitialized(RowsToRead * Width);
+            const bool bInvert = Photometric == PHOTOMETRIC_MINISWHITE;
+
+            for (int32 Row = 0; Row < RowsToRead; ++Row)
+            {
+                if (TIFFReadScanline(Tiff, ScanlineBuffer.GetData(), NextRow + Row, 0) < 0)
+                {
+                    UE_LOG(LogFloorPlan, Error, TEXT("FloorPlanStripReader: Failed to read TIFF scanline %d"), NextRow + Row);
+                    OutLuminance.SetNum(Row * Width);
+                    NextRow = Height;
+                    return Row;
+                }
+
+                const uint8* Src = ScanlineBuffer.GetData();
+                uint8* Dest = OutLuminance.GetData() + Row * Width;
+                for (int32 X = 0; X < Width; ++X)
+                {
+                    uint8 Value;
+                    if (BitsPerSample == 1)
+                    {
+                        Value = ((Src[X >> 3] >> (7 - (X & 7))) & 1) ? 255 : 0;
+                    }
+                    else if (SamplesPerPixel == 1)
+                    {
+                        Value = Src[X];
+                    }
+                    else
+                    {
+                        const uint8* Pixel = Src + X * SamplesPerPixel;
+                        Value = ToLuminance(Pixel[0], Pixel[1], Pixel[2]);
+                    }
+                    Dest[X] = bInvert ? 255 - Value : Value;
+                }
+            }
+
+            NextRow += RowsToRead;
+            return RowsToRead;
+        }
+
+    private:
+        TIFF* Tiff = nullptr;
+        uint16 BitsPerSample = 1;
+        uint16 SamplesPerPixel = 1;
+        uint16 Photometric = PHOTOMETRIC_MINISWHITE;
+        TArray<uint8> ScanlineBuffer;
+        int32 NextRow = 0;
+    };
+#endif
+
+    // Serves rows from an already decoded single-channel image (JPEG/BMP fallback, not out-of-core)
+    class FDecodedStripReader : public FFloorPlanStripReader
+    {
+    public:
+        bool Open(const FString& FilePath)
+        {
+            TArray<uint8> FileData;
+            if (!FFileHelper::LoadFileToArray(FileData, *FilePath))
+            {
+                return false;
+            }
+
+            IImageWrapperModule& ImageWrapperModule = FModuleManager::LoadModuleChecked<IImageWrapperModule>(TEXT("ImageWrapper"));
+            const EImageFormat Format = ImageWrapperModule.DetectImageFormat(FileData.GetData(), FileData.Num());
+            if (Format == EImageFormat::Invalid)
+            {
+                return false;
+            }
+
+            TSharedPtr<IImageWrapper> ImageWrapper = ImageWrapperModule.CreateImageWrapper(Format);
+            if (!ImageWrapper.IsValid() || !ImageWrapper->SetCompressed(FileData.GetData(), FileData.Num()))
+            {
+                return false;
+            }
+
+            FileData.Empty();
+            if (!ImageWrapper->GetRaw(ERGBFormat::Gray, 8, Luminance))
+            {
+                return false;
+            }
+
+            Width = static_cast<int32>(ImageWrapper->GetWidth());
+            Height = static_cast<int32>(ImageWrapper->GetHeight());
+            UE_LOG(LogFloorPlan, Warning, TEXT("FloorPlanStripReader: %s was fully decoded (strip decoding supports PNG and TIFF only)"), *FilePath);
+            return Width > 0 && Height > 0;
+        }
+
+        virtual int32 ReadRows(int32 MaxRows, TArray<uint8>& OutLuminance) override
+        {
+            const int32 RowsToRead = FMath::Min(MaxRows, Height - NextRow);
+            if (RowsToRead <= 0)
+            {
+                OutLuminance.Reset();
+                return 0;
+            }
+
+            OutLuminance.SetNumUninitialized(RowsToRead * Width);
+            FMemory::Memcpy(OutLuminance.GetData(), Luminance.GetData() + static_cast<int64>(NextRow) * Width, RowsToRead * Width);
+            NextRow += RowsToRead;
+            return RowsToRead;
+        }
+
+    private:
+        TArray64<uint8> Luminance;
+        int32 NextRow = 0;
+    };
+
+    // Walks the locked source mip of a texture, converting only the requested rows
+    class FTextureStripReader : public FFloorPlanStripReader
+    {
+    public:
+        virtual ~FTextureStripReader()
+        {
+            if (!Texture || !SourceData)
+            {
+                return;
+            }
+#if WITH_EDITORONLY_DATA
+            if (bLockedSource)
+            {
+                Texture->Source.UnlockMip(0);
+                return;
+            }
+#endif
+            Texture->GetPlatformData()->Mips[0].BulkData.Unlock();
+        }
+
+        bool Open(UTexture2D* InTexture)
+        {
+            Texture = InTexture;
+
+#if WITH_EDITORONLY_DATA
+            // Prefer the uncompressed source data, platform data is usually block compressed
+            const ETextureSourceFormat SourceFormat = Texture->Source.GetFormat();
+            if (Texture->Source.IsValid() && (SourceFormat == TSF_BGRA8 || SourceFormat == TSF_G8))
+            {
+                SourceData = Texture->Source.LockMipReadOnly(0);
+                if (SourceData)
+                {
+                    bLockedSource = true;
+                    BytesPerPixel = SourceFormat == TSF_G8 ? 1 : 4;
+                    Width = Texture->Source.GetSizeX();
+                    Height = Texture->Source.GetSizeY();
+                    return true;
+                }
+            }
+#endif
+
+            FTexturePlatformData* PlatformData = Texture->GetPlatformData();
+            if (!PlatformData || PlatformData->Mips.Num() == 0 || PlatformData->PixelFormat != PF_B8G8R8A8)
+            {
+                return false;
+            }
+
+            FTexture2DMipMap& MipMap = PlatformData->Mips[0];
+            SourceData = static_cast<const uint8*>(MipMap.BulkData.LockReadOnly());
+            BytesPerPixel = 4;
+            Width = MipMap.SizeX;
+            Height = MipMap.SizeY;
+            return SourceData != nullptr;
+        }
+
+        virtual int32 ReadRows(int32 MaxRows, TArray<uint8>& OutLuminance) override
+        {
+            const int32 RowsToRead = FMath::Min(MaxRows, Height - NextRow);
+            if (RowsToRead <= 0)
+            {
+                OutLuminance.Reset();
+                return 0;
+            }
+
+            OutLuminance.SetNumUninitialized(RowsToRead * Width);
+            for (int32 Row = 0; Row < RowsToRead; ++Row)
+            {
+                const uint8* Src = SourceData + (static_cast<int64>(NextRow + Row) * Width) * BytesPerPixel;
+                uint8* Dest = OutLuminance.GetData() + Row * Width;
+                if (BytesPerPixel == 1)
+                {
+                    FMemory::Memcpy(Dest, Src, Width);
+                    continue;
+                }
+
+                for (int32 X = 0; X < Width; ++X)
+                {
+                    // BGRA layout
+                    Dest[X] = ToLuminance(Src[X * 4 + 2], Src[X * 4 + 1], Src[X * 4]);
+                }
+            }
+
+            NextRow += RowsToRead;
+            return RowsToRead;
+        }
+
+    private:
+        UTexture2D* Texture = nullptr;
+        const uint8* SourceData = nullptr;
+        int32 BytesPerPixel = 4;
+        int32 NextRow = 0;
+        bool bLockedSource = false;
+    };
+}
+
+TUniquePtr<FFloorPlanStripReader> FFloorPlanStripReader::CreateForFile(const FString& FilePath)
+{
+    using namespace FloorPlanStripReaderPrivate;
+
+    const FString Extension = FPaths::GetExtension(FilePath).ToLower();
+
+    if (Extension == TEXT("png"))
+    {
+        TUniquePtr<FPngStripReader> Reader = MakeUnique<FPngStripReader>();
+        if (Reader->Open(FilePath))
+        {
+            return Reader;
+        }
+    }
+
+#if WITH_FLOORPLAN_LIBTIFF
+    if (Extension == TEXT("tif") || Extension == TEXT("tiff"))
+    {
+        TUniquePtr<FTiffStripReader> Reader = MakeUnique<FTiffStripReader>();
+        if (Reader->Open(FilePath))
+        {
+            return Reader;
+        }
+    }
+#endif
+
+    TUniquePtr<FDecodedStripReader> Reader = MakeUnique<FDecodedStripReader>();
+    if (Reader->Open(FilePath))
+    {
+        return Reader;
+    }
+
+    UE_LOG(LogFloorPlan, Error, TEXT("FloorPlanStripReader: Could not open image %s"), *FilePath);
+    return nullptr;
+}
+
+TUniquePtr<FFloorPlanStripReader> FFloorPlanStripReader::CreateForTexture(UTexture2D* Texture)
+{
+    using namespace FloorPlanStripReaderPrivate;
+
+    if (!Texture)
+    {
+        return nullptr;
+    }
+
+    TUniquePtr<FTextureStripReader> Reader = MakeUnique<FTextureStripReader>();
+    if (Reader->Open(Texture))
+    {
+        return Reader;
+    }
+
+    UE_LOG(LogFloorPlan, Error, TEXT("FloorPlanStripReader: Texture %s has no uncompressed BGRA8/G8 data to read"), *Texture->GetName());
+    return nullptr;
+}
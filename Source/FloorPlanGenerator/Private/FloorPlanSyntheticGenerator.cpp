@@ -0,0 +1,630 @@
+#include "FloorPlanSyntheticGenerator.h"
+#include "FloorPlanLog.h"
+#include "FloorPlanStripReader.h"
+#include "FloorPlanTextRecognizer.h"
+
+namespace FloorPlanSyntheticGeneratorPrivate
+{
+    const TCHAR* RoomNames[] = {
+        TEXT("KITCHEN"), TEXT("LIVING"), TEXT("DINING"), TEXT("BED ROOM"), TEXT("MASTER BEDROOM"),
+        TEXT("TOILET"), TEXT("STUDY"), TEXT("STORE"), TEXT("LOBBY"), TEXT("BALCONY")
+    };
+
+    // Stateless per-pixel hash so any row can be rasterized independently
+    uint32 HashPixel(int32 X, int32 Y, int32 Seed)
+    {
+        uint32 Hash = static_cast<uint32>(X) * 73856093u ^ static_cast<uint32>(Y) * 19349663u ^ static_cast<uint32>(Seed) * 83492791u;
+        Hash ^= Hash >> 13;
+        Hash *= 0x5bd1e995u;
+        Hash ^= Hash >> 15;
+        return Hash;
+    }
+
+    // Rasterizes rows of a generator on demand
+    class FSyntheticStripReader : public FFloorPlanStripReader
+    {
+    public:
+        explicit FSyntheticStripReader(const FFloorPlanSyntheticGenerator& InGenerator)
+            : Generator(InGenerator)
+        {
+            Width = Generator.GetSettings().Width;
+            Height = Generator.GetSettings().Height;
+        }
+
+        virtual int32 ReadRows(int32 MaxRows, TArray<uint8>& OutLuminance) override
+        {
+            const int32 NumRows = FMath::Min(MaxRows, Height - NextRow);
+            if (NumRows <= 0)
+            {
+                return 0;
+            }
+
+            OutLuminance.SetNumUninitialized(NumRows * Width);
+            for (int32 Row = 0; Row < NumRows; ++Row)
+            {
+                Generator.RasterizeRow(NextRow + Row, OutLuminance.GetData() + Row * Width);
+            }
+            NextRow += NumRows;
+            return NumRows;
+        }
+
+    private:
+        const FFloorPlanSyntheticGenerator& Generator;
+        int32 NextRow = 0;
+    };
+}
+
+FFloorPlanSyntheticGenerator::FFloorPlanSyntheticGenerator(const FFloorPlanSyntheticSettings& InSettings)
+    : Settings(InSettings)
+{
+    Settings.Width = FMath::Max(64, Settings.Width);
+    Settings.Height = FMath::Max(64, Settings.Height);
+    Settings.NumRooms = FMath::Max(1, Settings.NumRooms);
+    Settings.GrayJitter = FMath::Clamp(Settings.GrayJitter, 0, 45);
+
+    BuildLayout();
+}
+
+TUniquePtr<FFloorPlanStripReader> FFloorPlanSyntheticGenerator::CreateReader() const
+{
+    return MakeUnique<FloorPlanSyntheticGeneratorPrivate::FSyntheticStripReader>(*this);
+}
+
+void FFloorPlanSyntheticGenerator::BuildLayout()
+{
+    using namespace FloorPlanSyntheticGeneratorPrivate;
+
+    FRandomStream Random(Settings.Seed);
+
+    const int32 LongSide = FMath::Max(Settings.Width, Settings.Height);
+    CmPerPixel = Settings.PlanSizeCm / LongSide;
+    Truth.ScaleFactor = CmPerPixel * 10.0f;
+    WallPixels = FMath::Max(2, FMath::RoundToInt(Settings.WallThicknessCm / CmPerPixel));
+
+    const int32 DoorPixels = FMath::Max(WallPixels * 2, FMath::RoundToInt(Settings.DoorWidthCm / CmPerPixel));
+    const int32 MinRoomPixels = DoorPixels + WallPixels * 4;
+    const int32 Margin = FMath::Max(WallPixels * 2, FMath::RoundToInt(LongSide * 0.05f));
+    const FIntRect Outer(Margin, Margin, Settings.Width - Margin, Settings.Height - Margin);
+
+    // Exterior walls: top, bottom, left, right
+    Walls.Add({ true, true, Outer.Min.Y, Outer.Min.X, Outer.Max.X, {} });
+    Walls.Add({ true, true, Outer.Max.Y, Outer.Min.X, Outer.Max.X, {} });
+    Walls.Add({ false, true, Outer.Min.X, Outer.Min.Y, Outer.Max.Y, {} });
+    Walls.Add({ false, true, Outer.Max.X, Outer.Min.Y, Outer.Max.Y, {} });
+
+    // Binary space partition, always splitting the largest room across its long side
+    TArray<FIntRect> Leaves;
+    Leaves.Add(Outer);
+    while (Leaves.Num() < Settings.NumRooms)
+    {
+        int32 Best = INDEX_NONE;
+        int64 BestArea = 0;
+        for (int32 Index = 0; Index < Leaves.Num(); ++Index)
+        {
+            const FIntRect& Leaf = Leaves[Index];
+            const int64 Area = static_cast<int64>(Leaf.Width()) * Leaf.Height();
+            if (FMath::Max(Leaf.Width(), Leaf.Height()) >= MinRoomPixels * 2 && Area > BestArea)
+            {
+                Best = Index;
+                BestArea = Area;
+            }
+        }
+
+        if (Best == INDEX_NONE)
+        {
+            UE_LOG(LogFloorPlan, Warning, TEXT("FloorPlanSyntheticGenerator: Only %d of %d rooms fit into %dx%d"),
+                   Leaves.Num(), Settings.NumRooms, Settings.Width, Settings.Height);
+            break;
+        }
+
+        const FIntRect Leaf = Leaves[Best];
+        const bool bSplitX = Leaf.Width() >= Leaf.Height();
+        const int32 Length = bSplitX ? Leaf.Width() : Leaf.Height();
+        const int32 Split = FMath::Clamp(FMath::RoundToInt(Length * Random.FRandRange(0.35f, 0.65f)), MinRoomPixels, Length - MinRoomPixels);
+
+        FWallLine Wall;
+        Wall.bHorizontal = !bSplitX;
+        Wall.bExterior = false;
+        if (bSplitX)
+        {
+            Wall.Across = Leaf.Min.X + Split;
+            Wall.Start = Leaf.Min.Y;
+            Wall.End = Leaf.Max.Y;
+            Leaves[Best] = FIntRect(Leaf.Min.X, Leaf.Min.Y, Wall.Across, Leaf.Max.Y);
+            Leaves.Add(FIntRect(Wall.Across, Leaf.Min.Y, Leaf.Max.X, Leaf.Max.Y));
+        }
+        else
+        {
+            Wall.Across = Leaf.Min.Y + Split;
+            Wall.Start = Leaf.Min.X;
+            Wall.End = Leaf.Max.X;
+            Leaves[Best] = FIntRect(Leaf.Min.X, Leaf.Min.Y, Leaf.Max.X, Wall.Across);
+            Leaves.Add(FIntRect(Leaf.Min.X, Wall.Across, Leaf.Max.X, Leaf.Max.Y));
+        }
+        Walls.Add(Wall);
+    }
+
+    for (FWallLine& Wall : Walls)
+    {
+        if (!Wall.bExterior && Random.FRand() < Settings.DoorProbability)
+        {
+            AddDoor(Wall, Random);
+        }
+    }
+
+    const int32 HalfWall = WallPixels / 2;
+    for (const FIntRect& Leaf : Leaves)
+    {
+        // Windows centered on the room sides that lie on the exterior walls
+        if (Leaf.Min.Y == Outer.Min.Y && Random.FRand() < Settings.WindowProbability)
+        {
+            AddWindow(Walls[0], Leaf.Min.X, Leaf.Max.X);
+        }
+        if (Leaf.Max.Y == Outer.Max.Y && Random.FRand() < Settings.WindowProbability)
+        {
+            AddWindow(Walls[1], Leaf.Min.X, Leaf.Max.X);
+        }
+        if (Leaf.Min.X == Outer.Min.X && Random.FRand() < Settings.WindowProbability)
+        {
+            AddWindow(Walls[2], Leaf.Min.Y, Leaf.Max.Y);
+        }
+        if (Leaf.Max.X == Outer.Max.X && Random.FRand() < Settings.WindowProbability)
+        {
+            AddWindow(Walls[3], Leaf.Min.Y, Leaf.Max.Y);
+        }
+
+        // Room interior between the wall faces
+        const FIntRect Interior(Leaf.Min.X - HalfWall + WallPixels, Leaf.Min.Y - HalfWall + WallPixels, Leaf.Max.X - HalfWall, Leaf.Max.Y - HalfWall);
+
+        FRoomData Room;
+        Room.RoomName = RoomNames[Random.RandRange(0, UE_ARRAY_COUNT(RoomNames) - 1)];
+        Room.BoundaryPoints.Add(ToWorld(Interior.Min.X, Interior.Min.Y));
+        Room.BoundaryPoints.Add(ToWorld(Interior.Max.X, Interior.Min.Y));
+        Room.BoundaryPoints.Add(ToWorld(Interior.Max.X, Interior.Max.Y));
+        Room.BoundaryPoints.Add(ToWorld(Interior.Min.X, Interior.Max.Y));
+        Room.Center = ToWorld((Interior.Min.X + Interior.Max.X) * 0.5f, (Interior.Min.Y + Interior.Max.Y) * 0.5f);
+        Room.Dimensions = FVector2D(Interior.Width(), Interior.Height()) * CmPerPixel;
+        Truth.Rooms.Add(Room);
+
+        if (Settings.bDrawText)
+        {
+            const FString DimensionText = FormatFeetInches(Room.Dimensions.X) + TEXT(" x ") + FormatFeetInches(Room.Dimensions.Y);
+            AddRoomLabel(Interior, Room.RoomName, DimensionText);
+        }
+    }
+
+    for (const FWallLine& Wall : Walls)
+    {
+        AddWallRects(Wall);
+    }
+
+    // Bucket primitives by row band so each row only visits what overlaps it
+    const int32 NumBands = FMath::DivideAndRoundUp(Settings.Height, BandRows);
+    RectBands.SetNum(NumBands);
+    ArcBands.SetNum(NumBands);
+    for (int32 Index = 0; Index < Rects.Num(); ++Index)
+    {
+        const FRectPrimitive& Rect = Rects[Index];
+        for (int32 Band = FMath::Max(0, Rect.Y0 / BandRows); Band <= FMath::Min(NumBands - 1, (Rect.Y1 - 1) / BandRows); ++Band)
+        {
+            RectBands[Band].Add(Index);
+        }
+    }
+    for (int32 Index = 0; Index < Arcs.Num(); ++Index)
+    {
+        const FArcPrimitive& Arc = Arcs[Index];
+        for (int32 Band = FMath::Max(0, Arc.Y0 / BandRows); Band <= FMath::Min(NumBands - 1, (Arc.Y1 - 1) / BandRows); ++Band)
+        {
+            ArcBands[Band].Add(Index);
+        }
+    }
+
+    UE_LOG(LogFloorPlan, Log, TEXT("FloorPlanSyntheticGenerator: %dx%d seed %d -> %d rooms, %d wall segments, %d openings, %.2f cm/pixel"),
+           Settings.Width, Settings.Height, Settings.Seed, Truth.Rooms.Num(), Truth.Walls.Num(), Truth.Openings.Num(), CmPerPixel);
+}
+
+void FFloorPlanSyntheticGenerator::AddDoor(FWallLine& Wall, FRandomStream& Random)
+{
+    const int32 DoorPixels = FMath::Max(WallPixels * 2, FMath::RoundToInt(Settings.DoorWidthCm / CmPerPixel));
+    const int32 Lowest = Wall.Start + WallPixels * 2;
+    const int32 Highest = Wall.End - WallPixels * 2 - DoorPixels;
+    if (Highest < Lowest)
+    {
+        return;
+    }
+
+    const int32 GapStart = Random.RandRange(Lowest, Highest);
+    const int32 GapEnd = GapStart + DoorPixels;
+    Wall.Gaps.Add(FInt32Interval(GapStart, GapEnd));
+
+    // Swing arc and door leaf hinged at the start of the gap, on a random side of the wall
+    const int32 Side = Random.RandBool() ? 1 : -1;
+    const int32 LineWidth = FMath::Max(1, WallPixels / 5);
+    const float WallCenter = (Wall.Across - WallPixels / 2) + WallPixels * 0.5f;
+    const float HingeAcross = WallCenter + Side * WallPixels * 0.5f;
+    const int32 LeafFrom = FMath::RoundToInt(FMath::Min(HingeAcross, HingeAcross + Side * DoorPixels));
+    const int32 LeafTo = FMath::RoundToInt(FMath::Max(HingeAcross, HingeAcross + Side * DoorPixels));
+
+    FOpeningData Door;
+    Door.bIsDoor = true;
+    Door.Size = FVector2D(DoorPixels, WallPixels) * CmPerPixel;
+
+    if (Wall.bHorizontal)
+    {
+        AddArc(FVector2D(GapStart, HingeAcross), DoorPixels, LineWidth * 0.5f, 1, Side, AnnotationValue);
+        AddRect(GapStart, LeafFrom, GapStart + LineWidth, LeafTo, AnnotationValue);
+        Door.Position = ToWorld((GapStart + GapEnd) * 0.5f, WallCenter);
+        Door.Rotation = 0.0f;
+    }
+    else
+    {
+        AddArc(FVector2D(HingeAcross, GapStart), DoorPixels, LineWidth * 0.5f, Side, 1, AnnotationValue);
+        AddRect(LeafFrom, GapStart, LeafTo, GapStart + LineWidth, AnnotationValue);
+        Door.Position = ToWorld(WallCenter, (GapStart + GapEnd) * 0.5f);
+        Door.Rotation = 90.0f;
+    }
+    Truth.Openings.Add(Door);
+}
+
+void FFloorPlanSyntheticGenerator::AddWindow(FWallLine& Wall, int32 SideStart, int32 SideEnd)
+{
+    const int32 WindowPixels = FMath::Max(WallPixels * 2, FMath::RoundToInt(Settings.WindowWidthCm / CmPerPixel));
+    if (SideEnd - SideStart < WindowPixels + WallPixels * 4)
+    {
+        return;
+    }
+
+    const int32 GapStart = (SideStart + SideEnd) / 2 - WindowPixels / 2;
+    const int32 GapEnd = GapStart + WindowPixels;
+    Wall.Gaps.Add(FInt32Interval(GapStart, GapEnd));
+
+    // Three parallel lines spanning the gap: both wall faces and the glass
+    const int32 LineWidth = FMath::Max(1, WallPixels / 5);
+    const int32 WallMin = Wall.Across - WallPixels / 2;
+    const int32 Offsets[] = { WallMin, WallMin + (WallPixels - LineWidth) / 2, WallMin + WallPixels - LineWidth };
+    for (int32 Offset : Offsets)
+    {
+        if (Wall.bHorizontal)
+        {
+            AddRect(GapStart, Offset, GapEnd, Offset + LineWidth, AnnotationValue);
+        }
+        else
+        {
+            AddRect(Offset, GapStart, Offset + LineWidth, GapEnd, AnnotationValue);
+        }
+    }
+
+    const float WallCenter = WallMin + WallPixels * 0.5f;
+    FOpeningData Window;
+    Window.bIsDoor = false;
+    Window.Size = FVector2D(WindowPixels, WallPixels) * CmPerPixel;
+    Window.Position = Wall.bHorizontal ? ToWorld((GapStart + GapEnd) * 0.5f, WallCenter) : ToWorld(WallCenter, (GapStart + GapEnd) * 0.5f);
+    Window.Rotation = Wall.bHorizontal ? 0.0f : 90.0f;
+    Truth.Openings.Add(Window);
+}
+
+void FFloorPlanSyntheticGenerator::AddWallRects(const FWallLine& Wall)
+{
+    TArray<FInt32Interval> Gaps = Wall.Gaps;
+    Gaps.Sort([](const FInt32Interval& A, const FInt32Interval& B) { return A.Min < B.Min; });
+
+    // Walls run past their end points by half the thickness so corners and T-junctions close
+    const int32 WallMin = Wall.Across - WallPixels / 2;
+    const float WallCenter = WallMin + WallPixels * 0.5f;
+    const int32 Last = Wall.End - WallPixels / 2 + WallPixels;
+    int32 Cursor = Wall.Start - WallPixels / 2;
+
+    auto AddPiece = [this, &Wall, WallMin, WallCenter](int32 From, int32 To)
+    {
+        if (To <= From)
+        {
+            return;
+        }
+
+        FWallSegmentData Segment;
+        Segment.Thickness = WallPixels * CmPerPixel;
+        if (Wall.bHorizontal)
+        {
+            AddRect(From, WallMin, To, WallMin + WallPixels, WallValue);
+            Segment.Start = ToWorld(From, WallCenter);
+            Segment.End = ToWorld(To, WallCenter);
+        }
+        else
+        {
+            AddRect(WallMin, From, WallMin + WallPixels, To, WallValue);
+            Segment.Start = ToWorld(WallCenter, From);
+            Segment.End = ToWorld(WallCenter, To);
+        }
+        Truth.Walls.Add(Segment);
+    };
+
+    for (const FInt32Interval& Gap : Gaps)
+    {
+        AddPiece(Cursor, Gap.Min);
+        Cursor = Gap.Max;
+    }
+    AddPiece(Cursor, Last);
+}
+
+void FFloorPlanSyntheticGenerator::AddRoomLabel(const FIntRect& Interior, const FString& Name, const FString& DimensionText)
+{
+    // Glyph cells below 2 pixels cannot be told apart from speckles
+    const int32 CellSize = FMath::RoundToInt(Settings.TextHeightCm / 7.0f / CmPerPixel);
+    if (CellSize < 2)
+    {
+        return;
+    }
+
+    const int32 NameWidth = DrawText(Name, 0, 0, CellSize, true);
+    const int32 DimensionWidth = DrawText(DimensionText, 0, 0, CellSize, true);
+    const int32 LineHeight = 7 * CellSize;
+    const int32 LineGap = 3 * CellSize;
+
+    // Stay well inside the label crop the recognizer reads
+    const int32 AvailableWidth = Interior.Width() * 7 / 10;
+    const int32 AvailableHeight = Interior.Height() * 7 / 10;
+    if (NameWidth > AvailableWidth || LineHeight > AvailableHeight)
+    {
+        return;
+    }
+
+    const bool bWithDimensions = DimensionWidth <= AvailableWidth && LineHeight * 2 + LineGap <= AvailableHeight;
+    const int32 TotalHeight = bWithDimensions ? LineHeight * 2 + LineGap : LineHeight;
+    const FIntPoint Center = Interior.Min + Interior.Size() / 2;
+    const int32 Top = Center.Y - TotalHeight / 2;
+
+    DrawText(Name, Center.X - NameWidth / 2, Top, CellSize, false);
+    if (bWithDimensions)
+    {
+        DrawText(DimensionText, Center.X - DimensionWidth / 2, Top + LineHeight + LineGap, CellSize, false);
+    }
+}
+
+int32 FFloorPlanSyntheticGenerator::DrawText(const FString& Text, int32 X, int32 Y, int32 CellSize, bool bMeasureOnly)
+{
+    int32 Cursor = X;
+    for (TCHAR Character : Text)
+    {
+        uint8 Rows[7];
+        if (Character == TEXT(' ') || !FFloorPlanTextRecognizer::GetBuiltInGlyph(Character, Rows))
+        {
+            Cursor += 6 * CellSize;
+            continue;
+        }
+
+        if (!bMeasureOnly)
+        {
+            // One rectangle per horizontal run of set bits
+            for (int32 Row = 0; Row < 7; ++Row)
+            {
+                int32 Column = 0;
+                while (Column < 5)
+                {
+                    if (!((Rows[Row] >> (4 - Column)) & 1))
+                    {
+                        ++Column;
+                        continue;
+                    }
+
+                    const int32 RunStart = Column;
+                    while (Column < 5 && ((Rows[Row] >> (4 - Column)) & 1))
+                    {
+                        ++Column;
+                    }
+                    AddRect(Cursor + RunStart * CellSize, Y + Row * CellSize, Cursor + Column * CellSize, Y + (Row + 1) * CellSize, AnnotationValue);
+                }
+            }
+        }
+        Cursor += 6 * CellSize;
+    }
+    return FMath::Max(0, Cursor - X - CellSize);
+}
+
+void FFloorPlanSyntheticGenerator::AddRect(int32 X0, int32 Y0, int32 X1, int32 Y1, uint8 Value)
+{
+    X0 = FMath::Max(X0, 0);
+    Y0 = FMath::Max(Y0, 0);
+    X1 = FMath::Min(X1, Settings.Width);
+    Y1 = FMath::Min(Y1, Settings.Height);
+    if (X0 < X1 && Y0 < Y1)
+    {
+        Rects.Add({ X0, Y0, X1, Y1, Value });
+    }
+}
+
+void FFloorPlanSyntheticGenerator::AddArc(const FVector2D& Center, float Radius, float HalfWidth, int32 SignX, int32 SignY, uint8 Value)
+{
+    const float Reach = Radius + HalfWidth;
+    const int32 Y0 = FMath::Max(0, FMath::FloorToInt(SignY > 0 ? Center.Y : Center.Y - Reach));
+    const int32 Y1 = FMath::Min(Settings.Height, FMath::CeilToInt(SignY > 0 ? Center.Y + Reach : Center.Y) + 1);
+    if (Y0 < Y1)
+    {
+        Arcs.Add({ Center, Radius, HalfWidth, SignX, SignY, Y0, Y1, Value });
+    }
+}
+
+void FFloorPlanSyntheticGenerator::RasterizeRow(int32 Y, uint8* OutRow) const
+{
+    using namespace FloorPlanSyntheticGeneratorPrivate;
+
+    const int32 Width = Settings.Width;
+    FMemory::Memset(OutRow, 255, Width);
+
+    const int32 Band = Y / BandRows;
+    for (int32 Index : RectBands[Band])
+    {
+        const FRectPrimitive& Rect = Rects[Index];
+        if (Y >= Rect.Y0 && Y < Rect.Y1)
+        {
+            for (int32 X = Rect.X0; X < Rect.X1; ++X)
+            {
+                OutRow[X] = FMath::Min(OutRow[X], Rect.Value);
+            }
+        }
+    }
+
+    for (int32 Index : ArcBands[Band])
+    {
+        const FArcPrimitive& Arc = Arcs[Index];
+        const float DY = Y + 0.5f - Arc.Center.Y;
+        if (DY * Arc.SignY < 0.0f)
+        {
+            continue;
+        }
+
+        const float Outer = FMath::Square(Arc.Radius + Arc.HalfWidth) - DY * DY;
+        if (Outer < 0.0f)
+        {
+            continue;
+        }
+
+        // Pixels whose centers lie inside the ring on the arc's side of the center
+        const float InnerReach = FMath::Sqrt(FMath::Max(0.0f, FMath::Square(Arc.Radius - Arc.HalfWidth) - DY * DY));
+        const float OuterReach = FMath::Sqrt(Outer);
+        const float From = Arc.SignX > 0 ? Arc.Center.X + InnerReach : Arc.Center.X - OuterReach;
+        const float To = Arc.SignX > 0 ? Arc.Center.X + OuterReach : Arc.Center.X - InnerReach;
+        const int32 X0 = FMath::Max(0, FMath::CeilToInt(From - 0.5f));
+        const int32 X1 = FMath::Min(Width - 1, FMath::FloorToInt(To - 0.5f));
+        for (int32 X = X0; X <= X1; ++X)
+        {
+            OutRow[X] = FMath::Min(OutRow[X], Arc.Value);
+        }
+    }
+
+    // Scan noise: brightness jitter keeps every class inside its threshold band, speckles land in between
+    const uint32 Jitter = static_cast<uint32>(Settings.GrayJitter) + 1;
+    const uint32 SpeckleThreshold = static_cast<uint32>(FMath::Clamp(Settings.SpeckleFraction, 0.0f, 1.0f) * static_cast<float>(MAX_uint32));
+    for (int32 X = 0; X < Width; ++X)
+    {
+        const uint32 Hash = HashPixel(X, Y, Settings.Seed);
+        if (HashPixel(Y, X, Settings.Seed + 1) < SpeckleThreshold)
+        {
+            OutRow[X] = SpeckleValue;
+        }
+        else if (OutRow[X] == 255)
+        {
+            OutRow[X] = static_cast<uint8>(255 - Hash % Jitter);
+        }
+        else
+        {
+            OutRow[X] = static_cast<uint8>(FMath::Min<uint32>(OutRow[X] + Hash % Jitter, 254));
+        }
+    }
+}
+
+FString FFloorPlanSyntheticGenerator::FormatFeetInches(float Centimeters)
+{
+    // Nearest half inch, the way plans are usually dimensioned
+    const int32 HalfInches = FMath::RoundToInt(Centimeters / 2.54f * 2.0f);
+    const int32 Feet = HalfInches / 24;
+    const int32 Inches = (HalfInches % 24) / 2;
+    return (HalfInches % 2) ? FString::Printf(TEXT("%d'-%d.5\""), Feet, Inches) : FString::Printf(TEXT("%d'-%d\""), Feet, Inches);
+}
+
+FFloorPlanAccuracy FFloorPlanSyntheticGenerator::Score(const FFloorPlanGroundTruth& Truth, const TArray<FRoomData>& Rooms,
+                                                      const TArray<FOpeningData>& Openings, const TArray<FWallSegmentData>& Segments)
+{
+    auto Ratio = [](int32 Count, int32 Total)
+    {
+        return Total > 0 ? static_cast<float>(Count) / Total : 0.0f;
+    };
+
+    FFloorPlanAccuracy Accuracy;
+
+    // Rooms match one-to-one by bounding box overlap
+    TBitArray<> RoomUsed(false, Rooms.Num());
+    int32 RoomMatches = 0;
+    int32 NameMatches = 0;
+    for (const FRoomData& TruthRoom : Truth.Rooms)
+    {
+        const FBox2D TruthBox(TruthRoom.BoundaryPoints);
+        int32 Best = INDEX_NONE;
+        float BestOverlap = 0.5f;
+        for (int32 Index = 0; Index < Rooms.Num(); ++Index)
+        {
+            if (RoomUsed[Index] || Rooms[Index].BoundaryPoints.Num() == 0)
+            {
+                continue;
+            }
+
+            const FBox2D Box(Rooms[Index].BoundaryPoints);
+            const FVector2D OverlapMin(FMath::Max(Box.Min.X, TruthBox.Min.X), FMath::Max(Box.Min.Y, TruthBox.Min.Y));
+            const FVector2D OverlapMax(FMath::Min(Box.Max.X, TruthBox.Max.X), FMath::Min(Box.Max.Y, TruthBox.Max.Y));
+            const float Intersection = FMath::Max(0.0f, OverlapMax.X - OverlapMin.X) * FMath::Max(0.0f, OverlapMax.Y - OverlapMin.Y);
+            const float Union = Box.GetArea() + TruthBox.GetArea() - Intersection;
+            const float Overlap = Union > 0.0f ? Intersection / Union : 0.0f;
+            if (Overlap >= BestOverlap)
+            {
+                Best = Index;
+                BestOverlap = Overlap;
+            }
+        }
+
+        if (Best != INDEX_NONE)
+        {
+            RoomUsed[Best] = true;
+            ++RoomMatches;
+            NameMatches += Rooms[Best].RoomName == TruthRoom.RoomName ? 1 : 0;
+        }
+    }
+    Accuracy.RoomRecall = Ratio(RoomMatches, Truth.Rooms.Num());
+    Accuracy.RoomPrecision = Ratio(RoomMatches, Rooms.Num());
+    Accuracy.RoomNameAccuracy = Ratio(NameMatches, RoomMatches);
+
+    // Openings match the nearest unused detection within half the opening width
+    TBitArray<> OpeningUsed(false, Openings.Num());
+    int32 OpeningMatches = 0;
+    int32 TypeMatches = 0;
+    for (const FOpeningData& TruthOpening : Truth.Openings)
+    {
+        int32 Best = INDEX_NONE;
+        float BestDistance = FMath::Max(TruthOpening.Size.X * 0.5f, TruthOpening.Size.Y);
+        for (int32 Index = 0; Index < Openings.Num(); ++Index)
+        {
+            const float Distance = FVector2D::Distance(Openings[Index].Position, TruthOpening.Position);
+            if (!OpeningUsed[Index] && Distance <= BestDistance)
+            {
+                Best = Index;
+                BestDistance = Distance;
+            }
+        }
+
+        if (Best != INDEX_NONE)
+        {
+            OpeningUsed[Best] = true;
+            ++OpeningMatches;
+            TypeMatches += Openings[Best].bIsDoor == TruthOpening.bIsDoor ? 1 : 0;
+        }
+    }
+    Accuracy.OpeningRecall = Ratio(OpeningMatches, Truth.Openings.Num());
+    Accuracy.OpeningPrecision = Ratio(OpeningMatches, Openings.Num());
+    Accuracy.OpeningTypeAccuracy = Ratio(TypeMatches, OpeningMatches);
+
+    // Thickness error against the truth wall under each detected segment's midpoint
+    double ThicknessError = 0.0;
+    int32 ThicknessMatches = 0;
+    for (const FWallSegmentData& Segment : Segments)
+    {
+        const FVector2D Mid = (Segment.Start + Segment.End) * 0.5f;
+        const FWallSegmentData* Nearest = nullptr;
+        float NearestDistance = MAX_flt;
+        for (const FWallSegmentData& TruthWall : Truth.Walls)
+        {
+            const float Distance = FVector2D::Distance(Mid, FMath::ClosestPointOnSegment2D(Mid, TruthWall.Start, TruthWall.End));
+            if (Distance <= TruthWall.Thickness && Distance < NearestDistance)
+            {
+                Nearest = &TruthWall;
+                NearestDistance = Distance;
+            }
+        }
+
+        if (Nearest)
+        {
+            ThicknessError += FMath::Abs(Segment.Thickness - Nearest->Thickness);
+            ++ThicknessMatches;
+        }
+    }
+    Accuracy.WallThicknessError = ThicknessMatches > 0 ? static_cast<float>(ThicknessError / ThicknessMatches) : 0.0f;
+
+    return Accuracy;
+}
@@ -0,0 +1,434 @@
+#include "FloorPlanTextRecognizer.h"
+#include "FloorPlanLog.h"
+#include "FloorPlanMask.h"
+#include "FloorPlanParallel.h"
+
+namespace FloorPlanTextRecognizerPrivate
+{
+    // Bundled 5x7 glyph set, one byte per row with bit 4 as the leftmost column
+    struct FBuiltInGlyph
+    {
+        TCHAR Character;
+        uint8 Rows[7];
+    };
+
+    const FBuiltInGlyph BuiltInGlyphs[] = {
+        { TEXT('0'), { 0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E } },
+        { TEXT('1'), { 0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E } },
+        { TEXT('2'), { 0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F } },
+        { TEXT('3'), { 0x1F, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0E } },
+        { TEXT('4'), { 0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02 } },
+        { TEXT('5'), { 0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E } },
+        { TEXT('6'), { 0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E } },
+        { TEXT('7'), { 0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08 } },
+        { TEXT('8'), { 0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E } },
+        { TEXT('9'), { 0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C } },
+        { TEXT('A'), { 0x0E, 0x11, 0x11, 0x11, 0x1F, 0x11, 0x11 } },
+        { TEXT('B'), { 0x1E, 0x11, 0x11, 0x1E, 0x11, 0x11, 0x1E } },
+        { TEXT('C'), { 0x0E, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0E } },
+        { TEXT('D'), { 0x1C, 0x12, 0x11, 0x11, 0x11, 0x12, 0x1C } },
+        { TEXT('E'), { 0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x1F } },
+        { TEXT('F'), { 0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x10 } },
+        { TEXT('G'), { 0x0E, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0F } },
+        { TEXT('H'), { 0x11, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11 } },
+        { TEXT('I'), { 0x0E, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E } },
+        { TEXT('J'), { 0x07, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0C } },
+        { TEXT('K'), { 0x11, 0x12, 0x14, 0x18, 0x14, 0x12, 0x11 } },
+        { TEXT('L'), { 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1F } },
+        { TEXT('M'), { 0x11, 0x1B, 0x15, 0x15, 0x11, 0x11, 0x11 } },
+        { TEXT('N'), { 0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11 } },
+        { TEXT('O'), { 0x0E, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E } },
+        { TEXT('P'), { 0x1E, 0x11, 0x11, 0x1E, 0x10, 0x10, 0x10 } },
+        { TEXT('Q'), { 0x0E, 0x11, 0x11, 0x11, 0x15, 0x12, 0x0D } },
+        { TEXT('R'), { 0x1E, 0x11, 0x11, 0x1E, 0x14, 0x12, 0x11 } },
+        { TEXT('S'), { 0x0F, 0x10, 0x10, 0x0E, 0x01, 0x01, 0x1E } },
+        { TEXT('T'), { 0x1F, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04 } },
+        { TEXT('U'), { 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E } },
+        { TEXT('V'), { 0x11, 0x11, 0x11, 0x11, 0x11, 0x0A, 0x04 } },
+        { TEXT('W'), { 0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0A } },
+        { TEXT('X'), { 0x11, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x11 } },
+        { TEXT('Y'), { 0x11, 0x11, 0x11, 0x0A, 0x04, 0x04, 0x04 } },
+        { TEXT('Z'), { 0x1F, 0x01, 0x02, 0x04, 0x08, 0x10, 0x1F } },
+        // Punctuation is classified by size and position, these rows are only used for rendering
+        { TEXT('\''), { 0x04, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00 } },
+        { TEXT('"'), { 0x0A, 0x0A, 0x00, 0x00, 0x00, 0x00, 0x00 } },
+        { TEXT('-'), { 0x00, 0x00, 0x00, 0x0E, 0x00, 0x00, 0x00 } },
+        { TEXT('.'), { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04 } },
+        { TEXT('x'), { 0x00, 0x00, 0x11, 0x0A, 0x04, 0x0A, 0x11 } },
+    };
+
+    // Weight of the aspect ratio mismatch against the per-cell coverage error
+    constexpr float AspectWeight = 4.0f;
+}
+
+FFloorPlanTextRecognizer::FFloorPlanTextRecognizer()
+{
+    using namespace FloorPlanTextRecognizerPrivate;
+
+    for (const FBuiltInGlyph& BuiltIn : BuiltInGlyphs)
+    {
+        if (!FChar::IsAlnum(BuiltIn.Character) || FChar::IsLower(BuiltIn.Character))
+        {
+            continue;
+        }
+
+        TArray<uint8> Bitmap;
+        Bitmap.SetNumZeroed(5 * 7);
+        for (int32 Row = 0; Row < 7; ++Row)
+        {
+            for (int32 Column = 0; Column < 5; ++Column)
+            {
+                Bitmap[Row * 5 + Column] = (BuiltIn.Rows[Row] >> (4 - Column)) & 1;
+            }
+        }
+        AddGlyphTemplate(BuiltIn.Character, Bitmap, 5, 7);
+    }
+}
+
+bool FFloorPlanTextRecognizer::GetBuiltInGlyph(TCHAR Character, uint8 (&OutRows)[7])
+{
+    using namespace FloorPlanTextRecognizerPrivate;
+
+    for (const FBuiltInGlyph& BuiltIn : BuiltInGlyphs)
+    {
+        if (BuiltIn.Character == Character)
+        {
+            FMemory::Memcpy(OutRows, BuiltIn.Rows, sizeof(OutRows));
+            return true;
+        }
+    }
+    return false;
+}
+
+void FFloorPlanTextRecognizer::AddGlyphTemplate(TCHAR Character, const TArray<uint8>& Bitmap, int32 BitmapWidth, int32 BitmapHeight)
+{
+    FGlyph Glyph;
+    Glyph.Bounds = FIntRect(MAX_int32, MAX_int32, MIN_int32, MIN_int32);
+    for (int32 Y = 0; Y < BitmapHeight; ++Y)
+    {
+        for (int32 X = 0; X < BitmapWidth; ++X)
+        {
+            if (Bitmap[Y * BitmapWidth + X])
+            {
+                Glyph.Pixels.Add(FIntPoint(X, Y));
+                Glyph.Bounds.Include(FIntPoint(X, Y));
+            }
+        }
+    }
+
+    if (Glyph.Pixels.Num() == 0)
+    {
+        return;
+    }
+
+    Templates.RemoveAll([Character](const FGlyphTemplate& Existing) { return Existing.Character == Character; });
+
+    FGlyphTemplate& Template = Templates.AddDefaulted_GetRef();
+    Template.Character = Character;
+    Template.Aspect = (Glyph.Bounds.Width() + 1.0f) / (Glyph.Bounds.Height() + 1.0f);
+    RasterizeToGrid(Glyph, Template.Grid);
+}
+
+void FFloorPlanTextRecognizer::RecognizeRooms(const FFloorPlanMask& Mask, const TArray<FIntRect>& RoomRects, TArray<TArray<FString>>& OutLines) const
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(FFloorPlanTextRecognizer::RecognizeRooms);
+
+    OutLines.SetNum(RoomRects.Num());
+
+    FFloorPlanParallel::For(RoomRects.Num(), [this, &Mask, &RoomRects, &OutLines](int32 RoomIndex)
+    {
+        // Labels sit inside the room, keep clear of the walls and door swings along the edges
+        const FIntRect& Room = RoomRects[RoomIndex];
+        const FIntPoint Inset(Room.Width() / 10, Room.Height() / 10);
+        const FIntRect LabelArea(Room.Min + Inset, Room.Max - Inset);
+
+        OutLines[RoomIndex].Reset();
+        if (LabelArea.Width() > 0 && LabelArea.Height() > 0)
+        {
+            RecognizeRegion(Mask, LabelArea, OutLines[RoomIndex]);
+        }
+    });
+}
+
+void FFloorPlanTextRecognizer::RecognizeRegion(const FFloorPlanMask& Mask, const FIntRect& Region, TArray<FString>& OutLines) const
+{
+    TArray<FGlyph> Glyphs;
+    FindGlyphs(Mask, Region, Glyphs);
+    if (Glyphs.Num() == 0)
+    {
+        return;
+    }
+
+    // Median glyph height separates full-height characters from punctuation
+    TArray<int32> Heights;
+    for (const FGlyph& Glyph : Glyphs)
+    {
+        Heights.Add(Glyph.Bounds.Height() + 1);
+    }
+    Heights.Sort();
+    const float MedianHeight = Heights[Heights.Num() / 2];
+
+    struct FTextLine
+    {
+        int32 Top;
+        int32 Bottom;
+        TArray<int32> GlyphIndices;
+    };
+    TArray<FTextLine> Lines;
+
+    // Seed lines with full-height glyphs
+    for (int32 Index = 0; Index < Glyphs.Num(); ++Index)
+    {
+        const FIntRect& Bounds = Glyphs[Index].Bounds;
+        if (Bounds.Height() + 1 < MedianHeight * 0.7f)
+        {
+            continue;
+        }
+
+        const float CenterY = (Bounds.Min.Y + Bounds.Max.Y) * 0.5f;
+        FTextLine* Line = Lines.FindByPredicate([CenterY, MedianHeight](const FTextLine& Existing)
+        {
+            return FMath::Abs((Existing.Top + Existing.Bottom) * 0.5f - CenterY) < MedianHeight * 0.5f;
+        });
+        if (!Line)
+        {
+            Line = &Lines.AddDefaulted_GetRef();
+            Line->Top = Bounds.Min.Y;
+            Line->Bottom = Bounds.Max.Y;
+        }
+        Line->Top = FMath::Min(Line->Top, Bounds.Min.Y);
+        Line->Bottom = FMath::Max(Line->Bottom, Bounds.Max.Y);
+        Line->GlyphIndices.Add(Index);
+    }
+
+    // Attach punctuation to the line it sits in
+    for (int32 Index = 0; Index < Glyphs.Num(); ++Index)
+    {
+        const FIntRect& Bounds = Glyphs[Index].Bounds;
+        if (Bounds.Height() + 1 >= MedianHeight * 0.7f)
+        {
+            continue;
+        }
+
+        const float CenterY = (Bounds.Min.Y + Bounds.Max.Y) * 0.5f;
+        for (FTextLine& Line : Lines)
+        {
+            const float Slack = (Line.Bottom - Line.Top + 1) * 0.2f;
+            if (CenterY >= Line.Top - Slack && CenterY <= Line.Bottom + Slack)
+            {
+                Line.GlyphIndices.Add(Index);
+                break;
+            }
+        }
+    }
+
+    Lines.Sort([](const FTextLine& A, const FTextLine& B) { return A.Top < B.Top; });
+
+    for (FTextLine& Line : Lines)
+    {
+        Line.GlyphIndices.Sort([&Glyphs](int32 A, int32 B) { return Glyphs[A].Bounds.Min.X < Glyphs[B].Bounds.Min.X; });
+
+        const int32 LineHeight = Line.Bottom - Line.Top + 1;
+        FString Text;
+        int32 PreviousRight = INDEX_NONE;
+        for (int32 GlyphIndex : Line.GlyphIndices)
+        {
+            const FGlyph& Glyph = Glyphs[GlyphIndex];
+            const TCHAR Character = ClassifyGlyph(Glyph, Line.Top, Line.Bottom);
+            const int32 Gap = PreviousRight == INDEX_NONE ? 0 : Glyph.Bounds.Min.X - PreviousRight;
+
+            // Two neighboring apostrophes are an inch mark
+            if (Character == TEXT('\'') && Text.EndsWith(TEXT("'")) && Gap < LineHeight * 0.3f)
+            {
+                Text[Text.Len() - 1] = TEXT('"');
+            }
+            else
+            {
+                if (PreviousRight != INDEX_NONE && Gap > LineHeight * 0.5f)
+                {
+                    Text.AppendChar(TEXT(' '));
+                }
+                Text.AppendChar(Character);
+            }
+            PreviousRight = Glyph.Bounds.Max.X;
+        }
+
+        if (!Text.IsEmpty())
+        {
+            OutLines.Add(Text);
+        }
+    }
+}
+
+void FFloorPlanTextRecognizer::FindGlyphs(const FFloorPlanMask& Mask, const FIntRect& Region, TArray<FGlyph>& OutGlyphs) const
+{
+    const FIntRect Clipped(
+        FIntPoint(FMath::Max(Region.Min.X, 0), FMath::Max(Region.Min.Y, 0)),
+        FIntPoint(FMath::Min(Region.Max.X, Mask.Width), FMath::Min(Region.Max.Y, Mask.Height)));
+    const int32 CropWidth = Clipped.Width();
+    const int32 CropHeight = Clipped.Height();
+    if (CropWidth <= 0 || CropHeight <= 0)
+    {
+        return;
+    }
+
+    const int32 MaxGlyphHeight = FMath::Max(4, CropHeight / 3);
+    const int32 MaxGlyphWidth = FMath::Max(4, CropWidth / 2);
+
+    auto IsInk = [&Mask](int32 X, int32 Y)
+    {
+        return Mask.Get(X, Y) != FFloorPlanMask::Room;
+    };
+
+    TBitArray<> Visited(false, CropWidth * CropHeight);
+    TArray<FIntPoint> Stack;
+
+    for (int32 Y = Clipped.Min.Y; Y < Clipped.Max.Y; ++Y)
+    {
+        for (int32 X = Clipped.Min.X; X < Clipped.Max.X; ++X)
+        {
+            const int32 LocalIndex = (Y - Clipped.Min.Y) * CropWidth + (X - Clipped.Min.X);
+            if (Visited[LocalIndex] || !IsInk(X, Y))
+            {
+                continue;
+            }
+
+            // 8-connected ink component
+            FGlyph Glyph;
+            Glyph.Bounds = FIntRect(X, Y, X, Y);
+            bool bTouchesCropEdge = false;
+
+            Visited[LocalIndex] = true;
+            Stack.Reset();
+            Stack.Add(FIntPoint(X, Y));
+            while (Stack.Num() > 0)
+            {
+                const FIntPoint Pixel = Stack.Pop();
+                Glyph.Pixels.Add(Pixel);
+                Glyph.Bounds.Include(Pixel);
+                bTouchesCropEdge |= Pixel.X == Clipped.Min.X || Pixel.Y == Clipped.Min.Y || Pixel.X == Clipped.Max.X - 1 || Pixel.Y == Clipped.Max.Y - 1;
+
+                for (int32 DY = -1; DY <= 1; ++DY)
+                {
+                    for (int32 DX = -1; DX <= 1; ++DX)
+                    {
+                        const int32 NX = Pixel.X + DX;
+                        const int32 NY = Pixel.Y + DY;
+                        if (NX < Clipped.Min.X || NX >= Clipped.Max.X || NY < Clipped.Min.Y || NY >= Clipped.Max.Y)
+                        {
+                            continue;
+                        }
+
+                        const int32 NeighborIndex = (NY - Clipped.Min.Y) * CropWidth + (NX - Clipped.Min.X);
+                        if (!Visited[NeighborIndex] && IsInk(NX, NY))
+                        {
+                            Visited[NeighborIndex] = true;
+                            Stack.Add(FIntPoint(NX, NY));
+                        }
+                    }
+                }
+            }
+
+            // Furniture, hatching and walls are too large or run into the crop edge
+            const int32 GlyphHeight = Glyph.Bounds.Height() + 1;
+            const int32 GlyphWidth = Glyph.Bounds.Width() + 1;
+            if (!bTouchesCropEdge && Glyph.Pixels.Num() >= 2 && GlyphHeight <= MaxGlyphHeight && GlyphWidth <= MaxGlyphWidth)
+            {
+                OutGlyphs.Add(MoveTemp(Glyph));
+            }
+        }
+    }
+}
+
+TCHAR FFloorPlanTextRecognizer::ClassifyGlyph(const FGlyph& Glyph, int32 LineTop, int32 LineBottom) const
+{
+    using namespace FloorPlanTextRecognizerPrivate;
+
+    const float LineHeight = LineBottom - LineTop + 1.0f;
+    const float GlyphWidth = Glyph.Bounds.Width() + 1.0f;
+    const float GlyphHeight = Glyph.Bounds.Height() + 1.0f;
+    const float RelativeHeight = GlyphHeight / LineHeight;
+    const float RelativeCenter = ((Glyph.Bounds.Min.Y + Glyph.Bounds.Max.Y) * 0.5f - LineTop) / LineHeight;
+
+    // Punctuation is decided by size and position in the line
+    if (RelativeHeight < 0.45f)
+    {
+        if (GlyphWidth > GlyphHeight * 1.5f && RelativeCenter > 0.3f && RelativeCenter < 0.75f)
+        {
+            return TEXT('-');
+        }
+        if (RelativeCenter < 0.4f)
+        {
+            return TEXT('\'');
+        }
+        if (RelativeCenter > 0.6f)
+        {
+            return TEXT('.');
+        }
+        return TEXT('-');
+    }
+
+    float Grid[GridWidth * GridHeight];
+    RasterizeToGrid(Glyph, Grid);
+    const float Aspect = GlyphWidth / GlyphHeight;
+
+    TCHAR Best = TEXT('?');
+    float BestDistance = MAX_flt;
+    for (const FGlyphTemplate& Template : Templates)
+    {
+        float Distance = 0.0f;
+        for (int32 Cell = 0; Cell < GridWidth * GridHeight; ++Cell)
+        {
+            Distance += FMath::Square(Grid[Cell] - Template.Grid[Cell]);
+        }
+        Distance += AspectWeight * FMath::Square(FMath::Loge(Aspect / Template.Aspect));
+
+        if (Distance < BestDistance)
+        {
+            BestDistance = Distance;
+            Best = Template.Character;
+        }
+    }
+
+    // The dimension separator is a lowercase x at x-height
+    if (Best == TEXT('X') && RelativeHeight < 0.8f)
+    {
+        return TEXT('x');
+    }
+    return Best;
+}
+
+void FFloorPlanTextRecognizer::RasterizeToGrid(const FGlyph& Glyph, float* OutGrid)
+{
+    const int32 Width = Glyph.Bounds.Width() + 1;
+    const int32 Height = Glyph.Bounds.Height() + 1;
+
+    TArray<uint8> Bitmap;
+    Bitmap.SetNumZeroed(Width * Height);
+    for (const FIntPoint& Pixel : Glyph.Pixels)
+    {
+        Bitmap[(Pixel.Y - Glyph.Bounds.Min.Y) * Width + (Pixel.X - Glyph.Bounds.Min.X)] = 1;
+    }
+
+    // 3x3 supersampling per cell works for glyphs both smaller and larger than the grid
+    constexpr int32 SubSamples = 3;
+    for (int32 GY = 0; GY < GridHeight; ++GY)
+    {
+        for (int32 GX = 0; GX < GridWidth; ++GX)
+        {
+            int32 Hits = 0;
+            for (int32 SY = 0; SY < SubSamples; ++SY)
+            {
+                for (int32 SX = 0; SX < SubSamples; ++SX)
+                {
+                    const float U = (GX + (SX + 0.5f) / SubSamples) / GridWidth;
+                    const float V = (GY + (SY + 0.5f) / SubSamples) / GridHeight;
+                    const int32 X = FMath::Min(FMath::FloorToInt(U * Width), Width - 1);
+                    const int32 Y = FMath::Min(FMath::FloorToInt(V * Height), Height - 1);
+                    Hits += Bitmap[Y * Width + X];
+                }
+            }
+            OutGrid[GY * GridWidth + GX] = static_cast<float>(Hits) / (SubSamples * SubSamples);
+        }
+    }
+}
@@ -0,0 +1,600 @@
+#include "FloorPlanVectorAnalyzer.h"
+#include "FloorPlanLog.h"
+#include "FloorPlanVectorScene.h"
+#include "Algo/Sort.h"
+
+namespace FloorPlanVectorAnalyzerPrivate
+{
+    bool PointInPolygon(const FVector2D& Point, const TArray<FVector2D>& Polygon)
+    {
+        bool bInside = false;
+        for (int32 Index = 0, Previous = Polygon.Num() - 1; Index < Polygon.Num(); Previous = Index++)
+        {
+            const FVector2D& A = Polygon[Index];
+            const FVector2D& B = Polygon[Previous];
+            if ((A.Y > Point.Y) != (B.Y > Point.Y) && Point.X < (B.X - A.X) * (Point.Y - A.Y) / (B.Y - A.Y) + A.X)
+            {
+                bInside = !bInside;
+            }
+        }
+        return bInside;
+    }
+
+    float Overlap(float Start0, float End0, float Start1, float End1)
+    {
+        return FMath::Min(End0, End1) - FMath::Max(Start0, Start1);
+    }
+}
+
+FFloorPlanVectorAnalyzer::FFloorPlanVectorAnalyzer(const FFloorPlanVectorScene& InScene, const FFloorPlanVectorSettings& InSettings)
+    : Scene(InScene)
+    , Settings(InSettings)
+{
+}
+
+void FFloorPlanVectorAnalyzer::Run()
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(FFloorPlanVectorAnalyzer::Run);
+
+    BuildOrientedLines();
+    DetectWindows();
+    PairWallFaces();
+    DetectGapOpenings();
+    BuildWalls();
+    DetectRooms();
+
+    UE_LOG(LogFloorPlan, Log, TEXT("FloorPlanVectorAnalyzer: %d face lines in %d directions -> %d wall segments, %d openings, %d rooms"),
+           Oriented.Num(), BinAngles.Num(), Walls.Num(), Openings.Num(), Rooms.Num());
+}
+
+void FFloorPlanVectorAnalyzer::MoveResults(TArray<FWallSegmentData>& OutWalls, TArray<FOpeningData>& OutOpenings,
+                                           TArray<FRoomData>& OutRooms, TArray<TArray<FString>>& OutRoomLines)
+{
+    OutWalls = MoveTemp(Walls);
+    OutOpenings = MoveTemp(Openings);
+    OutRooms = MoveTemp(Rooms);
+    OutRoomLines = MoveTemp(RoomLines);
+}
+
+void FFloorPlanVectorAnalyzer::BuildOrientedLines()
+{
+    struct FCandidate
+    {
+        int32 Line;
+        float Angle;
+        float Length;
+    };
+
+    // Undirected angles in [-tolerance, 180 - tolerance) so nearly horizontal lines share one bin
+    const float Tolerance = FMath::Max(Settings.AngleToleranceDegrees, 0.01f);
+    TArray<FCandidate> Candidates;
+    for (int32 LineIndex = 0; LineIndex < Scene.Lines.Num(); ++LineIndex)
+    {
+        const FFloorPlanVectorLine& Line = Scene.Lines[LineIndex];
+        const FVector2D Delta = Line.End - Line.Start;
+        const float Length = Delta.Size();
+        if (Length < Settings.MinWallLength || !Scene.LayerMatches(Line.Layer, Settings.WallLayers))
+        {
+            continue;
+        }
+
+        float Angle = FMath::RadiansToDegrees(FMath::Atan2(Delta.Y, Delta.X));
+        Angle += Angle < 0.0f ? 180.0f : 0.0f;
+        Angle -= Angle >= 180.0f - Tolerance ? 180.0f : 0.0f;
+        Candidates.Add({ LineIndex, Angle, Length });
+    }
+
+    Candidates.Sort([](const FCandidate& A, const FCandidate& B) { return A.Angle < B.Angle; });
+
+    // Bins start at their first member so the spread inside a bin never exceeds the tolerance
+    TArray<int32> CandidateBins;
+    CandidateBins.SetNumUninitialized(Candidates.Num());
+    TArray<double> WeightedAngles;
+    TArray<double> Weights;
+    for (int32 Index = 0; Index < Candidates.Num(); ++Index)
+    {
+        if (Index == 0 || Candidates[Index].Angle - Candidates[BinFirst.Last()].Angle > Tolerance)
+        {
+            BinFirst.Add(Index);
+            WeightedAngles.Add(0.0);
+            Weights.Add(0.0);
+        }
+        CandidateBins[Index] = BinFirst.Num() - 1;
+        WeightedAngles.Last() += Candidates[Index].Angle * Candidates[Index].Length;
+        Weights.Last() += Candidates[Index].Length;
+    }
+
+    BinAngles.SetNumUninitialized(Weights.Num());
+    for (int32 Bin = 0; Bin < Weights.Num(); ++Bin)
+    {
+        BinAngles[Bin] = FMath::DegreesToRadians(static_cast<float>(WeightedAngles[Bin] / Weights[Bin]));
+    }
+
+    Oriented.Reserve(Candidates.Num());
+    for (int32 Index = 0; Index < Candidates.Num(); ++Index)
+    {
+        const int32 Bin = CandidateBins[Index];
+        const FVector2D Direction(FMath::Cos(BinAngles[Bin]), FMath::Sin(BinAngles[Bin]));
+        const FVector2D Normal(-Direction.Y, Direction.X);
+        const FFloorPlanVectorLine& Line = Scene.Lines[Candidates[Index].Line];
+
+        const float Along0 = FVector2D::DotProduct(Line.Start, Direction);
+        const float Along1 = FVector2D::DotProduct(Line.End, Direction);
+        Oriented.Add({ Bin, FVector2D::DotProduct((Line.Start + Line.End) * 0.5f, Normal), FMath::Min(Along0, Along1), FMath::Max(Along0, Along1) });
+    }
+
+    // Candidates are already grouped by bin, so sorting within bins keeps BinFirst valid
+    for (int32 Bin = 0; Bin < BinFirst.Num(); ++Bin)
+    {
+        const int32 First = BinFirst[Bin];
+        const int32 Last = Bin + 1 < BinFirst.Num() ? BinFirst[Bin + 1] : Oriented.Num();
+        Algo::Sort(MakeArrayView(Oriented.GetData() + First, Last - First), [](const FOrientedLine& A, const FOrientedLine& B)
+        {
+            return A.Across < B.Across;
+        });
+    }
+    BinFirst.Add(Oriented.Num());
+
+    Covered.SetNum(Oriented.Num());
+}
+
+void FFloorPlanVectorAnalyzer::DetectWindows()
+{
+    using namespace FloorPlanVectorAnalyzerPrivate;
+
+    // A window is a glass line between two wall faces, all spanning the same opening
+    for (int32 Bin = 0; Bin + 1 < BinFirst.Num(); ++Bin)
+    {
+        const int32 First = BinFirst[Bin];
+        const int32 Last = BinFirst[Bin + 1];
+
+        for (int32 Glass = First; Glass < Last; ++Glass)
+        {
+            const FOrientedLine& GlassLine = Oriented[Glass];
+            const float Width = GlassLine.AlongEnd - GlassLine.AlongStart;
+            if (Width < Settings.MinOpeningWidth || Width > Settings.MaxOpeningWidth)
+            {
+                continue;
+            }
+
+            auto Spans = [this, &GlassLine, Width](int32 Index)
+            {
+                return Overlap(Oriented[Index].AlongStart, Oriented[Index].AlongEnd, GlassLine.AlongStart, GlassLine.AlongEnd) >= Width * 0.8f;
+            };
+
+            // Outermost pair of faces around the glass line that still forms a plausible wall
+            int32 BestBelow = INDEX_NONE;
+            int32 BestAbove = INDEX_NONE;
+            float BestThickness = 0.0f;
+            for (int32 Below = Glass - 1; Below >= First && GlassLine.Across - Oriented[Below].Across <= Settings.MaxWallThickness; --Below)
+            {
+                if (Oriented[Below].Across >= GlassLine.Across || !Spans(Below))
+                {
+                    continue;
+                }
+
+                for (int32 Above = Glass + 1; Above < Last && Oriented[Above].Across - Oriented[Below].Across <= Settings.MaxWallThickness; ++Above)
+                {
+                    const float Thickness = Oriented[Above].Across - Oriented[Below].Across;
+                    if (Oriented[Above].Across > GlassLine.Across && Thickness >= Settings.MinWallThickness && Thickness > BestThickness && Spans(Above))
+                    {
+                        BestBelow = Below;
+                        BestAbove = Above;
+                        BestThickness = Thickness;
+                    }
+                }
+            }
+
+            if (BestBelow == INDEX_NONE)
+            {
+                continue;
+            }
+
+            const FFloatInterval Span(GlassLine.AlongStart, GlassLine.AlongEnd);
+            for (int32 Index = BestBelow; Index <= BestAbove; ++Index)
+            {
+                Cover(Index, Span);
+            }
+
+            // Symbols with several glass lines report one window
+            const float Across = (Oriented[BestBelow].Across + Oriented[BestAbove].Across) * 0.5f;
+            const bool bDuplicate = Windows.ContainsByPredicate([Bin, Across, &Span, BestThickness](const FWindowSpan& Window)
+            {
+                return Window.Bin == Bin && FMath::Abs(Window.Across - Across) < BestThickness * 0.5f &&
+                       Overlap(Window.AlongStart, Window.AlongEnd, Span.Min, Span.Max) > 0.0f;
+            });
+            if (bDuplicate)
+            {
+                continue;
+            }
+
+            Windows.Add({ Bin, Across, Span.Min, Span.Max });
+
+            FOpeningData Window;
+            Window.bIsDoor = false;
+            Window.Position = FromFrame(Bin, (Span.Min + Span.Max) * 0.5f, Across);
+            Window.Size = FVector2D(Width, BestThickness);
+            Window.Rotation = GetBinRotation(Bin);
+            Openings.Add(Window);
+        }
+    }
+}
+
+void FFloorPlanVectorAnalyzer::PairWallFaces()
+{
+    using namespace FloorPlanVectorAnalyzerPrivate;
+
+    // Each stretch of a face pairs with the nearest parallel face on the far side that is still free there
+    TArray<FFloatInterval> FreeLower;
+    TArray<FFloatInterval> FreeBoth;
+    for (int32 Bin = 0; Bin + 1 < BinFirst.Num(); ++Bin)
+    {
+        const int32 Last = BinFirst[Bin + 1];
+        for (int32 Lower = BinFirst[Bin]; Lower < Last; ++Lower)
+        {
+            const FOrientedLine& LowerLine = Oriented[Lower];
+            for (int32 Upper = Lower + 1; Upper < Last && Oriented[Upper].Across - LowerLine.Across <= Settings.MaxWallThickness; ++Upper)
+            {
+                const FOrientedLine& UpperLine = Oriented[Upper];
+                const float Thickness = UpperLine.Across - LowerLine.Across;
+                if (Thickness < Settings.MinWallThickness ||
+                    Overlap(LowerLine.AlongStart, LowerLine.AlongEnd, UpperLine.AlongStart, UpperLine.AlongEnd) < Settings.MinWallLength)
+                {
+                    continue;
+                }
+
+                const FFloatInterval Shared(FMath::Max(LowerLine.AlongStart, UpperLine.AlongStart), FMath::Min(LowerLine.AlongEnd, UpperLine.AlongEnd));
+                FreeLower.Reset();
+                GetUncovered(Lower, Shared, FreeLower);
+                for (const FFloatInterval& Range : FreeLower)
+                {
+                    FreeBoth.Reset();
+                    GetUncovered(Upper, Range, FreeBoth);
+                    for (const FFloatInterval& Piece : FreeBoth)
+                    {
+                        if (Piece.Size() < Settings.MinWallLength)
+                        {
+                            continue;
+                        }
+
+                        FWallPiece WallPiece;
+                        WallPiece.Bin = Bin;
+                        WallPiece.Across = (LowerLine.Across + UpperLine.Across) * 0.5f;
+                        WallPiece.AlongStart = Piece.Min;
+                        WallPiece.AlongEnd = Piece.Max;
+                        WallPiece.Thickness = Thickness;
+                        Pieces.Add(WallPiece);
+
+                        Cover(Lower, Piece);
+                        Cover(Upper, Piece);
+                    }
+                }
+            }
+        }
+    }
+}
+
+void FFloorPlanVectorAnalyzer::DetectGapOpenings()
+{
+    using namespace FloorPlanVectorAnalyzerPrivate;
+
+    // Arc lookup by hinge cell, one maximum opening width per cell
+    const float CellSize = FMath::Max(Settings.MaxOpeningWidth, 1.0f);
+    TMap<FIntPoint, TArray<int32>> ArcGrid;
+    for (int32 ArcIndex = 0; ArcIndex < Scene.Arcs.Num(); ++ArcIndex)
+    {
+        const FVector2D& Center = Scene.Arcs[ArcIndex].Center;
+        ArcGrid.FindOrAdd(FIntPoint(FMath::FloorToInt(Center.X / CellSize), FMath::FloorToInt(Center.Y / CellSize))).Add(ArcIndex);
+    }
+
+    auto HasSwingArc = [this, &ArcGrid, CellSize](const FVector2D& Hinge, float Width, float Thickness)
+    {
+        const FIntPoint Cell(FMath::FloorToInt(Hinge.X / CellSize), FMath::FloorToInt(Hinge.Y / CellSize));
+        for (int32 DY = -1; DY <= 1; ++DY)
+        {
+            for (int32 DX = -1; DX <= 1; ++DX)
+            {
+                if (const TArray<int32>* Bucket = ArcGrid.Find(FIntPoint(Cell.X + DX, Cell.Y + DY)))
+                {
+                    for (int32 ArcIndex : *Bucket)
+                    {
+                        const FFloorPlanVectorArc& Arc = Scene.Arcs[ArcIndex];
+                        if (FVector2D::Distance(Arc.Center, Hinge) <= Thickness + Width * 0.15f &&
+                            Arc.Radius >= Width * 0.6f && Arc.Radius <= Width * 1.3f)
+                        {
+                            return true;
+                        }
+                    }
+                }
+            }
+        }
+        return false;
+    };
+
+    Pieces.Sort([](const FWallPiece& A, const FWallPiece& B)
+    {
+        return A.Bin != B.Bin ? A.Bin < B.Bin : A.Across < B.Across;
+    });
+
+    // Collinear pieces form one wall line, the spaces between neighbors are opening candidates
+    TArray<int32> Group;
+    int32 PieceIndex = 0;
+    while (PieceIndex < Pieces.Num())
+    {
+        Group.Reset();
+        const FWallPiece& Anchor = Pieces[PieceIndex];
+        while (PieceIndex < Pieces.Num() && Pieces[PieceIndex].Bin == Anchor.Bin &&
+               Pieces[PieceIndex].Across - Anchor.Across <= FMath::Max(Anchor.Thickness * 0.5f, 1.0f))
+        {
+            Group.Add(PieceIndex++);
+        }
+
+        Group.Sort([this](int32 A, int32 B) { return Pieces[A].AlongStart < Pieces[B].AlongStart; });
+
+        for (int32 Index = 0; Index + 1 < Group.Num(); ++Index)
+        {
+            FWallPiece& Before = Pieces[Group[Index]];
+            FWallPiece& After = Pieces[Group[Index + 1]];
+            const float GapStart = Before.AlongEnd;
+            const float GapEnd = After.AlongStart;
+            const float Width = GapEnd - GapStart;
+            if (Width < Settings.MinOpeningWidth || Width > Settings.MaxOpeningWidth)
+            {
+                continue;
+            }
+
+            Before.bOpeningAtEnd = true;
+            After.bOpeningAtStart = true;
+
+            const float Across = (Before.Across + After.Across) * 0.5f;
+            const float Thickness = FMath::Max(Before.Thickness, After.Thickness);
+            const float Center = (GapStart + GapEnd) * 0.5f;
+            const int32 Bin = Before.Bin;
+            const bool bWindow = Windows.ContainsByPredicate([Bin, Across, Center, Thickness](const FWindowSpan& Window)
+            {
+                return Window.Bin == Bin && FMath::Abs(Window.Across - Across) <= Thickness &&
+                       Center > Window.AlongStart && Center < Window.AlongEnd;
+            });
+            if (bWindow)
+            {
+                continue;
+            }
+
+            FOpeningData Door;
+            Door.bIsDoor = true;
+            Door.Position = FromFrame(Bin, Center, Across);
+            Door.Size = FVector2D(Width, Thickness);
+            Door.Rotation = GetBinRotation(Bin);
+
+            // Gaps without a swing arc are plain passages: the walls stay open there, but no door is placed
+            if (!HasSwingArc(FromFrame(Bin, GapStart, Across), Width, Thickness) && !HasSwingArc(FromFrame(Bin, GapEnd, Across), Width, Thickness))
+            {
+                UE_LOG(LogFloorPlan, Verbose, TEXT("FloorPlanVectorAnalyzer: Gap at %s has no door arc, keeping it as a passage"),
+                       *Door.Position.ToString());
+                Passages.Add(Door);
+                continue;
+            }
+            Openings.Add(Door);
+        }
+    }
+}
+
+void FFloorPlanVectorAnalyzer::BuildWalls()
+{
+    // Face pairs stop where another wall meets them, extending by half the thickness closes corners and T-junctions
+    Walls.Reserve(Pieces.Num());
+    for (const FWallPiece& Piece : Pieces)
+    {
+        const float Extend = Piece.Thickness * 0.5f;
+        FWallSegmentData Segment;
+        Segment.Start = FromFrame(Piece.Bin, Piece.AlongStart - (Piece.bOpeningAtStart ? 0.0f : Extend), Piece.Across);
+        Segment.End = FromFrame(Piece.Bin, Piece.AlongEnd + (Piece.bOpeningAtEnd ? 0.0f : Extend), Piece.Across);
+        Segment.Thickness = Piece.Thickness;
+        Walls.Add(Segment);
+    }
+}
+
+void FFloorPlanVectorAnalyzer::DetectRooms()
+{
+    TArray<FBox2D> RoomBoxes;
+    TArray<const TArray<FVector2D>*> Outlines;
+
+    // Closed outlines on room layers are exact rooms
+    for (const FFloorPlanVectorPolygon& Polygon : Scene.Polygons)
+    {
+        if (!Scene.LayerMatches(Polygon.Layer, Settings.RoomLayers))
+        {
+            continue;
+        }
+
+        const FBox2D Box(Polygon.Points);
+        FRoomData Room;
+        Room.RoomName = FString::Printf(TEXT("Room_%d"), Rooms.Num() + 1);
+        Room.BoundaryPoints = Polygon.Points;
+        Room.Center = Box.GetCenter();
+        Room.Dimensions = Box.GetSize();
+        Rooms.Add(Room);
+        RoomBoxes.Add(Box);
+        Outlines.Add(&Polygon.Points);
+    }
+
+    if (Rooms.Num() > 0)
+    {
+        AssignTexts(RoomBoxes, Outlines);
+        return;
+    }
+
+    // Otherwise every label that is enclosed by walls on all four sides seeds a rectangular room
+    TArray<int32> TextOrder;
+    for (int32 TextIndex = 0; TextIndex < Scene.Texts.Num(); ++TextIndex)
+    {
+        TextOrder.Add(TextIndex);
+    }
+    TextOrder.Sort([this](int32 A, int32 B)
+    {
+        const FVector2D& PositionA = Scene.Texts[A].Position;
+        const FVector2D& PositionB = Scene.Texts[B].Position;
+        return PositionA.Y != PositionB.Y ? PositionA.Y < PositionB.Y : PositionA.X < PositionB.X;
+    });
+
+    for (int32 TextIndex : TextOrder)
+    {
+        const FVector2D& Origin = Scene.Texts[TextIndex].Position;
+        if (RoomBoxes.ContainsByPredicate([&Origin](const FBox2D& Box) { return Box.IsInside(Origin); }))
+        {
+            continue;
+        }
+
+        const float Left = CastToWall(Origin, FVector2D(-1.0f, 0.0f));
+        const float Right = CastToWall(Origin, FVector2D(1.0f, 0.0f));
+        const float Up = CastToWall(Origin, FVector2D(0.0f, -1.0f));
+        const float Down = CastToWall(Origin, FVector2D(0.0f, 1.0f));
+        if (Left == MAX_flt || Right == MAX_flt || Up == MAX_flt || Down == MAX_flt ||
+            Left + Right < Settings.MinOpeningWidth || Up + Down < Settings.MinOpeningWidth)
+        {
+            continue;
+        }
+
+        const FBox2D Box(FVector2D(Origin.X - Left, Origin.Y - Up), FVector2D(Origin.X + Right, Origin.Y + Down));
+        FRoomData Room;
+        Room.RoomName = FString::Printf(TEXT("Room_%d"), Rooms.Num() + 1);
+        Room.BoundaryPoints = { Box.Min, FVector2D(Box.Max.X, Box.Min.Y), Box.Max, FVector2D(Box.Min.X, Box.Max.Y) };
+        Room.Center = Box.GetCenter();
+        Room.Dimensions = Box.GetSize();
+        Rooms.Add(Room);
+        RoomBoxes.Add(Box);
+        Outlines.Add(nullptr);
+    }
+
+    AssignTexts(RoomBoxes, Outlines);
+}
+
+void FFloorPlanVectorAnalyzer::AssignTexts(const TArray<FBox2D>& RoomBoxes, const TArray<const TArray<FVector2D>*>& Outlines)
+{
+    using namespace FloorPlanVectorAnalyzerPrivate;
+
+    // Each text goes to the smallest room containing it, lines are ordered top to bottom
+    TArray<TArray<TPair<FVector2D, FString>>> Collected;
+    Collected.SetNum(Rooms.Num());
+    for (const FFloorPlanVectorText& Text : Scene.Texts)
+    {
+        int32 Best = INDEX_NONE;
+        float BestArea = MAX_flt;
+        for (int32 RoomIndex = 0; RoomIndex < RoomBoxes.Num(); ++RoomIndex)
+        {
+            const FBox2D& Box = RoomBoxes[RoomIndex];
+            if (Box.IsInside(Text.Position) && Box.GetArea() < BestArea &&
+                (!Outlines[RoomIndex] || PointInPolygon(Text.Position, *Outlines[RoomIndex])))
+            {
+                Best = RoomIndex;
+                BestArea = Box.GetArea();
+            }
+        }
+
+        if (Best != INDEX_NONE)
+        {
+            Collected[Best].Emplace(Text.Position, Text.Text);
+        }
+    }
+
+    RoomLines.SetNum(Rooms.Num());
+    for (int32 RoomIndex = 0; RoomIndex < Rooms.Num(); ++RoomIndex)
+    {
+        Collected[RoomIndex].Sort([](const TPair<FVector2D, FString>& A, const TPair<FVector2D, FString>& B)
+        {
+            return A.Key.Y != B.Key.Y ? A.Key.Y < B.Key.Y : A.Key.X < B.Key.X;
+        });
+        for (const TPair<FVector2D, FString>& Line : Collected[RoomIndex])
+        {
+            RoomLines[RoomIndex].Add(Line.Value);
+        }
+    }
+}
+
+void FFloorPlanVectorAnalyzer::Cover(int32 LineIndex, const FFloatInterval& Range)
+{
+    Covered[LineIndex].Add(Range);
+}
+
+void FFloorPlanVectorAnalyzer::GetUncovered(int32 LineIndex, const FFloatInterval& Range, TArray<FFloatInterval>& OutFree) const
+{
+    // Covered lists stay short (a few walls and windows per face), so a straight subtraction is enough
+    OutFree.Add(Range);
+    for (const FFloatInterval& Used : Covered[LineIndex])
+    {
+        for (int32 Index = OutFree.Num() - 1; Index >= 0; --Index)
+        {
+            const FFloatInterval Free = OutFree[Index];
+            if (Used.Max <= Free.Min || Used.Min >= Free.Max)
+            {
+                continue;
+            }
+
+            OutFree.RemoveAtSwap(Index);
+            if (Used.Min > Free.Min)
+            {
+                OutFree.Add(FFloatInterval(Free.Min, Used.Min));
+            }
+            if (Used.Max < Free.Max)
+            {
+                OutFree.Add(FFloatInterval(Used.Max, Free.Max));
+            }
+        }
+    }
+    OutFree.Sort([](const FFloatInterval& A, const FFloatInterval& B) { return A.Min < B.Min; });
+}
+
+FVector2D FFloorPlanVectorAnalyzer::FromFrame(int32 Bin, float Along, float Across) const
+{
+    const FVector2D Direction(FMath::Cos(BinAngles[Bin]), FMath::Sin(BinAngles[Bin]));
+    return Direction * Along + FVector2D(-Direction.Y, Direction.X) * Across;
+}
+
+float FFloorPlanVectorAnalyzer::GetBinRotation(int32 Bin) const
+{
+    return FMath::RadiansToDegrees(BinAngles[Bin]);
+}
+
+float FFloorPlanVectorAnalyzer::CastToWall(const FVector2D& Origin, const FVector2D& Direction) const
+{
+    float Nearest = MAX_flt;
+    auto Test = [&Origin, &Direction, &Nearest](const FVector2D& Start, const FVector2D& End, float Thickness)
+    {
+        const FVector2D Segment = End - Start;
+        const float Denominator = FVector2D::CrossProduct(Direction, Segment);
+        const float Length = Segment.Size();
+        if (FMath::Abs(Denominator) < 1.0e-4f * Length)
+        {
+            return;
+        }
+
+        const FVector2D ToStart = Start - Origin;
+        const float Distance = FVector2D::CrossProduct(ToStart, Segment) / Denominator;
+        const float Along = FVector2D::CrossProduct(ToStart, Direction) / Denominator;
+        const float Margin = Thickness * 0.5f / Length;
+        if (Distance > 0.0f && Along >= -Margin && Along <= 1.0f + Margin)
+        {
+            // Stop at the near face rather than the center line
+            const float FaceOffset = Thickness * 0.5f * Length / FMath::Abs(Denominator);
+            Nearest = FMath::Min(Nearest, FMath::Max(Distance - FaceOffset, 0.0f));
+        }
+    };
+
+    for (const FWallSegmentData& Wall : Walls)
+    {
+        Test(Wall.Start, Wall.End, Wall.Thickness);
+    }
+
+    // Openings and passages close the room outline so rays do not escape through doorways
+    for (const TArray<FOpeningData>* Gaps : { &Openings, &Passages })
+    {
+        for (const FOpeningData& Opening : *Gaps)
+        {
+            const float Radians = FMath::DegreesToRadians(Opening.Rotation);
+            const FVector2D HalfSpan = FVector2D(FMath::Cos(Radians), FMath::Sin(Radians)) * (Opening.Size.X * 0.5f);
+            Test(Opening.Position - HalfSpan, Opening.Position + HalfSpan, Opening.Size.Y);
+        }
+    }
+
+    return Nearest;
+}
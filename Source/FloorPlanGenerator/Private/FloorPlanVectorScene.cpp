@@ -0,0 +1,250 @@
+#include "FloorPlanVectorScene.h"
+
+float FFloorPlanVectorTransform::ApplyAngle(float Degrees) const
+{
+    const float Radians = FMath::DegreesToRadians(Degrees);
+    const FVector2D Direction = AxisX * FMath::Cos(Radians) + AxisY * FMath::Sin(Radians);
+    return FMath::RadiansToDegrees(FMath::Atan2(Direction.Y, Direction.X));
+}
+
+FFloorPlanVectorTransform FFloorPlanVectorTransform::Then(const FFloorPlanVectorTransform& Parent) const
+{
+    FFloorPlanVectorTransform Result;
+    Result.AxisX = Parent.AxisX * AxisX.X + Parent.AxisY * AxisX.Y;
+    Result.AxisY = Parent.AxisX * AxisY.X + Parent.AxisY * AxisY.Y;
+    Result.Translation = Parent.Apply(Translation);
+    return Result;
+}
+
+int32 FFloorPlanVectorScene::FindOrAddLayer(const FString& Name)
+{
+    const int32 Existing = Layers.IndexOfByKey(Name);
+    return Existing != INDEX_NONE ? Existing : Layers.Add(Name);
+}
+
+bool FFloorPlanVectorScene::LayerMatches(int32 Layer, const TArray<FString>& Patterns) const
+{
+    if (Patterns.Num() == 0)
+    {
+        return true;
+    }
+
+    for (const FString& Pattern : Patterns)
+    {
+        if (Layers[Layer].MatchesWildcard(Pattern))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+int32 FFloorPlanVectorScene::FindOrAddFilteredLayer(const FString& Name, const FFloorPlanVectorReadSettings& Settings)
+{
+    if (const int32* Cached = FilteredLayers.Find(Name))
+    {
+        return *Cached;
+    }
+
+    const int32 Layer = FindOrAddLayer(Name);
+    const bool bIncluded = LayerMatches(Layer, Settings.IncludeLayers);
+    const bool bExcluded = Settings.ExcludeLayers.Num() > 0 && LayerMatches(Layer, Settings.ExcludeLayers);
+    return FilteredLayers.Add(Name, bIncluded && !bExcluded ? Layer : INDEX_NONE);
+}
+
+void FFloorPlanVectorScene::AddLine(const FVector2D& Start, const FVector2D& End, int32 Layer)
+{
+    if (Start.Equals(End))
+    {
+        return;
+    }
+
+    Lines.Add({ Start, End, Layer });
+    Bounds += Start;
+    Bounds += End;
+}
+
+void FFloorPlanVectorScene::AddArc(const FVector2D& Center, float Radius, float StartAngle, float SweepAngle, int32 Layer)
+{
+    if (Radius <= 0.0f || FMath::IsNearlyZero(SweepAngle))
+    {
+        return;
+    }
+
+    Arcs.Add({ Center, Radius, StartAngle, SweepAngle, Layer });
+    Bounds += Center - FVector2D(Radius, Radius);
+    Bounds += Center + FVector2D(Radius, Radius);
+}
+
+void FFloorPlanVectorScene::AddText(const FVector2D& Position, float Height, const FString& Text, int32 Layer)
+{
+    if (Text.IsEmpty())
+    {
+        return;
+    }
+
+    Texts.Add({ Position, Height, Text, Layer });
+    Bounds += Position;
+}
+
+void FFloorPlanVectorScene::AddPolygon(TArray<FVector2D>&& Points, int32 Layer)
+{
+    if (Points.Num() < 3)
+    {
+        return;
+    }
+
+    for (const FVector2D& Point : Points)
+    {
+        Bounds += Point;
+    }
+    Polygons.Add({ MoveTemp(Points), Layer });
+}
+
+void FFloorPlanVectorScene::AddBulgeSegment(const FVector2D& Start, const FVector2D& End, float Bulge, int32 Layer)
+{
+    const float Chord = FVector2D::Distance(Start, End);
+    if (FMath::Abs(Bulge) < 1.0e-4f || Chord <= 0.0f)
+    {
+        AddLine(Start, End, Layer);
+        return;
+    }
+
+    // Included angle is 4 * atan(bulge), positive bulges turn counter-clockwise in drawing space
+    const float Included = 4.0f * FMath::Atan(Bulge);
+    const float Radius = Chord / (2.0f * FMath::Abs(FMath::Sin(Included * 0.5f)));
+    const FVector2D Mid = (Start + End) * 0.5f;
+    const FVector2D Direction = (End - Start) / Chord;
+    const FVector2D Normal(-Direction.Y, Direction.X);
+    const float Sagitta = Radius * FMath::Cos(Included * 0.5f);
+    const FVector2D Center = Mid + Normal * (Bulge > 0.0f ? Sagitta : -Sagitta);
+
+    const float StartAngle = FMath::RadiansToDegrees(FMath::Atan2(Start.Y - Center.Y, Start.X - Center.X));
+    AddArc(Center, Radius, StartAngle, FMath::RadiansToDegrees(Included), Layer);
+}
+
+void FFloorPlanVectorScene::AddArcThroughPoints(const FVector2D& Start, const FVector2D& Mid, const FVector2D& End, int32 Layer)
+{
+    // Circumcenter from the perpendicular bisectors of Start-Mid and Start-End
+    const FVector2D B = Mid - Start;
+    const FVector2D C = End - Start;
+    const float Denominator = 2.0f * FVector2D::CrossProduct(B, C);
+    if (FMath::Abs(Denominator) < 1.0e-6f * (B.SizeSquared() + C.SizeSquared()))
+    {
+        AddLine(Start, End, Layer);
+        return;
+    }
+
+    const FVector2D Offset((C.Y * B.SizeSquared() - B.Y * C.SizeSquared()) / Denominator,
+                           (B.X * C.SizeSquared() - C.X * B.SizeSquared()) / Denominator);
+    const FVector2D Center = Start + Offset;
+
+    // Sweep toward End on the side that passes through Mid
+    auto AngleOf = [&Center](const FVector2D& Point)
+    {
+        return FMath::RadiansToDegrees(FMath::Atan2(Point.Y - Center.Y, Point.X - Center.X));
+    };
+    const float StartAngle = AngleOf(Start);
+    const float ToMid = FMath::Fmod(AngleOf(Mid) - StartAngle + 720.0f, 360.0f);
+    const float ToEnd = FMath::Fmod(AngleOf(End) - StartAngle + 720.0f, 360.0f);
+    const float Sweep = ToMid <= ToEnd ? ToEnd : ToEnd - 360.0f;
+
+    AddArc(Center, Offset.Size(), StartAngle, Sweep, Layer);
+}
+
+void FFloorPlanVectorScene::AddCubic(const FVector2D& P0, const FVector2D& P1, const FVector2D& P2, const FVector2D& P3, int32 Layer)
+{
+    auto Evaluate = [&](float T)
+    {
+        const float U = 1.0f - T;
+        return P0 * (U * U * U) + P1 * (3.0f * U * U * T) + P2 * (3.0f * U * T * T) + P3 * (T * T * T);
+    };
+
+    // Drawing tools write circular arcs as cubics with at most a quarter turn each, check the quarter points against the circle
+    const FVector2D Mid = Evaluate(0.5f);
+    const FVector2D B = Mid - P0;
+    const FVector2D C = P3 - P0;
+    const float Denominator = 2.0f * FVector2D::CrossProduct(B, C);
+    if (FMath::Abs(Denominator) > 1.0e-6f * (B.SizeSquared() + C.SizeSquared()))
+    {
+        const FVector2D Center = P0 + FVector2D((C.Y * B.SizeSquared() - B.Y * C.SizeSquared()) / Denominator,
+                                                (B.X * C.SizeSquared() - C.X * B.SizeSquared()) / Denominator);
+        const float Radius = FVector2D::Distance(Center, P0);
+        const float Tolerance = Radius * 0.01f;
+        if (FMath::Abs(FVector2D::Distance(Center, Evaluate(0.25f)) - Radius) <= Tolerance &&
+            FMath::Abs(FVector2D::Distance(Center, Evaluate(0.75f)) - Radius) <= Tolerance)
+        {
+            AddArcThroughPoints(P0, Mid, P3, Layer);
+            return;
+        }
+    }
+
+    // Straight cubics stay a single line, curved ones are split evenly
+    const float ControlLength = FVector2D::Distance(P0, P1) + FVector2D::Distance(P1, P2) + FVector2D::Distance(P2, P3);
+    const float ChordLength = FVector2D::Distance(P0, P3);
+    const int32 NumSegments = ControlLength - ChordLength < 1.0e-3f * ControlLength ? 1 : 16;
+    FVector2D Previous = P0;
+    for (int32 Segment = 1; Segment <= NumSegments; ++Segment)
+    {
+        const FVector2D Next = Segment == NumSegments ? P3 : Evaluate(static_cast<float>(Segment) / NumSegments);
+        AddLine(Previous, Next, Layer);
+        Previous = Next;
+    }
+}
+
+void FFloorPlanVectorScene::NormalizeToOrigin(bool bFlipY)
+{
+    if (!Bounds.bIsValid)
+    {
+        return;
+    }
+
+    const FVector2D Origin(Bounds.Min.X, bFlipY ? Bounds.Max.Y : Bounds.Min.Y);
+    const float SignY = bFlipY ? -1.0f : 1.0f;
+    auto Map = [&Origin, SignY](const FVector2D& Point)
+    {
+        return FVector2D(Point.X - Origin.X, (Point.Y - Origin.Y) * SignY);
+    };
+
+    for (FFloorPlanVectorLine& Line : Lines)
+    {
+        Line.Start = Map(Line.Start);
+        Line.End = Map(Line.End);
+    }
+
+    // Mirroring reverses the sweep direction, so the mirrored arc starts where the original ended
+    for (FFloorPlanVectorArc& Arc : Arcs)
+    {
+        Arc.Center = Map(Arc.Center);
+        if (bFlipY)
+        {
+            Arc.StartAngle = -(Arc.StartAngle + Arc.SweepAngle);
+        }
+    }
+
+    for (FFloorPlanVectorText& Text : Texts)
+    {
+        Text.Position = Map(Text.Position);
+    }
+
+    for (FFloorPlanVectorPolygon& Polygon : Polygons)
+    {
+        for (FVector2D& Point : Polygon.Points)
+        {
+            Point = Map(Point);
+        }
+    }
+
+    Bounds = FBox2D(FVector2D::ZeroVector, Bounds.GetSize());
+}
+
+void FFloorPlanVectorScene::Reset()
+{
+    Layers.Reset();
+    Lines.Reset();
+    Arcs.Reset();
+    Texts.Reset();
+    Polygons.Reset();
+    Bounds = FBox2D(ForceInit);
+    FilteredLayers.Reset();
+}
@@ -1,4 +1,8 @@
 #include "MeshGenerator.h"
+#include "FloorPlanLog.h"
+#include "FloorPlanMeshBuffers.h"
+#include "FloorPlanMaterialSet.h"
+#include "FloorPlanPolygonUnion.h"
 #include "Engine/StaticMesh.h"
 #include "Engine/Engine.h"
 #include "Components/StaticMeshComponent.h"
@@ -7,10 +11,63 @@
 #include "ProceduralMeshComponent.h"
 #include "MeshDescription.h"
 #include "StaticMeshAttributes.h"
+#include "Algo/Sort.h"
+
+namespace MeshGeneratorPrivate
+{
+    // One UV0 tile per meter of surface
+    constexpr float UVWorldSize = 100.0f;
+
+    // Planar frame of a face: horizontal faces project onto XY, vertical faces run U along the face and V down
+    void GetFaceFrame(const FVector& Normal, FVector& OutU, FVector& OutV)
+    {
+        if (FMath::Abs(Normal.Z) > 0.7f)
+        {
+            OutU = FVector::ForwardVector;
+            OutV = FVector::RightVector;
+            return;
+        }
+        OutU = FVector::CrossProduct(FVector::UpVector, Normal).GetSafeNormal();
+        OutV = FVector::DownVector;
+    }
+}
 
 UMeshGenerator::UMeshGenerator()
 {
     MeshCounter = 0;
+
+    // Merged buildings reach millions of triangles, so they are Nanite by default
+    FFloorPlanMeshOutputSettings Merged;
+    Merged.bNanite = true;
+    OutputSettings.Add(EFloorPlanMeshKind::Merged, Merged);
+}
+
+FFloorPlanMeshOutputSettings UMeshGenerator::GetOutputSettings(EFloorPlanMeshKind Kind) const
+{
+    const FFloorPlanMeshOutputSettings* Settings = OutputSettings.Find(Kind);
+    return Settings ? *Settings : FFloorPlanMeshOutputSettings();
+}
+
+UFloorPlanMaterialSet* UMeshGenerator::GetMaterialSet()
+{
+    if (!MaterialSet)
+    {
+        MaterialSet = NewObject<UFloorPlanMaterialSet>(this);
+    }
+    return MaterialSet;
+}
+
+FString UMeshGenerator::GetSlotName(EFloorPlanMeshKind Kind)
+{
+    switch (Kind)
+    {
+    case EFloorPlanMeshKind::Floor:
+        return TEXT("Floor");
+    case EFloorPlanMeshKind::Ceiling:
+        return TEXT("Ceiling");
+    default:
+        return TEXT("Wall");
+    }
 }
 
 UStaticMesh* UMeshGenerator::GenerateWallMesh(const FVector2D& StartPoint, const FVector2D& EndPoint, 
@@ -33,19 +90,22 @@ UStaticMesh* UMeshGenerator::GenerateWallMesh(const FVector2D& StartPoint, const
     float WallHeightUE = Height;
     float WallThicknessUE = Thickness;
     
-    CreateWallMeshWithOpenings(Vertices, Triangles, UVs, Normals, 
-                              WallLengthUE, WallHeightUE, WallThicknessUE, 
-                              Openings, DoorHeight, WindowHeight);
+    {
+        FLOORPLAN_SCOPE_STAGE(STAT_FloorPlanMeshBuild, &Profile, MeshBuildMs);
+        CreateWallMeshWithOpenings(Vertices, Triangles, UVs, Normals, 
+                                  WallLengthUE, WallHeightUE, WallThicknessUE, 
+                                  Openings, DoorHeight, WindowHeight);
+    }
 
     FString MeshName = FString::Printf(TEXT("Wall_%.0f_x_%.0f"), WallLengthUE, WallHeightUE);
-    return CreateStaticMeshAsset(Vertices, Triangles, UVs, Normals, MeshName);
+    return CreateStaticMeshAsset(Vertices, Triangles, UVs, Normals, MeshName, EFloorPlanMeshKind::Wall);
 }
 
 UStaticMesh* UMeshGenerator::GenerateFloorMesh(const TArray<FVector2D>& BoundaryPoints, float ZHeight)
 {
     if (BoundaryPoints.Num() < 3)
     {
-        UE_LOG(LogTemp, Error, TEXT("MeshGenerator: Not enough boundary points for floor mesh"));
+        UE_LOG(LogFloorPlan, Error, TEXT("MeshGenerator: Not enough boundary points for floor mesh"));
         return nullptr;
     }
 
@@ -69,10 +129,13 @@ UStaticMesh* UMeshGenerator::GenerateFloorMesh(const TArray<FVector2D>& Boundary
     float RoomLength = MaxPoint.Y - MinPoint.Y;
     float FloorThickness = 20.0f; // 20cm thick floor
 
-    CreateThickFloorMesh(Vertices, Triangles, UVs, Normals, RoomWidth, RoomLength, FloorThickness);
+    {
+        FLOORPLAN_SCOPE_STAGE(STAT_FloorPlanMeshBuild, &Profile, MeshBuildMs);
+        CreateThickFloorMesh(Vertices, Triangles, UVs, Normals, RoomWidth, RoomLength, FloorThickness);
+    }
 
     FString MeshName = FString::Printf(TEXT("Floor_%.0f_x_%.0f"), RoomWidth, RoomLength);
-    return CreateStaticMeshAsset(Vertices, Triangles, UVs, Normals, MeshName);
+    return CreateStaticMeshAsset(Vertices, Triangles, UVs, Normals, MeshName, EFloorPlanMeshKind::Floor);
 }
 
 UStaticMesh* UMeshGenerator::GenerateCeilingMesh(const TArray<FVector2D>& BoundaryPoints, float ZHeight)
@@ -102,10 +165,13 @@ UStaticMesh* UMeshGenerator::GenerateCeilingMesh(const TArray<FVector2D>& Bounda
     float RoomLength = MaxPoint.Y - MinPoint.Y;
     float CeilingThickness = 15.0f; // 15cm thick ceiling
 
-    CreateThickCeilingMesh(Vertices, Triangles, UVs, Normals, RoomWidth, RoomLength, CeilingThickness);
+    {
+        FLOORPLAN_SCOPE_STAGE(STAT_FloorPlanMeshBuild, &Profile, MeshBuildMs);
+        CreateThickCeilingMesh(Vertices, Triangles, UVs, Normals, RoomWidth, RoomLength, CeilingThickness);
+    }
 
     FString MeshName = FString::Printf(TEXT("Ceiling_%.0f_x_%.0f"), RoomWidth, RoomLength);
-    return CreateStaticMeshAsset(Vertices, Triangles, UVs, Normals, MeshName);
+    return CreateStaticMeshAsset(Vertices, Triangles, UVs, Normals, MeshName, EFloorPlanMeshKind::Ceiling);
 }
 
 void UMeshGenerator::CreateWallMeshWithOpenings(TArray<FVector>& Vertices, TArray<int32>& Triangles, 
@@ -129,17 +195,25 @@ void UMeshGenerator::CreateWallMeshWithOpenings(TArray<FVector>& Vertices, TArra
     }
     else
     {
-        // Create wall segments with openings
+        // Create wall segments with openings. Position.X is the opening center measured along the wall
+        // from its start; openings are walked in order and clipped to the wall and to each other.
+        TArray<FOpeningData> SortedOpenings = Openings;
+        Algo::SortBy(SortedOpenings, [](const FOpeningData& Opening) { return Opening.Position.X; });
+
         float CurrentX = -Length * 0.5f;
         
-        for (const FOpeningData& Opening : Openings)
+        for (const FOpeningData& Opening : SortedOpenings)
         {
-            float OpeningX = 0.0f; // Center opening for simplicity
+            float OpeningX = static_cast<float>(Opening.Position.X) - Length * 0.5f;
             float OpeningWidth = Opening.Size.X;
             float OpeningHeight = Opening.bIsDoor ? DoorHeight : WindowHeight;
             
-            float OpeningStart = OpeningX - OpeningWidth * 0.5f;
-            float OpeningEnd = OpeningX + OpeningWidth * 0.5f;
+            float OpeningStart = FMath::Max(OpeningX - OpeningWidth * 0.5f, CurrentX);
+            float OpeningEnd = FMath::Min(OpeningX + OpeningWidth * 0.5f, Length * 0.5f);
+            if (OpeningEnd <= OpeningStart)
+            {
+                continue;
+            }
             
             // Wall segment before opening
             if (OpeningStart > CurrentX)
@@ -216,232 +290,334 @@ void UMeshGenerator::CreateWallMeshWithOpenings(TArray<FVector>& Vertices, TArra
         CreateWallSegmentMesh(Vertices, Triangles, UVs, Normals, Segment, Thickness);
     }
     
-    UE_LOG(LogTemp, Warning, TEXT("Generated wall mesh: %.1f x %.1f x %.1f with %d openings, %d segments"), 
+    UE_LOG(LogFloorPlan, Verbose, TEXT("MeshGenerator: Generated wall mesh %.1f x %.1f x %.1f with %d openings, %d segments"), 
            Length, Height, Thickness, Openings.Num(), WallSegments.Num());
 }
 
-void UMeshGenerator::CreateWallSegmentMesh(TArray<FVector>& Vertices, TArray<int32>& Triangles,
-                                          TArray<FVector2D>& UVs, TArray<FVector>& Normals,
-                                          const FWallSegment& Segment, float Thickness)
+void UMeshGenerator::AddQuad(TArray<FVector>& Vertices, TArray<int32>& Triangles,
+                             TArray<FVector2D>& UVs, TArray<FVector>& Normals,
+                             const FVector (&Corners)[4], const FVector& Normal)
 {
-    int32 StartIndex = Vertices.Num();
-    
-    float HalfThickness = Thickness * 0.5f;
-    float SegmentWidth = Segment.EndX - Segment.StartX;
-    float SegmentHeight = Segment.EndZ - Segment.StartZ;
-    
-    // Create box vertices for wall segment
-    TArray<FVector> BoxVertices = {
-        // Front face
-        FVector(Segment.StartX, -HalfThickness, Segment.StartZ), // 0
-        FVector(Segment.EndX, -HalfThickness, Segment.StartZ),   // 1
-        FVector(Segment.EndX, -HalfThickness, Segment.EndZ),     // 2
-        FVector(Segment.StartX, -HalfThickness, Segment.EndZ),   // 3
-        // Back face
-        FVector(Segment.StartX, HalfThickness, Segment.StartZ),  // 4
-        FVector(Segment.EndX, HalfThickness, Segment.StartZ),    // 5
-        FVector(Segment.EndX, HalfThickness, Segment.EndZ),      // 6
-        FVector(Segment.StartX, HalfThickness, Segment.EndZ)     // 7
-    };
-    
-    Vertices.Append(BoxVertices);
-    
-    // Add UVs
-    for (int32 i = 0; i < 8; i++)
-    {
-        UVs.Add(FVector2D((i % 2) * 1.0f, (i / 4) * 1.0f));
-    }
-    
-    // Add normals (will be calculated properly later)
-    for (int32 i = 0; i < 8; i++)
+    using namespace MeshGeneratorPrivate;
+
+    const int32 StartIndex = Vertices.Num();
+
+    // Box projection: the face's own tangent frame at world scale, so textures tile continuously across segments
+    FVector TangentU;
+    FVector TangentV;
+    GetFaceFrame(Normal, TangentU, TangentV);
+    for (const FVector& Corner : Corners)
     {
-        Normals.Add(FVector::UpVector);
+        Vertices.Add(Corner);
+        Normals.Add(Normal);
+        UVs.Add(FVector2D(FVector::DotProduct(Corner, TangentU), FVector::DotProduct(Corner, TangentV)) / UVWorldSize);
     }
-    
-    // Create triangles for box faces
-    TArray<int32> BoxTriangles = {
-        // Front face
-        0, 2, 1, 0, 3, 2,
-        // Back face  
-        4, 5, 6, 4, 6, 7,
-        // Left face
-        4, 7, 3, 4, 3, 0,
-        // Right face
-        1, 2, 6, 1, 6, 5,
-        // Bottom face
-        4, 0, 1, 4, 1, 5,
-        // Top face
-        3, 7, 6, 3, 6, 2
-    };
-    
-    // Add triangles with offset
-    for (int32 Triangle : BoxTriangles)
+
+    // Front faces wind so that the corner cross product points away from the normal, as on the original slabs
+    const bool bFlip = FVector::DotProduct(FVector::CrossProduct(Corners[1] - Corners[0], Corners[2] - Corners[0]), Normal) > 0.0f;
+    const int32 QuadTriangles[2][6] = { { 0, 1, 2, 0, 2, 3 }, { 0, 2, 1, 0, 3, 2 } };
+    for (int32 Corner : QuadTriangles[bFlip ? 1 : 0])
     {
-        Triangles.Add(StartIndex + Triangle);
+        Triangles.Add(StartIndex + Corner);
     }
 }
 
+void UMeshGenerator::AddBoxFaces(TArray<FVector>& Vertices, TArray<int32>& Triangles,
+                                 TArray<FVector2D>& UVs, TArray<FVector>& Normals,
+                                 const FVector& Min, const FVector& Max)
+{
+    // Four unique corners per face so normals stay flat and every face is its own lightmap chart
+    AddQuad(Vertices, Triangles, UVs, Normals, { FVector(Min.X, Min.Y, Max.Z), FVector(Max.X, Min.Y, Max.Z), FVector(Max.X, Max.Y, Max.Z), FVector(Min.X, Max.Y, Max.Z) }, FVector::UpVector);
+    AddQuad(Vertices, Triangles, UVs, Normals, { FVector(Min.X, Min.Y, Min.Z), FVector(Min.X, Max.Y, Min.Z), FVector(Max.X, Max.Y, Min.Z), FVector(Max.X, Min.Y, Min.Z) }, FVector::DownVector);
+    AddQuad(Vertices, Triangles, UVs, Normals, { FVector(Min.X, Min.Y, Min.Z), FVector(Max.X, Min.Y, Min.Z), FVector(Max.X, Min.Y, Max.Z), FVector(Min.X, Min.Y, Max.Z) }, FVector::LeftVector);
+    AddQuad(Vertices, Triangles, UVs, Normals, { FVector(Max.X, Max.Y, Min.Z), FVector(Min.X, Max.Y, Min.Z), FVector(Min.X, Max.Y, Max.Z), FVector(Max.X, Max.Y, Max.Z) }, FVector::RightVector);
+    AddQuad(Vertices, Triangles, UVs, Normals, { FVector(Min.X, Max.Y, Min.Z), FVector(Min.X, Min.Y, Min.Z), FVector(Min.X, Min.Y, Max.Z), FVector(Min.X, Max.Y, Max.Z) }, FVector::BackwardVector);
+    AddQuad(Vertices, Triangles, UVs, Normals, { FVector(Max.X, Min.Y, Min.Z), FVector(Max.X, Max.Y, Min.Z), FVector(Max.X, Max.Y, Max.Z), FVector(Max.X, Min.Y, Max.Z) }, FVector::ForwardVector);
+}
+
+void UMeshGenerator::CreateWallSegmentMesh(TArray<FVector>& Vertices, TArray<int32>& Triangles,
+                                          TArray<FVector2D>& UVs, TArray<FVector>& Normals,
+                                          const FWallSegment& Segment, float Thickness)
+{
+    const float HalfThickness = Thickness * 0.5f;
+    AddBoxFaces(Vertices, Triangles, UVs, Normals,
+                FVector(Segment.StartX, -HalfThickness, Segment.StartZ),
+                FVector(Segment.EndX, HalfThickness, Segment.EndZ));
+}
+
 void UMeshGenerator::CreateThickFloorMesh(TArray<FVector>& Vertices, TArray<int32>& Triangles,
                                          TArray<FVector2D>& UVs, TArray<FVector>& Normals,
                                          float Width, float Length, float Thickness)
 {
-    int32 StartIndex = Vertices.Num();
-    
-    float HalfWidth = Width * 0.5f;
-    float HalfLength = Length * 0.5f;
-    
-    // Create thick floor vertices (box)
-    TArray<FVector> FloorVertices = {
-        // Top face
-        FVector(-HalfWidth, -HalfLength, 0),      // 0
-        FVector(HalfWidth, -HalfLength, 0),       // 1
-        FVector(HalfWidth, HalfLength, 0),        // 2
-        FVector(-HalfWidth, HalfLength, 0),       // 3
-        // Bottom face
-        FVector(-HalfWidth, -HalfLength, -Thickness), // 4
-        FVector(HalfWidth, -HalfLength, -Thickness),  // 5
-        FVector(HalfWidth, HalfLength, -Thickness),   // 6
-        FVector(-HalfWidth, HalfLength, -Thickness)   // 7
-    };
+    // Walkable top face at Z = 0, slab below it
+    AddBoxFaces(Vertices, Triangles, UVs, Normals,
+                FVector(-Width * 0.5f, -Length * 0.5f, -Thickness),
+                FVector(Width * 0.5f, Length * 0.5f, 0.0f));
     
-    Vertices.Append(FloorVertices);
-    
-    // Add UVs
-    for (int32 i = 0; i < 8; i++)
-    {
-        UVs.Add(FVector2D((i % 2) * 1.0f, ((i / 2) % 2) * 1.0f));
-    }
-    
-    // Add normals
-    for (int32 i = 0; i < 8; i++)
-    {
-        Normals.Add(FVector::UpVector);
-    }
-    
-    // Create triangles for floor box
-    TArray<int32> FloorTriangles = {
-        // Top face
-        0, 2, 1, 0, 3, 2,
-        // Bottom face
-        4, 5, 6, 4, 6, 7,
-        // Front face
-        0, 1, 5, 0, 5, 4,
-        // Back face
-        2, 3, 7, 2, 7, 6,
-        // Left face
-        3, 0, 4, 3, 4, 7,
-        // Right face
-        1, 2, 6, 1, 6, 5
-    };
-    
-    for (int32 Triangle : FloorTriangles)
-    {
-        Triangles.Add(StartIndex + Triangle);
-    }
-    
-    UE_LOG(LogTemp, Warning, TEXT("Generated thick floor: %.1f x %.1f x %.1f"), Width, Length, Thickness);
+    UE_LOG(LogFloorPlan, Verbose, TEXT("MeshGenerator: Generated thick floor %.1f x %.1f x %.1f"), Width, Length, Thickness);
 }
 
 void UMeshGenerator::CreateThickCeilingMesh(TArray<FVector>& Vertices, TArray<int32>& Triangles,
                                            TArray<FVector2D>& UVs, TArray<FVector>& Normals,
                                            float Width, float Length, float Thickness)
 {
-    int32 StartIndex = Vertices.Num();
-    
-    float HalfWidth = Width * 0.5f;
-    float HalfLength = Length * 0.5f;
-    
-    // Create thick ceiling vertices (box at top)
-    TArray<FVector> CeilingVertices = {
-        // Bottom face
-        FVector(-HalfWidth, -HalfLength, 0),      // 0
-        FVector(HalfWidth, -HalfLength, 0),       // 1
-        FVector(HalfWidth, HalfLength, 0),        // 2
-        FVector(-HalfWidth, HalfLength, 0),       // 3
-        // Top face
-        FVector(-HalfWidth, -HalfLength, Thickness), // 4
-        FVector(HalfWidth, -HalfLength, Thickness),  // 5
-        FVector(HalfWidth, HalfLength, Thickness),   // 6
-        FVector(-HalfWidth, HalfLength, Thickness)   // 7
-    };
-    
-    Vertices.Append(CeilingVertices);
-    
-    // Add UVs
-    for (int32 i = 0; i < 8; i++)
-    {
-        UVs.Add(FVector2D((i % 2) * 1.0f, ((i / 2) % 2) * 1.0f));
-    }
-    
-    // Add normals
-    for (int32 i = 0; i < 8; i++)
-    {
-        Normals.Add(FVector::DownVector);
-    }
-    
-    // Create triangles for ceiling box
-    TArray<int32> CeilingTriangles = {
-        // Bottom face
-        0, 1, 2, 0, 2, 3,
-        // Top face
-        4, 6, 5, 4, 7, 6,
-        // Front face
-        0, 5, 1, 0, 4, 5,
-        // Back face
-        2, 6, 3, 3, 6, 7,
-        // Left face
-        3, 7, 0, 0, 7, 4,
-        // Right face
-        1, 5, 2, 2, 5, 6
-    };
+    // Visible bottom face at Z = 0, slab above it
+    AddBoxFaces(Vertices, Triangles, UVs, Normals,
+                FVector(-Width * 0.5f, -Length * 0.5f, 0.0f),
+                FVector(Width * 0.5f, Length * 0.5f, Thickness));
     
-    for (int32 Triangle : CeilingTriangles)
+    UE_LOG(LogFloorPlan, Verbose, TEXT("MeshGenerator: Generated thick ceiling %.1f x %.1f x %.1f"), Width, Length, Thickness);
+}
+
+void UMeshGenerator::CreateSlabMesh(TArray<FVector>& Vertices, TArray<int32>& Triangles,
+                                    TArray<FVector2D>& UVs, TArray<FVector>& Normals,
+                                    const TArray<FFloorPlanPolygon>& Polygons, float MinZ, float MaxZ)
+{
+    using namespace MeshGeneratorPrivate;
+
+    TArray<FVector2D> CapVertices;
+    TArray<int32> CapTriangles;
+    for (const FFloorPlanPolygon& Polygon : Polygons)
     {
-        Triangles.Add(StartIndex + Triangle);
+        if (!FFloorPlanPolygonUnion::Triangulate(Polygon, CapVertices, CapTriangles))
+        {
+            UE_LOG(LogFloorPlan, Warning, TEXT("MeshGenerator: Could not triangulate a slab outline with %d points and %d holes"),
+                   Polygon.Outer.Num(), Polygon.Holes.Num());
+            continue;
+        }
+
+        // Top and bottom caps with their own vertices, so normals stay flat; UVs as on horizontal box faces
+        for (int32 Cap = 0; Cap < 2; ++Cap)
+        {
+            const bool bTop = Cap == 0;
+            const FVector Normal = bTop ? FVector::UpVector : FVector::DownVector;
+            const int32 StartIndex = Vertices.Num();
+            for (const FVector2D& Point : CapVertices)
+            {
+                Vertices.Add(FVector(Point.X, Point.Y, bTop ? MaxZ : MinZ));
+                Normals.Add(Normal);
+                UVs.Add(Point / UVWorldSize);
+            }
+
+            // Cap triangles are counter-clockwise; front faces wind against their normal, as in AddQuad
+            for (int32 Index = 0; Index + 2 < CapTriangles.Num(); Index += 3)
+            {
+                Triangles.Add(StartIndex + CapTriangles[Index]);
+                Triangles.Add(StartIndex + CapTriangles[Index + (bTop ? 2 : 1)]);
+                Triangles.Add(StartIndex + CapTriangles[Index + (bTop ? 1 : 2)]);
+            }
+        }
+
+        // Outline and hole edges both have the slab on their left, so every side faces to the right
+        auto AddSides = [&](const TArray<FVector2D>& Ring)
+        {
+            for (int32 Index = 0; Index < Ring.Num(); ++Index)
+            {
+                const FVector2D& A = Ring[Index];
+                const FVector2D& B = Ring[(Index + 1) % Ring.Num()];
+                const FVector2D Direction = (B - A).GetSafeNormal();
+                if (Direction.IsNearlyZero())
+                {
+                    continue;
+                }
+                AddQuad(Vertices, Triangles, UVs, Normals,
+                        { FVector(A.X, A.Y, MinZ), FVector(B.X, B.Y, MinZ), FVector(B.X, B.Y, MaxZ), FVector(A.X, A.Y, MaxZ) },
+                        FVector(Direction.Y, -Direction.X, 0.0f));
+            }
+        };
+        AddSides(Polygon.Outer);
+        for (const TArray<FVector2D>& Hole : Polygon.Holes)
+        {
+            AddSides(Hole);
+        }
     }
-    
-    UE_LOG(LogTemp, Warning, TEXT("Generated thick ceiling: %.1f x %.1f x %.1f"), Width, Length, Thickness);
+
+    UE_LOG(LogFloorPlan, Verbose, TEXT("MeshGenerator: Generated slab over %d outlines from Z %.1f to %.1f"), Polygons.Num(), MinZ, MaxZ);
 }
 
 UStaticMesh* UMeshGenerator::CreateStaticMeshAsset(const TArray<FVector>& Vertices, 
                                                   const TArray<int32>& Triangles, 
                                                   const TArray<FVector2D>& UVs,
                                                   const TArray<FVector>& Normals,
-                                                  const FString& MeshName)
+                                                  const FString& MeshName,
+                                                  EFloorPlanMeshKind Kind)
 {
-    if (Vertices.Num() == 0 || Triangles.Num() == 0)
+    FFloorPlanMeshBuffers Buffers;
+    Buffers.Append(Vertices, Triangles, UVs, Normals, Buffers.FindOrAddSection(GetSlotName(Kind)), FTransform::Identity);
+
+    const FFloorPlanMeshOutputSettings Settings = GetOutputSettings(Kind);
     {
-        UE_LOG(LogTemp, Error, TEXT("MeshGenerator: No vertices or triangles to create mesh"));
+        FLOORPLAN_SCOPE_STAGE(STAT_FloorPlanMeshBuild, &Profile, MeshBuildMs);
+        Buffers.PackLightmapUVs(Settings.LightmapResolution);
+    }
+    return CreateStaticMeshAsset(Buffers, MeshName, Settings);
+}
+
+UStaticMesh* UMeshGenerator::CreateMeshAsset(const FFloorPlanMeshBuffers& Buffers, const FString& MeshName, EFloorPlanMeshKind Kind)
+{
+    check(IsInGameThread());
+    return CreateStaticMeshAsset(Buffers, MeshName, GetOutputSettings(Kind));
+}
+
+TArray<UStaticMesh*> UMeshGenerator::CreateMergedMeshAssets(const FFloorPlanMeshBuffers& Buffers, const FString& BaseName)
+{
+    const FFloorPlanMeshOutputSettings Settings = GetOutputSettings(EFloorPlanMeshKind::Merged);
+
+    TArray<FFloorPlanMeshBuffers> Chunks;
+    {
+        FLOORPLAN_SCOPE_STAGE(STAT_FloorPlanMeshBuild, &Profile, MeshBuildMs);
+        Buffers.SplitSpatially(Settings.MaxTrianglesPerChunk, Chunks);
+        for (FFloorPlanMeshBuffers& Chunk : Chunks)
+        {
+            Chunk.PackLightmapUVs(Settings.LightmapResolution);
+
+            FFloorPlanMeshOptimizeStats Stats;
+            Chunk.Optimize(&Stats);
+            Profile.AddMeshOptimization(Stats);
+        }
+    }
+
+    TArray<UStaticMesh*> Meshes;
+    for (int32 ChunkIndex = 0; ChunkIndex < Chunks.Num(); ++ChunkIndex)
+    {
+        const FString MeshName = Chunks.Num() > 1 ? FString::Printf(TEXT("%s_Chunk%02d"), *BaseName, ChunkIndex) : BaseName;
+        if (UStaticMesh* Mesh = CreateStaticMeshAsset(Chunks[ChunkIndex], MeshName, Settings))
+        {
+            Meshes.Add(Mesh);
+        }
+    }
+
+    UE_LOG(LogFloorPlan, Log, TEXT("MeshGenerator: Created %d merged mesh chunks for %s (%lld triangles, %s)"),
+           Meshes.Num(), *BaseName, Buffers.GetNumTriangles(), Settings.bNanite ? TEXT("Nanite") : TEXT("LODs"));
+    return Meshes;
+}
+
+UStaticMesh* UMeshGenerator::CreateStaticMeshAsset(const FFloorPlanMeshBuffers& Buffers, const FString& MeshName, const FFloorPlanMeshOutputSettings& Settings)
+{
+    const int32 NumVertices = Buffers.GetNumVertices();
+    const int64 NumTriangles = Buffers.GetNumTriangles();
+    if (NumVertices == 0 || NumTriangles == 0)
+    {
+        UE_LOG(LogFloorPlan, Error, TEXT("MeshGenerator: No vertices or triangles to create mesh"));
         return nullptr;
     }
 
+    FLOORPLAN_SCOPE_STAGE(STAT_FloorPlanAssetCreate, &Profile, AssetCreateMs);
+    INC_DWORD_STAT_BY(STAT_FloorPlanVertices, NumVertices);
+    INC_DWORD_STAT_BY(STAT_FloorPlanTriangles, NumTriangles);
+    Profile.MeshCount++;
+    Profile.VertexCount += NumVertices;
+    Profile.TriangleCount += NumTriangles;
+
     // Create package in Content Browser
     FString PackagePath = FString::Printf(TEXT("/Game/FloorPlanAssets/%s"), *MeshName);
     UPackage* Package = CreatePackage(*PackagePath);
     
     // Create static mesh
     UStaticMesh* StaticMesh = NewObject<UStaticMesh>(Package, *MeshName, RF_Public | RF_Standalone);
-    StaticMesh->GetStaticMaterials().Add(FStaticMaterial());
     
-    // Create mesh description
+    // Slots share the set's cached materials, so no mesh loads a material on its own
+    UFloorPlanMaterialSet* Materials = GetMaterialSet();
+
+    // Mesh description: shared vertices, one vertex instance per triangle corner, one polygon group per section
     FMeshDescription MeshDescription;
     FStaticMeshAttributes Attributes(MeshDescription);
     Attributes.Register();
-    
-    // Add vertices
-    for (int32 i = 0; i < Vertices.Num(); i++)
+
+    TVertexAttributesRef<FVector3f> VertexPositions = Attributes.GetVertexPositions();
+    TVertexInstanceAttributesRef<FVector3f> InstanceNormals = Attributes.GetVertexInstanceNormals();
+    TVertexInstanceAttributesRef<FVector2f> InstanceUVs = Attributes.GetVertexInstanceUVs();
+    TPolygonGroupAttributesRef<FName> SlotNames = Attributes.GetPolygonGroupMaterialSlotNames();
+
+    // UV1 comes pre-packed from the buffers when present, so lightmaps need no engine-side unwrap
+    const bool bHasLightmapUVs = Buffers.LightmapUVs.Num() == NumVertices;
+    InstanceUVs.SetNumChannels(bHasLightmapUVs ? 2 : 1);
+
+    MeshDescription.ReserveNewVertices(NumVertices);
+    MeshDescription.ReserveNewVertexInstances(static_cast<int32>(NumTriangles * 3));
+    MeshDescription.ReserveNewTriangles(static_cast<int32>(NumTriangles));
+    MeshDescription.ReserveNewPolygonGroups(Buffers.Sections.Num());
+
+    TArray<FVertexID> VertexIDs;
+    VertexIDs.SetNumUninitialized(NumVertices);
+    for (int32 Vertex = 0; Vertex < NumVertices; ++Vertex)
     {
-        MeshDescription.CreateVertex();
+        VertexIDs[Vertex] = MeshDescription.CreateVertex();
+        VertexPositions[VertexIDs[Vertex]] = Buffers.Positions[Vertex];
     }
-    
+
+    for (const FFloorPlanMeshSection& Section : Buffers.Sections)
+    {
+        if (Section.Indices.Num() < 3)
+        {
+            continue;
+        }
+
+        const FName SlotName(*Section.MaterialName);
+        const FPolygonGroupID Group = MeshDescription.CreatePolygonGroup();
+        SlotNames[Group] = SlotName;
+        StaticMesh->GetStaticMaterials().Add(FStaticMaterial(Materials->GetMaterial(SlotName), SlotName, SlotName));
+
+        for (int32 Index = 0; Index + 2 < Section.Indices.Num(); Index += 3)
+        {
+            FVertexInstanceID Corners[3];
+            for (int32 Corner = 0; Corner < 3; ++Corner)
+            {
+                const uint32 Vertex = Section.Indices[Index + Corner];
+                Corners[Corner] = MeshDescription.CreateVertexInstance(VertexIDs[Vertex]);
+                InstanceNormals[Corners[Corner]] = Buffers.Normals.IsValidIndex(Vertex) ? Buffers.Normals[Vertex] : FVector3f::UpVector;
+                InstanceUVs.Set(Corners[Corner], 0, Buffers.UVs.IsValidIndex(Vertex) ? Buffers.UVs[Vertex] : FVector2f::ZeroVector);
+                if (bHasLightmapUVs)
+                {
+                    InstanceUVs.Set(Corners[Corner], 1, Buffers.LightmapUVs[Vertex]);
+                }
+            }
+            MeshDescription.CreateTriangle(Group, MakeArrayView(Corners));
+        }
+    }
+
+    // LOD 0 carries the geometry; without Nanite, reduced LODs are generated from it
+    const int32 NumLODs = Settings.bNanite ? 1 : FMath::Clamp(Settings.NumLODs, 1, 8);
+    for (int32 LODIndex = 0; LODIndex < NumLODs; ++LODIndex)
+    {
+        FStaticMeshSourceModel& SourceModel = StaticMesh->AddSourceModel();
+        SourceModel.BuildSettings.bRecomputeNormals = false;
+        SourceModel.BuildSettings.bRecomputeTangents = true;
+        SourceModel.BuildSettings.bRemoveDegenerates = true;
+        SourceModel.BuildSettings.bGenerateLightmapUVs = !bHasLightmapUVs;
+        SourceModel.BuildSettings.SrcLightmapIndex = 0;
+        SourceModel.BuildSettings.DstLightmapIndex = 1;
+        SourceModel.BuildSettings.MinLightmapResolution = Settings.LightmapResolution;
+        // Half-precision UVs and 8-bit tangent frames; the buffers are welded, so most sections get 16-bit indices
+        SourceModel.BuildSettings.bUseFullPrecisionUVs = false;
+        SourceModel.BuildSettings.bUseHighPrecisionTangentBasis = false;
+        if (LODIndex > 0)
+        {
+            SourceModel.ReductionSettings.PercentTriangles = FMath::Pow(FMath::Clamp(Settings.LODReduction, 0.05f, 1.0f), static_cast<float>(LODIndex));
+            SourceModel.ScreenSize.Default = FMath::Pow(0.5f, static_cast<float>(LODIndex));
+        }
+    }
+    StaticMesh->SetLightMapCoordinateIndex(1);
+    StaticMesh->SetLightMapResolution(Settings.LightmapResolution);
+    StaticMesh->CreateMeshDescription(0, MoveTemp(MeshDescription));
+    StaticMesh->CommitMeshDescription(0);
+
+    // Nanite keeps full detail; the fallback serves ray tracing, collision and non-Nanite platforms
+    StaticMesh->NaniteSettings.bEnabled = Settings.bNanite;
+    StaticMesh->NaniteSettings.FallbackPercentTriangles = FMath::Clamp(Settings.NaniteFallbackPercentTriangles, 0.0f, 1.0f);
+    StaticMesh->NaniteSettings.FallbackRelativeError = FMath::Max(0.0f, Settings.NaniteFallbackRelativeError);
+
+    StaticMesh->Build(/*bInSilent=*/ true);
+    StaticMesh->PostEditChange();
+
     // Mark package dirty and register
     Package->MarkPackageDirty();
     FAssetRegistryModule::AssetCreated(StaticMesh);
     
-    UE_LOG(LogTemp, Warning, TEXT("✓ Created mesh asset: %s with %d vertices, %d triangles - saved to Content Browser"), 
-           *MeshName, Vertices.Num(), Triangles.Num() / 3);
+    UE_LOG(LogFloorPlan, Verbose, TEXT("MeshGenerator: Created mesh asset %s with %d vertices, %lld triangles, %s"), 
+           *MeshName, NumVertices, NumTriangles, Settings.bNanite ? TEXT("Nanite") : *FString::Printf(TEXT("%d LODs"), NumLODs));
     
     return StaticMesh;
 }
 
-// FWallSegment is now declared in header file
\ No newline at end of file
+// FWallSegment is now declared in header file
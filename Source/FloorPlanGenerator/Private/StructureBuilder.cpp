@@ -1,9 +1,17 @@
 #include "StructureBuilder.h"
+#include "FloorPlanLog.h"
 #include "FloorPlanAnalyzer.h"
 #include "MeshGenerator.h"
+#include "FloorPlanMeshBuffers.h"
+#include "FloorPlanGLBExporter.h"
+#include "FloorPlanParallel.h"
+#include "FloorPlanPolygonUnion.h"
+#include "FloorPlanSpatialIndex.h"
+#include "FloorPlanMaterialSet.h"
 #include "Engine/World.h"
 #include "Engine/StaticMeshActor.h"
 #include "Components/StaticMeshComponent.h"
+#include "Components/InstancedStaticMeshComponent.h"
 #include "Materials/MaterialInterface.h"
 #include "UObject/ConstructorHelpers.h"
 #include "Engine/Engine.h"
@@ -17,97 +25,463 @@ void UStructureBuilder::BuildStructure(UWorld* World, UFloorPlanAnalyzer* Analyz
 {
     if (!World || !Analyzer)
     {
-        UE_LOG(LogTemp, Error, TEXT("StructureBuilder: Invalid World or Analyzer"));
+        UE_LOG(LogFloorPlan, Error, TEXT("StructureBuilder: Invalid World or Analyzer"));
         return;
     }
 
-    // Create mesh generator if needed
-    if (!MeshGenerator)
+    // The reference keeps the snapshot alive for the whole build, whatever the analyzer does meanwhile
+    const FFloorPlanAnalysisResultRef Result = Analyzer->GetResult();
+    BuildStructure(World, *Result);
+}
+
+void UStructureBuilder::BuildStructure(UWorld* World, const FFloorPlanAnalysisResult& Result)
+{
+    if (!World)
     {
-        MeshGenerator = NewObject<UMeshGenerator>(this);
+        UE_LOG(LogFloorPlan, Error, TEXT("StructureBuilder: Invalid World"));
+        return;
     }
 
-    UE_LOG(LogTemp, Warning, TEXT("🏗️ StructureBuilder: Starting ACCURATE floor plan generation"));
+    UE_LOG(LogFloorPlan, Log, TEXT("StructureBuilder: Starting floor plan generation"));
+
+    GetMeshGenerator()->ResetProfile();
+    MeshGenerator->GetMaterialSet()->ResolveAll();
+    Profile = FFloorPlanProfile();
+    const uint64 StartCycles = FPlatformTime::Cycles64();
 
     // Generate meshes as assets in Content Browser (not level actors)
-    GenerateFloorPlanAssets(Analyzer);
+    if (bMergeBuilding)
+    {
+        FFloorPlanMeshBuffers Buffers;
+        BuildMeshBuffers(Result, Buffers);
+        MeshGenerator->CreateMergedMeshAssets(Buffers, TEXT("Building"));
+    }
+    else
+    {
+        GenerateFloorPlanAssets(Result);
+    }
+
+    AppendGeneratorProfile(StartCycles);
 
-    UE_LOG(LogTemp, Warning, TEXT("✅ StructureBuilder: Floor plan assets generated successfully!"));
+    UE_LOG(LogFloorPlan, Log, TEXT("StructureBuilder: Generated %d mesh assets (%lld vertices, %lld triangles) in %.1f ms"),
+           Profile.MeshCount, Profile.VertexCount, Profile.TriangleCount, Profile.TotalMs);
 }
 
-void UStructureBuilder::GenerateFloorPlanAssets(UFloorPlanAnalyzer* Analyzer)
+int32 UStructureBuilder::BuildTower(UWorld* World, const TArray<UFloorPlanAnalyzer*>& Storeys, float StoreyHeight)
 {
-    const TArray<FRoomData>& Rooms = Analyzer->GetRoomData();
-    const TArray<FOpeningData>& Openings = Analyzer->GetOpeningData();
+    if (Storeys.Contains(nullptr))
+    {
+        UE_LOG(LogFloorPlan, Error, TEXT("StructureBuilder: Invalid storey analyzers"));
+        return 0;
+    }
+
+    TArray<FFloorPlanAnalysisResultRef> Results;
+    Results.Reserve(Storeys.Num());
+    for (const UFloorPlanAnalyzer* Storey : Storeys)
+    {
+        Results.Add(Storey->GetResult());
+    }
+    return BuildTower(World, Results, StoreyHeight);
+}
+
+int32 UStructureBuilder::BuildTower(UWorld* World, const TArray<FFloorPlanAnalysisResultRef>& Storeys, float StoreyHeight)
+{
+    if (!World || Storeys.Num() == 0)
+    {
+        UE_LOG(LogFloorPlan, Error, TEXT("StructureBuilder: Invalid World or no storeys"));
+        return 0;
+    }
 
-    UE_LOG(LogTemp, Warning, TEXT("📐 Generating assets for %d rooms with %d openings"), Rooms.Num(), Openings.Num());
+    GetMeshGenerator()->ResetProfile();
+    MeshGenerator->GetMaterialSet()->ResolveAll();
+    Profile = FFloorPlanProfile();
+    const uint64 StartCycles = FPlatformTime::Cycles64();
+
+    // Floor slab below and ceiling slab above the walls, so stacked storeys never overlap
+    if (StoreyHeight <= 0.0f)
+    {
+        StoreyHeight = WallHeight + 20.0f + 15.0f;
+    }
 
-    // Generate floor and ceiling assets for each room
-    for (int32 RoomIndex = 0; RoomIndex < Rooms.Num(); ++RoomIndex)
+    // Each storey joins the first typical storey it repeats, otherwise it becomes a new typical storey
+    TArray<int32> Typicals;
+    TArray<TArray<int32>> Elevations;
+    for (int32 StoreyIndex = 0; StoreyIndex < Storeys.Num(); ++StoreyIndex)
     {
-        const FRoomData& Room = Rooms[RoomIndex];
-        
-        UE_LOG(LogTemp, Warning, TEXT("🏠 Processing room: %s (%.1f x %.1f cm)"), 
-               *Room.RoomName, Room.Dimensions.X, Room.Dimensions.Y);
+        int32 Group = INDEX_NONE;
+        for (int32 TypicalIndex = 0; TypicalIndex < Typicals.Num() && Group == INDEX_NONE; ++TypicalIndex)
+        {
+            if (IsSameStorey(*Storeys[Typicals[TypicalIndex]], *Storeys[StoreyIndex]))
+            {
+                Group = TypicalIndex;
+            }
+        }
+        if (Group == INDEX_NONE)
+        {
+            Group = Typicals.Add(StoreyIndex);
+            Elevations.AddDefaulted();
+        }
+        Elevations[Group].Add(StoreyIndex);
+    }
 
-        // Generate floor mesh asset (positioned at origin with unit scale)
-        UStaticMesh* FloorMesh = MeshGenerator->GenerateFloorMesh(Room.BoundaryPoints, 0.0f);
-        if (FloorMesh)
+    // One merged mesh set per typical storey, one instance per storey that repeats it
+    for (int32 Group = 0; Group < Typicals.Num(); ++Group)
+    {
+        FFloorPlanMeshBuffers Buffers;
+        BuildMeshBuffers(*Storeys[Typicals[Group]], Buffers);
+        const TArray<UStaticMesh*> Meshes = MeshGenerator->CreateMergedMeshAssets(Buffers, FString::Printf(TEXT("Storey_%02d"), Group + 1));
+
+        FActorSpawnParameters SpawnParameters;
+        SpawnParameters.Name = MakeUniqueObjectName(World->GetCurrentLevel(), AActor::StaticClass(), *FString::Printf(TEXT("FloorPlanStorey_%02d"), Group + 1));
+        AActor* StoreyActor = World->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity, SpawnParameters);
+        if (!StoreyActor)
         {
-            UE_LOG(LogTemp, Warning, TEXT("✅ Generated FLOOR asset for %s"), *Room.RoomName);
+            continue;
         }
 
-        // Generate ceiling mesh asset (positioned at origin with unit scale)
-        UStaticMesh* CeilingMesh = MeshGenerator->GenerateCeilingMesh(Room.BoundaryPoints, WallHeight);
-        if (CeilingMesh)
+        for (UStaticMesh* Mesh : Meshes)
         {
-            UE_LOG(LogTemp, Warning, TEXT("✅ Generated CEILING asset for %s"), *Room.RoomName);
+            UInstancedStaticMeshComponent* Instances = NewObject<UInstancedStaticMeshComponent>(StoreyActor);
+            Instances->SetStaticMesh(Mesh);
+            if (!StoreyActor->GetRootComponent())
+            {
+                StoreyActor->SetRootComponent(Instances);
+            }
+            else
+            {
+                Instances->SetupAttachment(StoreyActor->GetRootComponent());
+            }
+            StoreyActor->AddInstanceComponent(Instances);
+            Instances->RegisterComponent();
+
+            for (int32 StoreyIndex : Elevations[Group])
+            {
+                Instances->AddInstance(FTransform(FVector(0.0f, 0.0f, StoreyIndex * StoreyHeight)));
+            }
         }
+
+        UE_LOG(LogFloorPlan, Log, TEXT("StructureBuilder: Typical storey %d (analysis %d) used by %d storeys"),
+               Group + 1, Typicals[Group], Elevations[Group].Num());
     }
 
-    // Generate accurate wall layout based on floor plan
-    GenerateAccurateWallLayout(Analyzer);
+    AppendGeneratorProfile(StartCycles);
+
+    UE_LOG(LogFloorPlan, Log, TEXT("StructureBuilder: Built %d storeys from %d unique storey mesh sets (%d mesh assets) in %.1f ms"),
+           Storeys.Num(), Typicals.Num(), Profile.MeshCount, Profile.TotalMs);
+    return Typicals.Num();
 }
 
-void UStructureBuilder::GenerateAccurateWallLayout(UFloorPlanAnalyzer* Analyzer)
+FFloorPlanPortalGraph UStructureBuilder::BuildPortalGraph(UFloorPlanAnalyzer* Analyzer)
 {
-    UE_LOG(LogTemp, Warning, TEXT("🧱 Generating ACCURATE wall layout from floor plan"));
+    FFloorPlanPortalGraph Graph;
+    if (!Analyzer)
+    {
+        UE_LOG(LogFloorPlan, Error, TEXT("StructureBuilder: Invalid Analyzer"));
+        return Graph;
+    }
 
-    // Create wall layout based on your specific floor plan
-    TArray<FWallDefinition> WallDefinitions = CreateFloorPlanWallLayout();
+    Graph.Build(*Analyzer->GetResult(), WallThickness);
+    return Graph;
+}
+
+bool UStructureBuilder::IsSameStorey(const FFloorPlanAnalysisResult& Typical, const FFloorPlanAnalysisResult& Candidate) const
+{
+    if (&Typical == &Candidate)
+    {
+        return true;
+    }
 
-    // Generate wall mesh assets for each wall
-    for (int32 WallIndex = 0; WallIndex < WallDefinitions.Num(); ++WallIndex)
+    const TArray<FWallSegmentData>& Walls = Candidate.WallSegments;
+    const TArray<FOpeningData>& Openings = Candidate.Openings;
+    const TArray<FRoomData>& Rooms = Candidate.Rooms;
+    if (Walls.Num() != Typical.WallSegments.Num() || Openings.Num() != Typical.Openings.Num() || Rooms.Num() != Typical.Rooms.Num())
     {
-        const FWallDefinition& WallDef = WallDefinitions[WallIndex];
-        
-        UE_LOG(LogTemp, Warning, TEXT("🧱 Creating wall: %s (%.1f x %.1f cm) with %d openings"), 
-               *WallDef.WallName, WallDef.Length, WallHeight, WallDef.Openings.Num());
+        return false;
+    }
+
+    const FFloorPlanSpatialIndex& Index = Typical.GetSpatialIndex();
+    const double ToleranceSq = static_cast<double>(StoreyMatchTolerance) * StoreyMatchTolerance;
+    TArray<int32> Nearby;
+
+    // Walls match in either direction
+    for (const FWallSegmentData& Wall : Walls)
+    {
+        Index.FindWallsInRadius(Wall.Start, StoreyMatchTolerance, Nearby);
+        const bool bMatched = Nearby.ContainsByPredicate([&](int32 Other)
+        {
+            const FWallSegmentData& OtherWall = Typical.WallSegments[Other];
+            return (FVector2D::DistSquared(Wall.Start, OtherWall.Start) <= ToleranceSq && FVector2D::DistSquared(Wall.End, OtherWall.End) <= ToleranceSq) ||
+                   (FVector2D::DistSquared(Wall.Start, OtherWall.End) <= ToleranceSq && FVector2D::DistSquared(Wall.End, OtherWall.Start) <= ToleranceSq);
+        });
+        if (!bMatched)
+        {
+            return false;
+        }
+    }
+
+    for (const FOpeningData& Opening : Openings)
+    {
+        Index.FindOpeningsInRadius(Opening.Position, StoreyMatchTolerance, Nearby);
+        const bool bMatched = Nearby.ContainsByPredicate([&](int32 Other)
+        {
+            const FOpeningData& OtherOpening = Typical.Openings[Other];
+            return OtherOpening.bIsDoor == Opening.bIsDoor &&
+                   FVector2D::DistSquared(Opening.Position, OtherOpening.Position) <= ToleranceSq &&
+                   FMath::Abs(Opening.Size.X - OtherOpening.Size.X) <= StoreyMatchTolerance;
+        });
+        if (!bMatched)
+        {
+            return false;
+        }
+    }
+
+    // Rooms are compared by bounds, the room containing the candidate's center must have the same extent
+    for (const FRoomData& Room : Rooms)
+    {
+        const FBox2D Bounds = Room.BoundaryPoints.Num() > 0 ? FBox2D(Room.BoundaryPoints) : FBox2D(Room.Center - Room.Dimensions * 0.5, Room.Center + Room.Dimensions * 0.5);
+        const int32 Other = Index.FindRoomAt(Bounds.GetCenter());
+        if (Other == INDEX_NONE)
+        {
+            return false;
+        }
+
+        const FRoomData& OtherRoom = Typical.Rooms[Other];
+        const FBox2D OtherBounds = OtherRoom.BoundaryPoints.Num() > 0 ? FBox2D(OtherRoom.BoundaryPoints) : FBox2D(OtherRoom.Center - OtherRoom.Dimensions * 0.5, OtherRoom.Center + OtherRoom.Dimensions * 0.5);
+        if (FVector2D::DistSquared(Bounds.Min, OtherBounds.Min) > ToleranceSq || FVector2D::DistSquared(Bounds.Max, OtherBounds.Max) > ToleranceSq)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+UMeshGenerator* UStructureBuilder::GetMeshGenerator()
+{
+    if (!MeshGenerator)
+    {
+        MeshGenerator = NewObject<UMeshGenerator>(this);
+    }
+    return MeshGenerator;
+}
+
+void UStructureBuilder::GenerateFloorPlanAssets(const FFloorPlanAnalysisResult& Result)
+{
+    UE_LOG(LogFloorPlan, Log, TEXT("StructureBuilder: Generating assets for %d rooms with %d openings"),
+           Result.Rooms.Num(), Result.Openings.Num());
+
+    // Phase one: every floor, ceiling and wall is built on the workers
+    TArray<FFloorPlanMeshPiece> Pieces;
+    BuildMeshPieces(Result, CreateWallLayout(Result), /*bIncludeRooms=*/ true, Pieces, /*bPackLightmapUVs=*/ true);
+
+    // Phase two: UObject creation stays on the game thread, in one batch
+    check(IsInGameThread());
+    for (const FFloorPlanMeshPiece& Piece : Pieces)
+    {
+        if (MeshGenerator->CreateMeshAsset(Piece.Buffers, Piece.Name, Piece.Kind))
+        {
+            UE_LOG(LogFloorPlan, Verbose, TEXT("StructureBuilder: Generated asset %s"), *Piece.Name);
+        }
+    }
+}
+
+TArray<FWallDefinition> UStructureBuilder::CreateWallLayout(const FFloorPlanAnalysisResult& Result)
+{
+    // Use measured wall segments when the analysis produced them, otherwise the hand-authored layout
+    return Result.WallSegments.Num() > 0 ? CreateWallLayoutFromSegments(Result) : CreateFloorPlanWallLayout();
+}
+
+void UStructureBuilder::BuildMeshPieces(const FFloorPlanAnalysisResult& Result, const TArray<FWallDefinition>& WallDefinitions, bool bIncludeRooms,
+                                        TArray<FFloorPlanMeshPiece>& OutPieces, bool bPackLightmapUVs)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(UStructureBuilder::BuildMeshPieces);
+    FLOORPLAN_SCOPE_STAGE(STAT_FloorPlanMeshBuild, &Profile, MeshBuildMs);
+
+    const TArray<FRoomData>& Rooms = Result.Rooms;
+
+    // Settings are read up front so the workers never touch the generator
+    UMeshGenerator* Generator = GetMeshGenerator();
+    const int32 WallLightmapResolution = Generator->GetOutputSettings(EFloorPlanMeshKind::Wall).LightmapResolution;
+    const int32 FloorLightmapResolution = Generator->GetOutputSettings(EFloorPlanMeshKind::Floor).LightmapResolution;
+    const int32 CeilingLightmapResolution = Generator->GetOutputSettings(EFloorPlanMeshKind::Ceiling).LightmapResolution;
+
+    // Storey slabs cover the union of all rooms, grown by half the thickest wall so neighbours meet under it
+    TArray<FFloorPlanPolygon> SlabOutline;
+    if (bIncludeRooms && bStoreySlabs)
+    {
+        float MaxWallThickness = WallThickness;
+        for (const FWallSegmentData& Segment : Result.WallSegments)
+        {
+            MaxWallThickness = FMath::Max(MaxWallThickness, bOverrideMeasuredThickness ? WallThickness : Segment.Thickness);
+        }
 
-        // Generate wall mesh with proper openings
-        UStaticMesh* WallMesh = MeshGenerator->GenerateWallMesh(
-            FVector2D::ZeroVector, 
-            FVector2D(WallDef.Length, 0), 
-            WallHeight, 
-            WallThickness, 
-            WallDef.Openings, 
-            DoorHeight, 
-            WindowHeight
-        );
+        TArray<TArray<FVector2D>> Footprints;
+        for (const FRoomData& Room : Rooms)
+        {
+            Footprints.Add(Room.BoundaryPoints);
+        }
+        FFloorPlanPolygonUnion::Union(Footprints, MaxWallThickness * 0.5f, SlabOutline);
+    }
+
+    // Rooms first (floor, ceiling), then walls; each piece owns its output, so no locking is needed
+    const int32 NumRoomPieces = !bIncludeRooms ? 0 : (bStoreySlabs ? (SlabOutline.Num() > 0 ? 2 : 0) : Rooms.Num() * 2);
+    OutPieces.Reset();
+    OutPieces.SetNum(NumRoomPieces + WallDefinitions.Num());
+    TArray<FFloorPlanMeshOptimizeStats> PieceStats;
+    PieceStats.SetNum(OutPieces.Num());
 
-        if (WallMesh)
+    FFloorPlanParallel::For(OutPieces.Num(), [&](int32 PieceIndex)
+    {
+        FFloorPlanMeshPiece& Piece = OutPieces[PieceIndex];
+
+        // Per-task scratch, sized for the common box and wall cases
+        TArray<FVector> Vertices;
+        TArray<int32> Triangles;
+        TArray<FVector2D> UVs;
+        TArray<FVector> Normals;
+        Vertices.Reserve(96);
+        Triangles.Reserve(144);
+        UVs.Reserve(96);
+        Normals.Reserve(96);
+
+        int32 LightmapResolution = WallLightmapResolution;
+        if (PieceIndex < NumRoomPieces && bStoreySlabs)
         {
-            FString OpeningInfo = "";
-            for (const FOpeningData& Opening : WallDef.Openings)
+            // Slabs are built in plan coordinates, so only the ceiling is moved up
+            if (PieceIndex == 0)
+            {
+                UMeshGenerator::CreateSlabMesh(Vertices, Triangles, UVs, Normals, SlabOutline, -20.0f, 0.0f);
+                Piece.Name = TEXT("FloorSlab");
+                Piece.Kind = EFloorPlanMeshKind::Floor;
+                LightmapResolution = FloorLightmapResolution;
+            }
+            else
             {
-                FString OpeningType = Opening.bIsDoor ? TEXT("Door") : TEXT("Window");
-                float OpeningHeight = Opening.bIsDoor ? DoorHeight : WindowHeight;
-                OpeningInfo += FString::Printf(TEXT("%s(%.0fcm) "), *OpeningType, OpeningHeight);
+                UMeshGenerator::CreateSlabMesh(Vertices, Triangles, UVs, Normals, SlabOutline, 0.0f, 15.0f);
+                Piece.Name = TEXT("CeilingSlab");
+                Piece.Kind = EFloorPlanMeshKind::Ceiling;
+                Piece.Placement = FTransform(FVector(0.0f, 0.0f, WallHeight));
+                LightmapResolution = CeilingLightmapResolution;
             }
-            
-            UE_LOG(LogTemp, Warning, TEXT("✅ Generated WALL asset: %s - %s"), *WallDef.WallName, *OpeningInfo);
         }
+        else if (PieceIndex < NumRoomPieces)
+        {
+            // Floors and ceilings are built centered, so they are moved to the center of the room bounds
+            const FRoomData& Room = Rooms[PieceIndex / 2];
+            if (Room.BoundaryPoints.Num() < 3)
+            {
+                return;
+            }
+
+            const FBox2D RoomBounds(Room.BoundaryPoints);
+            const FVector2D Size = RoomBounds.GetSize();
+            const FVector Center(RoomBounds.GetCenter(), 0.0f);
+            if (PieceIndex % 2 == 0)
+            {
+                UMeshGenerator::CreateThickFloorMesh(Vertices, Triangles, UVs, Normals, Size.X, Size.Y, 20.0f);
+                Piece.Name = FString::Printf(TEXT("Floor_%.0f_x_%.0f"), Size.X, Size.Y);
+                Piece.Kind = EFloorPlanMeshKind::Floor;
+                Piece.Placement = FTransform(Center);
+                LightmapResolution = FloorLightmapResolution;
+            }
+            else
+            {
+                UMeshGenerator::CreateThickCeilingMesh(Vertices, Triangles, UVs, Normals, Size.X, Size.Y, 15.0f);
+                Piece.Name = FString::Printf(TEXT("Ceiling_%.0f_x_%.0f"), Size.X, Size.Y);
+                Piece.Kind = EFloorPlanMeshKind::Ceiling;
+                Piece.Placement = FTransform(Center + FVector(0.0f, 0.0f, WallHeight));
+                LightmapResolution = CeilingLightmapResolution;
+            }
+        }
+        else
+        {
+            // Walls are built along +X around their midpoint, hand-authored ones without plan positions stay at the origin
+            const FWallDefinition& WallDef = WallDefinitions[PieceIndex - NumRoomPieces];
+            const FVector2D End = WallDef.Start.Equals(WallDef.End) ? WallDef.Start + FVector2D(WallDef.Length, 0.0f) : WallDef.End;
+            const FVector2D Direction = (End - WallDef.Start).GetSafeNormal();
+            const float Thickness = WallDef.Thickness > 0.0f && !bOverrideMeasuredThickness ? WallDef.Thickness : WallThickness;
+
+            UMeshGenerator::CreateWallMeshWithOpenings(Vertices, Triangles, UVs, Normals, WallDef.Length, WallHeight, Thickness,
+                                                       WallDef.Openings, DoorHeight, WindowHeight);
+            Piece.Name = FString::Printf(TEXT("Wall_%.0f_x_%.0f"), WallDef.Length, WallHeight);
+            Piece.Kind = EFloorPlanMeshKind::Wall;
+            Piece.Placement = FTransform(FRotator(0.0f, FMath::RadiansToDegrees(FMath::Atan2(Direction.Y, Direction.X)), 0.0f),
+                                         FVector((WallDef.Start + End) * 0.5f, 0.0f));
+        }
+
+        Piece.Buffers.Append(Vertices, Triangles, UVs, Normals, Piece.Buffers.FindOrAddSection(UMeshGenerator::GetSlotName(Piece.Kind)), FTransform::Identity);
+        if (bPackLightmapUVs)
+        {
+            Piece.Buffers.PackLightmapUVs(LightmapResolution);
+        }
+        Piece.Buffers.Optimize(&PieceStats[PieceIndex]);
+    });
+
+    for (const FFloorPlanMeshOptimizeStats& Stats : PieceStats)
+    {
+        Profile.AddMeshOptimization(Stats);
+    }
+
+    // Rooms without a usable boundary leave empty pieces behind
+    OutPieces.RemoveAll([](const FFloorPlanMeshPiece& Piece) { return Piece.Buffers.GetNumVertices() == 0; });
+
+    UE_LOG(LogFloorPlan, Log, TEXT("StructureBuilder: Built %d mesh pieces (%d walls) on up to %d workers"),
+           OutPieces.Num(), WallDefinitions.Num(), FFloorPlanParallel::GetNumWorkers());
+}
+
+void UStructureBuilder::BuildMeshBuffers(const FFloorPlanAnalysisResult& Result, FFloorPlanMeshBuffers& OutBuffers)
+{
+    OutBuffers.Reset();
+
+    // Merged buffers are repacked per chunk, so per-piece lightmaps would be thrown away
+    TArray<FFloorPlanMeshPiece> Pieces;
+    BuildMeshPieces(Result, CreateWallLayout(Result), /*bIncludeRooms=*/ true, Pieces, /*bPackLightmapUVs=*/ false);
+
+    // Pieces are merged in build order, so the output does not depend on worker scheduling
+    FLOORPLAN_SCOPE_STAGE(STAT_FloorPlanMeshBuild, &Profile, MeshBuildMs);
+    OutBuffers.FindOrAddSection(UMeshGenerator::GetSlotName(EFloorPlanMeshKind::Wall));
+    OutBuffers.FindOrAddSection(UMeshGenerator::GetSlotName(EFloorPlanMeshKind::Floor));
+    OutBuffers.FindOrAddSection(UMeshGenerator::GetSlotName(EFloorPlanMeshKind::Ceiling));
+    for (const FFloorPlanMeshPiece& Piece : Pieces)
+    {
+        OutBuffers.Append(Piece.Buffers, Piece.Placement);
     }
+
+    // Pieces interleave their sections, one more pass welds across them and gives each section one vertex range
+    FFloorPlanMeshOptimizeStats Stats;
+    OutBuffers.Optimize(&Stats);
+    Profile.AddMeshOptimization(Stats);
+
+    Profile.MeshCount++;
+    Profile.VertexCount += OutBuffers.GetNumVertices();
+    Profile.TriangleCount += OutBuffers.GetNumTriangles();
+}
+
+bool UStructureBuilder::ExportGLB(UFloorPlanAnalyzer* Analyzer, const FString& FilePath, bool bQuantize)
+{
+    if (!Analyzer)
+    {
+        UE_LOG(LogFloorPlan, Error, TEXT("StructureBuilder: Invalid Analyzer"));
+        return false;
+    }
+
+    const FFloorPlanAnalysisResultRef Result = Analyzer->GetResult();
+    return ExportGLB(*Result, FilePath, bQuantize);
+}
+
+bool UStructureBuilder::ExportGLB(const FFloorPlanAnalysisResult& Result, const FString& FilePath, bool bQuantize)
+{
+    Profile = FFloorPlanProfile();
+    FFloorPlanStageTimer TotalTimer(&Profile.TotalMs);
+
+    FFloorPlanMeshBuffers Buffers;
+    BuildMeshBuffers(Result, Buffers);
+
+    FFloorPlanGLBSettings Settings;
+    Settings.bQuantize = bQuantize;
+    Settings.MaterialColors.Add(TEXT("Wall"), FLinearColor(0.9f, 0.9f, 0.88f));
+    Settings.MaterialColors.Add(TEXT("Floor"), FLinearColor(0.55f, 0.42f, 0.3f));
+    Settings.MaterialColors.Add(TEXT("Ceiling"), FLinearColor(0.95f, 0.95f, 0.95f));
+    return FFloorPlanGLBExporter::Write(Buffers, FilePath, Settings);
 }
 
 TArray<FWallDefinition> UStructureBuilder::CreateFloorPlanWallLayout()
@@ -192,32 +566,184 @@ TArray<FWallDefinition> UStructureBuilder::CreateFloorPlanWallLayout()
     ExteriorWall4.Length = 700.0f; // Right wall
     Walls.Add(ExteriorWall4);
 
-    UE_LOG(LogTemp, Warning, TEXT("📏 Created %d wall definitions for floor plan"), Walls.Num());
+    UE_LOG(LogFloorPlan, Log, TEXT("StructureBuilder: Created %d wall definitions for floor plan"), Walls.Num());
     return Walls;
 }
 
+TArray<FWallDefinition> UStructureBuilder::CreateWallLayoutFromSegments(const FFloorPlanAnalysisResult& Result)
+{
+    const TArray<FWallSegmentData>& Segments = Result.WallSegments;
+    TArray<FWallDefinition> Walls;
+    Walls.Reserve(Segments.Num());
+
+    for (const FWallSegmentData& Segment : Segments)
+    {
+        FWallDefinition Wall;
+        Wall.Start = Segment.Start;
+        Wall.End = Segment.End;
+        Wall.Length = FVector2D::Distance(Segment.Start, Segment.End);
+        Wall.Thickness = Segment.Thickness;
+        Walls.Add(Wall);
+    }
+
+    // Each opening goes into its nearest wall. Detected openings usually sit in the gap between two
+    // collinear segments, so the host is first bridged with the segment across the gap (or, without
+    // one, extended over the opening) until the opening lies inside it and gets its lintel and sill.
+    const FFloorPlanSpatialIndex& SpatialIndex = Result.GetSpatialIndex();
+    const TArray<FOpeningData>& Openings = Result.Openings;
+    TArray<int32> Hosts;
+    SpatialIndex.AssignOpeningsToWalls(OpeningSearchDistance, Hosts);
+
+    TArray<int32> MergedInto;
+    MergedInto.Init(INDEX_NONE, Walls.Num());
+    auto FindWall = [&MergedInto](int32 Wall)
+    {
+        while (MergedInto[Wall] != INDEX_NONE)
+        {
+            Wall = MergedInto[Wall];
+        }
+        return Wall;
+    };
+
+    int32 NumBridged = 0;
+    TArray<int32> Candidates;
+    for (int32 OpeningIndex = 0; OpeningIndex < Openings.Num(); ++OpeningIndex)
+    {
+        if (!Walls.IsValidIndex(Hosts[OpeningIndex]))
+        {
+            continue;
+        }
+
+        const int32 HostIndex = FindWall(Hosts[OpeningIndex]);
+        FWallDefinition& Host = Walls[HostIndex];
+        const FOpeningData& Opening = Openings[OpeningIndex];
+        const FVector2D Direction = (Host.End - Host.Start).GetSafeNormal();
+        const double HalfWidth = Opening.Size.X * 0.5;
+        const double Along = FVector2D::DotProduct(Opening.Position - Host.Start, Direction);
+        if (Along - HalfWidth >= 0.0 && Along + HalfWidth <= Host.Length)
+        {
+            continue;
+        }
+
+        // Nearest collinear segment on the far side of the opening
+        const bool bBeyondEnd = Along > Host.Length * 0.5;
+        int32 PartnerIndex = INDEX_NONE;
+        double PartnerGap = Opening.Size.X + OpeningSearchDistance;
+        double PartnerMin = 0.0;
+        double PartnerMax = 0.0;
+        SpatialIndex.FindWallsInRadius(Opening.Position, static_cast<float>(HalfWidth) + OpeningSearchDistance, Candidates);
+        for (const int32 Candidate : Candidates)
+        {
+            const int32 OtherIndex = FindWall(Candidate);
+            if (OtherIndex == HostIndex)
+            {
+                continue;
+            }
+
+            const FWallDefinition& Other = Walls[OtherIndex];
+            const double Tolerance = FMath::Max3(Host.Thickness, Other.Thickness, WallThickness);
+            const FVector2D ToStart = Other.Start - Host.Start;
+            const FVector2D ToEnd = Other.End - Host.Start;
+            if (FMath::Abs(FVector2D::CrossProduct(Direction, ToStart)) > Tolerance || FMath::Abs(FVector2D::CrossProduct(Direction, ToEnd)) > Tolerance)
+            {
+                continue;
+            }
+
+            const double OtherMin = FMath::Min(FVector2D::DotProduct(ToStart, Direction), FVector2D::DotProduct(ToEnd, Direction));
+            const double OtherMax = FMath::Max(FVector2D::DotProduct(ToStart, Direction), FVector2D::DotProduct(ToEnd, Direction));
+            const double Gap = bBeyondEnd ? OtherMin - Host.Length : -OtherMax;
+            if (Gap >= -Tolerance && Gap < PartnerGap)
+            {
+                PartnerIndex = OtherIndex;
+                PartnerGap = Gap;
+                PartnerMin = OtherMin;
+                PartnerMax = OtherMax;
+            }
+        }
+
+        double SpanMin = FMath::Min(0.0, Along - HalfWidth);
+        double SpanMax = FMath::Max(static_cast<double>(Host.Length), Along + HalfWidth);
+        if (PartnerIndex != INDEX_NONE)
+        {
+            SpanMin = FMath::Min(SpanMin, PartnerMin);
+            SpanMax = FMath::Max(SpanMax, PartnerMax);
+            Host.Thickness = FMath::Max(Host.Thickness, Walls[PartnerIndex].Thickness);
+            MergedInto[PartnerIndex] = HostIndex;
+            ++NumBridged;
+        }
+
+        const FVector2D Origin = Host.Start;
+        Host.Start = Origin + Direction * SpanMin;
+        Host.End = Origin + Direction * SpanMax;
+        Host.Length = static_cast<float>(SpanMax - SpanMin);
+    }
+
+    // Positioned by the distance along the wall from Start, which now always covers the opening
+    int32 NumHosted = 0;
+    for (int32 OpeningIndex = 0; OpeningIndex < Openings.Num(); ++OpeningIndex)
+    {
+        if (!Walls.IsValidIndex(Hosts[OpeningIndex]))
+        {
+            continue;
+        }
+
+        FWallDefinition& Wall = Walls[FindWall(Hosts[OpeningIndex])];
+        const FVector2D Direction = (Wall.End - Wall.Start).GetSafeNormal();
+        FOpeningData Opening = Openings[OpeningIndex];
+        Opening.Position = FVector2D(FVector2D::DotProduct(Opening.Position - Wall.Start, Direction), 0.0);
+        Wall.Openings.Add(Opening);
+        ++NumHosted;
+    }
+
+    TArray<FWallDefinition> Layout;
+    Layout.Reserve(Walls.Num() - NumBridged);
+    for (int32 WallIndex = 0; WallIndex < Walls.Num(); ++WallIndex)
+    {
+        if (MergedInto[WallIndex] == INDEX_NONE)
+        {
+            FWallDefinition& Wall = Layout.Add_GetRef(MoveTemp(Walls[WallIndex]));
+            Wall.WallName = FString::Printf(TEXT("Wall_%d"), Layout.Num());
+        }
+    }
+
+    UE_LOG(LogFloorPlan, Log, TEXT("StructureBuilder: Created %d wall definitions from %d measured segments (%d bridged across openings), %d of %d openings placed"),
+           Layout.Num(), Segments.Num(), NumBridged, NumHosted, Openings.Num());
+    return Layout;
+}
+
+void UStructureBuilder::AppendGeneratorProfile(uint64 StartCycles)
+{
+    // The builder times buffer building and records mesh optimization, the generator times asset creation
+    // and counts the assets. Buffers the builder counted end up as those assets, so its counts are dropped.
+    Profile.MeshCount = 0;
+    Profile.VertexCount = 0;
+    Profile.TriangleCount = 0;
+    Profile.Append(MeshGenerator->GetProfile());
+    Profile.TotalMs = static_cast<float>(FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles));
+}
+
 void UStructureBuilder::BuildFloors(UWorld* World, UFloorPlanAnalyzer* Analyzer)
 {
     // This function is now handled by GenerateFloorPlanAssets
-    UE_LOG(LogTemp, Log, TEXT("Floor generation handled by asset generation"));
+    UE_LOG(LogFloorPlan, Log, TEXT("Floor generation handled by asset generation"));
 }
 
 void UStructureBuilder::BuildWalls(UWorld* World, UFloorPlanAnalyzer* Analyzer)
 {
-    // This function is now handled by GenerateAccurateWallLayout
-    UE_LOG(LogTemp, Log, TEXT("Wall generation handled by accurate layout system"));
+    // This function is now handled by GenerateFloorPlanAssets
+    UE_LOG(LogFloorPlan, Log, TEXT("Wall generation handled by accurate layout system"));
 }
 
 void UStructureBuilder::BuildCeilings(UWorld* World, UFloorPlanAnalyzer* Analyzer)
 {
     // This function is now handled by GenerateFloorPlanAssets
-    UE_LOG(LogTemp, Log, TEXT("Ceiling generation handled by asset generation"));
+    UE_LOG(LogFloorPlan, Log, TEXT("Ceiling generation handled by asset generation"));
 }
 
 void UStructureBuilder::CreateOpenings(UWorld* World, UFloorPlanAnalyzer* Analyzer)
 {
     // Openings are now integrated into wall mesh generation
-    UE_LOG(LogTemp, Log, TEXT("Openings integrated into procedural wall meshes"));
+    UE_LOG(LogFloorPlan, Log, TEXT("Openings integrated into procedural wall meshes"));
 }
 
 AActor* UStructureBuilder::CreateMeshActor(UWorld* World, const FString& Name)
@@ -225,18 +751,3 @@ AActor* UStructureBuilder::CreateMeshActor(UWorld* World, const FString& Name)
     // Not used in new asset-based system
     return nullptr;
 }
-
-void UStructureBuilder::ApplyMaterial(UStaticMeshComponent* MeshComponent, const FString& MaterialPath)
-{
-    // Materials will be applied to generated assets
-    if (!MeshComponent)
-    {
-        return;
-    }
-
-    UMaterialInterface* Material = LoadObject<UMaterialInterface>(nullptr, *MaterialPath);
-    if (Material)
-    {
-        MeshComponent->SetMaterial(0, Material);
-    }
-}
\ No newline at end of file
@@ -0,0 +1,59 @@
+#include "Misc/AutomationTest.h"
+#include "FloorPlanPortalGraph.h"
+#include "FloorPlanAnalyzer.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFloorPlanPortalGraphGapDoorTest, "FloorPlanGenerator.PortalGraph.GapDoor",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FFloorPlanPortalGraphGapDoorTest::RunTest(const FString& Parameters)
+{
+    // Two rooms side by side, the wall between them broken by a 90 cm door gap from y = 150 to y = 240
+    FFloorPlanAnalysisResult Result;
+    FRoomData& West = Result.Rooms.AddDefaulted_GetRef();
+    West.RoomName = TEXT("KITCHEN");
+    West.BoundaryPoints = { FVector2D(0.0, 0.0), FVector2D(400.0, 0.0), FVector2D(400.0, 400.0), FVector2D(0.0, 400.0) };
+    West.Center = FVector2D(200.0, 200.0);
+    West.Dimensions = FVector2D(400.0, 400.0);
+    FRoomData& East = Result.Rooms.AddDefaulted_GetRef();
+    East.RoomName = TEXT("LIVING");
+    East.BoundaryPoints = { FVector2D(410.0, 0.0), FVector2D(800.0, 0.0), FVector2D(800.0, 400.0), FVector2D(410.0, 400.0) };
+    East.Center = FVector2D(605.0, 200.0);
+    East.Dimensions = FVector2D(390.0, 400.0);
+
+    FWallSegmentData& Lower = Result.WallSegments.AddDefaulted_GetRef();
+    Lower.Start = FVector2D(405.0, 0.0);
+    Lower.End = FVector2D(405.0, 150.0);
+    Lower.Thickness = 10.0f;
+    FWallSegmentData& Upper = Result.WallSegments.AddDefaulted_GetRef();
+    Upper.Start = FVector2D(405.0, 240.0);
+    Upper.End = FVector2D(405.0, 400.0);
+    Upper.Thickness = 10.0f;
+
+    FOpeningData& Door = Result.Openings.AddDefaulted_GetRef();
+    Door.bIsDoor = true;
+    Door.Position = FVector2D(405.0, 195.0);
+    Door.Size = FVector2D(90.0, 10.0);
+    Door.Rotation = 90.0f;
+
+    FFloorPlanPortalGraph Graph;
+    Graph.Build(Result, 10.0f);
+    if (!TestEqual(TEXT("The gap door becomes one portal"), Graph.Portals.Num(), 1))
+    {
+        return false;
+    }
+
+    // The portal covers the gap exactly, whichever way the host wall runs
+    const FFloorPlanPortal& Portal = Graph.Portals[0];
+    const double Low = FMath::Min(Portal.Start.Y, Portal.End.Y);
+    const double High = FMath::Max(Portal.Start.Y, Portal.End.Y);
+    TestEqual(TEXT("Portal lies on the wall line"), Portal.Start.X, 405.0, 0.01);
+    TestEqual(TEXT("Portal lies on the wall line"), Portal.End.X, 405.0, 0.01);
+    TestEqual(TEXT("Portal starts at the gap edge"), Low, 150.0, 0.01);
+    TestEqual(TEXT("Portal ends at the gap edge"), High, 240.0, 0.01);
+    TestTrue(TEXT("Portal joins both rooms"), (Portal.CellA == 0 && Portal.CellB == 1) || (Portal.CellA == 1 && Portal.CellB == 0));
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
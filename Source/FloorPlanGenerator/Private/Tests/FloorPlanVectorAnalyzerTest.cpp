@@ -0,0 +1,56 @@
+#include "Misc/AutomationTest.h"
+#include "FloorPlanVectorAnalyzer.h"
+#include "FloorPlanVectorScene.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFloorPlanVectorAnalyzerPassageTest, "FloorPlanGenerator.VectorAnalyzer.LabelledRoomsWithPassage",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FFloorPlanVectorAnalyzerPassageTest::RunTest(const FString& Parameters)
+{
+    // Two labelled rooms inside a 10 cm walled box, the wall between them (x = 400..410) broken by a
+    // 90 cm passage from y = 150 to y = 240 with no door arc
+    FFloorPlanVectorScene Scene;
+    const int32 Layer = Scene.FindOrAddLayer(TEXT("WALLS"));
+    Scene.AddLine(FVector2D(0.0, 0.0), FVector2D(810.0, 0.0), Layer);
+    Scene.AddLine(FVector2D(10.0, 10.0), FVector2D(800.0, 10.0), Layer);
+    Scene.AddLine(FVector2D(10.0, 390.0), FVector2D(800.0, 390.0), Layer);
+    Scene.AddLine(FVector2D(0.0, 400.0), FVector2D(810.0, 400.0), Layer);
+    Scene.AddLine(FVector2D(0.0, 0.0), FVector2D(0.0, 400.0), Layer);
+    Scene.AddLine(FVector2D(10.0, 10.0), FVector2D(10.0, 390.0), Layer);
+    Scene.AddLine(FVector2D(800.0, 10.0), FVector2D(800.0, 390.0), Layer);
+    Scene.AddLine(FVector2D(810.0, 0.0), FVector2D(810.0, 400.0), Layer);
+    for (const double X : { 400.0, 410.0 })
+    {
+        Scene.AddLine(FVector2D(X, 10.0), FVector2D(X, 150.0), Layer);
+        Scene.AddLine(FVector2D(X, 240.0), FVector2D(X, 390.0), Layer);
+    }
+    Scene.AddText(FVector2D(200.0, 200.0), 20.0f, TEXT("KITCHEN"), Layer);
+    Scene.AddText(FVector2D(605.0, 200.0), 20.0f, TEXT("LIVING"), Layer);
+
+    FFloorPlanVectorAnalyzer Analyzer(Scene, FFloorPlanVectorSettings());
+    Analyzer.Run();
+
+    TArray<FWallSegmentData> Walls;
+    TArray<FOpeningData> Openings;
+    TArray<FRoomData> Rooms;
+    TArray<TArray<FString>> RoomLines;
+    Analyzer.MoveResults(Walls, Openings, Rooms, RoomLines);
+
+    TestEqual(TEXT("The passage is not reported as an opening"), Openings.Num(), 0);
+    if (!TestEqual(TEXT("Each label seeds its own room"), Rooms.Num(), 2))
+    {
+        return false;
+    }
+
+    const FBox2D Kitchen(Rooms[0].BoundaryPoints);
+    const FBox2D Living(Rooms[1].BoundaryPoints);
+    TestEqual(TEXT("Kitchen stops at the passage"), Kitchen.Max.X, 400.0, 0.5);
+    TestEqual(TEXT("Living room starts at the passage"), Living.Min.X, 410.0, 0.5);
+    TestTrue(TEXT("Kitchen keeps its label"), RoomLines[0].Contains(TEXT("KITCHEN")));
+    TestTrue(TEXT("Living room keeps its label"), RoomLines[1].Contains(TEXT("LIVING")));
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,115 @@
+#include "Misc/AutomationTest.h"
+#include "StructureBuilder.h"
+#include "MeshGenerator.h"
+#include "FloorPlanAnalyzer.h"
+#include "Engine/World.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStructureBuilderGapOpeningTest, "FloorPlanGenerator.StructureBuilder.GapOpening",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FStructureBuilderGapOpeningTest::RunTest(const FString& Parameters)
+{
+    // Wall, 90 cm door gap, wall: the two segments end at the gap edges like detected ones do
+    FFloorPlanAnalysisResult Result;
+    FWallSegmentData& Left = Result.WallSegments.AddDefaulted_GetRef();
+    Left.Start = FVector2D(0.0, 0.0);
+    Left.End = FVector2D(300.0, 0.0);
+    Left.Thickness = 10.0f;
+    FWallSegmentData& Right = Result.WallSegments.AddDefaulted_GetRef();
+    Right.Start = FVector2D(390.0, 0.0);
+    Right.End = FVector2D(700.0, 0.0);
+    Right.Thickness = 10.0f;
+    FOpeningData& Door = Result.Openings.AddDefaulted_GetRef();
+    Door.bIsDoor = true;
+    Door.Position = FVector2D(345.0, 0.0);
+    Door.Size = FVector2D(90.0, 10.0);
+
+    UStructureBuilder* Builder = NewObject<UStructureBuilder>();
+    const TArray<FWallDefinition> Walls = Builder->CreateWallLayout(Result);
+    if (!TestEqual(TEXT("Segments across the gap form one wall"), Walls.Num(), 1))
+    {
+        return false;
+    }
+
+    const FWallDefinition& Wall = Walls[0];
+    TestEqual(TEXT("Wall length spans both segments and the gap"), Wall.Length, 700.0f, 0.01f);
+    if (!TestEqual(TEXT("Door is hosted"), Wall.Openings.Num(), 1))
+    {
+        return false;
+    }
+    TestEqual(TEXT("Door center keeps its position"), Wall.Openings[0].Position.X, 345.0, 0.01);
+
+    const float WallHeight = 300.0f;
+    const float DoorHeight = 244.0f;
+    TArray<FVector> Vertices;
+    TArray<int32> Triangles;
+    TArray<FVector2D> UVs;
+    TArray<FVector> Normals;
+    UMeshGenerator::CreateWallMeshWithOpenings(Vertices, Triangles, UVs, Normals, Wall.Length, WallHeight, Wall.Thickness, Wall.Openings, DoorHeight, 152.0f);
+
+    // Local X runs from -350 to 350, the gap from -50 to 40
+    double SolidLeftEnd = -TNumericLimits<double>::Max();
+    double SolidRightStart = TNumericLimits<double>::Max();
+    bool bHoleBelowLintel = true;
+    bool bHasLintel = false;
+    for (const FVector& Vertex : Vertices)
+    {
+        const bool bInGap = Vertex.X > -50.0 + KINDA_SMALL_NUMBER && Vertex.X < 40.0 - KINDA_SMALL_NUMBER;
+        if (Vertex.Z < DoorHeight - KINDA_SMALL_NUMBER)
+        {
+            bHoleBelowLintel &= !bInGap;
+            SolidLeftEnd = Vertex.X <= -50.0 + KINDA_SMALL_NUMBER ? FMath::Max(SolidLeftEnd, Vertex.X) : SolidLeftEnd;
+            SolidRightStart = Vertex.X >= 40.0 - KINDA_SMALL_NUMBER ? FMath::Min(SolidRightStart, Vertex.X) : SolidRightStart;
+        }
+        else if (Vertex.X >= -50.0 - KINDA_SMALL_NUMBER && Vertex.X <= 40.0 + KINDA_SMALL_NUMBER && FMath::IsNearlyEqual(Vertex.Z, static_cast<double>(DoorHeight), 0.01))
+        {
+            bHasLintel = true;
+        }
+    }
+
+    TestEqual(TEXT("Left wall stays solid up to the gap"), SolidLeftEnd, -50.0, 0.01);
+    TestEqual(TEXT("Right wall stays solid from the gap"), SolidRightStart, 40.0, 0.01);
+    TestTrue(TEXT("Gap is open below the door height"), bHoleBelowLintel);
+    TestTrue(TEXT("Gap has a lintel above the door"), bHasLintel);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStructureBuilderProfileTest, "FloorPlanGenerator.StructureBuilder.Profile",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FStructureBuilderProfileTest::RunTest(const FString& Parameters)
+{
+    FFloorPlanAnalysisResult Result;
+    const FVector2D Corners[] = { FVector2D(0.0, 0.0), FVector2D(400.0, 0.0), FVector2D(400.0, 300.0), FVector2D(0.0, 300.0) };
+    for (int32 Corner = 0; Corner < 4; ++Corner)
+    {
+        FWallSegmentData& Wall = Result.WallSegments.AddDefaulted_GetRef();
+        Wall.Start = Corners[Corner];
+        Wall.End = Corners[(Corner + 1) % 4];
+        Wall.Thickness = 10.0f;
+    }
+    FRoomData& Room = Result.Rooms.AddDefaulted_GetRef();
+    Room.RoomName = TEXT("LIVING");
+    Room.BoundaryPoints = { Corners[0], Corners[1], Corners[2], Corners[3] };
+    Room.Center = FVector2D(200.0, 150.0);
+    Room.Dimensions = FVector2D(400.0, 300.0);
+
+    UWorld* World = UWorld::CreateWorld(EWorldType::Inactive, false);
+    UStructureBuilder* Builder = NewObject<UStructureBuilder>();
+    Builder->SetMergeBuilding(false);
+    Builder->BuildStructure(World, Result);
+    const FFloorPlanProfile Profile = Builder->GetProfile();
+    World->DestroyWorld(false);
+
+    // One asset per wall, floor and ceiling; the per-piece optimization must survive asset creation
+    TestEqual(TEXT("Mesh count is the number of created assets"), Profile.MeshCount, 6);
+    TestTrue(TEXT("Optimized triangles are recorded"), Profile.OptimizedTriangleCount > 0);
+    TestTrue(TEXT("Weld statistics are recorded"), Profile.UnweldedVertexCount > 0 && Profile.WeldedVertexCount > 0);
+    TestTrue(TEXT("ACMR statistics are recorded"), Profile.CacheMissesBefore > 0 && Profile.CacheMissesAfter > 0);
+    TestTrue(TEXT("Index buffer statistics are recorded"), Profile.IndexBytesBefore > 0);
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/Future.h"
+#include "Containers/Queue.h"
+#include <atomic>
+
+class FSocket;
+class FTcpListener;
+class UFloorPlanAnalyzer;
+struct FIPv4Endpoint;
+
+// Submits analysis jobs to a FFloorPlanAnalysisServer on this machine. The server reads the plan itself,
+// so only the path, the scale and the analyzer settings travel; the reply is the serialized results.
+class FLOORPLANGENERATOR_API FFloorPlanAnalysisClient
+{
+public:
+    // Blocks until the server replies or the timeout passes; false when it is unreachable or the analysis failed
+    static bool Submit(const FString& Address, const FString& FilePath, float ScaleFactor, const TArray<uint8>& Settings,
+                       float TimeoutSeconds, TArray<uint8>& OutResults, bool& bOutCacheHit);
+};
+
+// Out-of-process analysis service shared by every editor on the machine (-run=FloorPlanServer). Results
+// are cached by file path, size, timestamp and analyzer settings, so a plan is analyzed once no matter how
+// many sessions ask for it; identical requests that arrive while it is running wait for the same job.
+// Connections are served on pool threads, analyses run one at a time in Tick on the game thread with one
+// warm analyzer, each already parallel inside.
+class FLOORPLANGENERATOR_API FFloorPlanAnalysisServer
+{
+public:
+    static constexpr uint16 DefaultPort = 7878;
+
+    ~FFloorPlanAnalysisServer();
+
+    // Address is "ip:port", normally 127.0.0.1 so only local editors can connect
+    bool Start(const FString& Address, int64 InMaxCacheBytes);
+    void Stop();
+
+    // Runs the queued analyses, returns how many were run
+    int32 Tick();
+
+    int32 GetNumCached() const;
+    int64 GetNumHits() const;
+    int64 GetNumMisses() const;
+
+private:
+    struct FJob
+    {
+        FString Key;
+        FString FilePath;
+        float ScaleFactor = 1.0f;
+        TArray<uint8> Settings;
+
+        // Written once before Done is set, read-only afterwards
+        TArray<uint8> Results;
+        bool bSucceeded = false;
+        double LastUsedSeconds = 0.0;
+
+        TPromise<void> Promise;
+        TSharedFuture<void> Done;
+    };
+
+    bool HandleConnectionAccepted(FSocket* Socket, const FIPv4Endpoint& Endpoint);
+    void ServeConnection(FSocket* Socket);
+    TSharedPtr<FJob> FindOrQueueJob(const FString& FilePath, float ScaleFactor, TArray<uint8>&& Settings, bool& bOutCacheHit);
+    void EvictToBudget();
+
+    TUniquePtr<FTcpListener> Listener;
+    UFloorPlanAnalyzer* Analyzer = nullptr;
+    int64 MaxCacheBytes = 0;
+
+    // Guards Jobs, CachedBytes and the counters
+    mutable FCriticalSection JobsLock;
+    TMap<FString, TSharedPtr<FJob>> Jobs;
+    int64 CachedBytes = 0;
+    int64 NumHits = 0;
+    int64 NumMisses = 0;
+
+    TQueue<TSharedPtr<FJob>, EQueueMode::Mpsc> PendingJobs;
+    std::atomic<int32> NumActiveConnections { 0 };
+    std::atomic<bool> bStopping { false };
+};
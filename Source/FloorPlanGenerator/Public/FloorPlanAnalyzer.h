@@ -3,8 +3,39 @@
 #include "CoreMinimal.h"
 #include "UObject/NoExportTypes.h"
 #include "Engine/Texture2D.h"
+#include "HAL/CriticalSection.h"
+#include "FloorPlanProfile.h"
+#include "FloorPlanPreprocessor.h"
 #include "FloorPlanAnalyzer.generated.h"
 
+class FFloorPlanStripReader;
+struct FFloorPlanMask;
+struct FFloorPlanVectorScene;
+class FFloorPlanSpatialIndex;
+
+UENUM(BlueprintType)
+enum class EFloorPlanAnalysisMode : uint8
+{
+    // Built-in sample layout, the image only provides its dimensions
+    Sample,
+    // Out-of-core analysis over horizontal strips, memory proportional to image width
+    Streaming,
+    // Coarse detection on a downsampled mip, full resolution only in boundary bands and opening candidates
+    Pyramid,
+    // Pyramid when it fits the memory budget, otherwise a cheaper pyramid or streaming strips
+    Auto
+};
+
+// Raster strategy chosen for one image under the memory budget
+struct FFloorPlanRasterPlan
+{
+    EFloorPlanAnalysisMode Mode = EFloorPlanAnalysisMode::Pyramid;
+    int32 StripRows = 256;
+    int32 CoarseLevel = 3;
+    bool bMeasureWallThickness = true;
+    int64 EstimatedBytes = 0;
+};
+
 USTRUCT(BlueprintType)
 struct FLOORPLANGENERATOR_API FRoomData
 {
@@ -56,6 +87,62 @@ struct FLOORPLANGENERATOR_API FOpeningData
     }
 };
 
+USTRUCT(BlueprintType)
+struct FLOORPLANGENERATOR_API FWallSegmentData
+{
+    GENERATED_BODY()
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    FVector2D Start;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    FVector2D End;
+
+    // Measured wall thickness in world units
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    float Thickness;
+
+    FWallSegmentData()
+    {
+        Start = FVector2D::ZeroVector;
+        End = FVector2D::ZeroVector;
+        Thickness = 0.0f;
+    }
+};
+
+// Results of one analysis, published by the analyzer once complete and never modified afterwards. The
+// analyzer only swaps its reference on the next run, so any number of builders and exporters on any
+// thread can keep reading a snapshot, without copies, while the analyzer moves on to the next plan.
+struct FLOORPLANGENERATOR_API FFloorPlanAnalysisResult
+{
+    FFloorPlanAnalysisResult();
+    ~FFloorPlanAnalysisResult();
+
+    TArray<FRoomData> Rooms;
+    TArray<FOpeningData> Openings;
+    TArray<FVector2D> WallPoints;
+    TArray<FWallSegmentData> WallSegments;
+    FVector2D ImageDimensions = FVector2D::ZeroVector;
+
+    // Scale factor derived from recognized dimension strings, 0 when the plan could not be calibrated
+    float CalibratedScaleFactor = 0.0f;
+
+    // Spatial index over the results, built by the first caller; concurrent callers wait for it
+    const FFloorPlanSpatialIndex& GetSpatialIndex() const;
+
+    // Analysis server wire format, both directions through one archive
+    void Serialize(FArchive& Ar);
+
+    // Shared result without any elements, held by analyzers before their first analysis
+    static TSharedRef<const FFloorPlanAnalysisResult, ESPMode::ThreadSafe> GetEmpty();
+
+private:
+    mutable FCriticalSection SpatialIndexLock;
+    mutable TUniquePtr<FFloorPlanSpatialIndex> SpatialIndex;
+};
+
+using FFloorPlanAnalysisResultRef = TSharedRef<const FFloorPlanAnalysisResult, ESPMode::ThreadSafe>;
+
 UCLASS(BlueprintType)
 class FLOORPLANGENERATOR_API UFloorPlanAnalyzer : public UObject
 {
@@ -68,22 +155,197 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Floor Plan Analysis")
     bool AnalyzeFloorPlan(UTexture2D* FloorPlanImage, float ScaleFactor);
 
-    // Getters for analyzed data
+    // Reads a PNG/TIFF file from disk without importing it as a texture (streaming or pyramid mode), DXF/SVG/PDF files go to AnalyzeFloorPlanVectorFile.
+    // With an analysis server set the file is analyzed (or served from cache) there, and here when it cannot be reached.
+    UFUNCTION(BlueprintCallable, Category = "Floor Plan Analysis")
+    bool AnalyzeFloorPlanFile(const FString& FilePath, float ScaleFactor);
+
+    // Local analysis server (-run=FloorPlanServer) for AnalyzeFloorPlanFile, as "ip:port"; empty analyzes in-process only
+    UFUNCTION(BlueprintCallable, Category = "Floor Plan Analysis")
+    void SetAnalysisServer(const FString& Address, float TimeoutSeconds = 600.0f);
+
+    // Reads walls, openings and rooms straight from DXF geometry, no raster stage.
+    // ScaleFactor only applies when the file has no $INSUNITS, as centimeters per drawing unit times 10.
+    UFUNCTION(BlueprintCallable, Category = "Floor Plan Analysis")
+    bool AnalyzeFloorPlanDXF(const FString& FilePath, float ScaleFactor);
+
+    // Vector input by extension: DXF, SVG or vector PDF (first page). SVG and PDF coordinates are paper units,
+    // so ScaleFactor seeds the scale the same way and the plan is always calibrated from its dimension labels.
+    UFUNCTION(BlueprintCallable, Category = "Floor Plan Analysis")
+    bool AnalyzeFloorPlanVectorFile(const FString& FilePath, float ScaleFactor);
+
+    // Analyzes rows from any strip reader (files, textures, generated plans) in streaming or pyramid mode
+    bool AnalyzeFloorPlanReader(FFloorPlanStripReader& Reader, float ScaleFactor);
+
+    // Analysis settings
+    UFUNCTION(BlueprintCallable, Category = "Floor Plan Analysis")
+    void SetAnalysisMode(EFloorPlanAnalysisMode Mode) { AnalysisMode = Mode; }
+
+    // Working set limit for raster analysis in bytes, 0 for none. Modes that would exceed it degrade:
+    // pyramid without wall thickness measurement, then streaming with fewer rows per strip.
+    UFUNCTION(BlueprintCallable, Category = "Floor Plan Analysis")
+    void SetMemoryBudget(int64 Bytes) { MemoryBudgetBytes = FMath::Max<int64>(0, Bytes); }
+
+    UFUNCTION(BlueprintCallable, Category = "Floor Plan Analysis")
+    void SetStreamingStripRows(int32 Rows) { StreamingStripRows = FMath::Max(1, Rows); }
+
+    UFUNCTION(BlueprintCallable, Category = "Floor Plan Analysis")
+    void SetPyramidCoarseLevel(int32 Level) { PyramidCoarseLevel = FMath::Clamp(Level, 1, 8); }
+
+    // Measures per-segment wall thickness with a distance transform (pyramid mode)
+    UFUNCTION(BlueprintCallable, Category = "Floor Plan Analysis")
+    void SetMeasureWallThickness(bool bMeasure) { bMeasureWallThickness = bMeasure; }
+
+    // Scan cleanup before pyramid analysis: local thresholds for uneven lighting, speck removal and wall
+    // gap bridging with a square element of the given radius (0 = off), and rotation of slightly skewed scans
+    UFUNCTION(BlueprintCallable, Category = "Floor Plan Analysis")
+    void SetThresholdMethod(EFloorPlanThresholdMethod Method) { PreprocessSettings.Method = Method; }
+
+    UFUNCTION(BlueprintCallable, Category = "Floor Plan Analysis")
+    void SetMorphologyRadii(int32 OpenRadius, int32 CloseRadius);
+
+    UFUNCTION(BlueprintCallable, Category = "Floor Plan Analysis")
+    void SetDeskew(bool bDeskew, float MaxSkewDegrees = 5.0f);
+
+    // Reads room labels and dimension strings inside each room and calibrates the scale from them (pyramid mode)
+    UFUNCTION(BlueprintCallable, Category = "Floor Plan Analysis")
+    void SetRecognizeText(bool bRecognize) { bRecognizeText = bRecognize; }
+
+    // Wildcard layer patterns for vector input, e.g. Include {"A-WALL*", "A-DOOR*"} or Exclude {"*DIM*", "*FURN*"}
+    UFUNCTION(BlueprintCallable, Category = "Floor Plan Analysis")
+    void SetVectorLayerFilter(const TArray<FString>& IncludeLayers, const TArray<FString>& ExcludeLayers);
+
     UFUNCTION(BlueprintPure, Category = "Floor Plan Analysis")
-    const TArray<FRoomData>& GetRoomData() const { return RoomData; }
+    EFloorPlanAnalysisMode GetAnalysisMode() const { return AnalysisMode; }
 
+    // Scale factor derived from recognized dimension strings, 0 when the plan could not be calibrated
     UFUNCTION(BlueprintPure, Category = "Floor Plan Analysis")
-    const TArray<FOpeningData>& GetOpeningData() const { return OpeningData; }
+    float GetCalibratedScaleFactor() const { return Result->CalibratedScaleFactor; }
+
+    // Snapshot of the last analysis. Hold on to it to keep reading those results from any thread after
+    // the analyzer has started on another plan; the getters below always read the latest one.
+    FFloorPlanAnalysisResultRef GetResult() const { return Result; }
+
+    // Getters for analyzed data. Blueprint copies the returned array on every evaluation of a pure node,
+    // so graphs should prefer the counts, indexed and paged accessors below (native code the views).
+    UFUNCTION(BlueprintPure, Category = "Floor Plan Analysis")
+    const TArray<FRoomData>& GetRoomData() const { return Result->Rooms; }
+
+    UFUNCTION(BlueprintPure, Category = "Floor Plan Analysis")
+    const TArray<FOpeningData>& GetOpeningData() const { return Result->Openings; }
+
+    UFUNCTION(BlueprintPure, Category = "Floor Plan Analysis")
+    const TArray<FVector2D>& GetWallPoints() const { return Result->WallPoints; }
 
     UFUNCTION(BlueprintPure, Category = "Floor Plan Analysis")
-    const TArray<FVector2D>& GetWallPoints() const { return WallPoints; }
+    const TArray<FWallSegmentData>& GetWallSegments() const { return Result->WallSegments; }
 
     UFUNCTION(BlueprintPure, Category = "Floor Plan Analysis")
-    FVector2D GetImageDimensions() const { return ImageDimensions; }
+    FVector2D GetImageDimensions() const { return Result->ImageDimensions; }
+
+    // Zero-copy views for native consumers, valid until the next analysis or reset
+    TConstArrayView<FRoomData> GetRoomsView() const { return Result->Rooms; }
+    TConstArrayView<FOpeningData> GetOpeningsView() const { return Result->Openings; }
+    TConstArrayView<FVector2D> GetWallPointsView() const { return Result->WallPoints; }
+    TConstArrayView<FWallSegmentData> GetWallSegmentsView() const { return Result->WallSegments; }
+
+    // Element counts, for walking the results by index without copying whole arrays
+    UFUNCTION(BlueprintPure, Category = "Floor Plan Analysis|Query")
+    int32 GetNumRooms() const { return Result->Rooms.Num(); }
+
+    UFUNCTION(BlueprintPure, Category = "Floor Plan Analysis|Query")
+    int32 GetNumOpenings() const { return Result->Openings.Num(); }
+
+    UFUNCTION(BlueprintPure, Category = "Floor Plan Analysis|Query")
+    int32 GetNumWallPoints() const { return Result->WallPoints.Num(); }
+
+    UFUNCTION(BlueprintPure, Category = "Floor Plan Analysis|Query")
+    int32 GetNumWallSegments() const { return Result->WallSegments.Num(); }
+
+    // Single elements by index, false (and a default element) when the index is out of range
+    UFUNCTION(BlueprintPure, Category = "Floor Plan Analysis|Query")
+    bool GetRoom(int32 Index, FRoomData& OutRoom) const;
+
+    UFUNCTION(BlueprintPure, Category = "Floor Plan Analysis|Query")
+    bool GetOpening(int32 Index, FOpeningData& OutOpening) const;
+
+    UFUNCTION(BlueprintPure, Category = "Floor Plan Analysis|Query")
+    bool GetWallPoint(int32 Index, FVector2D& OutPoint) const;
+
+    UFUNCTION(BlueprintPure, Category = "Floor Plan Analysis|Query")
+    bool GetWallSegment(int32 Index, FWallSegmentData& OutSegment) const;
+
+    // Pages of up to Count elements starting at First, clamped to the results. Callable rather than pure,
+    // so a graph copies each page once per execution instead of once per connected pin.
+    UFUNCTION(BlueprintCallable, Category = "Floor Plan Analysis|Query")
+    TArray<FRoomData> GetRoomRange(int32 First, int32 Count) const;
+
+    UFUNCTION(BlueprintCallable, Category = "Floor Plan Analysis|Query")
+    TArray<FOpeningData> GetOpeningRange(int32 First, int32 Count) const;
+
+    UFUNCTION(BlueprintCallable, Category = "Floor Plan Analysis|Query")
+    TArray<FVector2D> GetWallPointRange(int32 First, int32 Count) const;
+
+    UFUNCTION(BlueprintCallable, Category = "Floor Plan Analysis|Query")
+    TArray<FWallSegmentData> GetWallSegmentRange(int32 First, int32 Count) const;
+
+    // Filtered iteration: start with Cursor = 0 and call until it returns false. Each call yields the next
+    // matching element and advances Cursor past it. Name patterns are wildcards, e.g. "Bed*" or "*Bath*".
+    UFUNCTION(BlueprintCallable, Category = "Floor Plan Analysis|Query")
+    bool GetNextOpening(bool bDoors, UPARAM(ref) int32& Cursor, FOpeningData& OutOpening) const;
+
+    UFUNCTION(BlueprintCallable, Category = "Floor Plan Analysis|Query")
+    bool GetNextRoomByName(const FString& NamePattern, UPARAM(ref) int32& Cursor, FRoomData& OutRoom) const;
+
+    // Indices of the matching elements, for graphs that fetch them one by one afterwards
+    UFUNCTION(BlueprintCallable, Category = "Floor Plan Analysis|Query")
+    TArray<int32> FindOpeningsOfKind(bool bDoors) const;
+
+    UFUNCTION(BlueprintCallable, Category = "Floor Plan Analysis|Query")
+    TArray<int32> FindRoomsByName(const FString& NamePattern) const;
+
+    // Spatial queries over the current results, backed by an index that is built on first use of each snapshot
+    UFUNCTION(BlueprintCallable, Category = "Floor Plan Analysis|Spatial")
+    int32 FindRoomAtPoint(const FVector2D& Point);
+
+    UFUNCTION(BlueprintCallable, Category = "Floor Plan Analysis|Spatial")
+    TArray<int32> FindWallsInRadius(const FVector2D& Point, float Radius);
+
+    UFUNCTION(BlueprintCallable, Category = "Floor Plan Analysis|Spatial")
+    TArray<int32> FindOpeningsInRadius(const FVector2D& Point, float Radius);
+
+    // Wall segment whose center line is nearest to the opening, -1 when none lies within MaxDistance
+    UFUNCTION(BlueprintCallable, Category = "Floor Plan Analysis|Spatial")
+    int32 FindNearestWallToOpening(int32 OpeningIndex, float MaxDistance = 100.0f);
+
+    // Host wall segment index for every opening, -1 for openings without a wall within MaxDistance
+    UFUNCTION(BlueprintCallable, Category = "Floor Plan Analysis|Spatial")
+    TArray<int32> GetOpeningWallAssignments(float MaxDistance = 100.0f);
+
+    const FFloorPlanSpatialIndex& GetSpatialIndex() const { return Result->GetSpatialIndex(); }
+
+    // Stage timings and counts of the last analysis
+    UFUNCTION(BlueprintPure, Category = "Floor Plan Analysis")
+    const FFloorPlanProfile& GetProfile() const { return Profile; }
+
+    // Settings and results in the analysis server's wire format, both directions through one archive
+    void SerializeSettings(FArchive& Ar);
+    void SerializeResults(FArchive& Ar);
 
 private:
     // Image processing functions
     bool ExtractImageData(UTexture2D* Texture, TArray<FColor>& PixelData, int32& Width, int32& Height);
+    FFloorPlanRasterPlan PlanRasterAnalysis(int32 Width, int32 Height) const;
+    bool AnalyzeRaster(FFloorPlanStripReader& Reader, float ScaleFactor);
+    bool AnalyzeOnServer(const FString& FilePath, float ScaleFactor);
+    bool AnalyzeStreaming(FFloorPlanStripReader& Reader, float ScaleFactor, const FFloorPlanRasterPlan& Plan);
+    bool AnalyzePyramid(FFloorPlanStripReader& Reader, float ScaleFactor, const FFloorPlanRasterPlan& Plan);
+    bool AnalyzeVectorScene(const FFloorPlanVectorScene& Scene, float ScaleFactor, bool bCalibrateFromLabels);
+    void ResetResults();
+    void PublishResults();
+    void RecognizeRoomLabels(const FFloorPlanMask& Mask, float ScaleFactor);
+    void ApplyRoomLabels(const TArray<TArray<FString>>& RoomLines, float ScaleFactor, bool bCalibrate);
+    void RescaleResults(float Factor);
     void DetectRooms(const TArray<FColor>& PixelData, int32 Width, int32 Height, float ScaleFactor);
     void DetectWalls(const TArray<FColor>& PixelData, int32 Width, int32 Height, float ScaleFactor);
     void DetectOpenings(const TArray<FColor>& PixelData, int32 Width, int32 Height, float ScaleFactor);
@@ -92,7 +354,7 @@ private:
     bool IsBlackPixel(const FColor& Pixel) const;
     bool IsWhitePixel(const FColor& Pixel) const;
     FVector2D PixelToWorldCoordinates(int32 X, int32 Y, float ScaleFactor) const;
-    void ParseDimensionText(const FString& Text, float& Width, float& Height) const;
+    bool ParseDimensionText(const FString& Text, float& Width, float& Height) const;
     FString ExtractRoomNameFromRegion(const TArray<FColor>& PixelData, int32 Width, int32 Height, 
                                      const FIntPoint& MinPoint, const FIntPoint& MaxPoint) const;
     
@@ -101,7 +363,7 @@ private:
     void CreateSampleWallPoints(float ScaleFactor);
     void CreateSampleOpenings(float ScaleFactor);
 
-    // Analyzed data
+    // Results of the analysis in progress, moved into a new snapshot by PublishResults once it completes
     UPROPERTY()
     TArray<FRoomData> RoomData;
 
@@ -111,6 +373,50 @@ private:
     UPROPERTY()
     TArray<FVector2D> WallPoints;
 
+    UPROPERTY()
+    TArray<FWallSegmentData> WallSegments;
+
     UPROPERTY()
     FVector2D ImageDimensions;
+
+    UPROPERTY()
+    EFloorPlanAnalysisMode AnalysisMode = EFloorPlanAnalysisMode::Sample;
+
+    UPROPERTY()
+    int32 StreamingStripRows = 256;
+
+    UPROPERTY()
+    int64 MemoryBudgetBytes = 0;
+
+    UPROPERTY()
+    int32 PyramidCoarseLevel = 3;
+
+    UPROPERTY()
+    bool bMeasureWallThickness = true;
+
+    UPROPERTY()
+    bool bRecognizeText = true;
+
+    FFloorPlanPreprocessSettings PreprocessSettings;
+
+    UPROPERTY()
+    float CalibratedScaleFactor = 0.0f;
+
+    UPROPERTY()
+    TArray<FString> VectorIncludeLayers;
+
+    UPROPERTY()
+    TArray<FString> VectorExcludeLayers;
+
+    UPROPERTY()
+    FString AnalysisServerAddress;
+
+    UPROPERTY()
+    float AnalysisServerTimeoutSeconds = 600.0f;
+
+    UPROPERTY()
+    FFloorPlanProfile Profile;
+
+    // Last published results, what every getter and query reads
+    FFloorPlanAnalysisResultRef Result = FFloorPlanAnalysisResult::GetEmpty();
 };
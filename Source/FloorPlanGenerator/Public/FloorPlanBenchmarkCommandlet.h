@@ -0,0 +1,21 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "FloorPlanBenchmarkCommandlet.generated.h"
+
+// Runs the analyzer over seeded synthetic plans across image sizes, room counts and thread caps,
+// and reports throughput, speedup and accuracy against the generator's ground truth.
+//
+// UnrealEditor-Cmd <Project> -run=FloorPlanBenchmark -Sizes=1024,4096,16384 -Rooms=8,32 -Threads=1,2,4,0
+//     -Mode=Pyramid|Streaming -Seed=1 -Repeat=1 -NoText -Csv=<path>
+UCLASS()
+class FLOORPLANGENERATOR_API UFloorPlanBenchmarkCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    UFloorPlanBenchmarkCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FloorPlanVectorScene.h"
+
+class IFileHandle;
+
+struct FFloorPlanDXFSettings : public FFloorPlanVectorReadSettings
+{
+    // Nested INSERT expansion limit, guards against recursive block references
+    int32 MaxBlockDepth = 8;
+};
+
+// Streaming ASCII DXF reader. The file is tokenized in fixed-size chunks and entities are emitted as soon
+// as their group codes are complete, so memory is bounded by the block definitions and the output scene.
+// Supports LINE, LWPOLYLINE (with bulges), ARC, CIRCLE, TEXT, MTEXT and INSERT of BLOCKS.
+class FLOORPLANGENERATOR_API FFloorPlanDXFReader
+{
+public:
+    explicit FFloorPlanDXFReader(const FFloorPlanDXFSettings& InSettings);
+
+    // Reads the file into OutScene in plan space (centimeters, Y down), false on binary or malformed files
+    bool Read(const FString& FilePath, FFloorPlanVectorScene& OutScene);
+
+    // Unit scale that was applied, and whether it came from the file header
+    float GetUnitToCm() const { return UnitToCm; }
+    bool HasUnits() const { return bHasUnits; }
+
+private:
+    // Entity under construction, reused between entities to avoid allocations
+    struct FEntity
+    {
+        FString Type;
+        FString Layer;
+        FString Text;
+        FString BlockName;
+        TArray<FVector2D> Vertices;
+        TArray<float> Bulges;
+        FVector2D Point = FVector2D::ZeroVector;
+        FVector2D Point2 = FVector2D::ZeroVector;
+        FVector2D Scale = FVector2D(1.0f, 1.0f);
+        float Radius = 0.0f;
+        float Height = 0.0f;
+        float Angle0 = 0.0f;
+        float Angle1 = 360.0f;
+        int32 Flags = 0;
+
+        void Reset(const FString& InType);
+    };
+
+    // Primitives of a BLOCK in block coordinates, instanced by INSERT
+    struct FBlock
+    {
+        FVector2D Base = FVector2D::ZeroVector;
+        TArray<FEntity> Entities;
+    };
+
+    bool ReadLine(FString& OutLine);
+    bool ReadPair(int32& OutCode, FString& OutValue);
+    void ApplyGroup(FEntity& Entity, int32 Code, const FString& Value) const;
+    void FinishEntity(FEntity& Entity);
+    void Emit(const FEntity& Entity, const FFloorPlanVectorTransform& Transform, const FString& ParentLayer, int32 Depth);
+
+    FFloorPlanDXFSettings Settings;
+    FFloorPlanVectorScene* Scene = nullptr;
+
+    // Chunked line tokenizer state
+    TUniquePtr<IFileHandle> File;
+    TArray<ANSICHAR> Buffer;
+    int32 BufferStart = 0;
+    int32 BufferEnd = 0;
+    bool bEndOfFile = false;
+    bool bParseError = false;
+    FString CodeLine;
+
+    // Section and block parsing state
+    FString Section;
+    FString PendingHeaderVariable;
+    TMap<FString, FBlock> Blocks;
+    FBlock* CurrentBlock = nullptr;
+
+    float UnitToCm = 1.0f;
+    bool bHasUnits = false;
+};
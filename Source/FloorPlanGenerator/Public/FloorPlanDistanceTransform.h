@@ -0,0 +1,44 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FloorPlanAnalyzer.h"
+
+struct FFloorPlanMask;
+
+struct FFloorPlanWallSegmentSettings
+{
+    // Shortest ridge run (in pixels) reported as a wall segment
+    int32 MinSegmentPixels = 20;
+
+    // Ridges of thicker black regions (filled symbols, hatching) are ignored
+    int32 MaxThicknessPixels = 60;
+
+    float ScaleFactor = 30.48f;
+};
+
+// Exact Euclidean distance transform (Felzenszwalb-Huttenlocher) over the wall pixels of a mask.
+// Both separable passes run in linear time per line and lines are processed in parallel.
+class FLOORPLANGENERATOR_API FFloorPlanDistanceTransform
+{
+public:
+    // Squared distance from every wall pixel to the nearest non-wall pixel, 0 for non-wall pixels
+    void Compute(const FFloorPlanMask& Mask);
+
+    // Extracts axis-aligned wall segments along the distance ridge, with thickness measured from the ridge distance
+    void ExtractWallSegments(const FFloorPlanWallSegmentSettings& Settings, TArray<FWallSegmentData>& OutSegments) const;
+
+    float GetSquaredDistance(int32 X, int32 Y) const { return SquaredDistance[static_cast<int64>(Y) * Width + X]; }
+    int32 GetWidth() const { return Width; }
+    int32 GetHeight() const { return Height; }
+    int64 GetAllocatedSize() const { return SquaredDistance.GetAllocatedSize(); }
+
+private:
+    // 1D lower envelope of parabolas, Values is transformed in place
+    static void Transform1D(float* Values, int32 Count, int64 Stride, TArray<float>& Scratch, TArray<int32>& Vertices, TArray<float>& Boundaries);
+
+    void ExtractRidges(bool bHorizontalWalls, const FFloorPlanWallSegmentSettings& Settings, TArray<FWallSegmentData>& OutSegments) const;
+
+    int32 Width = 0;
+    int32 Height = 0;
+    TArray64<float> SquaredDistance;
+};
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "FloorPlanExportCommandlet.generated.h"
+
+// Analyzes floor plan files and writes each generated building as a binary glTF file, without
+// creating any mesh asset. Input is a single file or a directory of PNG/TIFF/DXF/SVG/PDF plans,
+// whose subdirectories are mirrored under Output. Plans sharing a base name get <Name>_<ext>.glb.
+//
+// UnrealEditor-Cmd <Project> -run=FloorPlanExport -Input=<file|dir> -Output=<dir> -Scale=1.0
+//     -Mode=Pyramid|Streaming -WallHeight=300 -NoQuantize
+UCLASS()
+class FLOORPLANGENERATOR_API UFloorPlanExportCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    UFloorPlanExportCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+};
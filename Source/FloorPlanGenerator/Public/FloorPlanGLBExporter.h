@@ -0,0 +1,27 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FFloorPlanMeshBuffers;
+
+struct FFloorPlanGLBSettings
+{
+    // KHR_mesh_quantization: 16-bit positions dequantized by the node transform, 8-bit normals and
+    // 16-bit UVs when they fit [0, 1]; otherwise every attribute is written as float
+    bool bQuantize = true;
+
+    // Material colors by section name, sections without an entry get a light grey
+    TMap<FString, FLinearColor> MaterialColors;
+};
+
+// Writes mesh buffers as a single binary glTF 2.0 file: one interleaved vertex buffer view, one index
+// buffer view, one primitive per section. Unreal space (cm, Z up, left-handed) is converted to glTF
+// space (m, Y up, right-handed), so no UObject or editor exporter is involved.
+class FLOORPLANGENERATOR_API FFloorPlanGLBExporter
+{
+public:
+    static bool Write(const FFloorPlanMeshBuffers& Buffers, const FString& FilePath, const FFloorPlanGLBSettings& Settings = FFloorPlanGLBSettings());
+
+    // Serializes the GLB container into memory
+    static bool Serialize(const FFloorPlanMeshBuffers& Buffers, const FFloorPlanGLBSettings& Settings, TArray<uint8>& OutBytes);
+};
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FloorPlanParallel.h"
+
+// Summed-area table for constant-time box sums. The table has one extra leading row and column of zeros.
+template <typename SumType>
+class TFloorPlanIntegralImage
+{
+public:
+    // ValueAt(X, Y) returns the per-pixel value, rows are accumulated in parallel
+    template <typename ValueFunctionType>
+    void Build(int32 InWidth, int32 InHeight, ValueFunctionType ValueAt)
+    {
+        Width = InWidth;
+        Height = InHeight;
+        Stride = static_cast<int64>(Width) + 1;
+        Sums.SetNumUninitialized(Stride * (static_cast<int64>(Height) + 1));
+        FMemory::Memzero(Sums.GetData(), Stride * sizeof(SumType));
+
+        // Horizontal prefix sums, rows are independent
+        FFloorPlanParallel::For(Height, [this, &ValueAt](int32 Y)
+        {
+            SumType* Row = Sums.GetData() + (static_cast<int64>(Y) + 1) * Stride;
+            Row[0] = 0;
+            SumType Running = 0;
+            for (int32 X = 0; X < Width; ++X)
+            {
+                Running += static_cast<SumType>(ValueAt(X, Y));
+                Row[X + 1] = Running;
+            }
+        });
+
+        // Vertical accumulation, split into column bands so each task streams through contiguous memory
+        const int32 NumBands = FMath::Clamp(Width / 256, 1, 64);
+        FFloorPlanParallel::For(NumBands, [this, NumBands](int32 Band)
+        {
+            const int64 First = 1 + static_cast<int64>(Width) * Band / NumBands;
+            const int64 Last = 1 + static_cast<int64>(Width) * (Band + 1) / NumBands;
+            for (int32 Y = 2; Y <= Height; ++Y)
+            {
+                SumType* Row = Sums.GetData() + Y * Stride;
+                const SumType* Above = Row - Stride;
+                for (int64 X = First; X < Last; ++X)
+                {
+                    Row[X] += Above[X];
+                }
+            }
+        });
+    }
+
+    // Sum over the inclusive pixel rectangle [X0, X1] x [Y0, Y1], clamped to the image
+    SumType BoxSum(int32 X0, int32 Y0, int32 X1, int32 Y1) const
+    {
+        X0 = FMath::Max(X0, 0);
+        Y0 = FMath::Max(Y0, 0);
+        X1 = FMath::Min(X1, Width - 1);
+        Y1 = FMath::Min(Y1, Height - 1);
+        if (X0 > X1 || Y0 > Y1)
+        {
+            return 0;
+        }
+
+        const SumType* Top = Sums.GetData() + static_cast<int64>(Y0) * Stride;
+        const SumType* Bottom = Sums.GetData() + (static_cast<int64>(Y1) + 1) * Stride;
+        return Bottom[X1 + 1] - Bottom[X0] - Top[X1 + 1] + Top[X0];
+    }
+
+    // Number of pixels BoxSum would cover for the same rectangle
+    static int64 BoxArea(int32 X0, int32 Y0, int32 X1, int32 Y1)
+    {
+        return FMath::Max<int64>(0, static_cast<int64>(X1) - X0 + 1) * FMath::Max<int64>(0, static_cast<int64>(Y1) - Y0 + 1);
+    }
+
+    int32 GetWidth() const { return Width; }
+    int32 GetHeight() const { return Height; }
+    bool IsValid() const { return Sums.Num() > 0; }
+
+private:
+    int32 Width = 0;
+    int32 Height = 0;
+    int64 Stride = 0;
+    TArray64<SumType> Sums;
+};
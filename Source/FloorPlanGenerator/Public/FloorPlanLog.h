@@ -0,0 +1,44 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "HAL/LowLevelMemTracker.h"
+
+// Highest verbosity compiled into the binary, anything more verbose is stripped at compile time.
+// Shipping builds keep warnings and errors only; override with a module definition if needed.
+#ifndef FLOORPLAN_LOG_COMPILE_VERBOSITY
+#if UE_BUILD_SHIPPING
+#define FLOORPLAN_LOG_COMPILE_VERBOSITY Warning
+#else
+#define FLOORPLAN_LOG_COMPILE_VERBOSITY All
+#endif
+#endif
+
+FLOORPLANGENERATOR_API DECLARE_LOG_CATEGORY_EXTERN(LogFloorPlan, Log, FLOORPLAN_LOG_COMPILE_VERBOSITY);
+
+// "stat FloorPlan" in the console shows these counters
+DECLARE_STATS_GROUP(TEXT("FloorPlan"), STATGROUP_FloorPlan, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Extract"), STAT_FloorPlanExtract, STATGROUP_FloorPlan, FLOORPLANGENERATOR_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Binarize"), STAT_FloorPlanBinarize, STATGROUP_FloorPlan, FLOORPLANGENERATOR_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Label"), STAT_FloorPlanLabel, STATGROUP_FloorPlan, FLOORPLANGENERATOR_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Walls"), STAT_FloorPlanWalls, STATGROUP_FloorPlan, FLOORPLANGENERATOR_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Openings"), STAT_FloorPlanOpenings, STATGROUP_FloorPlan, FLOORPLANGENERATOR_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Text"), STAT_FloorPlanText, STATGROUP_FloorPlan, FLOORPLANGENERATOR_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Mesh Build"), STAT_FloorPlanMeshBuild, STATGROUP_FloorPlan, FLOORPLANGENERATOR_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Asset Create"), STAT_FloorPlanAssetCreate, STATGROUP_FloorPlan, FLOORPLANGENERATOR_API);
+
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Vertices"), STAT_FloorPlanVertices, STATGROUP_FloorPlan, FLOORPLANGENERATOR_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Triangles"), STAT_FloorPlanTriangles, STATGROUP_FloorPlan, FLOORPLANGENERATOR_API);
+
+// Low-level memory tracker tags, one per stage under the same names as the cycle stats, so
+// FLOORPLAN_SCOPE_STAGE attributes allocations to the stage that made them (-llm, "stat LLMFULL")
+LLM_DECLARE_TAG_API(STAT_FloorPlanExtract, FLOORPLANGENERATOR_API);
+LLM_DECLARE_TAG_API(STAT_FloorPlanBinarize, FLOORPLANGENERATOR_API);
+LLM_DECLARE_TAG_API(STAT_FloorPlanLabel, FLOORPLANGENERATOR_API);
+LLM_DECLARE_TAG_API(STAT_FloorPlanWalls, FLOORPLANGENERATOR_API);
+LLM_DECLARE_TAG_API(STAT_FloorPlanOpenings, FLOORPLANGENERATOR_API);
+LLM_DECLARE_TAG_API(STAT_FloorPlanText, FLOORPLANGENERATOR_API);
+LLM_DECLARE_TAG_API(STAT_FloorPlanMeshBuild, FLOORPLANGENERATOR_API);
+LLM_DECLARE_TAG_API(STAT_FloorPlanAssetCreate, FLOORPLANGENERATOR_API);
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FFloorPlanStripReader;
+struct FFloorPlanProfile;
+
+// Per-pixel classification of a floor plan image, one byte per pixel instead of a full FColor copy
+struct FLOORPLANGENERATOR_API FFloorPlanMask
+{
+    enum EPixelClass : uint8
+    {
+        Other = 0,
+        Wall = 1,
+        Room = 2
+    };
+
+    int32 Width = 0;
+    int32 Height = 0;
+    TArray64<uint8> Pixels;
+
+    void Init(int32 InWidth, int32 InHeight, uint8 Value = Other);
+    bool IsValid() const { return Width > 0 && Height > 0 && Pixels.Num() == static_cast<int64>(Width) * Height; }
+
+    int64 Index(int32 X, int32 Y) const { return static_cast<int64>(Y) * Width + X; }
+    uint8 Get(int32 X, int32 Y) const { return Pixels[Index(X, Y)]; }
+    bool Contains(int32 X, int32 Y) const { return X >= 0 && X < Width && Y >= 0 && Y < Height; }
+
+    // Bounds-checked class tests, outside the image counts as neither wall nor room
+    bool IsWall(int32 X, int32 Y) const { return Contains(X, Y) && Get(X, Y) == Wall; }
+    bool IsRoom(int32 X, int32 Y) const { return Contains(X, Y) && Get(X, Y) == Room; }
+
+    // Same brightness thresholds as UFloorPlanAnalyzer::IsBlackPixel / IsWhitePixel
+    static uint8 Classify(uint8 Luminance, uint8 BlackThreshold = 50, uint8 WhiteThreshold = 200)
+    {
+        return Luminance < BlackThreshold ? Wall : (Luminance > WhiteThreshold ? Room : Other);
+    }
+
+    // Classifies every strip of the reader into this mask, decode and classify times go to the profile if given
+    bool ReadFrom(FFloorPlanStripReader& Reader, int32 StripRows, uint8 BlackThreshold = 50, uint8 WhiteThreshold = 200, FFloorPlanProfile* Profile = nullptr);
+
+    // 2x2 reduction: wall wins so thin walls survive, room only where all four pixels are room
+    FFloorPlanMask Downsample() const;
+};
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/NoExportTypes.h"
+#include "FloorPlanMaterialSet.generated.h"
+
+class UMaterialInterface;
+class UPrimitiveComponent;
+
+// Materials shared by every generated mesh, one per surface slot (Wall, Floor, Ceiling). Each slot is
+// loaded once and cached, so builds never load by path per mesh or per component. Per-room variation
+// does not need material instances: the room tint goes into Custom Primitive Data, which the floor plan
+// materials read, so all rooms keep one material. The builder only creates mesh assets and merged storey
+// components, which span many rooms, so tints are applied by whoever places one room's floor or ceiling
+// asset in a component, through ApplyRoomData.
+UCLASS(BlueprintType)
+class FLOORPLANGENERATOR_API UFloorPlanMaterialSet : public UObject
+{
+    GENERATED_BODY()
+
+public:
+    // Custom Primitive Data layout: room tint RGB at indices 0-2
+    static constexpr int32 RoomTintDataIndex = 0;
+
+    UFloorPlanMaterialSet();
+
+    UFUNCTION(BlueprintCallable, Category = "Floor Plan Materials")
+    void SetMaterialPath(FName Slot, const TSoftObjectPtr<UMaterialInterface>& Material);
+
+    UFUNCTION(BlueprintCallable, Category = "Floor Plan Materials")
+    void SetMaterial(FName Slot, UMaterialInterface* Material);
+
+    // Cached material of the slot, loaded on first use; null for unknown slots or missing assets
+    UFUNCTION(BlueprintCallable, Category = "Floor Plan Materials")
+    UMaterialInterface* GetMaterial(FName Slot);
+
+    // Loads every slot not resolved yet, called once at the start of each build
+    UFUNCTION(BlueprintCallable, Category = "Floor Plan Materials")
+    void ResolveAll();
+
+    UFUNCTION(BlueprintCallable, Category = "Floor Plan Materials")
+    void SetRoomTint(const FString& RoomName, FLinearColor Tint);
+
+    // Tint of the room, white when it has none
+    UFUNCTION(BlueprintPure, Category = "Floor Plan Materials")
+    FLinearColor GetRoomTint(const FString& RoomName) const;
+
+    // Writes the room's tint into the primitive's Custom Primitive Data, for a component showing one room
+    UFUNCTION(BlueprintCallable, Category = "Floor Plan Materials")
+    void ApplyRoomData(UPrimitiveComponent* Primitive, const FString& RoomName) const;
+
+private:
+    UPROPERTY(EditAnywhere, Category = "Floor Plan Materials")
+    TMap<FName, TSoftObjectPtr<UMaterialInterface>> MaterialPaths;
+
+    UPROPERTY(EditAnywhere, Category = "Floor Plan Materials")
+    TMap<FString, FLinearColor> RoomTints;
+
+    // Null entries record slots that failed to load, so they are not retried per mesh
+    UPROPERTY(Transient)
+    TMap<FName, UMaterialInterface*> ResolvedMaterials;
+};
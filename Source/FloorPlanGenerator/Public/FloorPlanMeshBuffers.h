@@ -0,0 +1,70 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Triangles of one material, indices into the shared vertex arrays
+struct FFloorPlanMeshSection
+{
+    FString MaterialName;
+    TArray<uint32> Indices;
+};
+
+// What FFloorPlanMeshBuffers::Optimize gained. Cache misses are counted with a FIFO post-transform cache
+// of CacheSize entries, so misses / triangles is the ACMR; index bytes are 32-bit before and 16-bit after
+// for every section whose vertices span fewer than 65535 indices.
+struct FFloorPlanMeshOptimizeStats
+{
+    static constexpr int32 CacheSize = 16;
+
+    int32 VerticesBefore = 0;
+    int32 VerticesAfter = 0;
+    int64 Triangles = 0;
+    int64 CacheMissesBefore = 0;
+    int64 CacheMissesAfter = 0;
+    int64 IndexBytesBefore = 0;
+    int64 IndexBytesAfter = 0;
+
+    void Append(const FFloorPlanMeshOptimizeStats& Other);
+};
+
+// Whole-building geometry without any UObject: one vertex stream shared by every section, in world
+// space (centimeters, Z up). Filled by UStructureBuilder::BuildMeshBuffers and written by the GLB exporter.
+struct FLOORPLANGENERATOR_API FFloorPlanMeshBuffers
+{
+    TArray<FVector3f> Positions;
+    TArray<FVector3f> Normals;
+    TArray<FVector2f> UVs;
+    // Optional non-overlapping lightmap channel, filled by PackLightmapUVs
+    TArray<FVector2f> LightmapUVs;
+    TArray<FFloorPlanMeshSection> Sections;
+
+    int32 FindOrAddSection(const FString& MaterialName);
+
+    // Appends MeshGenerator output placed by Transform; missing normals or UVs are filled with defaults
+    void Append(const TArray<FVector>& Vertices, const TArray<int32>& Triangles, const TArray<FVector2D>& InUVs,
+                const TArray<FVector>& InNormals, int32 Section, const FTransform& Transform);
+
+    // Appends other buffers placed by Transform, sections are matched by material name
+    void Append(const FFloorPlanMeshBuffers& Other, const FTransform& Transform);
+
+    // Splits into chunks of at most MaxTriangles by recursive median cuts of the triangle centroids
+    // along the longest axis, so every chunk is spatially compact; sections are kept per chunk
+    void SplitSpatially(int32 MaxTriangles, TArray<FFloorPlanMeshBuffers>& OutChunks) const;
+
+    // Packs UV1 analytically: every connected patch of triangles is a chart laid out flat in its own
+    // plane at world scale, and charts are shelf-packed into the unit square with a gutter of two texels
+    // at Resolution. Generated pieces are unwelded flat quads, so each face is one distortion-free chart.
+    void PackLightmapUVs(int32 Resolution);
+
+    // Welds vertices with identical attributes, orders each section's triangles for the post-transform
+    // vertex cache (Forsyth) and then in clusters from the outside in against overdraw, and renumbers
+    // vertices in first-use order so every section owns one contiguous vertex range. Lightmap UVs are
+    // part of the weld key, so packed charts survive.
+    void Optimize(FFloorPlanMeshOptimizeStats* OutStats = nullptr);
+
+    int32 GetNumVertices() const { return Positions.Num(); }
+    int64 GetNumTriangles() const;
+    FBox3f GetBounds() const;
+
+    void Reset();
+};
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FloorPlanAnalyzer.h"
+#include "FloorPlanIntegralImage.h"
+
+struct FFloorPlanMask;
+
+struct FFloorPlanOpeningSettings
+{
+    // Wall gaps outside this range (world units) are not openings
+    float MinOpeningWidth = 50.0f;
+    float MaxOpeningWidth = 200.0f;
+
+    // Fraction of a row across the gap that must be ink to count as a window line
+    float WindowLineFill = 0.8f;
+
+    // Window symbols need at least this many parallel lines inside the gap: both wall faces and the glass
+    int32 MinWindowLines = 3;
+
+    // Fraction of swing arc samples that must hit ink to accept a door
+    float DoorArcHitRatio = 0.6f;
+
+    // Openings closer than this (world units) are merged
+    float DuplicateDistance = 30.0f;
+
+    float ScaleFactor = 30.48f;
+};
+
+// Finds door swing arcs and window line symbols in the gaps between collinear wall segments.
+// All symbol tests are constant-time box sums on an ink summed-area table, and duplicates are
+// rejected through a spatial hash instead of a scan over every opening found so far.
+class FLOORPLANGENERATOR_API FFloorPlanOpeningDetector
+{
+public:
+    FFloorPlanOpeningDetector(const FFloorPlanMask& Mask, const FFloorPlanOpeningSettings& InSettings);
+
+    void Detect(const TArray<FWallSegmentData>& Segments, TArray<FOpeningData>& OutOpenings) const;
+
+private:
+    // Wall gap in pixel coordinates along one wall line
+    struct FGap
+    {
+        bool bHorizontalWall;
+        float Across;
+        float AlongStart;
+        float AlongEnd;
+        float ThicknessPixels;
+    };
+
+    void FindGaps(const TArray<FWallSegmentData>& Segments, bool bHorizontalWalls, TArray<FGap>& OutGaps) const;
+    // False for gaps that are neither a window nor a door with a swing arc (plain passages)
+    bool ClassifyGap(const FGap& Gap, FOpeningData& OutOpening) const;
+    int32 CountWindowLines(const FGap& Gap) const;
+    float DoorArcScore(const FGap& Gap) const;
+
+    // Ink pixel count in a box given in (along, across) coordinates of the gap's wall
+    int32 InkInBox(bool bHorizontalWall, int32 Along0, int32 Across0, int32 Along1, int32 Across1) const;
+    bool HasInkNear(const FVector2D& Pixel, int32 Radius) const;
+
+    FFloorPlanOpeningSettings Settings;
+    float PixelToWorld;
+    TFloorPlanIntegralImage<uint32> Ink;
+};
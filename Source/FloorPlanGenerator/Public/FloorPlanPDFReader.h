@@ -0,0 +1,78 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FloorPlanVectorScene.h"
+
+// Vector PDF reader producing the same vector scene as the DXF importer. Reads the first page (or, when
+// the page tree sits in compressed object streams, every content-like stream), inflates FlateDecode
+// content, and interprets path, CTM, form XObject and simple-font text operators. Optional content
+// groups (/OC marked content) act as layers. Circular Bezier arcs come out as arcs like in SVG.
+class FLOORPLANGENERATOR_API FFloorPlanPDFReader
+{
+public:
+    explicit FFloorPlanPDFReader(const FFloorPlanVectorReadSettings& InSettings);
+
+    // Reads the file into OutScene in plan space (Y down, origin at the drawing bounds)
+    bool Read(const FString& FilePath, FFloorPlanVectorScene& OutScene);
+
+private:
+    // Path segment in device space, cubic control points only used when bCubic is set
+    struct FSegment
+    {
+        FVector2D Points[4];
+        bool bCubic = false;
+    };
+
+    struct FToken
+    {
+        enum EType { Number, Name, String, Other };
+
+        EType Type = Other;
+        float Number = 0.0f;
+        FString Text;
+    };
+
+    // Object table and raw object access
+    void IndexObjects();
+    int32 FindBytes(const ANSICHAR* Pattern, int32 Start, int32 End) const;
+    bool FindFirstPage(FString& OutPage, FString& OutResources) const;
+    FString GetDictionary(int32 ObjectNumber) const;
+    FString ResolveDictionary(const FString& Value) const;
+    bool GetStream(int32 ObjectNumber, TArray<uint8>& OutData) const;
+
+    // Content stream interpretation, Resources is the dictionary used for XObject and layer lookups
+    void ParseContent(const TArray<uint8>& Content, const FString& Resources, const FFloorPlanVectorTransform& Transform, int32 Depth);
+    bool NextToken(const TArray<uint8>& Content, int32& Cursor, FToken& OutToken, bool& bOutOperator) const;
+    void CloseSubpath();
+    void PaintPath(bool bEmit);
+    void FlushText();
+    int32 GetCurrentLayer() const { return LayerStack.Num() > 0 ? LayerStack.Last() : DefaultLayer; }
+    int32 GetLayer(const FString& Resources, const FString& PropertyName);
+
+    static FString GetValue(const FString& Dictionary, const TCHAR* Key);
+    static TArray<int32> GetReferences(const FString& Value);
+    static bool Inflate(const uint8* Source, int32 Size, TArray<uint8>& OutData);
+
+    FFloorPlanVectorReadSettings Settings;
+    FFloorPlanVectorScene* Scene = nullptr;
+
+    TArray<uint8> Data;
+    TMap<int32, int32> ObjectOffsets;
+
+    // Interpreter state of the content stream being parsed
+    TArray<FSegment> Path;
+    TArray<FVector2D> Subpath;
+    TArray<TArray<FVector2D>> ClosedOutlines;
+    bool bSubpathStraight = true;
+    FVector2D Current = FVector2D::ZeroVector;
+    FVector2D SubpathStart = FVector2D::ZeroVector;
+    TArray<int32> LayerStack;
+    TMap<FString, int32> LayerCache;
+    int32 DefaultLayer = INDEX_NONE;
+
+    // Text runs shown back to back without repositioning are merged into one label
+    FString PendingText;
+    FVector2D PendingTextPosition = FVector2D::ZeroVector;
+    float PendingTextHeight = 0.0f;
+    int32 PendingTextLayer = INDEX_NONE;
+};
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/ParallelFor.h"
+
+// ParallelFor with an optional cap on concurrently running tasks (FloorPlan.MaxThreads, 0 = all workers),
+// so thread scaling can be measured inside one process
+class FLOORPLANGENERATOR_API FFloorPlanParallel
+{
+public:
+    static int32 GetMaxThreads();
+    static void SetMaxThreads(int32 MaxThreads);
+
+    // Workers a parallel loop may occupy under the current cap, at least 1
+    static int32 GetNumWorkers();
+
+    template <typename FunctionType>
+    static void For(int32 Num, FunctionType Body)
+    {
+        const int32 MaxThreads = GetMaxThreads();
+        if (MaxThreads == 1)
+        {
+            for (int32 Index = 0; Index < Num; ++Index)
+            {
+                Body(Index);
+            }
+            return;
+        }
+
+        if (MaxThreads <= 0 || Num <= MaxThreads)
+        {
+            ParallelFor(Num, Body);
+            return;
+        }
+
+        // One contiguous chunk per allowed thread
+        ParallelFor(MaxThreads, [Num, MaxThreads, &Body](int32 Chunk)
+        {
+            const int32 First = static_cast<int32>(static_cast<int64>(Num) * Chunk / MaxThreads);
+            const int32 Last = static_cast<int32>(static_cast<int64>(Num) * (Chunk + 1) / MaxThreads);
+            for (int32 Index = First; Index < Last; ++Index)
+            {
+                Body(Index);
+            }
+        });
+    }
+};
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Plan-space polygon with holes (cm). The outer ring has positive signed area (counter-clockwise with
+// X right and Y up), holes have negative signed area.
+struct FFloorPlanPolygon
+{
+    TArray<FVector2D> Outer;
+    TArray<TArray<FVector2D>> Holes;
+};
+
+// Polygon union on an integer grid, used to merge room footprints into one slab outline per storey.
+// Coordinates are snapped to GridSize, so every orientation and coincidence test is exact: edges are
+// split where they cross or touch, an edge piece is kept when it separates covered from uncovered plan,
+// and the kept pieces are linked into rings. Uncovered regions enclosed by footprints (stairwells,
+// shafts) come out as holes.
+class FLOORPLANGENERATOR_API FFloorPlanPolygonUnion
+{
+public:
+    // Grid step in cm
+    static constexpr double GridSize = 0.1;
+
+    // Union of the footprints, each grown by Outset first with mitred corners (half a wall thickness
+    // makes rooms on both sides of a wall meet under it). Footprints of either winding are accepted.
+    static void Union(const TArray<TArray<FVector2D>>& Footprints, double Outset, TArray<FFloorPlanPolygon>& OutPolygons);
+
+    // Ear clipping after bridging every hole into the outer ring. OutVertices are the outer ring followed
+    // by the holes in order, OutTriangles wind counter-clockwise. False when the polygon is degenerate.
+    static bool Triangulate(const FFloorPlanPolygon& Polygon, TArray<FVector2D>& OutVertices, TArray<int32>& OutTriangles);
+};
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "FloorPlanPortalGraph.h"
+#include "FloorPlanPortalCullingComponent.generated.h"
+
+class UPrimitiveComponent;
+
+// Cell-and-portal culling for a generated interior: every tick the player camera's cell is found in the
+// portal graph, cells visible through doors and windows are resolved in plan space and the primitives
+// registered to all other cells are hidden. Primitives not registered to a cell are never touched.
+UCLASS(ClassGroup = (FloorPlan), meta = (BlueprintSpawnableComponent))
+class FLOORPLANGENERATOR_API UFloorPlanPortalCullingComponent : public UActorComponent
+{
+    GENERATED_BODY()
+
+public:
+    UFloorPlanPortalCullingComponent();
+
+    virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+    // Replaces the graph and forgets all registered primitives
+    UFUNCTION(BlueprintCallable, Category = "Portal Culling")
+    void SetPortalGraph(const FFloorPlanPortalGraph& InGraph);
+
+    UFUNCTION(BlueprintPure, Category = "Portal Culling")
+    const FFloorPlanPortalGraph& GetPortalGraph() const { return Graph; }
+
+    UFUNCTION(BlueprintCallable, Category = "Portal Culling")
+    void RegisterCellPrimitive(int32 Cell, UPrimitiveComponent* Primitive);
+
+    // Registers each primitive to the cell containing its bounds center; walls between rooms fall on no
+    // cell and stay visible. Returns the number of primitives assigned.
+    UFUNCTION(BlueprintCallable, Category = "Portal Culling")
+    int32 AssignPrimitivesToCells(const TArray<UPrimitiveComponent*>& Primitives);
+
+    // Off shows every cell again
+    UFUNCTION(BlueprintCallable, Category = "Portal Culling")
+    void SetCullingEnabled(bool bEnabled);
+
+    UFUNCTION(BlueprintPure, Category = "Portal Culling")
+    int32 GetNumVisibleCells() const { return NumVisibleCells; }
+
+private:
+    void ApplyVisibility(const TBitArray<>& Visible);
+
+    UPROPERTY()
+    FFloorPlanPortalGraph Graph;
+
+    // Registered primitives per cell
+    TArray<TArray<TWeakObjectPtr<UPrimitiveComponent>>> CellPrimitives;
+
+    // Last applied visibility, so only cells that change are touched
+    TBitArray<> AppliedVisibility;
+
+    bool bCullingEnabled = true;
+    int32 NumVisibleCells = 0;
+};
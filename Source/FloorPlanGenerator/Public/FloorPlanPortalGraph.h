@@ -0,0 +1,79 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FloorPlanPortalGraph.generated.h"
+
+struct FFloorPlanAnalysisResult;
+
+// Door or window between two rooms (or a room and the outside), as a segment in plan space
+USTRUCT(BlueprintType)
+struct FLOORPLANGENERATOR_API FFloorPlanPortal
+{
+    GENERATED_BODY()
+
+    // Cells on either side, -1 for the outside
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Portal")
+    int32 CellA = INDEX_NONE;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Portal")
+    int32 CellB = INDEX_NONE;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Portal")
+    FVector2D Start = FVector2D::ZeroVector;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Portal")
+    FVector2D End = FVector2D::ZeroVector;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Portal")
+    bool bIsDoor = true;
+
+    // Index of the FOpeningData this portal was made from
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Portal")
+    int32 Opening = INDEX_NONE;
+};
+
+// One room of the plan as a visibility cell
+USTRUCT(BlueprintType)
+struct FLOORPLANGENERATOR_API FFloorPlanCell
+{
+    GENERATED_BODY()
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Portal")
+    FString RoomName;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Portal")
+    TArray<FVector2D> Boundary;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Portal")
+    FBox2D Bounds = FBox2D(ForceInit);
+
+    // Portals touching this cell
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Portal")
+    TArray<int32> Portals;
+};
+
+// Room adjacency graph of one floor: rooms are cells, doors and windows are portals. Visibility is
+// resolved in plan space, walls are assumed to run from floor to ceiling.
+USTRUCT(BlueprintType)
+struct FLOORPLANGENERATOR_API FFloorPlanPortalGraph
+{
+    GENERATED_BODY()
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Portal")
+    TArray<FFloorPlanCell> Cells;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Portal")
+    TArray<FFloorPlanPortal> Portals;
+
+    // Cells from the analysis rooms, portals from its openings: each opening is laid along its host
+    // wall and the rooms are probed on both sides of the wall at WallThickness
+    void Build(const FFloorPlanAnalysisResult& Result, float WallThickness);
+
+    // Cell containing Point, INDEX_NONE outside every room
+    int32 FindCell(const FVector2D& Point) const;
+
+    // Marks every cell seen from Eye within the horizontal field of view: the eye's cell, then cells
+    // behind portals that overlap the view cone, narrowing the cone at each portal. Returns false when
+    // the eye is outside every room, in which case nothing can be culled.
+    bool FindVisibleCells(const FVector2D& Eye, float ViewYawDegrees, float HalfFovDegrees, TBitArray<>& OutVisible) const;
+};
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FloorPlanPreprocessor.generated.h"
+
+class FFloorPlanStripReader;
+struct FFloorPlanMask;
+struct FFloorPlanProfile;
+
+UENUM(BlueprintType)
+enum class EFloorPlanThresholdMethod : uint8
+{
+    // Fixed black and white luminance thresholds, for clean digital exports
+    Global,
+    // Local mean minus a fixed fraction (Bradley-Roth), fast and robust to lighting gradients
+    Bradley,
+    // Local mean and deviation (Sauvola), keeps faint lines on stained or yellowed paper
+    Sauvola
+};
+
+struct FFloorPlanPreprocessSettings
+{
+    EFloorPlanThresholdMethod Method = EFloorPlanThresholdMethod::Global;
+
+    // Global thresholds, also the ones used by the unpreprocessed mask
+    uint8 BlackThreshold = 50;
+    uint8 WhiteThreshold = 200;
+
+    // Side of the local window in pixels, about twice the thickest wall works well
+    int32 WindowSize = 31;
+
+    // Bradley: ink is darker than the local mean by more than this fraction
+    float BradleyFraction = 0.15f;
+
+    // Sauvola: T = Mean * (1 + K * (Deviation / Range - 1))
+    float SauvolaK = 0.2f;
+    float SauvolaRange = 128.0f;
+
+    // Radius of the square structuring element: opening removes specks, closing bridges breaks in walls.
+    // 0 turns the step off.
+    int32 OpenRadius = 0;
+    int32 CloseRadius = 0;
+
+    // Rotate the scan so walls are axis-aligned when the detected skew is within MaxSkewDegrees
+    bool bDeskew = false;
+    float MaxSkewDegrees = 5.0f;
+    float MinSkewDegrees = 0.1f;
+
+    // Whether anything beyond the global classification is requested
+    bool IsEnabled() const { return Method != EFloorPlanThresholdMethod::Global || OpenRadius > 0 || CloseRadius > 0 || bDeskew; }
+};
+
+// Cleans a raster scan up before analysis: projection-profile deskew, adaptive thresholding over
+// integral images, and morphological open/close on the bit-packed wall mask. Every step is linear in the
+// pixel count and runs in parallel over rows; the integral images are built per band of rows, so their
+// size depends on the image width, not the full frame.
+class FLOORPLANGENERATOR_API FFloorPlanPreprocessor
+{
+public:
+    explicit FFloorPlanPreprocessor(const FFloorPlanPreprocessSettings& InSettings);
+
+    // Reads the whole image and classifies it into OutMask, times go to the profile's binarize stage
+    bool Run(FFloorPlanStripReader& Reader, int32 StripRows, FFloorPlanMask& OutMask, FFloorPlanProfile* Profile = nullptr);
+
+    // Skew that was removed from the last image in degrees, 0 when it was left as is
+    float GetSkewDegrees() const { return SkewDegrees; }
+
+    // Working set beyond the mask: the luminance frame, its rotated copy and one band of integral images
+    static int64 EstimateWorkingBytes(int32 Width, int32 Height, const FFloorPlanPreprocessSettings& Settings);
+
+private:
+    void Threshold(const TArray64<uint8>& Luminance, int32 Width, int32 Height, FFloorPlanMask& OutMask) const;
+    float EstimateSkew(const FFloorPlanMask& Mask) const;
+    static void Rotate(const TArray64<uint8>& Source, int32 Width, int32 Height, float Degrees, TArray64<uint8>& OutRotated);
+    static void OpenClose(FFloorPlanMask& Mask, int32 OpenRadius, int32 CloseRadius);
+
+    FFloorPlanPreprocessSettings Settings;
+    float SkewDegrees = 0.0f;
+};
@@ -3,10 +3,15 @@
 #include "CoreMinimal.h"
 #include "UObject/NoExportTypes.h"
 #include "Engine/Texture2D.h"
+#include "Containers/Ticker.h"
+#include "FloorPlanAnalyzer.h"
+#include "StructureBuilder.h"
 #include "FloorPlanProcessor.generated.h"
 
 class UFloorPlanAnalyzer;
 class UStructureBuilder;
+class UProceduralMeshComponent;
+class AActor;
 
 UCLASS(BlueprintType, Blueprintable)
 class FLOORPLANGENERATOR_API UFloorPlanProcessor : public UObject
@@ -16,22 +21,51 @@ class FLOORPLANGENERATOR_API UFloorPlanProcessor : public UObject
 public:
     UFloorPlanProcessor();
 
-    // Main processing function
+    // Main processing function, returns stage timings and counts of the run
     UFUNCTION(BlueprintCallable, Category = "Floor Plan Generator")
-    void ProcessFloorPlan(UTexture2D* FloorPlanImage);
+    FFloorPlanProfile ProcessFloorPlan(UTexture2D* FloorPlanImage);
 
-    // Parameter setters
+    // Processes a PNG/TIFF from disk using streaming or pyramid analysis, or a DXF/SVG/PDF drawing directly from its geometry
     UFUNCTION(BlueprintCallable, Category = "Floor Plan Generator")
-    void SetWallHeight(float Height) { WallHeight = Height; }
+    FFloorPlanProfile ProcessFloorPlanFile(const FString& FilePath);
 
+    // Live edit: keeps the last analysis and shows the building as procedural mesh proxies in the editor
+    // world. Parameter setters then only redo the affected stage on the next tick: heights and thickness
+    // re-extrude the walls, the wall height moves the ceilings; analysis and floors are never redone.
+    // Fails when nothing has been analyzed yet.
     UFUNCTION(BlueprintCallable, Category = "Floor Plan Generator")
-    void SetDoorHeight(float Height) { DoorHeight = Height; }
+    bool BeginLiveEdit();
 
+    // Removes the proxies and builds the mesh assets once with the current parameters
     UFUNCTION(BlueprintCallable, Category = "Floor Plan Generator")
-    void SetWindowHeight(float Height) { WindowHeight = Height; }
+    FFloorPlanProfile FinalizeLiveEdit();
 
+    // Removes the proxies without building any assets
     UFUNCTION(BlueprintCallable, Category = "Floor Plan Generator")
-    void SetWallThickness(float Thickness) { WallThickness = Thickness; }
+    void CancelLiveEdit();
+
+    UFUNCTION(BlueprintPure, Category = "Floor Plan Generator")
+    bool IsLiveEditing() const { return LivePreviewActor != nullptr; }
+
+    // Duration of the last proxy update, to compare against the frame budget
+    UFUNCTION(BlueprintPure, Category = "Floor Plan Generator")
+    float GetLastLiveEditMs() const { return LastLiveEditMs; }
+
+    // Parameter setters, applied to the proxies on the next tick while live editing
+    UFUNCTION(BlueprintCallable, Category = "Floor Plan Generator")
+    void SetWallHeight(float Height);
+
+    UFUNCTION(BlueprintCallable, Category = "Floor Plan Generator")
+    void SetDoorHeight(float Height);
+
+    UFUNCTION(BlueprintCallable, Category = "Floor Plan Generator")
+    void SetWindowHeight(float Height);
+
+    UFUNCTION(BlueprintCallable, Category = "Floor Plan Generator")
+    void SetWallThickness(float Thickness);
+
+    UFUNCTION(BlueprintCallable, Category = "Floor Plan Generator")
+    void SetAnalysisMode(EFloorPlanAnalysisMode Mode) { AnalysisMode = Mode; }
 
     // Parameter getters
     UFUNCTION(BlueprintPure, Category = "Floor Plan Generator")
@@ -60,13 +94,112 @@ protected:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Parameters")
     float WallThickness = 10.0f; // 4 inches
 
+    // Use WallThickness for measured walls too. A thickness change during live edit does the same until
+    // the session is finalized or cancelled, without changing this setting.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Parameters")
+    bool bOverrideMeasuredWallThickness = false;
+
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Parameters")
     float ScaleFactor = 30.48f; // Feet to centimeters conversion
 
+    // One floor and one ceiling slab over the union of all rooms instead of a box per room
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Parameters")
+    bool bStoreySlabs = false;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Analysis")
+    EFloorPlanAnalysisMode AnalysisMode = EFloorPlanAnalysisMode::Sample;
+
+    // Working set limit for raster analysis, 0 for none. In Auto mode the analyzer picks the pyramid,
+    // the pyramid without thickness measurement or streaming strips to stay under it.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Analysis", meta = (ClampMin = "0", Units = "Megabytes"))
+    int32 MemoryBudgetMB = 0;
+
+    // Shared analysis server (-run=FloorPlanServer) for ProcessFloorPlanFile as "ip:port", empty for in-process only
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Analysis")
+    FString AnalysisServerAddress;
+
+    // Rows decoded per strip in streaming mode
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Analysis", meta = (ClampMin = "1"))
+    int32 StreamingStripRows = 256;
+
+    // Pyramid level the coarse detectors run on in pyramid mode
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Analysis", meta = (ClampMin = "1", ClampMax = "8"))
+    int32 PyramidCoarseLevel = 3;
+
+    // Measure per-segment wall thickness instead of using WallThickness everywhere (pyramid mode)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Analysis")
+    bool bMeasureWallThickness = true;
+
+    // Scan cleanup (pyramid mode): local thresholds for photos and yellowed paper, speck removal and wall
+    // gap bridging radii in pixels (0 = off), and rotation of slightly skewed scans
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Analysis")
+    EFloorPlanThresholdMethod ThresholdMethod = EFloorPlanThresholdMethod::Global;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Analysis", meta = (ClampMin = "0", ClampMax = "16"))
+    int32 SpeckRemovalRadius = 0;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Analysis", meta = (ClampMin = "0", ClampMax = "16"))
+    int32 GapBridgingRadius = 0;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Analysis")
+    bool bDeskew = false;
+
+    // Read room labels and dimension strings and calibrate the scale from them (pyramid mode)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Analysis")
+    bool bRecognizeText = true;
+
+    // Proxy updates slower than this are reported while live editing
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Live Edit", meta = (ClampMin = "1", Units = "Milliseconds"))
+    float LiveEditFrameBudgetMs = 16.0f;
+
+public:
+    virtual void BeginDestroy() override;
+
 private:
+    bool EnsureAnalyzerAndBuilder();
+    void ApplyBuilderParameters();
+    void BuildFromAnalysis();
+    FFloorPlanProfile CollectProfile() const;
+
+    // Live edit stages, each redone only when a parameter it depends on changed
+    void MarkLiveEditDirty(bool bWalls, bool bCeilings);
+    bool TickLiveEdit(float DeltaTime);
+    void UpdateLiveWalls();
+    void UpdateLiveRooms();
+    void UpdateLiveCeilingHeight();
+
     UPROPERTY()
     UFloorPlanAnalyzer* Analyzer;
 
     UPROPERTY()
     UStructureBuilder* Builder;
+
+    // Whether Analyzer holds a successful analysis that live edit can reuse
+    bool bHasAnalysis = false;
+
+    UPROPERTY(Transient)
+    AActor* LivePreviewActor = nullptr;
+
+    UPROPERTY(Transient)
+    UProceduralMeshComponent* LiveWalls = nullptr;
+
+    UPROPERTY(Transient)
+    UProceduralMeshComponent* LiveFloors = nullptr;
+
+    UPROPERTY(Transient)
+    UProceduralMeshComponent* LiveCeilings = nullptr;
+
+    // Wall graph of the analysis with openings hosted, resolved once per live edit session
+    TArray<FWallDefinition> LiveWallLayout;
+
+    // Wall height the ceiling proxies were built at, the component is offset by the difference
+    float LiveCeilingBuildHeight = 0.0f;
+
+    bool bLiveWallsDirty = false;
+    bool bLiveCeilingsDirty = false;
+
+    // Set by SetWallThickness during live edit, so measured walls follow the edited thickness
+    bool bLiveThicknessOverride = false;
+    float LastLiveEditMs = 0.0f;
+    FTSTicker::FDelegateHandle LiveEditTickerHandle;
 };
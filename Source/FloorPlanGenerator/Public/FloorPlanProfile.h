@@ -0,0 +1,146 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FloorPlanLog.h"
+#include "FloorPlanProfile.generated.h"
+
+struct FFloorPlanMeshOptimizeStats;
+
+// Stage timings and sizes of one floor plan run
+USTRUCT(BlueprintType)
+struct FLOORPLANGENERATOR_API FFloorPlanProfile
+{
+    GENERATED_BODY()
+
+    // Stage timings in milliseconds
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Profile")
+    float ExtractMs = 0.0f;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Profile")
+    float BinarizeMs = 0.0f;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Profile")
+    float LabelMs = 0.0f;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Profile")
+    float WallsMs = 0.0f;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Profile")
+    float OpeningsMs = 0.0f;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Profile")
+    float TextMs = 0.0f;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Profile")
+    float MeshBuildMs = 0.0f;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Profile")
+    float AssetCreateMs = 0.0f;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Profile")
+    float TotalMs = 0.0f;
+
+    // Sizes
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Profile")
+    int64 PixelCount = 0;
+
+    // Vector primitives read from CAD or vector input
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Profile")
+    int64 PrimitiveCount = 0;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Profile")
+    int32 RoomCount = 0;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Profile")
+    int32 WallSegmentCount = 0;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Profile")
+    int32 OpeningCount = 0;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Profile")
+    int32 MeshCount = 0;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Profile")
+    int64 VertexCount = 0;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Profile")
+    int64 TriangleCount = 0;
+
+    // Largest analysis working set (mask, run buffers) and process peak physical memory, in bytes
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Profile")
+    int64 PeakWorkingBytes = 0;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Profile")
+    int64 PeakMemoryBytes = 0;
+
+    // Raster strategy picked for the memory budget (e.g. "Pyramid L3", "Streaming 64 rows"), the budget
+    // itself (0 = unlimited) and the working set it was estimated to need
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Profile")
+    FString Strategy;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Profile")
+    int64 MemoryBudgetBytes = 0;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Profile")
+    int64 EstimatedWorkingBytes = 0;
+
+    // Mesh optimization over every optimized mesh: vertices before and after welding, post-transform cache
+    // misses before and after reordering (misses / triangles is the ACMR) and index buffer bytes
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Profile")
+    int64 OptimizedTriangleCount = 0;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Profile")
+    int64 UnweldedVertexCount = 0;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Profile")
+    int64 WeldedVertexCount = 0;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Profile")
+    int64 CacheMissesBefore = 0;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Profile")
+    int64 CacheMissesAfter = 0;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Profile")
+    int64 IndexBytesBefore = 0;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Profile")
+    int64 IndexBytesAfter = 0;
+
+    // Adds timings and counts of another run, peaks keep the maximum
+    void Append(const FFloorPlanProfile& Other);
+
+    void AddMeshOptimization(const FFloorPlanMeshOptimizeStats& Stats);
+
+    void LogSummary(const TCHAR* Label) const;
+};
+
+// Adds the elapsed milliseconds of its scope to a profile field, if one is given
+struct FFloorPlanStageTimer
+{
+    explicit FFloorPlanStageTimer(float* InTargetMs)
+        : TargetMs(InTargetMs)
+        , StartCycles(FPlatformTime::Cycles64())
+    {
+    }
+
+    ~FFloorPlanStageTimer()
+    {
+        if (TargetMs)
+        {
+            *TargetMs += static_cast<float>(FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles));
+        }
+    }
+
+private:
+    float* TargetMs;
+    uint64 StartCycles;
+};
+
+// Cycle stat, CPU profiler trace event, LLM tag and per-run timing for one pipeline stage.
+// ProfilePtr may be null, the stat, trace event and tag are recorded either way.
+#define FLOORPLAN_SCOPE_STAGE(StatName, ProfilePtr, Field) \
+    LLM_SCOPE_BYTAG(StatName); \
+    SCOPE_CYCLE_COUNTER(StatName); \
+    TRACE_CPUPROFILER_EVENT_SCOPE(StatName); \
+    FFloorPlanStageTimer PREPROCESSOR_JOIN(FloorPlanStageTimer_, __LINE__)((ProfilePtr) ? &(ProfilePtr)->Field : nullptr)
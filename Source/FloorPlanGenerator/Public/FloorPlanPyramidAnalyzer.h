@@ -0,0 +1,81 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FloorPlanAnalyzer.h"
+#include "FloorPlanMask.h"
+
+struct FFloorPlanProfile;
+
+struct FFloorPlanPyramidSettings
+{
+    // Pyramid level the coarse detectors run on, each level halves the resolution
+    int32 CoarseLevel = 3;
+
+    // Minimum room bounding box in full resolution pixels
+    int32 MinRoomSizePixels = 50;
+
+    // Wall points are kept at most once per cell of this size
+    int32 WallPointSpacingPixels = 4;
+
+    // Scanlines used to refine each room edge at full resolution
+    int32 RoomEdgeSamples = 5;
+
+    // Largest wall gap (in world units) treated as an opening candidate
+    float MaxOpeningWidth = 200.0f;
+
+    // A gap must be flanked by wall runs at least this many coarse cells long
+    int32 MinFlankingWallCells = 2;
+
+    float ScaleFactor = 30.48f;
+};
+
+// Coarse-to-fine detection: rooms, walls and opening candidates are found on a downsampled mip and only
+// the boundary bands, wall cells and gap candidates are revisited at full resolution
+class FLOORPLANGENERATOR_API FFloorPlanPyramidAnalyzer
+{
+public:
+    FFloorPlanPyramidAnalyzer(const FFloorPlanMask& InFullMask, const FFloorPlanPyramidSettings& InSettings);
+
+    // Stage times go to the profile if given: pyramid and rooms as labeling, wall refinement and gap search separately
+    void Run(FFloorPlanProfile* Profile = nullptr);
+
+    const TArray<FRoomData>& GetRooms() const { return Rooms; }
+    const TArray<FOpeningData>& GetOpenings() const { return Openings; }
+    const TArray<FVector2D>& GetWallPoints() const { return WallPoints; }
+
+    // Hands the result arrays to the caller without copying
+    void MoveResults(TArray<FRoomData>& OutRooms, TArray<FOpeningData>& OutOpenings, TArray<FVector2D>& OutWallPoints)
+    {
+        OutRooms = MoveTemp(Rooms);
+        OutOpenings = MoveTemp(Openings);
+        OutWallPoints = MoveTemp(WallPoints);
+    }
+
+    // Full resolution pixels read by the refinement passes, for comparing against a full-frame scan
+    int64 GetRefinedPixels() const { return RefinedPixels; }
+    int32 GetCoarseLevel() const { return CoarseLevel; }
+
+private:
+    void BuildPyramid();
+    void DetectRooms();
+    void RefineRoom(const FIntPoint& CoarseMin, const FIntPoint& CoarseMax);
+    void RefineWalls();
+    void DetectOpenings();
+    void RefineOpening(int32 Line, int32 GapStart, int32 GapEnd, bool bHorizontalWall);
+
+    const FFloorPlanMask& GetCoarse() const { return Levels.Last(); }
+    FVector2D PixelToWorld(float X, float Y) const { return FVector2D(X, Y) * (Settings.ScaleFactor / 10.0f); }
+
+    const FFloorPlanMask& FullMask;
+    FFloorPlanPyramidSettings Settings;
+
+    // Levels[0] is the first downsampled mip, the full resolution mask is not copied
+    TArray<FFloorPlanMask> Levels;
+    int32 CoarseLevel = 0;
+    int32 CellSize = 1;
+
+    TArray<FRoomData> Rooms;
+    TArray<FOpeningData> Openings;
+    TArray<FVector2D> WallPoints;
+    int64 RefinedPixels = 0;
+};
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FloorPlanVectorScene.h"
+
+// SVG reader producing the same vector scene as the DXF importer. Handles path (all commands, circular
+// arcs and cubics kept as arcs), line, polyline, polygon, rect, circle, ellipse and text, with nested
+// group transforms. Top-level groups (Inkscape layers or ids) act as layers; defs, symbols and hidden
+// content are skipped. SVG units are paper units, so UnitToCm normally comes from the caller's scale.
+class FLOORPLANGENERATOR_API FFloorPlanSVGReader
+{
+public:
+    explicit FFloorPlanSVGReader(const FFloorPlanVectorReadSettings& InSettings);
+
+    bool Read(const FString& FilePath, FFloorPlanVectorScene& OutScene);
+
+    // Parses markup that is already in memory
+    void Parse(const FString& Markup, FFloorPlanVectorScene& OutScene);
+
+private:
+    struct FElementState
+    {
+        FFloorPlanVectorTransform Transform;
+        FString Layer;
+        bool bSkip = false;
+    };
+
+    void HandleElement(const FString& Name, const TMap<FString, FString>& Attributes, const FElementState& State);
+    void ParsePath(const FString& Data, const FFloorPlanVectorTransform& Transform, int32 Layer);
+    void AddEllipticalArc(const FVector2D& From, const FVector2D& Radii, float XAxisRotation, bool bLargeArc, bool bSweep,
+                          const FVector2D& To, const FFloorPlanVectorTransform& Transform, int32 Layer);
+    void AddPolyline(const TArray<FVector2D>& Points, bool bClosed, const FFloorPlanVectorTransform& Transform, int32 Layer);
+
+    static FFloorPlanVectorTransform ParseTransform(const FString& Text);
+    static float GetFontSize(const TMap<FString, FString>& Attributes, float Default);
+
+    FFloorPlanVectorReadSettings Settings;
+    FFloorPlanVectorScene* Scene = nullptr;
+};
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "FloorPlanServerCommandlet.generated.h"
+
+// Runs the shared floor plan analysis server until the process is asked to exit. Editors point their
+// analyzers at it with UFloorPlanAnalyzer::SetAnalysisServer and fall back to in-process analysis
+// whenever it is not running.
+//
+// UnrealEditor-Cmd <Project> -run=FloorPlanServer -Address=127.0.0.1:7878 -CacheMB=2048
+UCLASS()
+class FLOORPLANGENERATOR_API UFloorPlanServerCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    UFloorPlanServerCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FloorPlanAnalyzer.h"
+
+// Bounding volume hierarchy over 2D boxes: one flat node array, built top-down by median splits along
+// the longest axis of the item centers. Leaves hold up to LeafSize items.
+class FLOORPLANGENERATOR_API FFloorPlanBVH2D
+{
+public:
+    static constexpr int32 LeafSize = 4;
+
+    void Build(const TArray<FBox2D>& Boxes);
+    void Reset();
+
+    // Calls Visitor with every item whose box overlaps Box
+    void QueryBox(const FBox2D& Box, TFunctionRef<void(int32)> Visitor) const;
+
+    // Item with the smallest DistanceSq, visiting nodes closest-first and stopping once no box can beat
+    // the best item; INDEX_NONE when nothing lies within MaxDistance
+    int32 FindNearest(const FVector2D& Point, float MaxDistance, TFunctionRef<double(int32)> DistanceSq) const;
+
+    int32 Num() const { return ItemBounds.Num(); }
+
+private:
+    // Inner nodes have Count == 0, their left child follows them and Right is the right child
+    struct FNode
+    {
+        FBox2D Bounds;
+        int32 First = 0;
+        int32 Count = 0;
+        int32 Right = INDEX_NONE;
+    };
+
+    int32 BuildNode(int32 First, int32 Count);
+
+    TArray<FNode> Nodes;
+    TArray<int32> Items;
+    TArray<FBox2D> ItemBounds;
+};
+
+// Spatial index over one set of analysis results: rooms by boundary, walls by center line and openings
+// by footprint. Built in O(n log n), queries are logarithmic in the number of items.
+class FLOORPLANGENERATOR_API FFloorPlanSpatialIndex
+{
+public:
+    void Build(const TArray<FRoomData>& InRooms, const TArray<FWallSegmentData>& InWalls, const TArray<FOpeningData>& InOpenings);
+
+    // Room whose boundary contains Point, the smallest one for nested outlines; INDEX_NONE outside all rooms
+    int32 FindRoomAt(const FVector2D& Point) const;
+
+    // Walls whose center line passes within Radius of Point
+    void FindWallsInRadius(const FVector2D& Point, float Radius, TArray<int32>& OutWalls) const;
+
+    // Openings whose footprint lies within Radius of Point
+    void FindOpeningsInRadius(const FVector2D& Point, float Radius, TArray<int32>& OutOpenings) const;
+
+    int32 FindNearestWall(const FVector2D& Point, float MaxDistance) const;
+
+    // Host wall of every opening: the nearest center line within MaxDistance, INDEX_NONE when none is
+    void AssignOpeningsToWalls(float MaxDistance, TArray<int32>& OutWallPerOpening) const;
+
+    int32 GetNumWalls() const { return Walls.Num(); }
+
+private:
+    double GetWallDistanceSq(int32 Wall, const FVector2D& Point) const;
+
+    TArray<TArray<FVector2D>> RoomBoundaries;
+    TArray<double> RoomAreas;
+    TArray<FWallSegmentData> Walls;
+    TArray<FBox2D> OpeningBounds;
+    TArray<FVector2D> OpeningCenters;
+
+    FFloorPlanBVH2D RoomTree;
+    FFloorPlanBVH2D WallTree;
+    FFloorPlanBVH2D OpeningTree;
+};
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FloorPlanAnalyzer.h"
+#include "FloorPlanMask.h"
+
+class FFloorPlanStripReader;
+struct FFloorPlanProfile;
+
+// Settings for the out-of-core analysis path
+struct FFloorPlanStreamingSettings
+{
+    // Rows decoded per strip
+    int32 StripRows = 256;
+
+    // Same thresholds as UFloorPlanAnalyzer::IsBlackPixel / IsWhitePixel
+    uint8 BlackThreshold = 50;
+    uint8 WhiteThreshold = 200;
+
+    // Minimum room bounding box in pixels (matches the full-frame room detection)
+    int32 MinRoomSizePixels = 50;
+
+    // Wall points are kept at most once per cell of this size, replacing the O(n^2) duplicate removal
+    int32 WallPointSpacingPixels = 4;
+
+    float ScaleFactor = 30.48f;
+};
+
+// Single-pass binarization, run-based room labeling and wall detection over a sliding window of rows.
+// Working memory is proportional to the image width: three classified rows for the 3x3 wall test and the
+// white runs of the previous row with their union-find component stats. Components are emitted as soon as
+// no run of the current row extends them.
+class FLOORPLANGENERATOR_API FFloorPlanStreamingAnalyzer
+{
+public:
+    FFloorPlanStreamingAnalyzer(int32 InWidth, int32 InHeight, const FFloorPlanStreamingSettings& InSettings);
+
+    // Pulls every strip from the reader and finishes the analysis, decode and labeling times go to the profile if given
+    bool Run(FFloorPlanStripReader& Reader, FFloorPlanProfile* Profile = nullptr);
+
+    // Feeds NumRows rows of luminance (Width bytes each), rows must arrive top to bottom
+    void ConsumeRows(const uint8* Luminance, int32 NumRows);
+
+    // Flushes the last wall row and the components still open at the bottom of the image
+    void Finish();
+
+    const TArray<FRoomData>& GetRooms() const { return Rooms; }
+    const TArray<FVector2D>& GetWallPoints() const { return WallPoints; }
+
+    // Hands the result arrays to the caller without copying
+    void MoveResults(TArray<FRoomData>& OutRooms, TArray<FVector2D>& OutWallPoints)
+    {
+        OutRooms = MoveTemp(Rooms);
+        OutWallPoints = MoveTemp(WallPoints);
+    }
+
+    // High-water mark of the sliding window state, excluding the result arrays
+    int64 GetPeakWorkingBytes() const { return PeakWorkingBytes; }
+
+private:
+    // Horizontal run of room pixels, [Start, End] inclusive
+    struct FRun
+    {
+        int32 Start;
+        int32 End;
+        int32 Label;
+    };
+
+    struct FComponentStats
+    {
+        FIntPoint Min;
+        FIntPoint Max;
+        int64 Area = 0;
+        bool bTouchesBorder = false;
+
+        void Merge(const FComponentStats& Other)
+        {
+            Min.X = FMath::Min(Min.X, Other.Min.X);
+            Min.Y = FMath::Min(Min.Y, Other.Min.Y);
+            Max.X = FMath::Max(Max.X, Other.Max.X);
+            Max.Y = FMath::Max(Max.Y, Other.Max.Y);
+            Area += Other.Area;
+            bTouchesBorder |= Other.bTouchesBorder;
+        }
+    };
+
+    uint8* GetClassRow(int32 Y) { return ClassRows.GetData() + (Y % 3) * Width; }
+    void ClassifyRow(const uint8* Luminance, uint8* OutClasses) const;
+    void LabelRow(int32 Y, const uint8* Classes);
+    void DetectWallsInRow(int32 Y);
+    void EmitRoom(const FComponentStats& Stats);
+    int32 FindRoot(int32 Node);
+    void UnionNodes(int32 A, int32 B);
+    void TrackWorkingSet(int64 ExtraBytes = 0);
+
+    int32 Width;
+    int32 Height;
+    FFloorPlanStreamingSettings Settings;
+
+    // Ring buffer of the last three classified rows
+    TArray<uint8> ClassRows;
+    int32 RowsClassified = 0;
+    int32 RowsWallScanned = 0;
+
+    // Labeling state: runs of the previous row and the stats of the components they belong to
+    TArray<FRun> PrevRuns;
+    TArray<FRun> CurRuns;
+    TArray<FComponentStats> ActiveStats;
+    TArray<FComponentStats> NextStats;
+
+    // Per-row union-find scratch over previous components and current runs
+    TArray<int32> Parent;
+    TArray<FComponentStats> NodeStats;
+    TArray<int32> RootToLabel;
+
+    // Occupancy of wall point cells in the current cell row
+    TBitArray<> WallCells;
+    int32 WallCellRow = INDEX_NONE;
+
+    TArray<FRoomData> Rooms;
+    TArray<FVector2D> WallPoints;
+    int64 PeakWorkingBytes = 0;
+};
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UTexture2D;
+
+// Reads a floor plan image as horizontal strips of 8-bit luminance so the full frame is never held in memory
+class FLOORPLANGENERATOR_API FFloorPlanStripReader
+{
+public:
+    virtual ~FFloorPlanStripReader() {}
+
+    // Opens a PNG or TIFF file for row-by-row decoding; other formats fall back to a full ImageWrapper decode
+    static TUniquePtr<FFloorPlanStripReader> CreateForFile(const FString& FilePath);
+
+    // Reads rows straight out of the texture source without copying the whole image
+    static TUniquePtr<FFloorPlanStripReader> CreateForTexture(UTexture2D* Texture);
+
+    int32 GetWidth() const { return Width; }
+    int32 GetHeight() const { return Height; }
+
+    // Decodes up to MaxRows rows into OutLuminance (Width bytes per row), returns the number of rows read (0 at the end)
+    virtual int32 ReadRows(int32 MaxRows, TArray<uint8>& OutLuminance) = 0;
+
+protected:
+    // Same brightness measure as UFloorPlanAnalyzer::IsBlackPixel / IsWhitePixel
+    static uint8 ToLuminance(uint8 R, uint8 G, uint8 B) { return static_cast<uint8>((R + G + B) / 3); }
+
+    int32 Width = 0;
+    int32 Height = 0;
+};
@@ -0,0 +1,137 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FloorPlanAnalyzer.h"
+
+class FFloorPlanStripReader;
+
+struct FFloorPlanSyntheticSettings
+{
+    int32 Width = 2048;
+    int32 Height = 2048;
+    int32 NumRooms = 8;
+    int32 Seed = 1;
+
+    // Physical size of the long image side, every other length scales with the resolution
+    float PlanSizeCm = 1500.0f;
+    float WallThicknessCm = 15.0f;
+    float DoorWidthCm = 90.0f;
+    float WindowWidthCm = 120.0f;
+    float TextHeightCm = 25.0f;
+
+    // Chance of a door in each interior wall and of a window on each exterior room side
+    float DoorProbability = 0.8f;
+    float WindowProbability = 0.5f;
+
+    // Room name and feet/inch dimension label at the center of each room
+    bool bDrawText = true;
+
+    // Fraction of pixels replaced by gray speckles, and the brightness jitter of paper and ink
+    float SpeckleFraction = 0.0005f;
+    int32 GrayJitter = 20;
+};
+
+// Ground truth of a generated plan, in the world units the analyzer reports when run with ScaleFactor
+struct FFloorPlanGroundTruth
+{
+    float ScaleFactor = 30.48f;
+    TArray<FRoomData> Rooms;
+    TArray<FWallSegmentData> Walls;
+    TArray<FOpeningData> Openings;
+};
+
+struct FFloorPlanAccuracy
+{
+    float RoomRecall = 0.0f;
+    float RoomPrecision = 0.0f;
+    float RoomNameAccuracy = 0.0f;
+    float OpeningRecall = 0.0f;
+    float OpeningPrecision = 0.0f;
+    float OpeningTypeAccuracy = 0.0f;
+
+    // Mean absolute wall thickness error of matched segments, world units
+    float WallThicknessError = 0.0f;
+};
+
+// Deterministic, seeded floor plan generator for benchmarks. Rooms come from a binary space partition,
+// interior walls get doors with swing arcs, exterior walls get window symbols, rooms get labels, and
+// the image is rasterized row by row on demand so even 40k x 40k plans never exist as a full frame.
+class FLOORPLANGENERATOR_API FFloorPlanSyntheticGenerator
+{
+public:
+    explicit FFloorPlanSyntheticGenerator(const FFloorPlanSyntheticSettings& InSettings);
+
+    const FFloorPlanSyntheticSettings& GetSettings() const { return Settings; }
+    const FFloorPlanGroundTruth& GetGroundTruth() const { return Truth; }
+
+    // Fresh reader over the generated image, the generator must outlive it
+    TUniquePtr<FFloorPlanStripReader> CreateReader() const;
+
+    // Writes Width luminance bytes of row Y
+    void RasterizeRow(int32 Y, uint8* OutRow) const;
+
+    // Compares analysis output against the ground truth of the same plan
+    static FFloorPlanAccuracy Score(const FFloorPlanGroundTruth& Truth, const TArray<FRoomData>& Rooms,
+                                    const TArray<FOpeningData>& Openings, const TArray<FWallSegmentData>& Segments);
+
+private:
+    // Wall center line in pixels with the door and window gaps cut into it
+    struct FWallLine
+    {
+        bool bHorizontal;
+        bool bExterior;
+        int32 Across;
+        int32 Start;
+        int32 End;
+        TArray<FInt32Interval> Gaps;
+    };
+
+    // Axis-aligned filled rectangle, [X0, X1) x [Y0, Y1)
+    struct FRectPrimitive
+    {
+        int32 X0, Y0, X1, Y1;
+        uint8 Value;
+    };
+
+    // Quarter ring centered on Center, covering the quadrant given by the signs
+    struct FArcPrimitive
+    {
+        FVector2D Center;
+        float Radius;
+        float HalfWidth;
+        int32 SignX;
+        int32 SignY;
+        int32 Y0, Y1;
+        uint8 Value;
+    };
+
+    void BuildLayout();
+    void AddDoor(FWallLine& Wall, FRandomStream& Random);
+    void AddWindow(FWallLine& Wall, int32 SideStart, int32 SideEnd);
+    void AddWallRects(const FWallLine& Wall);
+    void AddRoomLabel(const FIntRect& Interior, const FString& Name, const FString& DimensionText);
+    int32 DrawText(const FString& Text, int32 X, int32 Y, int32 CellSize, bool bMeasureOnly);
+    void AddRect(int32 X0, int32 Y0, int32 X1, int32 Y1, uint8 Value);
+    void AddArc(const FVector2D& Center, float Radius, float HalfWidth, int32 SignX, int32 SignY, uint8 Value);
+
+    FVector2D ToWorld(float X, float Y) const { return FVector2D(X, Y) * CmPerPixel; }
+    static FString FormatFeetInches(float Centimeters);
+
+    static constexpr int32 BandRows = 64;
+    static constexpr uint8 WallValue = 0;
+    static constexpr uint8 AnnotationValue = 100;
+    static constexpr uint8 SpeckleValue = 120;
+
+    FFloorPlanSyntheticSettings Settings;
+    FFloorPlanGroundTruth Truth;
+    float CmPerPixel = 1.0f;
+    int32 WallPixels = 2;
+
+    TArray<FWallLine> Walls;
+    TArray<FRectPrimitive> Rects;
+    TArray<FArcPrimitive> Arcs;
+
+    // Primitive indices per band of BandRows rows
+    TArray<TArray<int32>> RectBands;
+    TArray<TArray<int32>> ArcBands;
+};
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FFloorPlanMask;
+
+// Lightweight CPU text recognizer for room labels and dimension strings.
+// Glyphs are segmented as ink connected components inside a small crop, grouped into lines and
+// classified against a bundled 5x7 glyph set (digits, capitals and the foot/inch punctuation).
+class FLOORPLANGENERATOR_API FFloorPlanTextRecognizer
+{
+public:
+    FFloorPlanTextRecognizer();
+
+    // Rows of a bundled 5x7 glyph, bit 4 is the leftmost column. Also covers ' " - . x for rendering.
+    static bool GetBuiltInGlyph(TCHAR Character, uint8 (&OutRows)[7]);
+
+    // Adds or replaces a template from a row-major bitmap (non-zero = ink)
+    void AddGlyphTemplate(TCHAR Character, const TArray<uint8>& Bitmap, int32 BitmapWidth, int32 BitmapHeight);
+
+    // Recognizes the text lines inside a pixel rectangle of the mask, top to bottom
+    void RecognizeRegion(const FFloorPlanMask& Mask, const FIntRect& Region, TArray<FString>& OutLines) const;
+
+    // Recognizes the label area of every room rectangle, rooms are processed in parallel
+    void RecognizeRooms(const FFloorPlanMask& Mask, const TArray<FIntRect>& RoomRects, TArray<TArray<FString>>& OutLines) const;
+
+private:
+    // Normalized glyph grid every template and candidate is resampled to
+    static constexpr int32 GridWidth = 10;
+    static constexpr int32 GridHeight = 14;
+
+    struct FGlyph
+    {
+        FIntRect Bounds;
+        TArray<FIntPoint> Pixels;
+    };
+
+    struct FGlyphTemplate
+    {
+        TCHAR Character;
+        float Aspect;
+        float Grid[GridWidth * GridHeight];
+    };
+
+    void FindGlyphs(const FFloorPlanMask& Mask, const FIntRect& Region, TArray<FGlyph>& OutGlyphs) const;
+    TCHAR ClassifyGlyph(const FGlyph& Glyph, int32 LineTop, int32 LineBottom) const;
+    static void RasterizeToGrid(const FGlyph& Glyph, float* OutGrid);
+
+    TArray<FGlyphTemplate> Templates;
+};
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FloorPlanAnalyzer.h"
+
+struct FFloorPlanVectorScene;
+
+struct FFloorPlanVectorSettings
+{
+    // Wildcard layer patterns for wall faces (empty = every layer) and for closed room outlines
+    TArray<FString> WallLayers;
+    TArray<FString> RoomLayers = { TEXT("*ROOM*"), TEXT("*AREA*"), TEXT("*SPACE*") };
+
+    // Distance between the two drawn faces of a wall, centimeters
+    float MinWallThickness = 5.0f;
+    float MaxWallThickness = 60.0f;
+    float MinWallLength = 10.0f;
+
+    // Width range of door and window gaps, centimeters
+    float MinOpeningWidth = 50.0f;
+    float MaxOpeningWidth = 250.0f;
+
+    // Lines within this angle are treated as parallel
+    float AngleToleranceDegrees = 1.0f;
+};
+
+// Builds walls, openings and rooms straight from vector primitives, cost scales with primitive count.
+// Walls are pairs of parallel face lines, windows are a glass line between those faces, doors are wall gaps
+// with a swing arc hinged at one end (gaps without one stay open as passages but are not reported as
+// openings), and rooms come from closed outlines or from the walls, openings and passages around each label.
+class FLOORPLANGENERATOR_API FFloorPlanVectorAnalyzer
+{
+public:
+    FFloorPlanVectorAnalyzer(const FFloorPlanVectorScene& InScene, const FFloorPlanVectorSettings& InSettings);
+
+    void Run();
+
+    // Room text lines are returned per room, top to bottom, for name and dimension parsing
+    void MoveResults(TArray<FWallSegmentData>& OutWalls, TArray<FOpeningData>& OutOpenings,
+                     TArray<FRoomData>& OutRooms, TArray<TArray<FString>>& OutRoomLines);
+
+private:
+    // Wall face line in the frame of its angle bin: Along runs with the bin direction, Across is the signed offset
+    struct FOrientedLine
+    {
+        int32 Bin;
+        float Across;
+        float AlongStart;
+        float AlongEnd;
+    };
+
+    // Paired faces in bin frame coordinates, ends next to an opening are not extended into junctions
+    struct FWallPiece
+    {
+        int32 Bin;
+        float Across;
+        float AlongStart;
+        float AlongEnd;
+        float Thickness;
+        bool bOpeningAtStart = false;
+        bool bOpeningAtEnd = false;
+    };
+
+    struct FWindowSpan
+    {
+        int32 Bin;
+        float Across;
+        float AlongStart;
+        float AlongEnd;
+    };
+
+    void BuildOrientedLines();
+    void DetectWindows();
+    void PairWallFaces();
+    void DetectGapOpenings();
+    void BuildWalls();
+    void DetectRooms();
+    void AssignTexts(const TArray<FBox2D>& RoomBoxes, const TArray<const TArray<FVector2D>*>& Outlines);
+
+    // Marks Range of an oriented line as consumed by a window or a wall
+    void Cover(int32 LineIndex, const FFloatInterval& Range);
+    void GetUncovered(int32 LineIndex, const FFloatInterval& Range, TArray<FFloatInterval>& OutFree) const;
+
+    FVector2D FromFrame(int32 Bin, float Along, float Across) const;
+    float GetBinRotation(int32 Bin) const;
+
+    // Distance from Origin along Direction to the nearest wall, opening or passage face, MAX_flt when nothing is hit
+    float CastToWall(const FVector2D& Origin, const FVector2D& Direction) const;
+
+    const FFloorPlanVectorScene& Scene;
+    FFloorPlanVectorSettings Settings;
+
+    // Oriented lines sorted by bin, then across; BinFirst holds the first index of each bin plus a sentinel
+    TArray<FOrientedLine> Oriented;
+    TArray<float> BinAngles;
+    TArray<int32> BinFirst;
+    TArray<TArray<FFloatInterval>> Covered;
+
+    TArray<FWindowSpan> Windows;
+    TArray<FWallPiece> Pieces;
+
+    TArray<FWallSegmentData> Walls;
+    TArray<FOpeningData> Openings;
+    TArray<FRoomData> Rooms;
+
+    // Gaps without a door arc: not reported, but they close room outlines like openings do
+    TArray<FOpeningData> Passages;
+    TArray<TArray<FString>> RoomLines;
+};
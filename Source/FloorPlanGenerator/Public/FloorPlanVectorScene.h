@@ -0,0 +1,110 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Vector primitives in plan space: centimeters, X to the right and Y down like image input
+struct FFloorPlanVectorLine
+{
+    FVector2D Start;
+    FVector2D End;
+    int32 Layer;
+};
+
+// Circular arc from StartAngle sweeping SweepAngle degrees toward +Y
+struct FFloorPlanVectorArc
+{
+    FVector2D Center;
+    float Radius;
+    float StartAngle;
+    float SweepAngle;
+    int32 Layer;
+};
+
+struct FFloorPlanVectorText
+{
+    FVector2D Position;
+    float Height;
+    FString Text;
+    int32 Layer;
+};
+
+// Affine map between drawing spaces (block inserts, SVG groups, PDF CTM), column vectors AxisX, AxisY and Translation
+struct FLOORPLANGENERATOR_API FFloorPlanVectorTransform
+{
+    FVector2D AxisX = FVector2D(1.0f, 0.0f);
+    FVector2D AxisY = FVector2D(0.0f, 1.0f);
+    FVector2D Translation = FVector2D::ZeroVector;
+
+    FFloorPlanVectorTransform() {}
+    FFloorPlanVectorTransform(float A, float B, float C, float D, float E, float F)
+        : AxisX(A, B), AxisY(C, D), Translation(E, F) {}
+
+    FVector2D Apply(const FVector2D& Point) const { return AxisX * Point.X + AxisY * Point.Y + Translation; }
+    float ApplyAngle(float Degrees) const;
+    float GetDeterminant() const { return AxisX.X * AxisY.Y - AxisX.Y * AxisY.X; }
+
+    // This transform followed by Parent
+    FFloorPlanVectorTransform Then(const FFloorPlanVectorTransform& Parent) const;
+};
+
+// Closed outline, e.g. a room or area polyline
+struct FFloorPlanVectorPolygon
+{
+    TArray<FVector2D> Points;
+    int32 Layer;
+};
+
+// Options common to every vector reader
+struct FFloorPlanVectorReadSettings
+{
+    // Wildcard layer patterns; an empty include list keeps every layer
+    TArray<FString> IncludeLayers;
+    TArray<FString> ExcludeLayers;
+
+    // Centimeters per drawing unit (DXF: only when the header has no $INSUNITS)
+    float UnitToCm = 1.0f;
+};
+
+// Flat primitive lists shared by every vector input (DXF, SVG, PDF) and the vector analyzer
+struct FLOORPLANGENERATOR_API FFloorPlanVectorScene
+{
+    TArray<FString> Layers;
+    TArray<FFloorPlanVectorLine> Lines;
+    TArray<FFloorPlanVectorArc> Arcs;
+    TArray<FFloorPlanVectorText> Texts;
+    TArray<FFloorPlanVectorPolygon> Polygons;
+    FBox2D Bounds = FBox2D(ForceInit);
+
+    int32 FindOrAddLayer(const FString& Name);
+    const FString& GetLayerName(int32 Layer) const { return Layers[Layer]; }
+
+    // True when the layer matches any of the wildcard patterns, an empty list matches everything
+    bool LayerMatches(int32 Layer, const TArray<FString>& Patterns) const;
+
+    // Layer index for a name, INDEX_NONE when the read settings filter it out; decisions are cached per name
+    int32 FindOrAddFilteredLayer(const FString& Name, const FFloorPlanVectorReadSettings& Settings);
+
+    void AddLine(const FVector2D& Start, const FVector2D& End, int32 Layer);
+    void AddArc(const FVector2D& Center, float Radius, float StartAngle, float SweepAngle, int32 Layer);
+    void AddText(const FVector2D& Position, float Height, const FString& Text, int32 Layer);
+    void AddPolygon(TArray<FVector2D>&& Points, int32 Layer);
+
+    // Splits a polyline edge with a DXF-style bulge (tan of a quarter of the included angle) into a line or an arc
+    void AddBulgeSegment(const FVector2D& Start, const FVector2D& End, float Bulge, int32 Layer);
+
+    // Circle through three points, or a line when they are collinear
+    void AddArcThroughPoints(const FVector2D& Start, const FVector2D& Mid, const FVector2D& End, int32 Layer);
+
+    // Cubic Bezier: circular ones (door swings in SVG and PDF) become arcs, everything else is flattened into lines
+    void AddCubic(const FVector2D& P0, const FVector2D& P1, const FVector2D& P2, const FVector2D& P3, int32 Layer);
+
+    // Moves the drawing to the origin; Y-up drawings (CAD, PDF) are mirrored about their bounds into plan space
+    void NormalizeToOrigin(bool bFlipY);
+
+    int32 GetNumPrimitives() const { return Lines.Num() + Arcs.Num() + Texts.Num() + Polygons.Num(); }
+
+    void Reset();
+
+private:
+    TMap<FString, int32> FilteredLayers;
+};
@@ -4,10 +4,15 @@
 #include "UObject/NoExportTypes.h"
 #include "Engine/StaticMesh.h"
 #include "FloorPlanAnalyzer.h"
+#include "FloorPlanProfile.h"
 #include "MeshGenerator.generated.h"
 
+struct FFloorPlanMeshBuffers;
+struct FFloorPlanPolygon;
+class UFloorPlanMaterialSet;
+
 // Wall segment structure for procedural generation
-USERSTRUCT(BlueprintType)
+USTRUCT(BlueprintType)
 struct FWallSegment
 {
     GENERATED_BODY()
@@ -33,6 +38,52 @@ struct FWallSegment
     }
 };
 
+// Kind of generated mesh, each kind has its own output settings
+UENUM(BlueprintType)
+enum class EFloorPlanMeshKind : uint8
+{
+    Wall,
+    Floor,
+    Ceiling,
+    // Whole-building (storey) meshes merged from all pieces
+    Merged
+};
+
+// How a generated static mesh is built: Nanite with its fallback, or a classic reduction LOD chain
+USTRUCT(BlueprintType)
+struct FFloorPlanMeshOutputSettings
+{
+    GENERATED_BODY()
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Output")
+    bool bNanite = false;
+
+    // Fallback mesh for platforms and passes without Nanite, as a fraction of the source triangles
+    // and the relative error the simplifier may stop at (whichever is reached first)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Output", meta = (ClampMin = "0", ClampMax = "1"))
+    float NaniteFallbackPercentTriangles = 0.1f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Output", meta = (ClampMin = "0"))
+    float NaniteFallbackRelativeError = 1.0f;
+
+    // LOD chain when Nanite is off, each LOD keeps LODReduction of the previous one's triangles
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Output", meta = (ClampMin = "1", ClampMax = "8"))
+    int32 NumLODs = 1;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Output", meta = (ClampMin = "0.05", ClampMax = "1"))
+    float LODReduction = 0.5f;
+
+    // Merged meshes are split into spatially coherent chunks of at most this many triangles, so
+    // Nanite clusters stay local and chunks stream and cull independently
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Output", meta = (ClampMin = "1024"))
+    int32 MaxTrianglesPerChunk = 131072;
+
+    // Lightmap texel resolution; UV1 is packed analytically for it, so the engine's lightmap UV
+    // generation is skipped
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Output", meta = (ClampMin = "16", ClampMax = "4096"))
+    int32 LightmapResolution = 64;
+};
+
 UCLASS(BlueprintType)
 class FLOORPLANGENERATOR_API UMeshGenerator : public UObject
 {
@@ -54,7 +105,74 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Mesh Generation")
     UStaticMesh* GenerateCeilingMesh(const TArray<FVector2D>& BoundaryPoints, float ZHeight);
 
+    // Nanite and LOD options per mesh kind; merged meshes default to Nanite
+    UFUNCTION(BlueprintCallable, Category = "Mesh Generation")
+    void SetOutputSettings(EFloorPlanMeshKind Kind, const FFloorPlanMeshOutputSettings& Settings) { OutputSettings.Add(Kind, Settings); }
+
+    UFUNCTION(BlueprintPure, Category = "Mesh Generation")
+    FFloorPlanMeshOutputSettings GetOutputSettings(EFloorPlanMeshKind Kind) const;
+
+    // Materials assigned to the slots of every generated mesh, resolved once and shared
+    UFUNCTION(BlueprintCallable, Category = "Mesh Generation")
+    UFloorPlanMaterialSet* GetMaterialSet();
+
+    UFUNCTION(BlueprintCallable, Category = "Mesh Generation")
+    void SetMaterialSet(UFloorPlanMaterialSet* InMaterialSet) { MaterialSet = InMaterialSet; }
+
+    // Section and material slot name of a mesh kind ("Wall", "Floor", "Ceiling")
+    static FString GetSlotName(EFloorPlanMeshKind Kind);
+
+    // Creates the asset for buffers built elsewhere (typically on worker threads, lightmap UVs already
+    // packed) with the settings of Kind. Game thread only.
+    UStaticMesh* CreateMeshAsset(const FFloorPlanMeshBuffers& Buffers, const FString& MeshName, EFloorPlanMeshKind Kind);
+
+    // Creates one static mesh asset per spatial chunk of a whole-building buffer, with the Merged settings
+    TArray<UStaticMesh*> CreateMergedMeshAssets(const FFloorPlanMeshBuffers& Buffers, const FString& BaseName);
+
+    // Mesh build and asset creation timings, vertex and triangle counts since the last reset
+    UFUNCTION(BlueprintPure, Category = "Mesh Generation")
+    const FFloorPlanProfile& GetProfile() const { return Profile; }
+
+    UFUNCTION(BlueprintCallable, Category = "Mesh Generation")
+    void ResetProfile() { Profile = FFloorPlanProfile(); }
+
+    // Procedural mesh generation functions. They only fill buffers, so exporters and batch tools call
+    // them without an instance and without creating any mesh asset.
+    static void CreateWallMeshWithOpenings(TArray<FVector>& Vertices, TArray<int32>& Triangles, 
+                                           TArray<FVector2D>& UVs, TArray<FVector>& Normals,
+                                           float Length, float Height, float Thickness,
+                                           const TArray<FOpeningData>& Openings, 
+                                           float DoorHeight, float WindowHeight);
+
+    static void CreateWallSegmentMesh(TArray<FVector>& Vertices, TArray<int32>& Triangles,
+                                      TArray<FVector2D>& UVs, TArray<FVector>& Normals,
+                                      const struct FWallSegment& Segment, float Thickness);
+
+    static void CreateThickFloorMesh(TArray<FVector>& Vertices, TArray<int32>& Triangles,
+                                     TArray<FVector2D>& UVs, TArray<FVector>& Normals,
+                                     float Width, float Length, float Thickness);
+
+    static void CreateThickCeilingMesh(TArray<FVector>& Vertices, TArray<int32>& Triangles,
+                                       TArray<FVector2D>& UVs, TArray<FVector>& Normals,
+                                       float Width, float Length, float Thickness);
+
+    // Slab over plan polygons from MinZ to MaxZ: ear-clipped top and bottom caps and one side quad per
+    // outline and hole edge, so footprints merged by FFloorPlanPolygonUnion have no inner side faces
+    static void CreateSlabMesh(TArray<FVector>& Vertices, TArray<int32>& Triangles,
+                               TArray<FVector2D>& UVs, TArray<FVector>& Normals,
+                               const TArray<FFloorPlanPolygon>& Polygons, float MinZ, float MaxZ);
+
 private:
+    // Appends one flat quad with its own four vertices, world-scaled planar UV0 and the given normal
+    static void AddQuad(TArray<FVector>& Vertices, TArray<int32>& Triangles,
+                        TArray<FVector2D>& UVs, TArray<FVector>& Normals,
+                        const FVector (&Corners)[4], const FVector& Normal);
+
+    // Appends the six faces of an axis-aligned box
+    static void AddBoxFaces(TArray<FVector>& Vertices, TArray<int32>& Triangles,
+                            TArray<FVector2D>& UVs, TArray<FVector>& Normals,
+                            const FVector& Min, const FVector& Max);
+
     // Helper functions for mesh creation
     void CreateBoxMesh(TArray<FVector>& Vertices, TArray<int32>& Triangles, TArray<FVector2D>& UVs,
                        const FVector& Center, const FVector& Extent);
@@ -66,34 +184,27 @@ private:
                                const FVector& WallStart, const FVector& WallEnd, float Height, float Thickness,
                                const TArray<FOpeningData>& Openings, float DoorHeight, float WindowHeight);
 
-    // Procedural mesh generation functions
-    void CreateWallMeshWithOpenings(TArray<FVector>& Vertices, TArray<int32>& Triangles, 
-                                   TArray<FVector2D>& UVs, TArray<FVector>& Normals,
-                                   float Length, float Height, float Thickness,
-                                   const TArray<FOpeningData>& Openings, 
-                                   float DoorHeight, float WindowHeight);
-
-    void CreateWallSegmentMesh(TArray<FVector>& Vertices, TArray<int32>& Triangles,
-                              TArray<FVector2D>& UVs, TArray<FVector>& Normals,
-                              const struct FWallSegment& Segment, float Thickness);
-
-    void CreateThickFloorMesh(TArray<FVector>& Vertices, TArray<int32>& Triangles,
-                             TArray<FVector2D>& UVs, TArray<FVector>& Normals,
-                             float Width, float Length, float Thickness);
-
-    void CreateThickCeilingMesh(TArray<FVector>& Vertices, TArray<int32>& Triangles,
-                               TArray<FVector2D>& UVs, TArray<FVector>& Normals,
-                               float Width, float Length, float Thickness);
-
     UStaticMesh* CreateStaticMeshAsset(const TArray<FVector>& Vertices, 
                                        const TArray<int32>& Triangles, 
                                        const TArray<FVector2D>& UVs,
                                        const TArray<FVector>& Normals,
-                                       const FString& MeshName);
+                                       const FString& MeshName,
+                                       EFloorPlanMeshKind Kind);
+
+    UStaticMesh* CreateStaticMeshAsset(const FFloorPlanMeshBuffers& Buffers, const FString& MeshName, const FFloorPlanMeshOutputSettings& Settings);
 
     // Utility functions
     FVector2D To2D(const FVector& Vector3D) { return FVector2D(Vector3D.X, Vector3D.Y); }
     FVector To3D(const FVector2D& Vector2D, float Z = 0.0f) { return FVector(Vector2D.X, Vector2D.Y, Z); }
     
     int32 MeshCounter = 0;
+
+    UPROPERTY()
+    TMap<EFloorPlanMeshKind, FFloorPlanMeshOutputSettings> OutputSettings;
+
+    UPROPERTY()
+    UFloorPlanMaterialSet* MaterialSet = nullptr;
+
+    UPROPERTY()
+    FFloorPlanProfile Profile;
 };
@@ -4,10 +4,13 @@
 #include "UObject/NoExportTypes.h"
 #include "Components/StaticMeshComponent.h"
 #include "FloorPlanAnalyzer.h"
+#include "FloorPlanMeshBuffers.h"
+#include "MeshGenerator.h"
+#include "FloorPlanPortalGraph.h"
 #include "StructureBuilder.generated.h"
 
 // Wall definition structure for accurate layout generation
-USERSTRUCT(BlueprintType)
+USTRUCT(BlueprintType)
 struct FWallDefinition
 {
     GENERATED_BODY()
@@ -18,6 +21,18 @@ struct FWallDefinition
     UPROPERTY(EditAnywhere, BlueprintReadWrite)
     float Length = 0.0f;
 
+    // Measured thickness, 0 uses the builder's WallThickness
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    float Thickness = 0.0f;
+
+    // Plan position of the wall center line (zero for hand-authored layouts)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    FVector2D Start = FVector2D::ZeroVector;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    FVector2D End = FVector2D::ZeroVector;
+
+    // Openings in this wall, Position.X is the opening center measured along the wall from Start
     UPROPERTY(EditAnywhere, BlueprintReadWrite)
     TArray<FOpeningData> Openings;
 
@@ -25,12 +40,23 @@ struct FWallDefinition
     {
         WallName = TEXT("");
         Length = 0.0f;
+        Thickness = 0.0f;
     }
 };
 
 class UFloorPlanAnalyzer;
 class UMeshGenerator;
 
+// One floor, ceiling or wall built off the game thread: local-space buffers (lightmap UVs packed) and
+// the transform that places them in the plan
+struct FFloorPlanMeshPiece
+{
+    FString Name;
+    EFloorPlanMeshKind Kind = EFloorPlanMeshKind::Wall;
+    FTransform Placement;
+    FFloorPlanMeshBuffers Buffers;
+};
+
 UCLASS(BlueprintType)
 class FLOORPLANGENERATOR_API UStructureBuilder : public UObject
 {
@@ -39,10 +65,33 @@ class FLOORPLANGENERATOR_API UStructureBuilder : public UObject
 public:
     UStructureBuilder();
 
-    // Main building function
+    // Main building function, builds the analyzer's current results
     UFUNCTION(BlueprintCallable, Category = "Structure Builder")
     void BuildStructure(UWorld* World, UFloorPlanAnalyzer* Analyzer);
 
+    // Builds a result snapshot, independent of the analyzer that produced it
+    void BuildStructure(UWorld* World, const FFloorPlanAnalysisResult& Result);
+
+    // Builds the whole building into UObject-free buffers: walls placed along their plan segments, floors
+    // and ceilings at each room's bounds, one section per surface kind. No mesh assets are created.
+    void BuildMeshBuffers(const FFloorPlanAnalysisResult& Result, FFloorPlanMeshBuffers& OutBuffers);
+
+    // Wall layout the builder uses for an analysis: measured segments with their openings when the analysis
+    // produced them, otherwise the hand-authored layout
+    TArray<FWallDefinition> CreateWallLayout(const FFloorPlanAnalysisResult& Result);
+
+    // Builds one piece per wall of WallDefinitions and, with bIncludeRooms, a floor and a ceiling per room
+    // (or one of each for the storey with storey slabs on), in parallel and without touching UObjects.
+    // Pieces come out rooms first, in input order.
+    void BuildMeshPieces(const FFloorPlanAnalysisResult& Result, const TArray<FWallDefinition>& WallDefinitions, bool bIncludeRooms,
+                         TArray<FFloorPlanMeshPiece>& OutPieces, bool bPackLightmapUVs);
+
+    // Writes the building straight to a binary glTF file (.glb), quantized unless bQuantize is off
+    UFUNCTION(BlueprintCallable, Category = "Structure Builder")
+    bool ExportGLB(UFloorPlanAnalyzer* Analyzer, const FString& FilePath, bool bQuantize = true);
+
+    bool ExportGLB(const FFloorPlanAnalysisResult& Result, const FString& FilePath, bool bQuantize = true);
+
     // Parameter setters
     UFUNCTION(BlueprintCallable, Category = "Structure Builder")
     void SetWallHeight(float Height) { WallHeight = Height; }
@@ -56,11 +105,61 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Structure Builder")
     void SetWallThickness(float Thickness) { WallThickness = Thickness; }
 
+    // WallThickness normally only applies to walls without a measured thickness; with the override it
+    // replaces the measured values too
+    UFUNCTION(BlueprintCallable, Category = "Structure Builder")
+    void SetOverrideMeasuredThickness(bool bOverride) { bOverrideMeasuredThickness = bOverride; }
+
+    // Builds one merged, spatially chunked mesh set for the whole building instead of one asset per
+    // wall, floor and ceiling; the chunks use the generator's Merged output settings (Nanite by default)
+    UFUNCTION(BlueprintCallable, Category = "Structure Builder")
+    void SetMergeBuilding(bool bMerge) { bMergeBuilding = bMerge; }
+
+    // Replaces the floor and ceiling box of every room by one floor and one ceiling slab per storey over
+    // the union of all room footprints, grown by half the thickest wall so the slab runs under the walls.
+    // Regions enclosed by rooms but not part of any (stairwells, shafts) stay open.
+    UFUNCTION(BlueprintCallable, Category = "Structure Builder")
+    void SetStoreySlabs(bool bSlabs) { bStoreySlabs = bSlabs; }
+
+    // Builds a multi-storey building from one analysis per storey (bottom to top). Storeys whose walls,
+    // openings and rooms match within the storey match tolerance share one merged mesh set, placed by
+    // instancing at each elevation. StoreyHeight <= 0 stacks storeys on the wall height plus both slabs.
+    // Returns the number of unique storeys.
+    UFUNCTION(BlueprintCallable, Category = "Structure Builder")
+    int32 BuildTower(UWorld* World, const TArray<UFloorPlanAnalyzer*>& Storeys, float StoreyHeight = 0.0f);
+
+    int32 BuildTower(UWorld* World, const TArray<FFloorPlanAnalysisResultRef>& Storeys, float StoreyHeight = 0.0f);
+
+    // Room adjacency graph for cell-and-portal culling: rooms as cells, doors and windows as portals.
+    // Feed it to a UFloorPlanPortalCullingComponent together with the room geometry.
+    UFUNCTION(BlueprintCallable, Category = "Structure Builder")
+    FFloorPlanPortalGraph BuildPortalGraph(UFloorPlanAnalyzer* Analyzer);
+
+    // Largest wall end point, opening or room size difference (cm) for two storeys to count as identical
+    UFUNCTION(BlueprintCallable, Category = "Structure Builder")
+    void SetStoreyMatchTolerance(float Tolerance) { StoreyMatchTolerance = FMath::Max(0.0f, Tolerance); }
+
+    // Mesh generator used for asset creation, e.g. to change its per-kind Nanite and LOD settings
+    UFUNCTION(BlueprintCallable, Category = "Structure Builder")
+    UMeshGenerator* GetMeshGenerator();
+
+    // Mesh build and asset creation timings and counts of the last BuildStructure call
+    UFUNCTION(BlueprintPure, Category = "Structure Builder")
+    const FFloorPlanProfile& GetProfile() const { return Profile; }
+
 private:
-    // Accurate floor plan generation functions
-    void GenerateFloorPlanAssets(UFloorPlanAnalyzer* Analyzer);
-    void GenerateAccurateWallLayout(UFloorPlanAnalyzer* Analyzer);
+    // Accurate floor plan generation functions. Geometry is built by BuildMeshPieces in parallel,
+    // assets are then created on the game thread.
+    void GenerateFloorPlanAssets(const FFloorPlanAnalysisResult& Result);
     TArray<FWallDefinition> CreateFloorPlanWallLayout();
+    TArray<FWallDefinition> CreateWallLayoutFromSegments(const FFloorPlanAnalysisResult& Result);
+
+    // Whether Candidate repeats Typical: same counts, and every wall, opening and room of Candidate has
+    // a counterpart in Typical within StoreyMatchTolerance (looked up through Typical's spatial index)
+    bool IsSameStorey(const FFloorPlanAnalysisResult& Typical, const FFloorPlanAnalysisResult& Candidate) const;
+
+    // Adds the generator's asset creation profile to the builder's own and sets the total since StartCycles
+    void AppendGeneratorProfile(uint64 StartCycles);
     
     // Legacy building functions (now handled by asset generation)
     void BuildWalls(UWorld* World, UFloorPlanAnalyzer* Analyzer);
@@ -70,14 +169,24 @@ private:
 
     // Helper functions
     AActor* CreateMeshActor(UWorld* World, const FString& Name);
-    void ApplyMaterial(UStaticMeshComponent* MeshComponent, const FString& MaterialPath);
 
     // Parameters
     float WallHeight = 300.0f;
     float DoorHeight = 244.0f;
     float WindowHeight = 152.0f;
     float WallThickness = 10.0f;
+    bool bMergeBuilding = false;
+    bool bStoreySlabs = false;
+    bool bOverrideMeasuredThickness = false;
+
+    float StoreyMatchTolerance = 5.0f;
+
+    // Openings farther than this from every wall center line are not placed in any wall
+    float OpeningSearchDistance = 100.0f;
 
     UPROPERTY()
     UMeshGenerator* MeshGenerator;
+
+    UPROPERTY()
+    FFloorPlanProfile Profile;
 };